@@ -13,6 +13,7 @@
 #include "GlobalUnsynced.h"
 #include "LoadScreen.h"
 #include "SelectedUnitsHandler.h"
+#include "SimBenchmark.h"
 #include "WaitCommandsAI.h"
 #include "WordCompletion.h"
 #include "IVideoCapturing.h"
@@ -47,6 +48,7 @@
 #include "Rendering/UnitDrawer.h"
 #include "Rendering/UniformConstants.h"
 #include "Rendering/Map/InfoTexture/IInfoTextureHandler.h"
+#include "Rendering/Models/IModelParser.h"
 #include "Rendering/Textures/NamedTextures.h"
 #include "Lua/LuaGaia.h"
 #include "Lua/LuaHandle.h"
@@ -105,6 +107,7 @@
 #include "UI/TooltipConsole.h"
 #include "UI/ProfileDrawer.h"
 #include "UI/Groups/GroupHandler.h"
+#include "System/AllocCounter.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
@@ -121,7 +124,9 @@
 #include "System/Sound/ISound.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/Sync/DumpState.h"
+#include "System/Sync/SyncedPrimitiveBase.h"
 #include "System/TimeProfiler.h"
+#include "System/UnorderedSet.hpp"
 
 
 #undef CreateDirectory
@@ -558,6 +563,44 @@ void CGame::PreLoadSimulation(LuaParser* defsParser)
 	explGenHandler.Init();
 }
 
+// queue the model of every buildable unit-type (and its first wreck) for
+// parsing on the thread-pool while the loadscreen is up, so that the first
+// spawn of a new type in a running game does not have to parse it
+static void PreloadBuildableModels()
+{
+	std::vector<std::string> modelNames;
+	spring::unordered_set<std::string> queuedNames;
+
+	const auto QueueModel = [&](const SolidObjectDef* def) {
+		if (def == nullptr || def->modelName.empty())
+			return;
+		if (!queuedNames.insert(def->modelName).second)
+			return;
+
+		modelNames.push_back(def->modelName);
+	};
+
+	for (const UnitDef& builderDef: unitDefHandler->GetUnitDefsVec()) {
+		for (const auto& buildOption: builderDef.buildOptions) {
+			const UnitDef* ud = unitDefHandler->GetUnitDefByName(buildOption.second);
+
+			if (ud == nullptr)
+				continue;
+
+			QueueModel(ud);
+			QueueModel(featureDefHandler->GetFeatureDef(ud->wreckName, false));
+		}
+	}
+
+	modelLoader.PreloadModels(modelNames);
+
+	#ifdef HEADLESS
+	// nothing to upload without GL, so block here and let the
+	// logged stats serve as a pure parse-throughput benchmark
+	modelLoader.FinishPreload();
+	#endif
+}
+
 void CGame::PostLoadSimulation(LuaParser* defsParser)
 {
 	CommonDefHandler::InitStatic();
@@ -577,6 +620,10 @@ void CGame::PostLoadSimulation(LuaParser* defsParser)
 		loadscreen->SetLoadMessage("Loading Feature Definitions");
 		featureDefHandler->Init(defsParser);
 	}
+	{
+		loadscreen->SetLoadMessage("Preloading Unit Models");
+		PreloadBuildableModels();
+	}
 
 	CUnit::InitStatic();
 	CCommandAI::InitCommandDescriptionCache();
@@ -795,6 +842,12 @@ void CGame::LoadFinalize()
 		LEAVE_SYNCED_CODE();
 	}
 
+	{
+		// models queued in PostLoadSimulation; GL resources are
+		// still created lazily on the main thread at first use
+		loadscreen->SetLoadMessage("[" + std::string(__func__) + "] finalizing model preload");
+		modelLoader.FinishPreload();
+	}
 	{
 		loadscreen->SetLoadMessage("[" + std::string(__func__) + "] finalizing PFS");
 
@@ -1491,6 +1544,9 @@ void CGame::StartPlaying()
 
 	if (saveFileHandler == nullptr)
 		eventHandler.GameStart();
+
+	if (simBenchmark.IsEnabled())
+		simBenchmark.Start();
 }
 
 
@@ -1505,6 +1561,8 @@ void CGame::SimFrame() {
 	gs->frameNum += 1;
 	lastFrameTime = spring_gettime();
 
+	SYNC_DEBUG_NEW_FRAME(gs->frameNum);
+
 	// clear allocator statistics periodically
 	// note: allocator itself should do this (so that
 	// stats are reliable when paused) but see LuaUser
@@ -1535,6 +1593,7 @@ void CGame::SimFrame() {
 	// everything from here is simulation
 	{
 		SCOPED_SPECIAL_TIMER("Sim");
+		ALLOC_COUNTER_PHASE(SYNC_PHASE_OTHER);
 
 		{
 			SCOPED_TIMER("Sim::GameFrame");
@@ -1544,17 +1603,22 @@ void CGame::SimFrame() {
 			if (luaGCControl == 0)
 				eventHandler.CollectGarbage(false);
 
+			SYNC_DEBUG_PHASE(SYNC_PHASE_GAMEFRAME);
 			eventHandler.GameFrame(gs->frameNum);
 		}
 
 		helper->Update();
 		mapDamage->Update();
-		pathManager->Update();
+		{
+			SYNC_DEBUG_PHASE(SYNC_PHASE_PATHING);
+			pathManager->Update();
+		}
 		unitHandler.Update();
 		projectileHandler.Update();
 		featureHandler.Update();
 		{
 			SCOPED_TIMER("Sim::Script");
+			SYNC_DEBUG_PHASE(SYNC_PHASE_UNIT_SCRIPTS);
 			unitScriptEngine->Tick(33);
 		}
 		envResHandler.Update();
@@ -1569,14 +1633,23 @@ void CGame::SimFrame() {
 		playerHandler.GameFrame(gs->frameNum);
 	}
 
+	AllocCounter::EndFrame();
+
+	#ifdef ALLOC_COUNTING
+	if ((gs->frameNum % (GAME_SPEED * 60)) == 0)
+		LOG("[Game::%s][frame=%d] heap allocations per sim-frame (count bytes)\n%s", __func__, gs->frameNum, AllocCounter::GetReport().c_str());
+	#endif
+
 	lastSimFrameTime = spring_gettime();
 	gu->avgSimFrameTime = mix(gu->avgSimFrameTime, (lastSimFrameTime - lastFrameTime).toMilliSecsf(), 0.05f);
 	gu->avgSimFrameTime = std::max(gu->avgSimFrameTime, 0.001f);
 
 	eventHandler.DbgTimingInfo(TIMING_SIM, lastFrameTime, lastSimFrameTime);
+	simBenchmark.EndFrame(gs->frameNum, lastFrameTime, lastSimFrameTime);
 
 	#ifdef HEADLESS
-	{
+	// benchmarks run as fast as possible
+	if (!simBenchmark.IsRunning()) {
 		const float msecMaxSimFrameTime = 1000.0f / (GAME_SPEED * gs->wantedSpeedFactor);
 		const float msecDifSimFrameTime = (lastSimFrameTime - lastFrameTime).toMilliSecsf();
 		// multiply by 0.5 to give unsynced code some execution time (50% of our sleep-budget)
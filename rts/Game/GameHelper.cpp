@@ -45,6 +45,38 @@ static CGameHelper gGameHelper;
 CGameHelper* helper = &gGameHelper;
 
 
+// bottom-up merge-sort; same order as std::stable_sort but the merge
+// buffer is reused instead of being heap-allocated on every call
+template<typename T, typename Pred>
+static void StableMergeSort(std::vector<T>& items, std::vector<T>& buffer, Pred pred)
+{
+	const size_t numItems = items.size();
+
+	if (numItems < 2)
+		return;
+
+	buffer.resize(numItems);
+
+	T* src = items.data();
+	T* dst = buffer.data();
+
+	for (size_t width = 1; width < numItems; width *= 2) {
+		for (size_t lo = 0; lo < numItems; lo += (width * 2)) {
+			const size_t mid = std::min(lo + width, numItems);
+			const size_t hi = std::min(lo + width * 2, numItems);
+
+			// merge takes from the first range on ties, which keeps it stable
+			std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, pred);
+		}
+
+		std::swap(src, dst);
+	}
+
+	if (src != items.data())
+		std::copy(src, src + numItems, items.data());
+}
+
+
 void CGameHelper::Init()
 {
 	for (auto& wdVec: waitingDamages) {
@@ -747,7 +779,7 @@ size_t CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* av
 		}
 	}
 
-	std::stable_sort(targets.begin(), targets.end(), [](const std::pair<float, CUnit*>& a, const std::pair<float, CUnit*>& b) { return (a.first < b.first); });
+	StableMergeSort(targets, helper->targetSortBuffer, [](const std::pair<float, CUnit*>& a, const std::pair<float, CUnit*>& b) { return (a.first < b.first); });
 
 #ifdef TRACE_SYNC
 	{
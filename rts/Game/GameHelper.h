@@ -185,6 +185,7 @@ private:
 public:
 	std::vector<int> targetUnitIDs; // GetEnemyUnits{NoLosTest}
 	std::vector<std::pair<float, CUnit*>> targetPairs; // GenerateWeaponTargets
+	std::vector<std::pair<float, CUnit*>> targetSortBuffer; // GenerateWeaponTargets
 };
 
 extern CGameHelper* helper;
@@ -0,0 +1,175 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cinttypes>
+#include <fstream>
+
+#include "SimBenchmark.h"
+#include "Action.h"
+#include "CommandMessage.h"
+#include "GlobalUnsynced.h"
+#include "IVideoCapturing.h"
+#include "Net/GameServer.h"
+#include "Net/Protocol/NetProtocol.h"
+#include "System/AllocCounter.h"
+#include "System/LoadSave/DemoReader.h"
+#include "System/SpringFormat.h"
+#include "System/TimeProfiler.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/Log/ILog.h"
+#include "System/Platform/Misc.h"
+#include "System/Sync/HsiehHash.h"
+#include "System/Sync/SyncChecker.h"
+
+CSimBenchmark simBenchmark;
+
+
+static float GetPercentile(const std::vector<float>& sortedTimes, float p)
+{
+	if (sortedTimes.empty())
+		return 0.0f;
+
+	return sortedTimes[std::min(sortedTimes.size() - 1, size_t(p * sortedTimes.size()))];
+}
+
+
+void CSimBenchmark::Start()
+{
+	assert(IsEnabled());
+	assert(!running);
+
+	running = true;
+	syncChecksum = 0;
+
+	frameTimes.clear();
+	frameTimes.reserve(numFrames);
+	startTimerTotals.clear();
+
+	// timers accumulate from engine start; remember where they were
+	// so the report only covers the benchmarked frames
+	profiler.Update();
+
+	for (const auto& p: profiler.GetSortedProfiles()) {
+		startTimerTotals[p.first] = p.second.total;
+	}
+
+	AllocCounter::Reset();
+
+	if ((replay = (gameServer != nullptr && gameServer->GetDemoReader() != nullptr))) {
+		// replays have their frames recorded already, make the server
+		// push all of them at once (same as /skip) and sim through the
+		// backlog as fast as possible
+		clientNet->Send(CommandMessage(Action(spring::format("skip f%u", numFrames)), gu->myPlayerNum).Pack());
+	} else {
+		// same lockstep frame-creation path as video-capturing, the
+		// server thread then no longer schedules frames by wall-clock
+		videoCapturing->SetAllowRecord(true);
+	}
+
+	startTime = spring_gettime();
+
+	LOG("[SimBenchmark::%s] simulating %u frames (replay=%d)", __func__, numFrames, replay);
+}
+
+void CSimBenchmark::EndFrame(int frameNum, spring_time frameStartTime, spring_time frameEndTime)
+{
+	if (!running)
+		return;
+
+	frameTimes.push_back((frameEndTime - frameStartTime).toMilliSecsf());
+
+	#ifdef SYNCCHECK
+	// the running checksum is reset every 4096 frames, fold every
+	// frame's value so the final one covers the entire benchmark
+	const unsigned int frameChecksum = CSyncChecker::GetChecksum();
+	syncChecksum = HsiehHash(&frameChecksum, sizeof(frameChecksum), syncChecksum);
+	#endif
+
+	if (frameTimes.size() < numFrames)
+		return;
+
+	Finish(frameNum);
+}
+
+
+void CSimBenchmark::Finish(int frameNum)
+{
+	running = false;
+
+	const std::string& report = GetReport(frameNum);
+	const std::string& fileName = dataDirsAccess.LocateFile("simbench.txt", FileQueryFlags::WRITE);
+
+	std::ofstream file(fileName.c_str(), std::ios::out);
+
+	if (file.is_open()) {
+		file << report;
+		LOG("[SimBenchmark::%s] wrote %s", __func__, fileName.c_str());
+	} else {
+		LOG_L(L_ERROR, "[SimBenchmark::%s] could not open %s", __func__, fileName.c_str());
+	}
+
+	LOG("[SimBenchmark::%s]\n%s", __func__, report.c_str());
+
+	if (!replay)
+		videoCapturing->SetAllowRecord(false);
+
+	gu->globalQuit = true;
+}
+
+std::string CSimBenchmark::GetReport(int frameNum)
+{
+	const float seconds = (spring_gettime() - startTime).toSecsf();
+
+	std::vector<float> sortedTimes = frameTimes;
+	std::sort(sortedTimes.begin(), sortedTimes.end());
+
+	float sumTime = 0.0f;
+
+	for (const float t: sortedTimes) {
+		sumTime += t;
+	}
+
+	std::string report;
+
+	report += spring::format("frames: %u\n", unsigned(frameTimes.size()));
+	report += spring::format("replay: %d\n", replay);
+	report += spring::format("lastFrame: %d\n", frameNum);
+	report += spring::format("seconds: %.3f\n", seconds);
+	report += spring::format("frameTimeMean: %.3f\n", sumTime / std::max(size_t(1), sortedTimes.size()));
+	report += spring::format("frameTimeP50: %.3f\n", GetPercentile(sortedTimes, 0.50f));
+	report += spring::format("frameTimeP90: %.3f\n", GetPercentile(sortedTimes, 0.90f));
+	report += spring::format("frameTimeP99: %.3f\n", GetPercentile(sortedTimes, 0.99f));
+	report += spring::format("frameTimeMax: %.3f\n", sortedTimes.empty()? 0.0f: sortedTimes.back());
+	report += spring::format("peakMemoryKB: %" PRIu64 "\n", Platform::PeakMemoryUsage());
+	#ifdef SYNCCHECK
+	report += spring::format("syncChecksum: 0x%08x\n", syncChecksum);
+	#else
+	// nothing to check desyncs against, make that explicit
+	report += "syncChecksum: none\n";
+	#endif
+
+	if (AllocCounter::IsEnabled())
+		report += AllocCounter::GetReport();
+
+	profiler.Update();
+
+	std::vector< std::pair<std::string, float> > timerTotals;
+
+	for (const auto& p: profiler.GetSortedProfiles()) {
+		const auto it = startTimerTotals.find(p.first);
+		const spring_time startTotal = (it != startTimerTotals.end())? it->second: spring_notime;
+
+		timerTotals.emplace_back(p.first, (p.second.total - startTotal).toMilliSecsf());
+	}
+
+	std::sort(timerTotals.begin(), timerTotals.end(), [](const std::pair<std::string, float>& a, const std::pair<std::string, float>& b) {
+		return (a.second > b.second || (a.second == b.second && a.first < b.first));
+	});
+
+	for (const auto& p: timerTotals) {
+		report += spring::format("timer[%s]: %.3f\n", p.first.c_str(), p.second);
+	}
+
+	return report;
+}
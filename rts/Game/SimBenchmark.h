@@ -0,0 +1,55 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SIM_BENCHMARK_H
+#define SIM_BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+#include "System/Misc/SpringTime.h"
+#include "System/UnorderedMap.hpp"
+
+/**
+ * Fast-forwards a fixed number of sim-frames (--simbench <N>) as fast as the
+ * machine allows and writes a report to simbench.txt in the write-dir once
+ * they are done, after which the engine quits. Frames are created in lockstep
+ * the same way as while video-capturing, so neither wall-clock time nor the
+ * network can change what gets simulated. When watching a replay the demo's
+ * frames are skipped through instead, as fast as they can be simulated.
+ *
+ * The report holds one "key: value" pair per line: frame-time percentiles,
+ * the peak resident memory of the process, the sync checksum folded over all
+ * benchmarked frames ("none" in builds without SYNCCHECK) and the totals of
+ * every SCOPED_TIMER accumulated while the benchmark was running (see
+ * test/benchmark).
+ */
+class CSimBenchmark {
+public:
+	void SetNumFrames(unsigned int n) { numFrames = n; }
+
+	bool IsEnabled() const { return (numFrames > 0); }
+	bool IsRunning() const { return running; }
+
+	void Start();
+	void EndFrame(int frameNum, spring_time frameStartTime, spring_time frameEndTime);
+
+private:
+	void Finish(int frameNum);
+	std::string GetReport(int frameNum);
+
+private:
+	spring::unordered_map<std::string, spring_time> startTimerTotals;
+	std::vector<float> frameTimes;
+
+	spring_time startTime;
+
+	unsigned int numFrames = 0;
+	unsigned int syncChecksum = 0;
+
+	bool running = false;
+	bool replay = false;
+};
+
+extern CSimBenchmark simBenchmark;
+
+#endif // SIM_BENCHMARK_H
@@ -16,6 +16,7 @@
 #include "Sim/Misc/GlobalConstants.h" // for GAME_SPEED
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Path/IPathManager.h"
+#include "Sim/Units/UnitHandler.h"
 #include "Sim/Units/UnitMemPool.h"
 #include "Sim/Projectiles/ProjectileHandler.h"
 #include "Sim/Projectiles/ProjectileMemPool.h"
@@ -383,8 +384,8 @@ static void DrawInfoText()
 	CVertexArray* va = GetVertexArray();
 	va->Initialize();
 		va->AddVertex0(             0.01f - 10 * globalRendering->pixelX, 0.02f - 10 * globalRendering->pixelY, 0.0f);
-		va->AddVertex0(             0.01f - 10 * globalRendering->pixelX, 0.17f + 20 * globalRendering->pixelY, 0.0f);
-		va->AddVertex0(MIN_X_COOR - 0.05f + 10 * globalRendering->pixelX, 0.17f + 20 * globalRendering->pixelY, 0.0f);
+		va->AddVertex0(             0.01f - 10 * globalRendering->pixelX, 0.19f + 20 * globalRendering->pixelY, 0.0f);
+		va->AddVertex0(MIN_X_COOR - 0.05f + 10 * globalRendering->pixelX, 0.19f + 20 * globalRendering->pixelY, 0.0f);
 		va->AddVertex0(MIN_X_COOR - 0.05f + 10 * globalRendering->pixelX, 0.02f - 10 * globalRendering->pixelY, 0.0f);
 	glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
 	va->DrawArray0(GL_QUADS);
@@ -401,6 +402,7 @@ static void DrawInfoText()
 	const char* luaFmtStr = "[7] Lua-allocated memory: %.1fMB (%.1fK allocs : %.5u usecs : %.1u states)";
 	const char* gpuFmtStr = "[8] GPU-allocated memory: %.1fMB / %.1fMB";
 	const char* sopFmtStr = "[9] SOP-allocated memory: {U,F,P,W}={%.1f/%.1f, %.1f/%.1f, %.1f/%.1f, %.1f/%.1f}KB";
+	const char* bvuFmtStr = "[10] {Rebuilt,Checked}UnitBoundingVolumes={%i, %i}";
 
 	const CProjectileHandler* ph = &projectileHandler;
 	const IPathManager* pm = pathManager;
@@ -466,6 +468,12 @@ static void DrawInfoText()
 		weaponMemPool.alloc_size() / 1024.0f,
 		weaponMemPool.freed_size() / 1024.0f
 	);
+
+	{
+		const int2 bvUpdates = unitHandler.GetNumBoundingVolumeUpdates();
+
+		font->glFormat(0.01f, 0.20f, 0.5f, DBG_FONT_FLAGS, bvuFmtStr, bvUpdates.x, bvUpdates.y);
+	}
 }
 
 
@@ -695,6 +695,223 @@ int LuaParser::DontMessWithMyCase(lua_State* L)
 }
 
 
+/******************************************************************************/
+/******************************************************************************/
+//
+//  LuaTableSnapshot
+//
+
+static bool ParseBoolean(lua_State* L, int index, bool& value);
+
+struct LuaTableSnapshot {
+	struct Value {
+		// true if the value can be read as a float3/float4 table component
+		bool IsTableFloat() const { return (number != 0.0f || IsStringLike()); }
+		// lua_isstring (numbers included)
+		bool IsStringLike() const { return (type == LuaTable::NUMBER || type == LuaTable::STRING); }
+
+		LuaTable::DataType type = LuaTable::NIL;
+
+		// conversions are all done by Lua itself when the snapshot
+		// is created, so the getters return exactly the same values
+		bool isNumber = false; // lua_isnumber (numeric strings included)
+		bool hasBool = false;
+		bool boolean = false;
+
+		int integer = 0;
+		int length = 0;
+		float number = 0.0f;
+
+		std::string string;
+		std::shared_ptr<const LuaTableSnapshot> table;
+	};
+
+	const Value* FindValue(int key) const {
+		const auto pred = [](const std::pair<int, Value>& p, int k) { return (p.first < k); };
+		const auto iter = std::lower_bound(intKeys.begin(), intKeys.end(), key, pred);
+
+		if (iter == intKeys.end() || iter->first != key)
+			return nullptr;
+
+		return &iter->second;
+	}
+	const Value* FindValue(const std::string& key) const {
+		const auto pred = [](const std::pair<std::string, Value>& p, const std::string& k) { return (p.first < k); };
+		const auto iter = std::lower_bound(strKeys.begin(), strKeys.end(), key, pred);
+
+		if (iter == strKeys.end() || iter->first != key)
+			return nullptr;
+
+		return &iter->second;
+	}
+
+	// same lookup rules as LuaTable::PushValue(const std::string&)
+	const Value* FindValuePath(const std::string& mixedKey) const {
+		const std::string key = lowerCppKeys? StringToLower(mixedKey): mixedKey;
+
+		if (key.find('.') == std::string::npos)
+			return (FindValue(key));
+
+		const LuaTableSnapshot* table = this;
+
+		size_t lastpos = 0;
+		size_t dotpos = key.find('.');
+
+		do {
+			const Value* value = table->FindValue(key.substr(lastpos, dotpos));
+
+			if (value == nullptr || value->table == nullptr)
+				return nullptr;
+
+			table = value->table.get();
+			lastpos = dotpos + 1;
+			dotpos = key.find('.', lastpos);
+		} while (dotpos != std::string::npos);
+
+		const std::string keyname = key.substr(lastpos);
+		const Value* value = table->FindValue(keyname);
+
+		if (value != nullptr)
+			return value;
+
+		bool failed;
+		const int i = StringToInt(keyname, &failed);
+
+		if (failed)
+			return nullptr;
+
+		return (table->FindValue(i));
+	}
+
+	bool GetFloat3(const Value* value, float3& f) const {
+		if (value->type == LuaTable::TABLE)
+			return (value->table != nullptr && value->table->GetTableFloats(&f.x, 3));
+		if (value->IsStringLike())
+			return (sscanf(value->string.c_str(), "%f %f %f", &f.x, &f.y, &f.z) == 3);
+
+		return false;
+	}
+	bool GetFloat4(const Value* value, float4& f) const {
+		if (value->type == LuaTable::TABLE)
+			return (value->table != nullptr && value->table->GetTableFloats(&f.x, 4));
+		if (value->IsStringLike())
+			return (sscanf(value->string.c_str(), "%f %f %f %f", &f.x, &f.y, &f.z, &f.w) == 4);
+
+		return false;
+	}
+
+	bool GetTableFloats(float* f, int n) const {
+		for (int i = 0; i < n; i++) {
+			const Value* value = FindValue(i + 1);
+
+			if (value == nullptr || !value->IsTableFloat())
+				return false;
+
+			f[i] = value->number;
+		}
+
+		return true;
+	}
+
+public:
+	// both sorted by key; numeric keys without an exact integer value are
+	// not kept since they can not be looked up through the LuaTable API
+	std::vector<std::pair<int, Value>> intKeys;
+	std::vector<std::pair<std::string, Value>> strKeys;
+
+	int length = 0;
+	bool lowerCppKeys = true;
+};
+
+
+typedef spring::unordered_map<const void*, std::shared_ptr<const LuaTableSnapshot>> LuaTableSnapshotMap;
+
+static std::shared_ptr<const LuaTableSnapshot> CreateTableSnapshot(lua_State* L, int table, bool lowerCppKeys, LuaTableSnapshotMap& tables);
+
+static void CreateValueSnapshot(lua_State* L, int index, bool lowerCppKeys, LuaTableSnapshot::Value& value, LuaTableSnapshotMap& tables)
+{
+	switch (lua_type(L, index)) {
+		case LUA_TBOOLEAN: { value.type = LuaTable::BOOLEAN; } break;
+		case LUA_TNUMBER : { value.type = LuaTable::NUMBER ; } break;
+		case LUA_TSTRING : { value.type = LuaTable::STRING ; } break;
+		case LUA_TTABLE  : { value.type = LuaTable::TABLE  ; } break;
+		default          : {                                } break;
+	}
+
+	value.isNumber = lua_isnumber(L, index);
+	value.hasBool = ParseBoolean(L, index, value.boolean);
+	value.integer = lua_toint(L, index);
+	value.number = lua_tonumber(L, index);
+
+	if (value.IsStringLike()) {
+		// convert a copy, lua_tostring would turn numbers into strings in-place
+		size_t len = 0;
+		lua_pushvalue(L, index);
+		const char* str = lua_tolstring(L, -1, &len);
+		value.string.assign(str, len);
+		value.length = lua_objlen(L, -1);
+		lua_pop(L, 1);
+		return;
+	}
+
+	if (value.type != LuaTable::TABLE)
+		return;
+
+	value.length = lua_objlen(L, index);
+	value.table = CreateTableSnapshot(L, index, lowerCppKeys, tables);
+}
+
+static std::shared_ptr<const LuaTableSnapshot> CreateTableSnapshot(lua_State* L, int table, bool lowerCppKeys, LuaTableSnapshotMap& tables)
+{
+	const void* tablePtr = lua_topointer(L, table);
+	const auto tableIter = tables.find(tablePtr);
+
+	// tables referenced more than once are shared; a (null) entry that
+	// is still being filled means this is a cycle, which gets cut here
+	if (tableIter != tables.end())
+		return tableIter->second;
+
+	tables[tablePtr] = nullptr;
+
+	if (!lua_checkstack(L, 4))
+		return nullptr;
+
+	std::shared_ptr<LuaTableSnapshot> snapshot = std::make_shared<LuaTableSnapshot>();
+
+	snapshot->length = lua_objlen(L, table);
+	snapshot->lowerCppKeys = lowerCppKeys;
+
+	for (lua_pushnil(L); lua_next(L, table) != 0; lua_pop(L, 1)) {
+		if (lua_israwstring(L, -2)) {
+			snapshot->strKeys.emplace_back(lua_tostring(L, -2), LuaTableSnapshot::Value{});
+			CreateValueSnapshot(L, lua_gettop(L), lowerCppKeys, snapshot->strKeys.back().second, tables);
+			continue;
+		}
+
+		if (!lua_israwnumber(L, -2))
+			continue;
+
+		const int intKey = lua_toint(L, -2);
+
+		if (lua_Number(intKey) != lua_tonumber(L, -2))
+			continue;
+
+		snapshot->intKeys.emplace_back(intKey, LuaTableSnapshot::Value{});
+		CreateValueSnapshot(L, lua_gettop(L), lowerCppKeys, snapshot->intKeys.back().second, tables);
+	}
+
+	{
+		using I = decltype(snapshot->intKeys)::value_type;
+		using S = decltype(snapshot->strKeys)::value_type;
+
+		std::sort(snapshot->intKeys.begin(), snapshot->intKeys.end(), [](const I& a, const I& b) { return (a.first < b.first); });
+		std::sort(snapshot->strKeys.begin(), snapshot->strKeys.end(), [](const S& a, const S& b) { return (a.first < b.first); });
+	}
+
+	return (tables[tablePtr] = snapshot);
+}
+
+
 /******************************************************************************/
 /******************************************************************************/
 //
@@ -739,6 +956,12 @@ LuaTable::LuaTable(const LuaTable& tbl)
 	L      = tbl.L;
 	path   = tbl.path;
 
+	if ((snapshot = tbl.snapshot) != nullptr) {
+		refnum  = LUA_NOREF;
+		isValid = true;
+		return;
+	}
+
 	if (parser != nullptr)
 		parser->AddTable(this);
 
@@ -775,6 +998,12 @@ LuaTable& LuaTable::operator=(const LuaTable& tbl)
 	L    = tbl.L;
 	path = tbl.path;
 
+	if ((snapshot = tbl.snapshot) != nullptr) {
+		refnum  = LUA_NOREF;
+		isValid = true;
+		return *this;
+	}
+
 	if (tbl.PushTable()) {
 		lua_pushvalue(L, -1); // copy
 		refnum = luaL_ref(L, LUA_REGISTRYINDEX);
@@ -795,6 +1024,17 @@ LuaTable LuaTable::SubTable(int key) const
 	SNPRINTF(buf, 32, "[%i]", key);
 	subTable.path = path + buf;
 
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		if (value != nullptr && value->table != nullptr) {
+			subTable.snapshot = value->table;
+			subTable.isValid = true;
+		}
+
+		return subTable;
+	}
+
 	if (!PushTable())
 		return subTable;
 
@@ -817,11 +1057,23 @@ LuaTable LuaTable::SubTable(int key) const
 
 LuaTable LuaTable::SubTable(const std::string& mixedKey) const
 {
-	const std::string key = !((parser != nullptr)? parser->lowerCppKeys : true) ? mixedKey : StringToLower(mixedKey);
+	const bool lowerKey = (snapshot != nullptr)? snapshot->lowerCppKeys: ((parser != nullptr)? parser->lowerCppKeys : true);
+	const std::string key = !lowerKey ? mixedKey : StringToLower(mixedKey);
 
 	LuaTable subTable;
 	subTable.path = path + "." + key;
 
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		if (value != nullptr && value->table != nullptr) {
+			subTable.snapshot = value->table;
+			subTable.isValid = true;
+		}
+
+		return subTable;
+	}
+
 	if (!PushTable())
 		return subTable;
 
@@ -896,6 +1148,25 @@ LuaTable::~LuaTable()
 }
 
 
+LuaTable LuaTable::Snapshot() const
+{
+	if (snapshot != nullptr)
+		return *this;
+
+	LuaTable snapshotTable;
+	snapshotTable.path = path;
+
+	if (!PushTable())
+		return snapshotTable;
+
+	LuaTableSnapshotMap tables;
+
+	snapshotTable.snapshot = CreateTableSnapshot(L, lua_gettop(L), parser->lowerCppKeys, tables);
+	snapshotTable.isValid = (snapshotTable.snapshot != nullptr);
+	return snapshotTable;
+}
+
+
 /******************************************************************************/
 
 bool LuaTable::PushTable() const
@@ -1033,6 +1304,9 @@ bool LuaTable::PushValue(const std::string& mixedKey) const
 
 bool LuaTable::KeyExists(int key) const
 {
+	if (snapshot != nullptr)
+		return (snapshot->FindValue(key) != nullptr);
+
 	if (!PushValue(key))
 		return false;
 
@@ -1043,6 +1317,9 @@ bool LuaTable::KeyExists(int key) const
 
 bool LuaTable::KeyExists(const std::string& key) const
 {
+	if (snapshot != nullptr)
+		return (snapshot->FindValuePath(key) != nullptr);
+
 	if (!PushValue(key))
 		return false;
 
@@ -1059,6 +1336,11 @@ bool LuaTable::KeyExists(const std::string& key) const
 
 LuaTable::DataType LuaTable::GetType(int key) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+		return ((value != nullptr)? value->type: NIL);
+	}
+
 	if (!PushValue(key))
 		return NIL;
 
@@ -1077,6 +1359,11 @@ LuaTable::DataType LuaTable::GetType(int key) const
 
 LuaTable::DataType LuaTable::GetType(const std::string& key) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+		return ((value != nullptr)? value->type: NIL);
+	}
+
 	if (!PushValue(key))
 		return NIL;
 
@@ -1101,6 +1388,9 @@ LuaTable::DataType LuaTable::GetType(const std::string& key) const
 
 int LuaTable::GetLength() const
 {
+	if (snapshot != nullptr)
+		return snapshot->length;
+
 	if (!PushTable())
 		return 0;
 
@@ -1110,6 +1400,11 @@ int LuaTable::GetLength() const
 
 int LuaTable::GetLength(int key) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+		return ((value != nullptr)? value->length: 0);
+	}
+
 	if (!PushValue(key))
 		return 0;
 
@@ -1121,6 +1416,11 @@ int LuaTable::GetLength(int key) const
 
 int LuaTable::GetLength(const std::string& key) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+		return ((value != nullptr)? value->length: 0);
+	}
+
 	if (!PushValue(key))
 		return 0;
 
@@ -1138,6 +1438,15 @@ int LuaTable::GetLength(const std::string& key) const
 
 bool LuaTable::GetKeys(std::vector<int>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->intKeys) {
+			data.push_back(p.first);
+		}
+
+		std::stable_sort(data.begin(), data.end());
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1155,6 +1464,15 @@ bool LuaTable::GetKeys(std::vector<int>& data) const
 
 bool LuaTable::GetKeys(std::vector<std::string>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->strKeys) {
+			data.push_back(p.first);
+		}
+
+		std::stable_sort(data.begin(), data.end());
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1173,6 +1491,18 @@ bool LuaTable::GetKeys(std::vector<std::string>& data) const
 
 bool LuaTable::GetPairs(std::vector<std::pair<int, std::string>>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->intKeys) {
+			if (p.second.IsStringLike())
+				data.emplace_back(p.first, p.second.string);
+		}
+
+		using P = typename std::remove_reference<decltype(data)>::type::value_type;
+
+		std::stable_sort(data.begin(), data.end(), [](const P& a, const P& b) { return (a.first < b.first); });
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1201,6 +1531,18 @@ bool LuaTable::GetPairs(std::vector<std::pair<int, std::string>>& data) const
 
 bool LuaTable::GetPairs(std::vector<std::pair<std::string, float>>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->strKeys) {
+			if (p.second.isNumber)
+				data.emplace_back(p.first, p.second.number);
+		}
+
+		using P = typename std::remove_reference<decltype(data)>::type::value_type;
+
+		std::stable_sort(data.begin(), data.end(), [](const P& a, const P& b) { return (a.first < b.first); });
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1222,6 +1564,24 @@ bool LuaTable::GetPairs(std::vector<std::pair<std::string, float>>& data) const
 
 bool LuaTable::GetPairs(std::vector<std::pair<std::string, std::string>>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->strKeys) {
+			if (p.second.IsStringLike()) {
+				data.emplace_back(p.first, p.second.string);
+				continue;
+			}
+			if (p.second.type == BOOLEAN) {
+				data.emplace_back(p.first, p.second.boolean ? "1" : "0");
+				continue;
+			}
+		}
+
+		using P = typename std::remove_reference<decltype(data)>::type::value_type;
+
+		std::stable_sort(data.begin(), data.end(), [](const P& a, const P& b) { return (a.first < b.first); });
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1257,6 +1617,15 @@ bool LuaTable::GetPairs(std::vector<std::pair<std::string, std::string>>& data)
 
 bool LuaTable::GetMap(spring::unordered_map<int, float>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->intKeys) {
+			if (p.second.isNumber)
+				data[p.first] = p.second.number;
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1274,6 +1643,15 @@ bool LuaTable::GetMap(spring::unordered_map<int, float>& data) const
 
 bool LuaTable::GetMap(spring::unordered_map<int, std::string>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->intKeys) {
+			if (p.second.IsStringLike())
+				data[p.first] = p.second.string;
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1298,6 +1676,15 @@ bool LuaTable::GetMap(spring::unordered_map<int, std::string>& data) const
 
 bool LuaTable::GetMap(spring::unordered_map<std::string, float>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->strKeys) {
+			if (p.second.isNumber)
+				data[p.first] = p.second.number;
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1315,6 +1702,21 @@ bool LuaTable::GetMap(spring::unordered_map<std::string, float>& data) const
 
 bool LuaTable::GetMap(spring::unordered_map<std::string, std::string>& data) const
 {
+	if (snapshot != nullptr) {
+		for (const auto& p: snapshot->strKeys) {
+			if (p.second.IsStringLike()) {
+				data[p.first] = p.second.string;
+				continue;
+			}
+			if (p.second.type == BOOLEAN) {
+				data[p.first] = p.second.boolean ? "1" : "0";
+				continue;
+			}
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1431,6 +1833,15 @@ static bool ParseBoolean(lua_State* L, int index, bool& value)
 
 int LuaTable::Get(const std::string& key, int def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+
+		if (value == nullptr || (value->integer == 0 && !value->IsStringLike()))
+			return def;
+
+		return value->integer;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1446,6 +1857,15 @@ int LuaTable::Get(const std::string& key, int def) const
 
 bool LuaTable::Get(const std::string& key, bool def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+
+		if (value == nullptr || !value->hasBool)
+			return def;
+
+		return value->boolean;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1461,6 +1881,15 @@ bool LuaTable::Get(const std::string& key, bool def) const
 
 float LuaTable::Get(const std::string& key, float def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+
+		if (value == nullptr || (value->number == 0.0f && !value->IsStringLike()))
+			return def;
+
+		return value->number;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1477,6 +1906,16 @@ float LuaTable::Get(const std::string& key, float def) const
 
 float3 LuaTable::Get(const std::string& key, const float3& def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+
+		float3 ret;
+		if (value == nullptr || !snapshot->GetFloat3(value, ret))
+			return def;
+
+		return ret;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1491,6 +1930,16 @@ float3 LuaTable::Get(const std::string& key, const float3& def) const
 
 float4 LuaTable::Get(const std::string& key, const float4& def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+
+		float4 ret;
+		if (value == nullptr || !snapshot->GetFloat4(value, ret))
+			return def;
+
+		return ret;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1507,6 +1956,15 @@ float4 LuaTable::Get(const std::string& key, const float4& def) const
 
 std::string LuaTable::Get(const std::string& key, const std::string& def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValuePath(key);
+
+		if (value == nullptr || !value->IsStringLike())
+			return def;
+
+		return value->string;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1528,6 +1986,15 @@ std::string LuaTable::Get(const std::string& key, const std::string& def) const
 
 int LuaTable::Get(int key, int def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		if (value == nullptr || (value->integer == 0 && !value->IsStringLike()))
+			return def;
+
+		return value->integer;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1543,6 +2010,15 @@ int LuaTable::Get(int key, int def) const
 
 bool LuaTable::Get(int key, bool def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		if (value == nullptr || !value->hasBool)
+			return def;
+
+		return value->boolean;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1558,6 +2034,15 @@ bool LuaTable::Get(int key, bool def) const
 
 float LuaTable::Get(int key, float def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		if (value == nullptr || (value->number == 0.0f && !value->IsStringLike()))
+			return def;
+
+		return value->number;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1574,6 +2059,16 @@ float LuaTable::Get(int key, float def) const
 
 float3 LuaTable::Get(int key, const float3& def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		float3 ret;
+		if (value == nullptr || !snapshot->GetFloat3(value, ret))
+			return def;
+
+		return ret;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -1588,6 +2083,16 @@ float3 LuaTable::Get(int key, const float3& def) const
 
 float4 LuaTable::Get(int key, const float4& def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		float4 ret;
+		if (value == nullptr || !snapshot->GetFloat4(value, ret))
+			return def;
+
+		return ret;
+	}
+
 	if (!PushValue(key)) {
 		return def;
 	}
@@ -1604,6 +2109,15 @@ float4 LuaTable::Get(int key, const float4& def) const
 
 std::string LuaTable::Get(int key, const std::string& def) const
 {
+	if (snapshot != nullptr) {
+		const LuaTableSnapshot::Value* value = snapshot->FindValue(key);
+
+		if (value == nullptr || !value->IsStringLike())
+			return def;
+
+		return value->string;
+	}
+
 	if (!PushValue(key))
 		return def;
 
@@ -3,6 +3,7 @@
 #ifndef LUA_PARSER_H
 #define LUA_PARSER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,7 @@ class float3;
 struct float4;
 class LuaTable;
 class LuaParser;
+struct LuaTableSnapshot;
 struct lua_State;
 
 
@@ -33,7 +35,13 @@ public:
 	LuaTable SubTable(const std::string& key) const;
 	LuaTable SubTableExpr(const std::string& expr) const;
 
-	bool IsValid() const { return (parser != nullptr); }
+	// returns a deep immutable copy of this table which no longer touches
+	// the parser's lua_State, so it can be read from any thread and outlive
+	// the parser (all getters behave as they do on the original)
+	LuaTable Snapshot() const;
+
+	bool IsValid() const { return (parser != nullptr || snapshot != nullptr); }
+	bool IsSnapshot() const { return (snapshot != nullptr); }
 
 	const std::string& GetPath() const { return path; }
 
@@ -112,6 +120,9 @@ private:
 	LuaParser* parser;
 	lua_State* L;
 	int refnum;
+
+	// non-null iff this table was created by Snapshot()
+	std::shared_ptr<const LuaTableSnapshot> snapshot;
 };
 
 
@@ -626,6 +626,8 @@ static int SetSolidObjectPieceCollisionVolumeData(lua_State* L, CSolidObject* ob
 	// piece volumes are not allowed to use discrete hit-testing
 	vol->InitShape(scales, offset, vType, CollisionVolume::COLVOL_HITTEST_CONT, pAxis);
 	vol->SetIgnoreHits(!luaL_checkboolean(L, 3));
+
+	obj->localModel.SetPieceBVHDirty();
 	return 0;
 }
 
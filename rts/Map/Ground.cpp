@@ -2,6 +2,7 @@
 
 
 #include "Ground.h"
+#include "HeightBoundsPyramid.h"
 #include "ReadMap.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
@@ -208,10 +209,148 @@ inline static bool ClampInMapHeight(float3& from, float3& to)
 }
 
 
+// tracks the largest pyramid block of heightmap squares that a ray is known
+// to pass above, so LineGroundColRaw can step its DDA straight to the first
+// square past that block (the squares it lands on are exactly those a full
+// trace would visit next, so the result stays identical to a full trace)
+//
+// the test is conservative: LineGroundSquareCol can only report a hit inside
+// a square where the line dips below the square's highest corner, blocks are
+// widened and raised by a margin to absorb rounding on either side
+class GroundRayBlockSkipper {
+public:
+	GroundRayBlockSkipper(const CHeightBoundsPyramid* hbp, const float3& from, const float3& to)
+		: pyramid(hbp)
+		, rayPos(from)
+		, rayDir(to - from)
+	{
+		if (pyramid == nullptr || pyramid->Empty())
+			return;
+
+		numLevels = pyramid->GetNumLevels();
+		baseSize = pyramid->GetLevelSize(0);
+
+		invDir.x = (rayDir.x != 0.0f)? (1.0f / rayDir.x): 0.0f;
+		invDir.y = (rayDir.z != 0.0f)? (1.0f / rayDir.z): 0.0f;
+	}
+
+	bool Skip(int sx, int sz) {
+		if (numLevels <= MIN_SKIP_LEVEL)
+			return false;
+		if (sx < 0 || sz < 0 || sx >= baseSize.x || sz >= baseSize.y)
+			return false;
+
+		if (InBlock(skipBlock, sx, sz))
+			return true;
+		if (InBlock(failBlock, sx, sz))
+			return false;
+
+		// if the ray can touch a block, it can also touch every block
+		// enclosing it, so search upward from the smallest level only
+		// as long as the test keeps passing
+		int level = MIN_SKIP_LEVEL;
+
+		if (!RayAboveBlock(level, sx >> level, sz >> level)) {
+			SetBlock(failBlock, level, sx, sz);
+			return false;
+		}
+
+		while ((level + 1) < numLevels && RayAboveBlock(level + 1, sx >> (level + 1), sz >> (level + 1))) {
+			level += 1;
+		}
+
+		SetBlock(skipBlock, level, sx, sz);
+		return true;
+	}
+
+public:
+	struct SquareBlock {
+		// inclusive square-bounds
+		int2 mins = {-1, -1};
+		int2 maxs = {-2, -2};
+	};
+
+	// block found by the last successful Skip call
+	const SquareBlock& GetSkipBlock() const { return skipBlock; }
+
+	static bool InBlock(const SquareBlock& b, int sx, int sz) {
+		return (sx >= b.mins.x && sx <= b.maxs.x && sz >= b.mins.y && sz <= b.maxs.y);
+	}
+
+private:
+	static void SetBlock(SquareBlock& b, int level, int sx, int sz) {
+		b.mins.x = (sx >> level) << level;
+		b.mins.y = (sz >> level) << level;
+		b.maxs.x = b.mins.x + (1 << level) - 1;
+		b.maxs.y = b.mins.y + (1 << level) - 1;
+	}
+
+	bool RayAboveBlock(int level, int bx, int bz) const {
+		const float x1 = ((bx    ) << level) * SQUARE_SIZE - BLOCK_XZ_MARGIN;
+		const float x2 = ((bx + 1) << level) * SQUARE_SIZE + BLOCK_XZ_MARGIN;
+		const float z1 = ((bz    ) << level) * SQUARE_SIZE - BLOCK_XZ_MARGIN;
+		const float z2 = ((bz + 1) << level) * SQUARE_SIZE + BLOCK_XZ_MARGIN;
+
+		// parametric interval (along the infinite line, squares at the
+		// ends of the DDA can extend past <from> or <to>) over the block
+		float tmin = -std::numeric_limits<float>::max();
+		float tmax =  std::numeric_limits<float>::max();
+
+		if (rayDir.x != 0.0f) {
+			const float t1 = (x1 - rayPos.x) * invDir.x;
+			const float t2 = (x2 - rayPos.x) * invDir.x;
+
+			tmin = std::max(tmin, std::min(t1, t2));
+			tmax = std::min(tmax, std::max(t1, t2));
+		} else if (rayPos.x < x1 || rayPos.x > x2) {
+			return false;
+		}
+
+		if (rayDir.z != 0.0f) {
+			const float t1 = (z1 - rayPos.z) * invDir.y;
+			const float t2 = (z2 - rayPos.z) * invDir.y;
+
+			tmin = std::max(tmin, std::min(t1, t2));
+			tmax = std::min(tmax, std::max(t1, t2));
+		} else if (rayPos.z < z1 || rayPos.z > z2) {
+			return false;
+		}
+
+		if (tmin > tmax)
+			return false;
+
+		const float minRayHeight = std::min(rayPos.y + rayDir.y * tmin, rayPos.y + rayDir.y * tmax);
+		const float maxHgtHeight = pyramid->GetMaxHeight(level, bx, bz);
+
+		return (minRayHeight > (maxHgtHeight + BLOCK_Y_MARGIN));
+	}
+
+private:
+	// smallest block worth a pyramid lookup (4x4 squares)
+	static constexpr int MIN_SKIP_LEVEL = 2;
+
+	static constexpr float BLOCK_XZ_MARGIN = 1.0f;
+	static constexpr float BLOCK_Y_MARGIN = 1.0f;
+
+	const CHeightBoundsPyramid* pyramid;
+
+	float3 rayPos;
+	float3 rayDir;
+	float2 invDir;
+
+	int2 baseSize;
+	int numLevels = 0;
+
+	SquareBlock skipBlock;
+	SquareBlock failBlock;
+};
+
+
 float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 {
 	const float* hm  = readMap->GetSharedCornerHeightMap(synced);
 	const float3* nm = readMap->GetSharedFaceNormals(synced);
+	const CHeightBoundsPyramid* hbp = readMap->GetSharedHeightBounds(synced);
 
 	const float3 pfrom = from;
 
@@ -244,6 +383,23 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 			return 0.0f + skippedDist;
 	}
 
+	const float dist = LineGroundColRaw(hm, nm, hbp, from, to);
+
+	if (dist >= 0.0f)
+		return (dist + skippedDist);
+
+	return -1.0f;
+}
+
+float CGround::LineGroundColRaw(
+	const float* hm,
+	const float3* nm,
+	const CHeightBoundsPyramid* hbp,
+	const float3& from,
+	const float3& to
+) {
+	GroundRayBlockSkipper skipper(hbp, from, to);
+
 	const float dx = to.x - from.x;
 	const float dz = to.z - from.z;
 	const int dirx = (dx > 0.0f) ? 1 : -1;
@@ -266,7 +422,7 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		const float ret = LineGroundSquareCol(hm, nm,  from, to,  fsx, fsz);
 
 		if (ret >= 0.0f)
-			return (ret + skippedDist);
+			return ret;
 
 		return -1.0f;
 	}
@@ -276,10 +432,26 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		int zp = fsz;
 
 		for (unsigned int i = 0, n = Square(mapDims.mapyp1); (Square(i) <= n && zp != tsz); i++) {
+			if (skipper.Skip(fsx, zp)) {
+				const GroundRayBlockSkipper::SquareBlock& block = skipper.GetSkipBlock();
+
+				// continue past the block unless the ray ends inside it
+				const int zpn = ((dirz > 0)? block.maxs.y: block.mins.y) + dirz;
+
+				if ((zpn - tsz) * dirz > 0)
+					return -1.0f;
+
+				// count the skipped squares against the step budget, a full
+				// trace would also give up if it ran out while inside a block
+				i += ((zpn - zp) * dirz - 1);
+				zp = zpn;
+				continue;
+			}
+
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  fsx, zp);
 
 			if (ret >= 0.0f)
-				return (ret + skippedDist);
+				return ret;
 
 			zp += dirz;
 		}
@@ -292,10 +464,23 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		int xp = fsx;
 
 		for (unsigned int i = 0, n = Square(mapDims.mapxp1); (Square(i) <= n && xp != tsx); i++) {
+			if (skipper.Skip(xp, fsz)) {
+				const GroundRayBlockSkipper::SquareBlock& block = skipper.GetSkipBlock();
+
+				const int xpn = ((dirx > 0)? block.maxs.x: block.mins.x) + dirx;
+
+				if ((xpn - tsx) * dirx > 0)
+					return -1.0f;
+
+				i += ((xpn - xp) * dirx - 1);
+				xp = xpn;
+				continue;
+			}
+
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  xp, fsz);
 
 			if (ret >= 0.0f)
-				return (ret + skippedDist);
+				return ret;
 
 			xp += dirx;
 		}
@@ -328,12 +513,94 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		int curx = fsx;
 		int curz = fsz;
 
+		// `normalized position` at which the ray crosses into column <nextx>
+		// or row <nextz>, 1337 for those past the end (see below); the block
+		// skip uses the same expressions so its exits match the DDA exactly
+		const auto EdgePosX = [&](int nextx) { return (((nextx - tsx) * dirx > 0)? 1337.0f: ((nextx + testposx - ffsx) * rdsx)); };
+		const auto EdgePosZ = [&](int nextz) { return (((nextz - tsz) * dirz > 0)? 1337.0f: ((nextz + testposz - ffsz) * rdsz)); };
+
+		// finds the first square past <block> the DDA would visit from <curx,
+		// curz>, unless that happens (within precision) beyond the ray's end
+		const auto ExitBlock = [&](const GroundRayBlockSkipper::SquareBlock& block, int2& exitSquare) {
+			const int bx = (dirx > 0)? block.maxs.x: block.mins.x;
+			const int bz = (dirz > 0)? block.maxs.y: block.mins.y;
+
+			const float bxn = EdgePosX(bx + dirx);
+			const float bzn = EdgePosZ(bz + dirz);
+
+			if (bxn >= 1.0f && bzn >= 1.0f)
+				return false;
+
+			// the DDA crosses a column-edge iff xn < zn and a row-edge iff zn <= xn,
+			// so it leaves through the x-side on the last row whose edge lies past
+			// bxn (or through the z-side on the last column whose edge is >= bzn)
+			if (bxn < bzn) {
+				int lo = curz;
+				int hi = bz;
+
+				while (lo != hi) {
+					const int mid = lo + ((hi - lo) * dirz / 2) * dirz;
+
+					if (EdgePosZ(mid + dirz) > bxn) {
+						hi = mid;
+					} else {
+						lo = mid + dirz;
+					}
+				}
+
+				exitSquare = {bx + dirx, lo};
+			} else {
+				int lo = curx;
+				int hi = bx;
+
+				while (lo != hi) {
+					const int mid = lo + ((hi - lo) * dirx / 2) * dirx;
+
+					if (EdgePosX(mid + dirx) >= bzn) {
+						hi = mid;
+					} else {
+						lo = mid + dirx;
+					}
+				}
+
+				exitSquare = {lo, bz + dirz};
+			}
+
+			return true;
+		};
+
 		for (unsigned int i = 0, n = Square(mapDims.mapxp1) + Square(mapDims.mapyp1); !stopTrace; i++) {
-			// test for collision with the ground-square triangles
-			const float ret = LineGroundSquareCol(hm, nm,  from, to,  curx, curz);
+			// test for collision with the ground-square triangles, unless the
+			// ray is known to pass above a whole block containing this square
+			if (skipper.Skip(curx, curz)) {
+				const GroundRayBlockSkipper::SquareBlock& block = skipper.GetSkipBlock();
+
+				// a monotone walk can not leave the block and come back
+				if (GroundRayBlockSkipper::InBlock(block, tsx, tsz))
+					return -1.0f;
+
+				int2 exitSquare;
+
+				if (ExitBlock(block, exitSquare)) {
+					// squares inside the block only ever advance one axis per step
+					const unsigned int numSteps = std::abs(exitSquare.x - curx) + std::abs(exitSquare.y - curz);
+
+					// a full trace gives up once its step budget runs out,
+					// even while inside the block
+					if (Square(i + numSteps - 1) > n)
+						return -1.0f;
+
+					curx = exitSquare.x;
+					curz = exitSquare.y;
+					i += (numSteps - 1);
+					continue;
+				}
+			} else {
+				const float ret = LineGroundSquareCol(hm, nm,  from, to,  curx, curz);
 
-			if (ret >= 0.0f)
-				return (ret + skippedDist);
+				if (ret >= 0.0f)
+					return ret;
+			}
 
 			// check if we reached the end already and need to stop the loop
 			const bool endReached = ((curx == tsx && curz == tsz) || (Square(i) > n));
@@ -347,16 +614,16 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 			// dir; i.e. x = from.x + n * (to.x - from.x) where 0 <= n <= 1
 			int nextx = curx + dirx;
 			int nextz = curz + dirz;
-			float xn = (nextx + testposx - ffsx) * rdsx;
-			float zn = (nextz + testposz - ffsz) * rdsz;
+			const float xn = EdgePosX(nextx);
+			const float zn = EdgePosZ(nextz);
 
 			// handle the following 2 cases:
 			//   1: (floor(to.x) == to.x) && (to.x < from.x)
 			//     here xn = to.x but curx = to.x - 1 so
 			//     we would be beyond the end of the ray
 			//   2: floating point precision issues
-			if ((nextx - tsx) * dirx > 0) { xn = 1337.0f; nextx = tsx; }
-			if ((nextz - tsz) * dirz > 0) { zn = 1337.0f; nextz = tsz; }
+			if ((nextx - tsx) * dirx > 0) { nextx = tsx; }
+			if ((nextz - tsz) * dirz > 0) { nextz = tsz; }
 
 			// advance to the next nearest edge in either x or z dir, or in the case we reached the end make sure
 			// we set it to the exact square positions (floating point precision sometimes hinders us to hit it)
@@ -377,6 +644,7 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 	return -1.0f;
 }
 
+
 float CGround::LineGroundCol(const float3 pos, const float3 dir, float len, bool synced)
 {
 	return (LineGroundCol(pos, pos + dir * std::max(len, 0.0f), synced));
@@ -530,6 +798,208 @@ float3 CGround::GetSmoothNormal(float x, float z, bool synced)
 
 
 
+// brackets the samples of a ballistic trajectory (parameterized by the xz
+// distance <d> travelled along <dir>) against the pyramid: for the largest
+// block around a sample whose highest corner the parabola stays above over
+// the whole <d>-interval spent inside it, all samples up to the end of that
+// interval are skipped, the rest are refined by the regular height tests
+//
+// block extents are shrunk by a margin (and those touching the map border
+// extended to infinity, since out-of-map samples clamp to the border) so a
+// skipped sample can only lie on a square inside the block
+class GroundTrajectoryBlockSkipper {
+public:
+	GroundTrajectoryBlockSkipper(
+		const CHeightBoundsPyramid* hbp,
+		const float3& pos,
+		const float3& dir,
+		float qdrCoeff,
+		float minDist,
+		float maxDist
+	)
+		: pyramid(hbp)
+		, trajPos(pos)
+		, trajDir(dir)
+		, trajQdr(qdrCoeff)
+		, distRange(minDist, maxDist)
+	{
+		if (pyramid == nullptr || pyramid->Empty())
+			return;
+
+		numLevels = pyramid->GetNumLevels();
+		baseSize = pyramid->GetLevelSize(0);
+
+		invDir.x = (trajDir.x != 0.0f)? (1.0f / trajDir.x): 0.0f;
+		invDir.y = (trajDir.z != 0.0f)? (1.0f / trajDir.z): 0.0f;
+	}
+
+	bool Skipping(float dist) const { return (dist <= skipEnd); }
+
+	bool Skip(float dist, float height, int sx, int sz) {
+		if (dist <= failEnd)
+			return false;
+		if (numLevels <= MIN_SKIP_LEVEL)
+			return false;
+
+		float2 range;
+		int level = MIN_SKIP_LEVEL;
+
+		if (!TrajAboveBlock(level, sx >> level, sz >> level, dist, height, range)) {
+			failEnd = range.y;
+			return false;
+		}
+
+		for (skipEnd = range.y; (level + 1) < numLevels; level++) {
+			if (!TrajAboveBlock(level + 1, sx >> (level + 1), sz >> (level + 1), dist, height, range))
+				break;
+
+			skipEnd = range.y;
+		}
+
+		return true;
+	}
+
+private:
+	// <range> receives the interval of distances from <dist> onward spent inside the block
+	bool TrajAboveBlock(int level, int bx, int bz, float dist, float height, float2& range) const {
+		const float maxBlockHeight = pyramid->GetMaxHeight(level, bx, bz) + BLOCK_Y_MARGIN;
+
+		range = {dist, dist};
+
+		// cheap early-out, the sample itself has to clear the block
+		if (height <= maxBlockHeight)
+			return false;
+
+		const int sx1 = (bx    ) << level;
+		const int sx2 = (bx + 1) << level;
+		const int sz1 = (bz    ) << level;
+		const int sz2 = (bz + 1) << level;
+
+		const float x1 = (sx1 <= 0         )? -std::numeric_limits<float>::max(): (sx1 * SQUARE_SIZE + BLOCK_XZ_MARGIN);
+		const float x2 = (sx2 >= baseSize.x)?  std::numeric_limits<float>::max(): (sx2 * SQUARE_SIZE - BLOCK_XZ_MARGIN);
+		const float z1 = (sz1 <= 0         )? -std::numeric_limits<float>::max(): (sz1 * SQUARE_SIZE + BLOCK_XZ_MARGIN);
+		const float z2 = (sz2 >= baseSize.y)?  std::numeric_limits<float>::max(): (sz2 * SQUARE_SIZE - BLOCK_XZ_MARGIN);
+
+		range = distRange;
+
+		if (trajDir.x != 0.0f) {
+			const float t1 = (x1 - trajPos.x) * invDir.x;
+			const float t2 = (x2 - trajPos.x) * invDir.x;
+
+			range.x = std::max(range.x, std::min(t1, t2));
+			range.y = std::min(range.y, std::max(t1, t2));
+		} else if (trajPos.x < x1 || trajPos.x > x2) {
+			range.y = range.x;
+			return false;
+		}
+
+		if (trajDir.z != 0.0f) {
+			const float t1 = (z1 - trajPos.z) * invDir.y;
+			const float t2 = (z2 - trajPos.z) * invDir.y;
+
+			range.x = std::max(range.x, std::min(t1, t2));
+			range.y = std::min(range.y, std::max(t1, t2));
+		} else if (trajPos.z < z1 || trajPos.z > z2) {
+			range.y = range.x;
+			return false;
+		}
+
+		// the sample itself must be covered, or its neighbors are not
+		if (dist < range.x || dist > range.y)
+			return false;
+
+		// only the remaining samples matter
+		range.x = dist;
+
+		float minTrajHeight = std::min(TrajHeight(range.x), TrajHeight(range.y));
+
+		// convex (upward-accelerated) trajectory, lowest point can be inside
+		if (trajQdr > 0.0f) {
+			const float vertDist = -trajDir.y / (2.0f * trajQdr);
+
+			if (vertDist > range.x && vertDist < range.y)
+				minTrajHeight = std::min(minTrajHeight, TrajHeight(vertDist));
+		}
+
+		return (minTrajHeight > maxBlockHeight);
+	}
+
+	float TrajHeight(float dist) const { return (trajPos.y + (trajDir.y + trajQdr * dist) * dist); }
+
+private:
+	static constexpr int MIN_SKIP_LEVEL = 2;
+
+	static constexpr float BLOCK_XZ_MARGIN = 1.0f;
+	static constexpr float BLOCK_Y_MARGIN = 1.0f;
+
+	const CHeightBoundsPyramid* pyramid;
+
+	float3 trajPos;
+	float3 trajDir;
+	float trajQdr;
+
+	float2 distRange;
+	float2 invDir;
+
+	int2 baseSize;
+	int numLevels = 0;
+
+	float skipEnd = -std::numeric_limits<float>::max();
+	float failEnd = -std::numeric_limits<float>::max();
+};
+
+
+// remembers the largest pyramid block the last tested position was above,
+// positions inside it and (still) above its highest corner can not be under
+// the interpolated ground
+class GroundPointBlockSkipper {
+public:
+	GroundPointBlockSkipper(const CHeightBoundsPyramid* hbp): pyramid(hbp) {
+		if (pyramid == nullptr || pyramid->Empty())
+			return;
+
+		numLevels = pyramid->GetNumLevels();
+	}
+
+	bool Skip(const float3& pos) {
+		if (numLevels == 0)
+			return false;
+
+		// same square InterpolateCornerHeight reads from
+		const int sx = Clamp(pos.x, 0.0f, float3::maxxpos) / SQUARE_SIZE;
+		const int sz = Clamp(pos.z, 0.0f, float3::maxzpos) / SQUARE_SIZE;
+
+		if ((sx >> blockLevel) == blockPos.x && (sz >> blockLevel) == blockPos.y && pos.y > blockMaxHeight)
+			return true;
+
+		int level = -1;
+
+		while ((level + 1) < numLevels && pos.y > (pyramid->GetMaxHeight(level + 1, sx >> (level + 1), sz >> (level + 1)) + BLOCK_Y_MARGIN)) {
+			level += 1;
+		}
+
+		if (level < 0)
+			return false;
+
+		blockLevel = level;
+		blockPos = {sx >> level, sz >> level};
+		blockMaxHeight = pyramid->GetMaxHeight(level, blockPos.x, blockPos.y) + BLOCK_Y_MARGIN;
+		return true;
+	}
+
+private:
+	static constexpr float BLOCK_Y_MARGIN = 1.0f;
+
+	const CHeightBoundsPyramid* pyramid;
+
+	int numLevels = 0;
+	int blockLevel = 0;
+
+	int2 blockPos = {-1, -1};
+	float blockMaxHeight = std::numeric_limits<float>::max();
+};
+
+
 float CGround::SimTrajectoryGroundColDist(const float3& trajStartPos, const float3& trajStartDir, const float3& acc, const float2& args)
 {
 	// args.x := speed, args.y := length
@@ -545,6 +1015,8 @@ float CGround::SimTrajectoryGroundColDist(const float3& trajStartPos, const floa
 	float3 pos = trajStartPos;
 	float3 vel = trajStartDir * args.x;
 
+	GroundPointBlockSkipper skipper(readMap->GetSharedHeightBounds(true));
+
 	// sample heights along the trajectory of a virtual projectile launched
 	// from <pos> with velocity <trajStartDir * speed>; <pos> is assumed to
 	// start inside map
@@ -552,7 +1024,7 @@ float CGround::SimTrajectoryGroundColDist(const float3& trajStartPos, const floa
 		vel += acc;
 		pos += vel;
 	}
-	while (pos.y >= GetHeightReal(pos)) {
+	while (skipper.Skip(pos) || pos.y >= GetHeightReal(pos)) {
 		vel += acc;
 		pos += vel;
 	}
@@ -567,7 +1039,6 @@ float CGround::TrajectoryGroundCol(const float3& trajStartPos, const float3& tra
 {
 	// trajTargetDir should be the normalized xz-vector from <trajStartPos> to the target
 	const float3 dir = {trajTargetDir.x, linCoeff, trajTargetDir.z};
-	const float3 alt = UpVector * qdrCoeff;
 
 	// limit checking to the in-map part of the line
 	const float2 ips = GetMapBoundaryIntersectionPoints(trajStartPos, dir * length);
@@ -579,16 +1050,40 @@ float CGround::TrajectoryGroundCol(const float3& trajStartPos, const float3& tra
 	const float minDist = length * std::max(0.0f, ips.x);
 	const float maxDist = length * std::min(1.0f, ips.y);
 
+	return (TrajectoryGroundColRaw(readMap->GetSharedCenterHeightMap(true), readMap->GetSharedHeightBounds(true), trajStartPos, trajTargetDir, linCoeff, qdrCoeff, minDist, maxDist));
+}
+
+float CGround::TrajectoryGroundColRaw(
+	const float* chm,
+	const CHeightBoundsPyramid* hbp,
+	const float3& trajStartPos,
+	const float3& trajTargetDir,
+	float linCoeff,
+	float qdrCoeff,
+	float minDist,
+	float maxDist
+) {
+	const float3 dir = {trajTargetDir.x, linCoeff, trajTargetDir.z};
+	const float3 alt = UpVector * qdrCoeff;
+
+	GroundTrajectoryBlockSkipper skipper(hbp, trajStartPos, dir, qdrCoeff, minDist, maxDist);
+
+	// samples stay at the same (accumulated) distances as without skipping
 	for (float dist = minDist; dist < maxDist; dist += SQUARE_SIZE) {
+		if (skipper.Skipping(dist))
+			continue;
+
 		const float3 pos = (trajStartPos + dir * dist) + (alt * dist * dist);
 
-		#if 1
-		if (GetApproximateHeight(pos) > pos.y)
-			return dist;
-		#else
-		if (GetHeightReal(pos) > pos.y)
+		// same square as GetApproximateHeight
+		const int xsquare = Clamp(int(pos.x) / SQUARE_SIZE, 0, mapDims.mapxm1);
+		const int zsquare = Clamp(int(pos.z) / SQUARE_SIZE, 0, mapDims.mapym1);
+
+		if (skipper.Skip(dist, pos.y, xsquare, zsquare))
+			continue;
+
+		if (chm[zsquare * mapDims.mapx + xsquare] > pos.y)
 			return dist;
-		#endif
 	}
 
 	return -1.0f;
@@ -6,6 +6,7 @@
 #include "System/float3.h"
 #include "System/type2.h"
 
+class CHeightBoundsPyramid;
 
 class CGround
 {
@@ -37,10 +38,15 @@ public:
 
 	static float LineGroundCol(float3 from, float3 to, bool synced = true);
 	static float LineGroundCol(const float3 pos, const float3 dir, float len, bool synced = true);
+	/// core of LineGroundCol on explicit heightmap data; <from> must already be clamped into the map
+	/// (the height-bounds pyramid is optional and only used to skip squares the ray passes above)
+	static float LineGroundColRaw(const float* hm, const float3* nm, const CHeightBoundsPyramid* hbp, const float3& from, const float3& to);
 	static float LinePlaneCol(const float3 pos, const float3 dir, float len, float hgt);
 	static float LineGroundWaterCol(const float3 pos, const float3 dir, float len, bool testWater, bool synced = true);
 
 	static float TrajectoryGroundCol(const float3& trajStartPos, const float3& trajTargetDir, float length, float linCoeff, float qdrCoeff);
+	/// core of TrajectoryGroundCol on an explicit center-heightmap, sampling distances [minDist, maxDist)
+	static float TrajectoryGroundColRaw(const float* chm, const CHeightBoundsPyramid* hbp, const float3& trajStartPos, const float3& trajTargetDir, float linCoeff, float qdrCoeff, float minDist, float maxDist);
 	static float SimTrajectoryGroundColDist(const float3& startPos, const float3& trajStartDir, const float3& acc, const float2& args);
 
 	static int GetSquare(const float3& pos);
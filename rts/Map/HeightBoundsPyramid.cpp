@@ -0,0 +1,110 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "HeightBoundsPyramid.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+void CHeightBoundsPyramid::Init(const float* cornerHeightMap, int sizex, int sizez)
+{
+	assert(sizex > 0 && sizez > 0);
+
+	levels.clear();
+	levels.reserve(16);
+
+	int2 size = {sizex, sizez};
+
+	while (true) {
+		levels.emplace_back();
+		levels.back().size = size;
+		levels.back().bounds.resize(size.x * size.y);
+
+		if (size.x == 1 && size.y == 1)
+			break;
+
+		size.x = (size.x + 1) >> 1;
+		size.y = (size.y + 1) >> 1;
+	}
+
+	Update(cornerHeightMap, 0, 0, sizex, sizez);
+}
+
+void CHeightBoundsPyramid::Kill()
+{
+	levels.clear();
+}
+
+
+void CHeightBoundsPyramid::Update(const float* cornerHeightMap, int x1, int z1, int x2, int z2)
+{
+	if (levels.empty())
+		return;
+
+	const int2& size = levels[0].size;
+
+	// a corner is shared by up to four squares
+	x1 = std::max(x1 - 1,          0);
+	z1 = std::max(z1 - 1,          0);
+	x2 = std::min(x2    , size.x - 1);
+	z2 = std::min(z2    , size.y - 1);
+
+	if (x1 > x2 || z1 > z2)
+		return;
+
+	UpdateBaseLevel(cornerHeightMap, x1, z1, x2, z2);
+
+	for (int level = 1, n = levels.size(); level < n; level++) {
+		x1 >>= 1; x2 >>= 1;
+		z1 >>= 1; z2 >>= 1;
+
+		UpdateLevel(level, x1, z1, x2, z2);
+	}
+}
+
+void CHeightBoundsPyramid::UpdateBaseLevel(const float* cornerHeightMap, int x1, int z1, int x2, int z2)
+{
+	Level& base = levels[0];
+
+	const int stride = base.size.x + 1;
+
+	for (int z = z1; z <= z2; z++) {
+		for (int x = x1; x <= x2; x++) {
+			const float hTL = cornerHeightMap[(z    ) * stride + (x    )];
+			const float hTR = cornerHeightMap[(z    ) * stride + (x + 1)];
+			const float hBL = cornerHeightMap[(z + 1) * stride + (x    )];
+			const float hBR = cornerHeightMap[(z + 1) * stride + (x + 1)];
+
+			float2& b = base.bounds[z * base.size.x + x];
+
+			b.x = std::min(std::min(hTL, hTR), std::min(hBL, hBR));
+			b.y = std::max(std::max(hTL, hTR), std::max(hBL, hBR));
+		}
+	}
+}
+
+void CHeightBoundsPyramid::UpdateLevel(int level, int x1, int z1, int x2, int z2)
+{
+	const Level& src = levels[level - 1];
+	      Level& dst = levels[level    ];
+
+	for (int z = z1; z <= z2; z++) {
+		const int sz0 = z * 2;
+		const int sz1 = std::min(sz0 + 1, src.size.y - 1);
+
+		for (int x = x1; x <= x2; x++) {
+			const int sx0 = x * 2;
+			const int sx1 = std::min(sx0 + 1, src.size.x - 1);
+
+			const float2& b00 = src.bounds[sz0 * src.size.x + sx0];
+			const float2& b10 = src.bounds[sz0 * src.size.x + sx1];
+			const float2& b01 = src.bounds[sz1 * src.size.x + sx0];
+			const float2& b11 = src.bounds[sz1 * src.size.x + sx1];
+
+			float2& b = dst.bounds[z * dst.size.x + x];
+
+			b.x = std::min(std::min(b00.x, b10.x), std::min(b01.x, b11.x));
+			b.y = std::max(std::max(b00.y, b10.y), std::max(b01.y, b11.y));
+		}
+	}
+}
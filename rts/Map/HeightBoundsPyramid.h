@@ -0,0 +1,55 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef HEIGHT_BOUNDS_PYRAMID_H
+#define HEIGHT_BOUNDS_PYRAMID_H
+
+#include <vector>
+
+#include "System/type2.h"
+
+
+/**
+ * Min/max height mip-pyramid over a corner-heightmap.
+ *
+ * Level 0 holds the bounds of the four corners of every heightmap square,
+ * each following level the bounds of 2x2 blocks of the level below (with
+ * odd dimensions rounded up). Ray- and trajectory-ground tests use it to
+ * skip blocks of squares the query can provably not touch.
+ */
+class CHeightBoundsPyramid
+{
+public:
+	/// (re)builds all levels from a (sizex + 1) * (sizez + 1) corner-heightmap
+	void Init(const float* cornerHeightMap, int sizex, int sizez);
+	/// refreshes all blocks touching corners [x1, x2] * [z1, z2] (inclusive)
+	void Update(const float* cornerHeightMap, int x1, int z1, int x2, int z2);
+	void Kill();
+
+	bool Empty() const { return levels.empty(); }
+
+	int GetNumLevels() const { return (levels.size()); }
+	int2 GetLevelSize(int level) const { return levels[level].size; }
+
+	/// x := minimum height, y := maximum height of block <bx, bz> in <level>
+	const float2& GetBounds(int level, int bx, int bz) const {
+		const Level& l = levels[level];
+		return l.bounds[bz * l.size.x + bx];
+	}
+
+	float GetMinHeight(int level, int bx, int bz) const { return (GetBounds(level, bx, bz).x); }
+	float GetMaxHeight(int level, int bx, int bz) const { return (GetBounds(level, bx, bz).y); }
+
+private:
+	void UpdateBaseLevel(const float* cornerHeightMap, int x1, int z1, int x2, int z2);
+	void UpdateLevel(int level, int x1, int z1, int x2, int z2);
+
+private:
+	struct Level {
+		int2 size;
+		std::vector<float2> bounds;
+	};
+
+	std::vector<Level> levels;
+};
+
+#endif
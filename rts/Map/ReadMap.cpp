@@ -88,6 +88,7 @@ CR_REG_METADATA(CReadMap, (
 	CR_IGNORED(sharedFaceNormals),
 	CR_IGNORED(sharedCenterNormals),
 	CR_IGNORED(sharedSlopeMaps),
+	CR_IGNORED(sharedHeightBounds),
 
 	CR_IGNORED(unsyncedHeightMapUpdates),
 	CR_IGNORED(unsyncedHeightMapUpdatesTemp),
@@ -124,6 +125,9 @@ std::vector<float> CReadMap::slopeMap;
 std::vector<uint8_t> CReadMap::typeMap;
 std::vector<float3> CReadMap::centerNormals2D;
 
+CHeightBoundsPyramid CReadMap::heightBoundsSynced;
+CHeightBoundsPyramid CReadMap::heightBoundsUnsynced;
+
 #ifdef USE_UNSYNCED_HEIGHTMAP
 std::vector<uint8_t> CReadMap::  syncedHeightMapDigests;
 std::vector<uint8_t> CReadMap::unsyncedHeightMapDigests;
@@ -251,6 +255,8 @@ void CReadMap::PostLoad()
 	sharedSlopeMaps[0] = &slopeMap[0]; // NO UNSYNCED VARIANT
 	sharedSlopeMaps[1] = &slopeMap[0];
 
+	InitHeightBounds();
+
 	//FIXME reconstruct
 	/*
 	mipPointerHeightMaps.fill(nullptr);
@@ -365,6 +371,8 @@ void CReadMap::Initialize()
 		sharedSlopeMaps[1] = &slopeMap[0];
 	}
 
+	InitHeightBounds();
+
 	mapChecksum = CalcHeightmapChecksum();
 
 	syncedHeightMapDigests.clear();
@@ -397,6 +405,23 @@ void CReadMap::UpdateHeightsRefMap(const float h, const bool remove)
 	}
 }
 
+void CReadMap::InitHeightBounds()
+{
+	heightBoundsSynced.Init(GetCornerHeightMapSynced(), mapDims.mapx, mapDims.mapy);
+
+	#ifdef USE_UNSYNCED_HEIGHTMAP
+	heightBoundsUnsynced.Init(GetCornerHeightMapUnsynced(), mapDims.mapx, mapDims.mapy);
+
+	sharedHeightBounds[0] = &heightBoundsUnsynced;
+	#else
+	heightBoundsUnsynced.Kill();
+
+	sharedHeightBounds[0] = &heightBoundsSynced;
+	#endif
+
+	sharedHeightBounds[1] = &heightBoundsSynced;
+}
+
 void CReadMap::UpdateHeightBounds()
 {
 	currHeightBounds = float2{ heightRefMap.begin()->first, heightRefMap.rbegin()->first };
@@ -491,7 +516,14 @@ void CReadMap::UpdateDraw(bool firstCall)
 
 	// TODO: quadtree or whatever
 	for (size_t i = 0, n = std::min(MAX_UHM_RECTS_PER_FRAME, unsyncedHeightMapUpdates.size()); i < n; i++) {
-		UpdateHeightMapUnsynced(*(unsyncedHeightMapUpdates.begin() + i));
+		const SRectangle& rect = *(unsyncedHeightMapUpdates.begin() + i);
+
+		UpdateHeightMapUnsynced(rect);
+
+		#ifdef USE_UNSYNCED_HEIGHTMAP
+		// the unsynced corner-heights are copied over a rectangle expanded by one
+		heightBoundsUnsynced.Update(GetCornerHeightMapUnsynced(), rect.x1 - 1, rect.z1 - 1, rect.x2 + 1, rect.z2 + 1);
+		#endif
 	}
 
 	for (size_t i = 0, n = std::min(MAX_UHM_RECTS_PER_FRAME, unsyncedHeightMapUpdates.size()); i < n; i++) {
@@ -524,6 +556,11 @@ void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect, bool initiali
 
 	UpdateCenterHeightmap(centerRect, initialize);
 	UpdateMipHeightmaps(centerRect, initialize);
+
+	// the initial (full) build happens in InitHeightBounds
+	if (!initialize)
+		heightBoundsSynced.Update(GetCornerHeightMapSynced(), cornerRect.x1, cornerRect.z1, cornerRect.x2, cornerRect.z2);
+
 	UpdateFaceNormals(centerRect, initialize);
 	UpdateSlopemap(centerRect, initialize); // must happen after UpdateFaceNormals()!
 
@@ -9,6 +9,7 @@
 
 #include "MapTexture.h"
 #include "MapDimensions.h"
+#include "HeightBoundsPyramid.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "System/float3.h"
@@ -183,6 +184,7 @@ public:
 	const float3* GetSharedFaceNormals(bool synced) const { return sharedFaceNormals[synced]; }
 	const float3* GetSharedCenterNormals(bool synced) const { return sharedCenterNormals[synced]; }
 	const float* GetSharedSlopeMap(bool synced) const { return sharedSlopeMaps[synced]; }
+	const CHeightBoundsPyramid* GetSharedHeightBounds(bool synced) const { return sharedHeightBounds[synced]; }
 
 	/// if you modify the heightmap through these, call UpdateHeightMapSynced
 	float SetHeight(const int idx, const float h, const int add = 0);
@@ -207,6 +209,7 @@ public:
 	unsigned int CalcHeightmapChecksum();
 	void UpdateHeightsRefMap(const float h, const bool remove = false);
 	void UpdateHeightBounds();
+	void InitHeightBounds();
 	unsigned int CalcTypemapChecksum();
 
 private:
@@ -252,6 +255,10 @@ protected:
 	static std::vector<uint8_t> typeMap;
 	static std::vector<float3> centerNormals2D;
 
+	/// min/max corner-height pyramids for ray-ground tests, kept in step with {heightMapSynced,heightMapUnsynced}Ptr
+	static CHeightBoundsPyramid heightBoundsSynced;
+	static CHeightBoundsPyramid heightBoundsUnsynced;
+
 
 	CRectangleOverlapHandler unsyncedHeightMapUpdates;
 	CRectangleOverlapHandler unsyncedHeightMapUpdatesTemp;
@@ -264,6 +271,7 @@ private:
 	const float3* sharedFaceNormals[2];
 	const float3* sharedCenterNormals[2];
 	const float* sharedSlopeMaps[2];
+	const CHeightBoundsPyramid* sharedHeightBounds[2];
 
 #ifdef USE_UNSYNCED_HEIGHTMAP
 	/// these are not "digests", just simple rolling counters
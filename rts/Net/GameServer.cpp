@@ -89,9 +89,6 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_GAMESERVER)
 
 
 
-/// frames until a synccheck will time out and a warning is given out
-static constexpr unsigned SYNCCHECK_TIMEOUT = 300;
-
 /// used to prevent msg spam
 static constexpr unsigned SYNCCHECK_MSG_TIMEOUT = 400;
 
@@ -673,7 +670,7 @@ void CGameServer::CheckSync()
 			const auto pChecksumIt = p.syncResponse.find(outstandingSyncFrame);
 
 			if (pChecksumIt == p.syncResponse.end()) {
-				if (outstandingSyncFrame >= (serverFrameNum - static_cast<int>(SYNCCHECK_TIMEOUT)))
+				if (outstandingSyncFrame >= (serverFrameNum - SYNCCHECK_TIMEOUT))
 					completeResponseSet = false;
 				else if (outstandingSyncFrame < p.lastFrameResponse)
 					noSyncResponsePlayers.push_back(p.id);
@@ -713,6 +710,8 @@ void CGameServer::CheckSync()
 			if (syncErrorFrame == 0 || (outstandingSyncFrame - syncErrorFrame > static_cast<int>(SYNCCHECK_MSG_TIMEOUT))) {
 				syncErrorFrame = outstandingSyncFrame;
 
+				StartSyncTreeBisection(outstandingSyncFrame);
+
 			#ifdef SYNCDEBUG
 				CSyncDebugger::GetInstance()->ServerTriggerSyncErrorHandling(serverFrameNum);
 
@@ -779,6 +778,41 @@ float CGameServer::GetDemoTime() const {
 }
 
 
+void CGameServer::StartSyncTreeBisection(int errorFrameNum)
+{
+#ifdef SYNCCHECK
+	std::vector<int> playerNums;
+
+	for (const GameParticipant& p: players) {
+		if (p.clientLink != nullptr)
+			playerNums.push_back(p.id);
+	}
+
+	// narrows the desync down to a frame, phase and object
+	syncTreeBisector.Start(errorFrameNum, playerNums);
+	BroadcastSyncTreeRequest();
+#endif
+}
+
+void CGameServer::StopSyncTreeWait(int playerNum)
+{
+#ifdef SYNCCHECK
+	if (syncTreeBisector.RemovePlayer(playerNum))
+		BroadcastSyncTreeRequest();
+#endif
+}
+
+void CGameServer::BroadcastSyncTreeRequest()
+{
+#ifdef SYNCCHECK
+	const CSyncTreeBisector::Request& r = syncTreeBisector.GetRequest();
+
+	// SD_TREE_DONE is sent too, clients then resume recording
+	Broadcast(CBaseNetProtocol::Get().SendSdTreeRequest(r.level, r.frameNum, r.phaseIdx, r.begin, r.end));
+#endif
+}
+
+
 void CGameServer::Update()
 {
 	const float tdif = spring_tomsecs(spring_gettime() - lastUpdate) * 0.001f;
@@ -1077,6 +1111,7 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			Message(spring::format(PlayerLeft, players[a].GetType(), players[a].name.c_str(), " normal quit"));
 			Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(a, 1));
 			players[a].Kill("[GameServer] user exited", true);
+			StopSyncTreeWait(a);
 			if (hostif != nullptr)
 				hostif->SendPlayerLeft(a, 1);
 			break;
@@ -1803,6 +1838,33 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			break;
 		}
 
+#ifdef SYNCCHECK
+		case NETMSG_SD_TREERESPONSE: {
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
+
+				uint16_t packetSize; pckt >> packetSize;
+				uint8_t playerNum; pckt >> playerNum;
+				uint8_t level; pckt >> level;
+
+				if (playerNum != a)
+					throw netcode::UnpackPacketException("Invalid player number");
+				if (packetSize < 5)
+					throw netcode::UnpackPacketException("Invalid packet size");
+
+				std::vector<uint32_t> data((packetSize - 5) / sizeof(uint32_t));
+
+				if (!data.empty())
+					pckt >> data;
+
+				if (syncTreeBisector.AddResponse(a, level, std::move(data)))
+					BroadcastSyncTreeRequest();
+			} catch (const netcode::UnpackPacketException& ex) {
+				Message(spring::format("Player %s sent invalid SyncTreeResponse: %s", players[a].name.c_str(), ex.what()));
+			}
+			break;
+		}
+#endif
 #ifdef SYNCDEBUG
 		case NETMSG_SD_CHKRESPONSE:
 		case NETMSG_SD_BLKRESPONSE:
@@ -1932,6 +1994,7 @@ void CGameServer::ServerReadNet()
 			Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(player.id, 0));
 
 			player.Kill("User timeout");
+			StopSyncTreeWait(player.id);
 
 			if (hostif != nullptr)
 				hostif->SendPlayerLeft(player.id, 0);
@@ -2077,9 +2140,11 @@ void CGameServer::GenerateAndSendGameID()
 		      &p[ 0], &p[ 1], &p[ 2], &p[ 3], &p[ 4], &p[ 5], &p[ 6], &p[ 7],
 		      &p[ 8], &p[ 9], &p[10], &p[11], &p[12], &p[13], &p[14], &p[15]) == 16);
 	#else
+		// field widths make both "53 69 ..." and the unseparated "5369..."
+		// form (as printed by e.g. the GameID callin) parse into 16 bytes
 		generatedGameID = (sscanf(myGameSetup->gameID.c_str(),
-		       "%hhx%hhx%hhx%hhx%hhx%hhx%hhx%hhx"
-		       "%hhx%hhx%hhx%hhx%hhx%hhx%hhx%hhx",
+		       "%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx"
+		       "%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx",
 		       &p[ 0], &p[ 1], &p[ 2], &p[ 3], &p[ 4], &p[ 5], &p[ 6], &p[ 7],
 		       &p[ 8], &p[ 9], &p[10], &p[11], &p[12], &p[13], &p[14], &p[15]) == 16);
 	#endif
@@ -2723,6 +2788,7 @@ void CGameServer::KickPlayer(int playerNum)
 	Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(playerNum, 2));
 
 	players[playerNum].Kill("Kicked from the battle", true);
+	StopSyncTreeWait(playerNum);
 
 	if (hostif != nullptr)
 		hostif->SendPlayerLeft(playerNum, 2);
@@ -20,6 +20,7 @@
 #include "System/float3.h"
 #include "System/GlobalRNG.h"
 #include "System/Misc/SpringTime.h"
+#include "System/Sync/SyncTreeBisector.h"
 #include "System/Threading/SpringThreading.h"
 
 /**
@@ -161,6 +162,10 @@ private:
 	void Update();
 	void ProcessPacket(const unsigned playerNum, std::shared_ptr<const netcode::RawPacket> packet);
 	void CheckSync();
+	/// asks all connected clients for their checksum trees (see CSyncTreeBisector)
+	void StartSyncTreeBisection(int errorFrameNum);
+	void StopSyncTreeWait(int playerNum);
+	void BroadcastSyncTreeRequest();
 	void HandleConnectionAttempts();
 	void ServerReadNet();
 
@@ -226,6 +231,8 @@ private:
 	/////////////////// sync stuff ///////////////////
 #ifdef SYNCCHECK
 	std::set<int> outstandingSyncFrames;
+
+	CSyncTreeBisector syncTreeBisector;
 #endif
 
 	/////////////////// game status variables ///////////////////
@@ -36,6 +36,9 @@
 #include "System/LoadSave/DemoRecorder.h"
 #include "System/Net/UnpackPacket.h"
 #include "System/Sound/ISound.h"
+#include "System/Sync/DumpState.h"
+#include "System/Sync/SyncChecker.h"
+#include "System/Sync/SyncTreeBisector.h"
 
 CONFIG(bool, LogClientData).defaultValue(false);
 
@@ -45,6 +48,62 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_NET)
 static spring::unordered_map<int32_t, uint32_t> localSyncChecksums;
 
 
+#ifdef SYNCCHECK
+static int GetDumpObjectType(std::uint32_t phaseID)
+{
+	switch (phaseID) {
+		case SYNC_PHASE_UNIT_MOVETYPES:
+		case SYNC_PHASE_UNIT_LOSSTATES:
+		case SYNC_PHASE_UNIT_SLOWUPDATES:
+		case SYNC_PHASE_UNIT_UPDATES:
+		case SYNC_PHASE_UNIT_WEAPONS:
+		case SYNC_PHASE_UNIT_SCRIPTS: {
+			return DUMP_OBJECT_UNIT;
+		} break;
+		case SYNC_PHASE_PROJECTILE_UPDATES: {
+			return DUMP_OBJECT_PROJECTILE;
+		} break;
+		case SYNC_PHASE_FEATURE_UPDATES: {
+			return DUMP_OBJECT_FEATURE;
+		} break;
+		default: {
+		} break;
+	}
+
+	return -1;
+}
+
+// answers a step of the server's search for a desync (see CSyncTreeBisector)
+static void SendSyncTreeResponse(const CSyncTreeBisector::Request& request)
+{
+	CSyncChecksumTree& tree = CSyncChecker::GetChecksumTree();
+
+	if (request.level == CSyncTreeBisector::SD_TREE_DONE) {
+		tree.SetFrozen(false);
+		return;
+	}
+
+	// keep the recorded frames as they are until the server is done
+	tree.SetFrozen(true);
+
+	std::vector<std::uint32_t> data;
+	CSyncTreeBisector::GetResponse(tree, request, data);
+
+	if (request.level == CSyncTreeBisector::SD_TREE_LEAF && data.size() >= 4) {
+		const std::vector<std::uint32_t> writes(data.begin() + 4, data.end());
+
+		LOG_L(L_WARNING, "[%s] frame %d, phase %s, object %d: checksum 0x%08X after %u writes", __func__,
+			request.frameNum, CSyncChecksumTree::GetPhaseName(data[0]), int(data[1]), data[2], data[3]);
+
+		if (int(data[1]) >= 0)
+			DumpObjectState(GetDumpObjectType(data[0]), int(data[1]), request.frameNum, writes);
+	}
+
+	clientNet->Send(CBaseNetProtocol::Get().SendSdTreeResponse(gu->myPlayerNum, request.level, data));
+}
+#endif
+
+
 void CGame::AddTraffic(int playerID, int packetCode, int length)
 {
 	auto it = playerTraffic.find(playerID);
@@ -612,6 +671,21 @@ void CGame::ClientReadNet()
 #endif
 			} break;
 
+#ifdef SYNCCHECK
+			case NETMSG_SD_TREEREQUEST: {
+				netcode::UnpackPacket pckt(packet, 1);
+
+				uint8_t   level; pckt >> level;
+				int32_t frameNum; pckt >> frameNum;
+				uint16_t phaseIdx; pckt >> phaseIdx;
+				uint32_t   begin; pckt >> begin;
+				uint32_t     end; pckt >> end;
+
+				SendSyncTreeResponse({level, frameNum, phaseIdx, begin, end});
+				AddTraffic(-1, packetCode, dataLength);
+			} break;
+#endif
+
 
 			case NETMSG_COMMAND: {
 				try {
@@ -606,6 +606,27 @@ PacketType CBaseNetProtocol::SendSdBlockresponse(uint8_t playerNum, std::vector<
 #endif // SYNCDEBUG
 
 
+#ifdef SYNCCHECK
+PacketType CBaseNetProtocol::SendSdTreeRequest(uint8_t level, int32_t frameNum, uint16_t phaseIdx, uint32_t begin, uint32_t end)
+{
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(level) + sizeof(frameNum) + sizeof(phaseIdx) + sizeof(begin) + sizeof(end), NETMSG_SD_TREEREQUEST);
+	*packet << level << frameNum << phaseIdx << begin << end;
+	return PacketType(packet);
+}
+
+PacketType CBaseNetProtocol::SendSdTreeResponse(uint8_t playerNum, uint8_t level, const std::vector<uint32_t>& data)
+{
+	const uint32_t payloadSize = sizeof(playerNum) + sizeof(level) + (data.size() * sizeof(uint32_t));
+	const uint32_t headerSize = sizeof(uint8_t) + sizeof(uint16_t);
+	const uint32_t packetSize = headerSize + payloadSize;
+
+	PackPacket* packet = new PackPacket(packetSize, NETMSG_SD_TREERESPONSE);
+	*packet << static_cast<uint16_t>(packetSize) << playerNum << level << data;
+	return PacketType(packet);
+}
+#endif // SYNCCHECK
+
+
 CBaseNetProtocol::CBaseNetProtocol()
 {
 	netcode::ProtocolDef* proto = netcode::ProtocolDef::GetInstance();
@@ -674,5 +695,9 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_SD_BLKREQUEST, 7);
 	proto->AddType(NETMSG_SD_BLKRESPONSE, -2);
 #endif // SYNCDEBUG
+#ifdef SYNCCHECK
+	proto->AddType(NETMSG_SD_TREEREQUEST, 16);
+	proto->AddType(NETMSG_SD_TREERESPONSE, -2);
+#endif // SYNCCHECK
 }
 
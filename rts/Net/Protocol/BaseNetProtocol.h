@@ -117,6 +117,10 @@ public:
 	PacketType SendSdBlockrequest(uint16_t begin, uint16_t length, uint16_t requestSize);
 	PacketType SendSdBlockresponse(uint8_t playerNum, std::vector<uint32_t> checksums);
 #endif
+#ifdef SYNCCHECK
+	PacketType SendSdTreeRequest(uint8_t level, int32_t frameNum, uint16_t phaseIdx, uint32_t begin, uint32_t end);
+	PacketType SendSdTreeResponse(uint8_t playerNum, uint8_t level, const std::vector<uint32_t>& data);
+#endif
 
 private:
 	CBaseNetProtocol();
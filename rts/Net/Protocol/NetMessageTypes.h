@@ -66,6 +66,11 @@ enum NETMSG {
 	NETMSG_SD_RESET         = 45,
 #endif // SYNCDEBUG
 
+#ifdef SYNCCHECK
+	NETMSG_SD_TREEREQUEST   = 46, // uint8_t level; int32_t frameNum; uint16_t phaseIdx; uint32_t begin, end;
+	NETMSG_SD_TREERESPONSE  = 47, // uint16_t msgsize; uint8_t playerNum, level; std::vector<uint32_t> data;
+#endif // SYNCCHECK
+
 	NETMSG_LOGMSG           = 49, // uint8_t playerNum, uint8_t logMsgLvl, std::string strData
 	NETMSG_LUAMSG           = 50, // /* uint16_t messageSize */, uint8_t playerNum, uint16_t script, uint8_t mode, std::vector<uint8_t> rawData
 
@@ -34,9 +34,11 @@
 #include "Sim/Weapons/WeaponDef.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/Platform/Misc.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
+#include "System/RadixSort.h"
 #include "System/SafeUtil.h"
 #include "System/StringUtil.h"
 
@@ -49,6 +51,19 @@ CProjectileDrawer* projectileDrawer = nullptr;
 // ~EventClient)
 static uint8_t projectileDrawerMem[sizeof(CProjectileDrawer)];
 
+// below this many particle-emitting projectiles FX vertices are
+// generated on the render thread only, above it in one chunk per
+// worker and concatenated in draw order afterwards
+static constexpr size_t MIN_FX_CHUNK_SIZE = 1024;
+
+struct ProjectileSortKey {
+	std::uint32_t key;
+	CProjectile* projectile;
+};
+
+static std::vector<ProjectileSortKey> projectileSortKeys[2];
+static std::vector<CVertexArray> fxChunkVAs;
+
 
 void CProjectileDrawer::InitStatic() {
 	//LOG_L(L_WARNING, "CProjectileDrawer::InitStatic()");
@@ -601,6 +616,81 @@ void CProjectileDrawer::DrawProjectileNow(CProjectile* pro, bool drawReflection,
 	sortedProjectiles[drawSorted && pro->drawSorted].push_back(pro);
 }
 
+void CProjectileDrawer::SortProjectiles()
+{
+	std::vector<CProjectile*>& projectiles = sortedProjectiles[1];
+
+	if (projectiles.size() <= 1)
+		return;
+
+	float minSortDist = std::numeric_limits<float>::max();
+	float maxSortDist = std::numeric_limits<float>::lowest();
+
+	for (const CProjectile* p: projectiles) {
+		minSortDist = std::min(minSortDist, p->GetSortDist());
+		maxSortDist = std::max(maxSortDist, p->GetSortDist());
+	}
+
+	// quantize the distances to 16 bits over the range they actually
+	// span, farthest first; equal keys keep their insertion order
+	const float keyScale = 65535.0f / std::max(maxSortDist - minSortDist, 1e-3f);
+
+	auto& sortKeys = projectileSortKeys[0];
+
+	sortKeys.clear();
+	sortKeys.reserve(projectiles.size());
+
+	for (CProjectile* p: projectiles) {
+		sortKeys.push_back({static_cast<std::uint32_t>((maxSortDist - p->GetSortDist()) * keyScale), p});
+	}
+
+	spring::RadixSort(sortKeys, projectileSortKeys[1], [](const ProjectileSortKey& k) { return k.key; });
+
+	for (size_t i = 0, n = sortKeys.size(); i < n; i++) {
+		projectiles[i] = sortKeys[i].projectile;
+	}
+}
+
+void CProjectileDrawer::DrawProjectilesFX(CVertexArray* va)
+{
+	const std::vector<CProjectile*>& sortedFX = sortedProjectiles[1];
+	const std::vector<CProjectile*>& unsortedFX = sortedProjectiles[0];
+
+	const size_t numProjectiles = sortedFX.size() + unsortedFX.size();
+	const size_t numChunks = std::min(size_t(ThreadPool::GetNumThreads()), numProjectiles / MIN_FX_CHUNK_SIZE);
+
+	if (numChunks <= 1) {
+		for (CProjectile* p: sortedFX) {
+			p->Draw(va);
+		}
+		for (CProjectile* p: unsortedFX) {
+			p->Draw(va);
+		}
+		return;
+	}
+
+	// Draw(va) only reads the camera and writes vertices, so contiguous
+	// ranges of the back-to-front order can be expanded concurrently
+	const size_t chunkSize = (numProjectiles + numChunks - 1) / numChunks;
+
+	if (fxChunkVAs.size() < numChunks)
+		fxChunkVAs.resize(numChunks);
+
+	for_mt(0, numChunks, [&](const int c) {
+		CVertexArray* chunkVA = &fxChunkVAs[c];
+		chunkVA->Initialize();
+
+		for (size_t i = c * chunkSize, n = std::min(numProjectiles, (c + 1) * chunkSize); i < n; i++) {
+			CProjectile* p = (i < sortedFX.size())? sortedFX[i]: unsortedFX[i - sortedFX.size()];
+			p->Draw(chunkVA);
+		}
+	});
+
+	for (size_t c = 0; c < numChunks; c++) {
+		va->Append(fxChunkVAs[c]);
+	}
+}
+
 
 
 void CProjectileDrawer::DrawProjectilesShadow(int modelType)
@@ -751,19 +841,14 @@ void CProjectileDrawer::Draw(bool drawReflection, bool drawRefraction) {
 		DrawProjectilesSet(renderProjectiles, drawReflection, drawRefraction);
 
 		// empty if !drawSorted
-		std::sort(sortedProjectiles[1].begin(), sortedProjectiles[1].end(), zSortCmp);
+		SortProjectiles();
 
 
 		fxVA = GetVertexArray();
 		fxVA->Initialize();
 
 		// collect the alpha-translucent particle effects in fxVA
-		for (CProjectile* p: sortedProjectiles[1]) {
-			p->Draw(fxVA);
-		}
-		for (CProjectile* p: sortedProjectiles[0]) {
-			p->Draw(fxVA);
-		}
+		DrawProjectilesFX(fxVA);
 	}
 
 	glEnable(GL_BLEND);
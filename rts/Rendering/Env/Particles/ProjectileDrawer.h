@@ -11,10 +11,10 @@
 #include "Rendering/Shaders/Shader.h"
 #include "Rendering/Models/3DModel.h"
 #include "Rendering/Models/ModelRenderContainer.h"
-#include "Sim/Projectiles/ProjectileFunctors.h"
 #include "System/EventClient.h"
 #include "System/UnorderedSet.hpp"
 
+class CProjectile;
 class CSolidObject;
 class CTextureAtlas;
 class CVertexArray;
@@ -135,6 +135,9 @@ private:
 	static bool CanDrawProjectile(const CProjectile* pro, const CSolidObject* owner);
 	void DrawProjectileNow(CProjectile* projectile, bool drawReflection, bool drawRefraction);
 
+	void SortProjectiles();
+	void DrawProjectilesFX(CVertexArray* va);
+
 	static void DrawProjectileShadow(CProjectile* projectile);
 	static bool DrawProjectileModel(const CProjectile* projectile);
 
@@ -158,8 +161,6 @@ private:
 
 	FBO perlinFB;
 
-	ProjectileDistanceComparator zSortCmp;
-
 
 	std::vector<const AtlasedTexture*> smokeTextures;
 
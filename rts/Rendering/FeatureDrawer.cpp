@@ -318,6 +318,10 @@ void CFeatureDrawer::DrawOpaquePass(bool deferredPass, bool, bool)
 {
 	unitDrawer->SetupOpaqueDrawing(deferredPass);
 
+	for (CFeature* f: featureDrawList.GetFarObjects()) {
+		farTextureHandler->Queue(f);
+	}
+
 	for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
 		unitDrawer->PushModelRenderState(modelType);
 		DrawOpaqueFeatures(modelType);
@@ -333,42 +337,21 @@ void CFeatureDrawer::DrawOpaquePass(bool deferredPass, bool, bool)
 
 void CFeatureDrawer::DrawOpaqueFeatures(int modelType)
 {
-	const auto& quads = camVisibleQuads[(CCameraHandler::GetActiveCamera())->GetCamType()];
-
-	for (int quad: quads) {
-		const auto& mdlRenderProxy = modelRenderers[quad];
-
-		if (mdlRenderProxy.GetLastDrawFrame() < globalRendering->drawFrame)
-			continue;
-
-		const auto& mdlRenderer = mdlRenderProxy.GetRenderer(modelType);
-		// const auto& featureBinKeys = mdlRenderer.GetObjectBinKeys();
-
-		for (unsigned int i = 0, n = mdlRenderer.GetNumObjectBins(); i < n; i++) {
-			CUnitDrawer::BindModelTypeTexture(modelType, mdlRenderer.GetObjectBinKey(i));
+	// opaque and shadow features, culled by FlagVisibleFeatures
+	for (unsigned int i = 0, n = featureDrawList.GetNumObjectBins(modelType, MODEL_DRAW_NEAR); i < n; i++) {
+		const auto& bin = featureDrawList.GetObjectBin(modelType, i, MODEL_DRAW_NEAR);
 
-			for (CFeature* f: mdlRenderer.GetObjectBin(i)) {
-				// fartex, opaque, shadow are allowed here
-				switch (f->drawFlag) {
-					case CFeature::FD_NODRAW_FLAG: {                              continue; } break;
-					case CFeature::FD_ALPHAF_FLAG: {                              continue; } break;
-					case CFeature::FD_FARTEX_FLAG: { farTextureHandler->Queue(f); continue; } break;
-					default: {} break;
-				}
+		CUnitDrawer::BindModelTypeTexture(modelType, bin.key);
 
-				// test this before the LOD calls (for consistency with UD)
-				if (!CanDrawFeature(f))
-					continue;
+		for (CFeature* f: bin.objects) {
+			if ( inShadowPass && LuaObjectDrawer::AddShadowMaterialObject(f, LUAOBJ_FEATURE))
+				continue;
+			if (!inShadowPass && LuaObjectDrawer::AddOpaqueMaterialObject(f, LUAOBJ_FEATURE))
+				continue;
 
-				if ( inShadowPass && LuaObjectDrawer::AddShadowMaterialObject(f, LUAOBJ_FEATURE))
-					continue;
-				if (!inShadowPass && LuaObjectDrawer::AddOpaqueMaterialObject(f, LUAOBJ_FEATURE))
-					continue;
+			unitDrawer->SetTeamColour(f->team);
 
-				unitDrawer->SetTeamColour(f->team);
-
-				DrawFeatureTrans(f, 0, 0, false, false);
-			}
+			DrawFeatureTrans(f, 0, 0, false, false);
 		}
 	}
 }
@@ -505,41 +488,20 @@ void CFeatureDrawer::DrawAlphaPass()
 
 void CFeatureDrawer::DrawAlphaFeatures(int modelType)
 {
-	const auto& quads = camVisibleQuads[(CCameraHandler::GetActiveCamera())->GetCamType()];
-
-	for (int quad: quads) {
-		const auto& mdlRenderProxy = modelRenderers[quad];
-
-		if (mdlRenderProxy.GetLastDrawFrame() < globalRendering->drawFrame)
-			continue;
-
-		const auto& mdlRenderer = mdlRenderProxy.GetRenderer(modelType);
-		// const auto& featureBinKeys = mdlRenderer.GetObjectBinKeys();
+	// alpha-faded features, culled by FlagVisibleFeatures
+	for (unsigned int i = 0, n = featureDrawList.GetNumObjectBins(modelType, MODEL_DRAW_FADE); i < n; i++) {
+		const auto& bin = featureDrawList.GetObjectBin(modelType, i, MODEL_DRAW_FADE);
 
-		for (unsigned int i = 0, n = mdlRenderer.GetNumObjectBins(); i < n; i++) {
-			CUnitDrawer::BindModelTypeTexture(modelType, mdlRenderer.GetObjectBinKey(i));
+		CUnitDrawer::BindModelTypeTexture(modelType, bin.key);
 
-			for (CFeature* f: mdlRenderer.GetObjectBin(i)) {
-				// only alpha is allowed here
-				switch (f->drawFlag) {
-					case CFeature::FD_NODRAW_FLAG: { continue; } break;
-					case CFeature::FD_OPAQUE_FLAG: { continue; } break;
-					case CFeature::FD_SHADOW_FLAG: { continue; } break;
-					case CFeature::FD_FARTEX_FLAG: { continue; } break;
-					default: {} break;
-				}
+		for (CFeature* f: bin.objects) {
+			if (LuaObjectDrawer::AddAlphaMaterialObject(f, LUAOBJ_FEATURE))
+				continue;
 
-				if (!CanDrawFeature(f))
-					continue;
+			unitDrawer->SetTeamColour(f->team, float2(f->drawAlpha, 1.0f));
 
-				if (LuaObjectDrawer::AddAlphaMaterialObject(f, LUAOBJ_FEATURE))
-					continue;
-
-				unitDrawer->SetTeamColour(f->team, float2(f->drawAlpha, 1.0f));
-
-				setFeatureAlphaMatFuncs[ffpAlphaMat](f);
-				DrawFeatureTrans(f, 0, 0, false, false);
-			}
+			setFeatureAlphaMatFuncs[ffpAlphaMat](f);
+			DrawFeatureTrans(f, 0, 0, false, false);
 		}
 	}
 }
@@ -642,61 +604,68 @@ void CFeatureDrawer::FlagVisibleFeatures(
 
 	const CCamera* playerCam = CCameraHandler::GetCamera(CCamera::CAMTYPE_PLAYER);
 
+	featureDrawList.Clear();
+
 	for (int quad: quads) {
-		auto& mdlRenderProxy = featureDrawer->modelRenderers[quad];
+		const auto& mdlRenderProxy = featureDrawer->modelRenderers[quad];
 
 		for (int i = 0; i < MODELTYPE_OTHER; ++i) {
-			const auto& mdlRenderer = mdlRenderProxy.GetRenderer(i);
-			// const auto& featureBinKeys = mdlRenderer.GetObjectBinKeys();
+			featureDrawList.AddObjects(i, mdlRenderProxy.GetRenderer(i));
+		}
+	}
 
-			for (unsigned int j = 0, n = mdlRenderer.GetNumObjectBins(); j < n; j++) {
-				for (CFeature* f: mdlRenderer.GetObjectBin(j)) {
-					assert(quad == f->drawQuad);
+	// every feature lives in exactly one quad, so the flags, fade alphas
+	// and transforms can be updated concurrently; sets the draw-lists the
+	// opaque, shadow and alpha passes consume
+	featureDrawList.Cull([&](CFeature* f) {
+		// clear marker; will be set at most once below
+		f->SetDrawFlag(CFeature::FD_NODRAW_FLAG);
 
-					// clear marker; will be set at most once below
-					f->SetDrawFlag(CFeature::FD_NODRAW_FLAG);
+		if (f->noDraw)
+			return MODEL_DRAW_CULL;
+		if (f->IsInVoid())
+			return MODEL_DRAW_CULL;
 
-					if (f->noDraw)
-						continue;
-					if (f->IsInVoid())
-						continue;
+		assert(f->def->drawType == DRAWTYPE_MODEL);
 
-					assert(f->def->drawType == DRAWTYPE_MODEL);
+		if (!gu->spectatingFullView && !f->IsInLosForAllyTeam(gu->myAllyTeam))
+			return MODEL_DRAW_CULL;
 
-					if (!gu->spectatingFullView && !f->IsInLosForAllyTeam(gu->myAllyTeam))
-						continue;
 
+		if (drawShadowPass) {
+			if (SetFeatureDrawAlpha(f, playerCam, sqFadeDistBegin, sqFadeDistEnd)) {
+				// no shadows for fully alpha-faded features from player's POV
+				f->UpdateTransform(f->drawPos, false);
+				f->SetDrawFlag(CFeature::FD_SHADOW_FLAG);
+				return (CanDrawFeature(f)? MODEL_DRAW_NEAR: MODEL_DRAW_CULL);
+			}
+			return MODEL_DRAW_CULL;
+		}
 
-					if (drawShadowPass) {
-						if (SetFeatureDrawAlpha(f, playerCam, sqFadeDistBegin, sqFadeDistEnd)) {
-							// no shadows for fully alpha-faded features from player's POV
-							f->UpdateTransform(f->drawPos, false);
-							f->SetDrawFlag(CFeature::FD_SHADOW_FLAG);
-						}
-						continue;
-					}
+		if (drawRefraction && !f->IsInWater())
+			return MODEL_DRAW_CULL;
 
-					if (drawRefraction && !f->IsInWater())
-						continue;
+		if (drawReflection && !CUnitDrawer::ObjectVisibleReflection(f->drawMidPos, cam->GetPos(), f->GetDrawRadius()))
+			return MODEL_DRAW_CULL;
 
-					if (drawReflection && !CUnitDrawer::ObjectVisibleReflection(f->drawMidPos, cam->GetPos(), f->GetDrawRadius()))
-						continue;
 
+		if (SetFeatureDrawAlpha(f, cam, sqFadeDistBegin, sqFadeDistEnd)) {
+			f->UpdateTransform(f->drawPos, false);
+			f->SetDrawFlag(mix(int(CFeature::FD_OPAQUE_FLAG), int(CFeature::FD_ALPHAF_FLAG), f->drawAlpha < 1.0f));
 
-					if (SetFeatureDrawAlpha(f, cam, sqFadeDistBegin, sqFadeDistEnd)) {
-						f->UpdateTransform(f->drawPos, false);
-						f->SetDrawFlag(mix(int(CFeature::FD_OPAQUE_FLAG), int(CFeature::FD_ALPHAF_FLAG), f->drawAlpha < 1.0f));
-						continue;
-					}
+			if (!CanDrawFeature(f))
+				return MODEL_DRAW_CULL;
 
-					// note: it looks pretty bad to first alpha-fade and then
-					// draw a fully *opaque* fartex, so restrict impostors to
-					// non-fading features
-					f->SetDrawFlag(CFeature::FD_FARTEX_FLAG * drawFarFeatures * (!f->alphaFade));
-				}
-			}
+			return ((f->drawAlpha < 1.0f)? MODEL_DRAW_FADE: MODEL_DRAW_NEAR);
 		}
-	}
+
+		// note: it looks pretty bad to first alpha-fade and then
+		// draw a fully *opaque* fartex, so restrict impostors to
+		// non-fading features
+		f->SetDrawFlag(CFeature::FD_FARTEX_FLAG * drawFarFeatures * (!f->alphaFade));
+
+		return ((f->drawFlag == CFeature::FD_FARTEX_FLAG)? MODEL_DRAW_FAR: MODEL_DRAW_CULL);
+	});
 }
 
 void CFeatureDrawer::GetVisibleFeatures(CCamera* cam, int extraSize, bool drawFar)
@@ -6,6 +6,7 @@
 #include <vector>
 #include <array>
 #include "Game/Camera.h"
+#include "Rendering/Models/ModelDrawList.h"
 #include "Rendering/Models/ModelRenderContainer.h"
 #include "System/creg/creg_cond.h"
 #include "System/EventClient.h"
@@ -129,6 +130,9 @@ private:
 	std::array<unsigned int, CCamera::CAMTYPE_ENVMAP> camVisDrawFrames;
 	std::vector<CFeature*> unsortedFeatures;
 
+	/// features that passed culling for the current pass and camera
+	ModelDrawList<CFeature> featureDrawList;
+
 	GL::GeometryBuffer* geomBuffer;
 };
 
@@ -42,6 +42,16 @@ void CVertexArray::Initialize()
 	stripArrayPos = stripArray;
 }
 
+void CVertexArray::Append(const CVertexArray& va)
+{
+	const unsigned int numFloats = va.drawIndex();
+
+	EnlargeArrays(numFloats, 0, 1);
+	memcpy(drawArrayPos, va.drawArray, numFloats * sizeof(float));
+
+	drawArrayPos += numFloats;
+}
+
 bool CVertexArray::IsReady() const
 {
 	return true;
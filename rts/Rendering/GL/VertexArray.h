@@ -107,6 +107,9 @@ public:
 	unsigned int drawIndex() const { return drawArrayPos - drawArray; }
 	void ResetPos() { drawArrayPos = drawArray; }
 
+	// appends the vertices (not the strips) of <va>, which must have the same layout
+	void Append(const CVertexArray& va);
+
 	// standard API
 	inline void AddVertex0(const float3& p);
 	inline void AddVertex0(float x, float y, float z);
@@ -7,6 +7,7 @@
 #include "System/Log/ILog.h"
 #include "System/SafeUtil.h"
 #include "System/SpringMath.h"
+#include "System/Threading/ThreadPool.h"
 #include "Sim/Misc/LosHandler.h"
 #include "Sim/Objects/SolidObject.h"
 #include "Sim/Projectiles/Projectile.h"
@@ -100,59 +101,54 @@ bool MatrixUploader::IsInView(const TObj* obj)
 }
 
 
-template<typename TObj>
-void MatrixUploader::GetVisibleObjects(std::map<int, const TObj*>& visibleObjects)
+template<typename TObj, typename TCont>
+void MatrixUploader::CullObjects(const TCont& objects, std::vector<const TObj*>& visibleObjects)
 {
-	visibleObjects.clear();
-
-	if constexpr (std::is_same<TObj, CUnit>::value) {
-		for (const auto* obj : unitHandler.GetActiveUnits()) {
-			if (!IsObjectVisible(obj))
-				continue;
+	// test in parallel, compact serially s.t. the visible set keeps a stable order
+	objVisibility.clear();
+	objVisibility.resize(objects.size(), 0);
 
-			if (!IsInView(obj))
-				continue;
+	for_mt(0, objects.size(), [&](const int i) {
+		const TObj* obj = objects[i];
 
-			visibleObjects[obj->id] = obj;
+		if constexpr (std::is_same<TObj, CProjectile>::value) {
+			if (!obj->weapon) // is this a weapon projectile? (true implies synced true)
+				return;
 		}
+
+		objVisibility[i] = (IsObjectVisible(obj) && IsInView(obj));
+	});
+
+	visibleObjects.clear();
+
+	for (size_t i = 0, n = objects.size(); i < n; i++) {
+		if (objVisibility[i] != 0)
+			visibleObjects.push_back(objects[i]);
+	}
+}
+
+template<typename TObj>
+void MatrixUploader::GetVisibleObjects(std::vector<const TObj*>& visibleObjects)
+{
+	if constexpr (std::is_same<TObj, CUnit>::value) {
+		CullObjects(unitHandler.GetActiveUnits(), visibleObjects);
 		return;
 	}
 
 	if constexpr (std::is_same<TObj, CFeature>::value) {
-		for (const int fID : featureHandler.GetActiveFeatureIDs()) {
-			const auto* obj = featureHandler.GetFeature(fID);
-			if (!IsObjectVisible(obj))
-				continue;
+		activeFeatures.clear();
+		activeFeatures.reserve(featureHandler.GetActiveFeatureIDs().size());
 
-			if (!IsInView(obj))
-				continue;
-
-			visibleObjects[fID] = obj;
+		for (const int fID : featureHandler.GetActiveFeatureIDs()) {
+			activeFeatures.push_back(featureHandler.GetFeature(fID));
 		}
+
+		CullObjects(activeFeatures, visibleObjects);
 		return;
 	}
 
-	//CProjectile part is a mess. TODO figure out how to retrieve an addressable ID
 	if constexpr (std::is_same<TObj, CProjectile>::value) {
-		int iter = 0;
-		for (const auto* obj : projectileHandler.GetActiveProjectiles(true)) {
-
-			if (!obj->weapon) // is this a weapon projectile? (true implies synced true)
-				continue;
-
-			//const CWeaponProjectile* wp = p->weapon ? static_cast<const CWeaponProjectile*>(p) : nullptr;
-			//const WeaponDef* wd = p->weapon ? wp->GetWeaponDef() : nullptr;
-
-			if (obj)
-
-			if (!IsObjectVisible(obj))
-				continue;
-
-			if (!IsInView(obj))
-				continue;
-
-			visibleObjects[iter++] = obj; //TODO: use projID instead of iter
-		}
+		CullObjects(projectileHandler.GetActiveProjectiles(true), visibleObjects);
 		return;
 	}
 
@@ -205,55 +201,53 @@ bool MatrixUploader::UpdateObjectDefs()
 }
 
 template<typename TObj>
-void MatrixUploader::UpdateVisibleObjects()
+void MatrixUploader::UpdateVisibleObjects(std::vector<const TObj*>& visibleObjects, std::vector<ElemOffset>& elemOffsets, uint32_t bufferOffset)
 {
-	std::map<int, const TObj*> visibleObjects;
 	GetVisibleObjects<TObj>(visibleObjects);
 
-	if constexpr (std::is_same<TObj, CUnit>::value || std::is_same<TObj, CFeature>::value) {
-		for (const auto& kv : visibleObjects) {
-			const int elemBeginIndex = elemUpdateOffset + std::distance(matrices.cbegin(), matrices.cend());
+	// every object gets one contiguous range: its transform followed by
+	// (for units and features) the model-space matrix of each piece
+	objElemOffsets.resize(visibleObjects.size());
 
-			const int objID = kv.first;
-			const TObj* obj = kv.second;
+	uint32_t elemCount = static_cast<uint32_t>(matrices.size());
 
-			matrices.emplace_back(obj->GetTransformMatrix(false, losHandler->GetGlobalLOS(gu->myAllyTeam)));
-			const auto& lm = obj->localModel;
-			for (const auto& lmp : lm.pieces) {
-				matrices.emplace_back(lmp.GetModelSpaceMatrix());
-			}
-
-			const int elemEndIndex = elemUpdateOffset + std::distance(matrices.cbegin(), matrices.cend());
+	for (size_t i = 0, n = visibleObjects.size(); i < n; i++) {
+		const TObj* obj = visibleObjects[i];
 
-			if constexpr (std::is_same<TObj, CUnit>::value) {
-				unitIDToOffsetMap[objID] = elemBeginIndex;
-				//LOG("Adding new unitID %d, elemBeginIndex %d elemEndIndex %d", objID, elemBeginIndex, elemEndIndex);
-			}
+		objElemOffsets[i] = elemCount;
 
-			if constexpr (std::is_same<TObj, CFeature>::value) {
-				featureIDToOffsetMap[objID] = elemBeginIndex;
-			}
+		if constexpr (std::is_same<TObj, CProjectile>::value) {
+			elemCount += 1;
+		} else {
+			elemCount += 1 + static_cast<uint32_t>(obj->localModel.pieces.size());
 		}
 
-		return;
+		if (static_cast<size_t>(obj->id) >= elemOffsets.size())
+			elemOffsets.resize(obj->id + 1);
+
+		elemOffsets[obj->id] = {bufferOffset + objElemOffsets[i], generation};
 	}
 
-	if constexpr (std::is_same<TObj, CProjectile>::value) {
-		for (const auto& kv : visibleObjects) {
-			const int elemBeginIndex = std::distance(matrices.cbegin(), matrices.cend());
+	matrices.resize(elemCount);
 
-			const int objID = kv.first;
-			const TObj* obj = kv.second;
+	const bool globalLOS = losHandler->GetGlobalLOS(gu->myAllyTeam);
 
-			matrices.emplace_back(obj->GetTransformMatrix(obj->GetProjectileType() == WEAPON_MISSILE_PROJECTILE));
+	// pieces are only shared within a model, so each object's lazy
+	// matrix updates stay on the thread that handles the object
+	for_mt(0, visibleObjects.size(), [&](const int i) {
+		const TObj* obj = visibleObjects[i];
+		CMatrix44f* objMatrices = &matrices[objElemOffsets[i]];
 
-			const int elemEndIndex = std::distance(matrices.cbegin(), matrices.cend());
+		if constexpr (std::is_same<TObj, CProjectile>::value) {
+			objMatrices[0] = obj->GetTransformMatrix(obj->GetProjectileType() == WEAPON_MISSILE_PROJECTILE);
+		} else {
+			objMatrices[0] = obj->GetTransformMatrix(false, globalLOS);
 
-			weaponIDToOffsetMap[objID] = elemBeginIndex;
+			for (const auto& lmp : obj->localModel.pieces) {
+				*(++objMatrices) = lmp.GetModelSpaceMatrix();
+			}
 		}
-
-		return;
-	}
+	});
 }
 
 
@@ -265,9 +259,15 @@ void MatrixUploader::Update()
 	matrices.clear();
 	bool updateObjectDefsNow = UpdateObjectDefs(); //will not touch bindpos matrices if already updated
 
-	UpdateVisibleObjects<CUnit>();
-	UpdateVisibleObjects<CFeature>();
-	UpdateVisibleObjects<CProjectile>();
+	// matrices also holds the constant part when it was just (re)built
+	const uint32_t bufferOffset = updateObjectDefsNow ? 0u : elemUpdateOffset;
+
+	// invalidates all offsets from the previous update at once
+	generation++;
+
+	UpdateVisibleObjects<CUnit>(visibleUnits, unitElemOffsets, bufferOffset);
+	UpdateVisibleObjects<CFeature>(visibleFeatures, featureElemOffsets, bufferOffset);
+	UpdateVisibleObjects<CProjectile>(visibleProjectiles, projectileElemOffsets, bufferOffset);
 
 	//LOG_L(L_INFO, "MatrixUploader::%s matrices.size = [%u]", __func__, static_cast<uint32_t>(matrices.size()));
 
@@ -333,25 +333,27 @@ uint32_t MatrixUploader::GetFeatureDefElemOffset(int32_t featureDefID)
 	return offsetIter->second;
 }
 
-uint32_t MatrixUploader::GetUnitElemOffset(int32_t unitID)
+uint32_t MatrixUploader::GetElemOffset(const std::vector<ElemOffset>& elemOffsets, int32_t objID, const char* objType) const
 {
-	const auto& unitIDIter = unitIDToOffsetMap.find(unitID);
-	if (unitIDIter == unitIDToOffsetMap.cend()) {
-		LOG_L(L_ERROR, "MatrixUploader::%s Supplied invalid %s %d", __func__, "UnitID", unitID);
+	if (objID < 0 || static_cast<size_t>(objID) >= elemOffsets.size() || elemOffsets[objID].generation != generation) {
+		LOG_L(L_ERROR, "MatrixUploader::%s Supplied invalid %s %d", __func__, objType, objID);
 		return ~0u;
 	}
 
-	return unitIDIter->second;
+	return elemOffsets[objID].offset;
+}
+
+uint32_t MatrixUploader::GetUnitElemOffset(int32_t unitID)
+{
+	return GetElemOffset(unitElemOffsets, unitID, "UnitID");
 }
 
-//TODO: DO DRY
 uint32_t MatrixUploader::GetFeatureElemOffset(int32_t featureID)
 {
-	const auto& featureIDIter = featureIDToOffsetMap.find(featureID);
-	if (featureIDIter == featureIDToOffsetMap.cend()) {
-		LOG_L(L_ERROR, "MatrixUploader::%s Supplied invalid %s %d", __func__, "FeatureID", featureID);
-		return ~0u;
-	}
+	return GetElemOffset(featureElemOffsets, featureID, "FeatureID");
+}
 
-	return featureIDIter->second;
-}
\ No newline at end of file
+uint32_t MatrixUploader::GetProjectileElemOffset(int32_t syncedProjectileID)
+{
+	return GetElemOffset(projectileElemOffsets, syncedProjectileID, "ProjectileID");
+}
@@ -5,13 +5,16 @@
 #include <cstdint>
 #include <vector>
 #include <unordered_map>
-#include <map>
 
 #include "System/Matrix44f.h"
 #include "System/SpringMath.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/VBO.h"
 
+class CUnit;
+class CFeature;
+class CProjectile;
+
 class MatrixUploader {
 public:
 	static constexpr bool enabled = true;
@@ -33,15 +36,27 @@ public:
 	uint32_t GetFeatureDefElemOffset(int32_t featureDefID);
 	uint32_t GetUnitElemOffset(int32_t unitID);
 	uint32_t GetFeatureElemOffset(int32_t featureID);
+	uint32_t GetProjectileElemOffset(int32_t syncedProjectileID);
+private:
+	// offset of an object's matrices, only valid if written by the current Update()
+	struct ElemOffset {
+		uint32_t offset = ~0u;
+		uint32_t generation = 0u;
+	};
 private:
 	template<typename TObj>
-	bool IsObjectVisible(const TObj* obj);
+	static bool IsObjectVisible(const TObj* obj);
 
 	template<typename TObj>
-	bool IsInView(const TObj* obj);
+	static bool IsInView(const TObj* obj);
+
+	template<typename TObj, typename TCont>
+	void CullObjects(const TCont& objects, std::vector<const TObj*>& visibleObjects);
 
 	template<typename TObj>
-	void GetVisibleObjects(std::map<int, const TObj*>& visibleObjects);
+	void GetVisibleObjects(std::vector<const TObj*>& visibleObjects);
+
+	uint32_t GetElemOffset(const std::vector<ElemOffset>& elemOffsets, int32_t objID, const char* objType) const;
 private:
 	void KillVBO();
 	void InitVBO(const uint32_t newElemCount);
@@ -50,7 +65,7 @@ private:
 	bool UpdateObjectDefs();
 
 	template<typename TObj>
-	void UpdateVisibleObjects();
+	void UpdateVisibleObjects(std::vector<const TObj*>& visibleObjects, std::vector<ElemOffset>& elemOffsets, uint32_t bufferOffset);
 private:
 	static constexpr uint32_t MATRIX_SSBO_BINDING_IDX = 0;
 	static constexpr uint32_t elemCount0 = 1u << 13;
@@ -62,12 +77,23 @@ private:
 	std::unordered_map<int32_t, std::string> featureDefToModel;
 	std::unordered_map<std::string, uint32_t> modelToOffsetMap;
 
-	std::unordered_map<int32_t, uint32_t> unitIDToOffsetMap;
-	std::unordered_map<int32_t, uint32_t> featureIDToOffsetMap;
-	std::unordered_map<int32_t, uint32_t> weaponIDToOffsetMap;
+	// indexed by object ID
+	std::vector<ElemOffset> unitElemOffsets;
+	std::vector<ElemOffset> featureElemOffsets;
+	std::vector<ElemOffset> projectileElemOffsets;
+
+	// per-update scratch, kept around to not reallocate every frame
+	std::vector<const CUnit*> visibleUnits;
+	std::vector<const CFeature*> visibleFeatures;
+	std::vector<const CProjectile*> visibleProjectiles;
+	std::vector<const CFeature*> activeFeatures;
+	std::vector<uint32_t> objElemOffsets;
+	std::vector<uint8_t> objVisibility;
 
 	std::vector<CMatrix44f> matrices;
 
+	uint32_t generation = 0u;
+
 	VBO* matrixSSBO;
 };
 
@@ -9,6 +9,8 @@
 #include "System/Exceptions.h"
 #include "System/SafeUtil.h"
 
+#include <xmmintrin.h>
+
 #include <algorithm>
 #include <cctype>
 #include <cstring>
@@ -29,8 +31,10 @@ CR_REG_METADATA(LocalModelPiece, (
 	// reload
 	CR_IGNORED(dispListID),
 	CR_IGNORED(original),
+	CR_IGNORED(lmodel),
 
 	CR_IGNORED(dirty),
+	CR_IGNORED(boundsDirty),
 	CR_IGNORED(modelSpaceMat),
 	CR_IGNORED(pieceSpaceMat),
 
@@ -41,7 +45,10 @@ CR_BIND(LocalModel, )
 CR_REG_METADATA(LocalModel, (
 	CR_MEMBER(pieces),
 
+	CR_IGNORED(pieceBounds),
 	CR_IGNORED(boundingVolume),
+	CR_IGNORED(pieceBVH),
+	CR_IGNORED(pieceBVHDirty),
 	CR_IGNORED(luaMaterialData)
 ))
 
@@ -315,11 +322,13 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 			S3DModelPiece* omp = model->GetPiece(n);
 
 			pieces[n].original = omp;
+			pieces[n].lmodel = this;
 			pieces[n].dispListID = omp->GetDisplayListID();
 		}
 
 		pieces[0].UpdateChildMatricesRec(true);
-		UpdateBoundingVolume();
+		InitBoundingVolume();
+		pieceBVH.Clear();
 		return;
 	}
 
@@ -334,7 +343,8 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 	// LocalModel::Update is never called, but they might have
 	// baked piece rotations (in the case of .dae)
 	pieces[0].UpdateChildMatricesRec(false);
-	UpdateBoundingVolume();
+	InitBoundingVolume();
+	pieceBVH.Clear();
 
 	assert(pieces.size() == model->numPieces);
 }
@@ -347,6 +357,7 @@ LocalModelPiece* LocalModel::CreateLocalModelPieces(const S3DModelPiece* mpParen
 	pieces.emplace_back(mpParent);
 	LocalModelPiece* lmpParent = &pieces.back();
 
+	lmpParent->lmodel = this;
 	lmpParent->SetLModelPieceIndex(pieces.size() - 1);
 	lmpParent->SetScriptPieceIndex(pieces.size() - 1);
 
@@ -364,46 +375,119 @@ LocalModelPiece* LocalModel::CreateLocalModelPieces(const S3DModelPiece* mpParen
 }
 
 
-void LocalModel::UpdateBoundingVolume()
+void LocalModel::InitBoundingVolume()
 {
-	// bounding-box extrema (local space)
-	float3 bbMins = DEF_MIN_SIZE;
-	float3 bbMaxs = DEF_MAX_SIZE;
+	pieceBounds.clear();
+	pieceBounds.resize(pieces.size() * 2);
 
-	for (const auto& lmPiece: pieces) {
-		const CMatrix44f& matrix = lmPiece.GetModelSpaceMatrix();
-		const S3DModelPiece* piece = lmPiece.original;
+	// pieces without geometry never overwrite their entries
+	for (size_t n = 0; n < pieceBounds.size(); n += 2) {
+		pieceBounds[n + 0] = DEF_MIN_SIZE;
+		pieceBounds[n + 1] = DEF_MAX_SIZE;
+	}
 
-		// skip empty pieces or bounds will not be sensible
-		if (!piece->HasGeometryData())
-			continue;
+	// every piece starts out with <boundsDirty> set; merge even if
+	// none has geometry so the volume is always initialized
+	UpdatePieceBounds();
+	MergePieceBounds();
+}
 
-		// transform only the corners of the piece's bounding-box
-		const float3 pMins = piece->mins;
-		const float3 pMaxs = piece->maxs;
-		const float3 verts[8] = {
-			// bottom
-			float3(pMins.x,  pMins.y,  pMins.z),
-			float3(pMaxs.x,  pMins.y,  pMins.z),
-			float3(pMaxs.x,  pMins.y,  pMaxs.z),
-			float3(pMins.x,  pMins.y,  pMaxs.z),
-			// top
-			float3(pMins.x,  pMaxs.y,  pMins.z),
-			float3(pMaxs.x,  pMaxs.y,  pMins.z),
-			float3(pMaxs.x,  pMaxs.y,  pMaxs.z),
-			float3(pMins.x,  pMaxs.y,  pMaxs.z),
-		};
-
-		for (const float3& v: verts) {
-			const float3 vertex = matrix * v;
-
-			bbMins = float3::min(bbMins, vertex);
-			bbMaxs = float3::max(bbMaxs, vertex);
-		}
+bool LocalModel::UpdateBoundingVolume()
+{
+	// static models and idle units skip the merge entirely
+	if (!UpdatePieceBounds())
+		return false;
+
+	MergePieceBounds();
+	return true;
+}
+
+bool LocalModel::UpdatePieceBounds()
+{
+	assert(pieceBounds.size() == pieces.size() * 2);
+
+	bool changed = false;
+
+	// only pieces that moved since the last update get their bounds re-transformed
+	for (size_t n = 0; n < pieces.size(); n++) {
+		changed |= pieces[n].UpdateModelSpaceBounds(&pieceBounds[n * 2]);
 	}
 
+	return changed;
+}
+
+void LocalModel::MergePieceBounds()
+{
+	// bounding-box extrema (local space); min and max are exact, so
+	// the merge-order (or vector width) can not affect sync
+	__m128 bbMins = _mm_set_ps(0.0f, DEF_MIN_SIZE.z, DEF_MIN_SIZE.y, DEF_MIN_SIZE.x);
+	__m128 bbMaxs = _mm_set_ps(0.0f, DEF_MAX_SIZE.z, DEF_MAX_SIZE.y, DEF_MAX_SIZE.x);
+
+	for (size_t n = 0; n < pieceBounds.size(); n += 2) {
+		bbMins = _mm_min_ps(bbMins, _mm_loadu_ps(pieceBounds[n + 0]));
+		bbMaxs = _mm_max_ps(bbMaxs, _mm_loadu_ps(pieceBounds[n + 1]));
+	}
+
+	float4 mins;
+	float4 maxs;
+
+	_mm_storeu_ps(mins, bbMins);
+	_mm_storeu_ps(maxs, bbMaxs);
+
 	// note: offset is relative to object->pos
-	boundingVolume.InitBox(bbMaxs - bbMins, (bbMaxs + bbMins) * 0.5f);
+	boundingVolume.InitBox(maxs - mins, (maxs + mins) * 0.5f);
+}
+
+
+const CPieceBVH& LocalModel::GetPieceBVH() const
+{
+	// only objects with per-piece collision ever ask for a hierarchy
+	if (pieceBVH.GetNumPieces() != pieces.size()) {
+		pieceBVH.Init(pieces.size());
+		UpdatePieceBVHBounds();
+		pieceBVH.Build();
+	} else if (pieceBVHDirty) {
+		UpdatePieceBVHBounds();
+		pieceBVH.Refit();
+	}
+
+	pieceBVHDirty = false;
+	return pieceBVH;
+}
+
+void LocalModel::UpdatePieceBVHBounds() const
+{
+	for (size_t n = 0; n < pieces.size(); n++) {
+		const LocalModelPiece& lmp = pieces[n];
+		const CollisionVolume* vol = lmp.GetCollisionVolume();
+		const CMatrix44f& mat = lmp.GetModelSpaceMatrix();
+
+		// CCollisionHandler::Intersect brings segments into volume-space via
+		// InvertAffine, i.e. through the transpose A^T of the rotation-part,
+		// so the region it tests is pos + inverse(A^T) * [-hs, hs]; this is
+		// just A * [-hs, hs] unless the piece is scaled
+		const float3 c0 = mat.GetX();
+		const float3 c1 = mat.GetY();
+		const float3 c2 = mat.GetZ();
+
+		const float3 pos = mat.Mul(vol->GetOffsets());
+		const float3& hs = vol->GetHScales();
+
+		const float det = c0.dot(c1.cross(c2));
+
+		if (math::fabs(det) < 1e-6f) {
+			// degenerate (zero-scaled) piece, let it always be tested
+			pieceBVH.SetPieceBounds(n, -OnesVector * 1e30f, OnesVector * 1e30f);
+			continue;
+		}
+
+		const float3 b0 = float3::fabs(c1.cross(c2) / det);
+		const float3 b1 = float3::fabs(c2.cross(c0) / det);
+		const float3 b2 = float3::fabs(c0.cross(c1) / det);
+		const float3 ext = b0 * hs.x + b1 * hs.y + b2 * hs.z;
+
+		pieceBVH.SetPieceBounds(n, pos - ext, pos + ext);
+	}
 }
 
 void S3DModel::CreateVBOs()
@@ -525,6 +609,7 @@ LocalModelPiece::LocalModelPiece(const S3DModelPiece* piece)
 	: colvol(piece->GetCollisionVolume())
 
 	, dirty(true)
+	, boundsDirty(true)
 
 	, scriptSetVisible(piece->HasGeometryData())
 	, blockScriptAnims(false)
@@ -534,6 +619,7 @@ LocalModelPiece::LocalModelPiece(const S3DModelPiece* piece)
 
 	, original(piece)
 	, parent(nullptr) // set later
+	, lmodel(nullptr) // set later
 {
 	assert(piece != nullptr);
 
@@ -548,6 +634,9 @@ LocalModelPiece::LocalModelPiece(const S3DModelPiece* piece)
 
 void LocalModelPiece::SetDirty() {
 	dirty = true;
+	boundsDirty = true;
+
+	lmodel->SetPieceBVHDirty();
 
 	for (LocalModelPiece* child: children) {
 		if (child->dirty)
@@ -588,6 +677,55 @@ void LocalModelPiece::UpdateChildMatricesRec(bool updateChildMatrices) const
 	}
 }
 
+bool LocalModelPiece::UpdateModelSpaceBounds(float4* bounds) const
+{
+	if (!boundsDirty)
+		return false;
+
+	// skip empty pieces or bounds will not be sensible; their entries
+	// keep the (inverted) default extrema set by InitBoundingVolume
+	if (!original->HasGeometryData()) {
+		boundsDirty = false;
+		return false;
+	}
+
+	// recalculates our matrix (and clears <dirty>) first, so any later
+	// SetDirty call is guaranteed to raise <boundsDirty> again
+	const CMatrix44f& matrix = GetModelSpaceMatrix();
+
+	// transform only the corners of the piece's bounding-box
+	const float3 pMins = original->mins;
+	const float3 pMaxs = original->maxs;
+	const float3 verts[8] = {
+		// bottom
+		float3(pMins.x,  pMins.y,  pMins.z),
+		float3(pMaxs.x,  pMins.y,  pMins.z),
+		float3(pMaxs.x,  pMins.y,  pMaxs.z),
+		float3(pMins.x,  pMins.y,  pMaxs.z),
+		// top
+		float3(pMins.x,  pMaxs.y,  pMins.z),
+		float3(pMaxs.x,  pMaxs.y,  pMins.z),
+		float3(pMaxs.x,  pMaxs.y,  pMaxs.z),
+		float3(pMins.x,  pMaxs.y,  pMaxs.z),
+	};
+
+	float3 bbMins = DEF_MIN_SIZE;
+	float3 bbMaxs = DEF_MAX_SIZE;
+
+	for (const float3& v: verts) {
+		const float3 vertex = matrix * v;
+
+		bbMins = float3::min(bbMins, vertex);
+		bbMaxs = float3::max(bbMaxs, vertex);
+	}
+
+	bounds[0] = bbMins;
+	bounds[1] = bbMaxs;
+
+	boundsDirty = false;
+	return true;
+}
+
 void LocalModelPiece::UpdateParentMatricesRec() const
 {
 	if (parent != nullptr && parent->dirty)
@@ -11,7 +11,9 @@
 #include "Lua/LuaObjectMaterial.h"
 #include "Rendering/GL/VBO.h"
 #include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/PieceBVH.h"
 #include "System/Matrix44f.h"
+#include "System/float4.h"
 #include "System/type2.h"
 #include "System/SafeUtil.h"
 #include "System/creg/creg_cond.h"
@@ -399,7 +401,7 @@ struct LocalModelPiece
 {
 	CR_DECLARE_STRUCT(LocalModelPiece)
 
-	LocalModelPiece(): dirty(true) {}
+	LocalModelPiece(): dirty(true), boundsDirty(true), lmodel(nullptr) {}
 	LocalModelPiece(const S3DModelPiece* piece);
 
 	void AddChild(LocalModelPiece* c) { children.push_back(c); }
@@ -463,6 +465,11 @@ struct LocalModelPiece
 	const CollisionVolume* GetCollisionVolume() const { return &colvol; }
 	      CollisionVolume* GetCollisionVolume()       { return &colvol; }
 
+	// writes the model-space {mins, maxs} of the original piece's bounding-box
+	// to <bounds> if this piece moved since the previous call, returns false
+	// (leaving <bounds> untouched) otherwise
+	bool UpdateModelSpaceBounds(float4* bounds) const;
+
 private:
 	float3 pos; // translation relative to parent LMP, *INITIALLY* equal to original->offset
 	float3 rot; // orientation relative to parent LMP, in radians (updated by scripts)
@@ -474,6 +481,8 @@ private:
 	CollisionVolume colvol;
 
 	mutable bool dirty;
+	// set along with <dirty>, but only cleared by UpdateModelSpaceBounds
+	mutable bool boundsDirty;
 
 public:
 	bool scriptSetVisible; // TODO: add (visibility) maxradius!
@@ -485,6 +494,7 @@ public:
 
 	const S3DModelPiece* original;
 	LocalModelPiece* parent;
+	LocalModel* lmodel; // owner, told by SetDirty that a piece moved
 
 	std::vector<LocalModelPiece*> children;
 	std::vector<unsigned int> lodDispLists;
@@ -508,6 +518,11 @@ struct LocalModel
 	const LocalModelPiece* GetRoot() const { return (GetPiece(0)); }
 	const CollisionVolume* GetBoundingVolume() const { return &boundingVolume; }
 
+	// hierarchy over the pieces' collision-volumes (model-space), built on
+	// first use and refit whenever a piece moved or its volume was changed
+	const CPieceBVH& GetPieceBVH() const;
+	void SetPieceBVHDirty() { pieceBVHDirty = true; }
+
 	const LuaObjectMaterialData* GetLuaMaterialData() const { return &luaMaterialData; }
 	      LuaObjectMaterialData* GetLuaMaterialData()       { return &luaMaterialData; }
 
@@ -532,7 +547,9 @@ struct LocalModel
 
 	void SetModel(const S3DModel* model, bool initialize = true);
 	void SetLODCount(unsigned int lodCount);
-	void UpdateBoundingVolume();
+
+	// returns true if any piece moved and the volume had to be rebuilt
+	bool UpdateBoundingVolume();
 
 	void GetBoundingBoxVerts(std::vector<float3>& verts) const {
 		verts.resize(8 + 2); GetBoundingBoxVerts(&verts[0]);
@@ -561,6 +578,12 @@ struct LocalModel
 private:
 	LocalModelPiece* CreateLocalModelPieces(const S3DModelPiece* mpParent);
 
+	void InitBoundingVolume();
+	bool UpdatePieceBounds();
+	void MergePieceBounds();
+
+	void UpdatePieceBVHBounds() const;
+
 	void DrawPieces() const;
 	void DrawPiecesLOD(unsigned int lod) const;
 
@@ -568,9 +591,15 @@ public:
 	std::vector<LocalModelPiece> pieces;
 
 private:
+	// cached model-space {mins, maxs} per piece, merged into boundingVolume
+	std::vector<float4> pieceBounds;
+
 	// object-oriented box; accounts for piece movement
 	CollisionVolume boundingVolume;
 
+	mutable CPieceBVH pieceBVH;
+	mutable bool pieceBVHDirty = true;
+
 	// custom Lua-set material this model should be rendered with
 	LuaObjectMaterialData luaMaterialData;
 };
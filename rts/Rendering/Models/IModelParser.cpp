@@ -15,6 +15,7 @@
 #include "System/Exceptions.h"
 #include "System/MainDefines.h" // SNPRINTF
 #include "System/SafeUtil.h"
+#include "System/Platform/Threading.h"
 #include "System/Threading/ThreadPool.h"
 #include "lib/assimp/include/assimp/Importer.hpp"
 
@@ -146,6 +147,8 @@ void CModelLoader::InitParsers()
 
 void CModelLoader::Kill()
 {
+	// make sure no preload worker is still writing into <models>
+	FinishPreload();
 	LogErrors();
 	KillModels();
 	KillParsers();
@@ -222,6 +225,69 @@ void CModelLoader::PreloadModel(const std::string& modelName)
 	});
 }
 
+void CModelLoader::PreloadModels(const std::vector<std::string>& modelNames)
+{
+	assert(Threading::IsMainThread() || Threading::IsGameLoadThread());
+
+	if (!ThreadPool::HasThreads())
+		return;
+
+	{
+		std::lock_guard<spring::mutex> lock(mutex);
+
+		if (numPreloadsQueued == numPreloadsDone) {
+			numPreloadsQueued = 0;
+			numPreloadsDone = 0;
+
+			preloadStartTime = spring_gettime();
+			preloadParseTime = spring_notime;
+		}
+
+		numPreloadsQueued += modelNames.size();
+	}
+
+	// file reading, parsing and piece-tree construction all happen on
+	// the workers; GL resources are created on first non-preload use
+	for (const std::string& modelName: modelNames) {
+		ThreadPool::Enqueue([modelName]() {
+			modelLoader.PreloadModelTask(modelName);
+		});
+	}
+}
+
+void CModelLoader::PreloadModelTask(const std::string& modelName)
+{
+	const spring_time t0 = spring_gettime();
+
+	LoadModel(modelName, true);
+
+	std::lock_guard<spring::mutex> lock(mutex);
+
+	preloadParseTime += (spring_gettime() - t0);
+	numPreloadsDone += 1;
+
+	cond.notify_all();
+}
+
+void CModelLoader::FinishPreload()
+{
+	std::unique_lock<spring::mutex> lock(mutex);
+
+	if (numPreloadsQueued == 0)
+		return;
+
+	cond.wait(lock, [&]() { return (numPreloadsDone == numPreloadsQueued); });
+
+	const int64_t wallTime = std::max(int64_t(1), (spring_gettime() - preloadStartTime).toMilliSecsi());
+	const int64_t parseTime = preloadParseTime.toMilliSecsi();
+
+	LOG("[ModelLoader::%s] preloaded %u models in %ims (parse=%ims, %.1f models/s, %u threads)",
+		__func__, numPreloadsDone, int(wallTime), int(parseTime), (numPreloadsDone * 1000.0f) / wallTime, unsigned(ThreadPool::GetNumThreads()));
+
+	numPreloadsQueued = 0;
+	numPreloadsDone = 0;
+}
+
 void CModelLoader::LogErrors()
 {
 	assert(Threading::IsMainThread());
@@ -257,22 +323,61 @@ S3DModel* CModelLoader::LoadModel(std::string name, bool preload)
 	StringToLowerInPlace(name);
 
 	{
-		std::lock_guard<spring::mutex> lock(mutex);
+		std::unique_lock<spring::mutex> lock(mutex);
+
+		while (true) {
+			// search in cache first
+			for (const auto& ref: refs) {
+				S3DModel* cachedModel = LoadCachedModel(*ref, preload);
+
+				if (cachedModel != nullptr)
+					return cachedModel;
+
+				// expensive, delay until needed
+				path = FindModelPath(name);
+			}
+
+			const auto isPending = [&](const std::string* ref) { return (pendingModels.find(*ref) != pendingModels.end()); };
 
-		// search in cache first
-		for (const auto& ref: refs) {
-			S3DModel* cachedModel = LoadCachedModel(*ref, preload);
+			if (std::none_of(std::begin(refs), std::end(refs), isPending))
+				break;
 
-			if (cachedModel != nullptr)
-				return cachedModel;
+			// being parsed by another thread; a preload request has nothing
+			// left to do since that thread will cache the model, and must not
+			// tie up a pool worker by waiting for it (the loading thread never
+			// waits on queued jobs, so any non-preload caller can block here)
+			if (preload)
+				return nullptr;
 
-			// expensive, delay until needed
-			path = FindModelPath(name);
+			cond.wait(lock);
 		}
+
+		pendingModels.insert(name);
+		pendingModels.insert(path);
 	}
 
+	const auto clearPending = [&]() {
+		{
+			std::lock_guard<spring::mutex> lock(mutex);
+			pendingModels.erase(name);
+			pendingModels.erase(path);
+		}
+
+		cond.notify_all();
+	};
+
+	S3DModel* model = nullptr;
+
 	// not found in cache, create the model and cache it
-	return (CreateModel(name, path, preload));
+	try {
+		model = CreateModel(name, path, preload);
+	} catch (...) {
+		clearPending();
+		throw;
+	}
+
+	clearPending();
+	return model;
 }
 
 S3DModel* CModelLoader::LoadCachedModel(const std::string& name, bool preload)
@@ -8,6 +8,8 @@
 
 #include "3DModel.h"
 #include "System/UnorderedMap.hpp"
+#include "System/UnorderedSet.hpp"
+#include "System/Misc/SpringTime.h"
 #include "System/Threading/SpringThreading.h"
 
 
@@ -32,6 +34,8 @@ public:
 
 	bool IsValid() const { return (!formats.empty()); }
 	void PreloadModel(const std::string& name);
+	void PreloadModels(const std::vector<std::string>& names);
+	void FinishPreload();
 	void LogErrors();
 
 public:
@@ -51,6 +55,7 @@ private:
 	void KillParsers();
 
 	void CreateLists(S3DModel* o);
+	void PreloadModelTask(const std::string& name);
 
 private:
 	ModelMap cache;
@@ -58,12 +63,25 @@ private:
 	ParserMap parsers;
 
 	spring::mutex mutex;
+	spring::condition_variable_any cond;
+
+	// names (and paths) of models some thread is currently parsing;
+	// non-preload requests for the same model wait for it to finish
+	// rather than parsing it a second time, preload requests skip it
+	spring::unordered_set<std::string> pendingModels;
 
 	std::vector<S3DModel> models;
 	std::vector< std::pair<std::string, std::string> > errors;
 
 	// all unique models loaded so far
 	unsigned int numModels = 0;
+
+	// bookkeeping for batches queued by PreloadModels
+	unsigned int numPreloadsQueued = 0;
+	unsigned int numPreloadsDone = 0;
+
+	spring_time preloadStartTime;
+	spring_time preloadParseTime;
 };
 
 extern CModelLoader modelLoader;
@@ -0,0 +1,136 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MODEL_DRAW_LIST_HDR
+#define MODEL_DRAW_LIST_HDR
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "System/Threading/ThreadPool.h"
+
+// per-object result of a draw-list's cull function
+enum {
+	MODEL_DRAW_CULL = 0, // not drawn by this pass
+	MODEL_DRAW_NEAR = 1, // drawn as model
+	MODEL_DRAW_FADE = 2, // drawn as model, alpha-faded
+	MODEL_DRAW_FAR  = 3, // drawn as far-texture
+};
+
+/**
+ * Compact per-camera draw-lists built from ModelRenderContainer bins.
+ * Candidates are gathered per model-type in bin order, classified by
+ * the cull function on ThreadPool workers (which must therefore only
+ * read shared state and write to the object it is given, e.g. its fade
+ * alpha) and then compacted serially so every list keeps the order of
+ * the container it was gathered from. GL submission walks the near or
+ * faded bins and the far-texture list, and never sees culled objects.
+ */
+template<typename TObject>
+class ModelDrawList {
+public:
+	struct ObjectBin {
+		int key;
+		std::vector<TObject*> objects;
+	};
+
+public:
+	void Clear() {
+		candidates.clear();
+		farObjects.clear();
+
+		// reuse inner vectors between passes
+		for (unsigned int k = 0; k < bins.size(); k++) {
+			for (auto& mdlBins: bins[k]) {
+				for (ObjectBin& bin: mdlBins) {
+					bin.objects.clear();
+				}
+			}
+
+			numBins[k].assign(numBins[k].size(), 0);
+		}
+	}
+
+	template<typename TContainer>
+	void AddObjects(int modelType, const TContainer& mdlRenderer) {
+		for (unsigned int i = 0, n = mdlRenderer.GetNumObjectBins(); i < n; i++) {
+			for (TObject* o: mdlRenderer.GetObjectBin(i)) {
+				candidates.push_back({o, modelType, mdlRenderer.GetObjectBinKey(i)});
+			}
+		}
+	}
+
+	template<typename TCullFunc>
+	void Cull(TCullFunc&& cullFunc) {
+		results.clear();
+		results.resize(candidates.size(), MODEL_DRAW_CULL);
+
+		for_mt(0, candidates.size(), [&](const int i) {
+			results[i] = cullFunc(candidates[i].object);
+		});
+
+		for (size_t i = 0, n = candidates.size(); i < n; i++) {
+			const Candidate& c = candidates[i];
+
+			switch (results[i]) {
+				case MODEL_DRAW_NEAR: { FindObjectBin(0, c.modelType, c.binKey).objects.push_back(c.object); } break;
+				case MODEL_DRAW_FADE: { FindObjectBin(1, c.modelType, c.binKey).objects.push_back(c.object); } break;
+				case MODEL_DRAW_FAR : { farObjects.push_back(c.object); } break;
+				default: {} break;
+			}
+		}
+	}
+
+	// <drawType> is either MODEL_DRAW_NEAR or MODEL_DRAW_FADE
+	unsigned int GetNumObjectBins(int modelType, int drawType = MODEL_DRAW_NEAR) const {
+		const auto& mdlNumBins = numBins[drawType == MODEL_DRAW_FADE];
+		return ((size_t(modelType) < mdlNumBins.size())? mdlNumBins[modelType]: 0);
+	}
+	const ObjectBin& GetObjectBin(int modelType, unsigned int i, int drawType = MODEL_DRAW_NEAR) const {
+		return bins[drawType == MODEL_DRAW_FADE][modelType][i];
+	}
+
+	const std::vector<TObject*>& GetFarObjects() const { return farObjects; }
+
+private:
+	ObjectBin& FindObjectBin(unsigned int k, int modelType, int key) {
+		if (size_t(modelType) >= bins[k].size()) {
+			bins[k].resize(modelType + 1);
+			numBins[k].resize(modelType + 1, 0);
+		}
+
+		auto& mdlBins = bins[k][modelType];
+		auto& mdlNumBins = numBins[k][modelType];
+
+		// candidates arrive grouped by bin, so the last one is almost always it
+		for (unsigned int j = mdlNumBins; j > 0; j--) {
+			if (mdlBins[j - 1].key == key)
+				return mdlBins[j - 1];
+		}
+
+		if (mdlBins.size() <= mdlNumBins)
+			mdlBins.emplace_back();
+
+		ObjectBin& bin = mdlBins[mdlNumBins++];
+		bin.key = key;
+		return bin;
+	}
+
+private:
+	struct Candidate {
+		TObject* object;
+		int modelType;
+		int binKey;
+	};
+
+	std::vector<Candidate> candidates;
+	std::vector<std::uint8_t> results;
+
+	// [0] := near, [1] := faded; each indexed by model-type
+	std::array< std::vector< std::vector<ObjectBin> >, 2> bins;
+	std::array< std::vector<unsigned int>, 2> numBins;
+
+	std::vector<TObject*> farObjects;
+};
+
+#endif
@@ -60,15 +60,67 @@ void CS3OTextureHandler::Kill()
 	textureCache.clear();
 	textureTable.clear();
 	bitmapCache.clear();
+	bitmapFlags.clear();
 }
 
 
 void CS3OTextureHandler::PreloadTexture(S3DModel* model, bool invertAxis, bool invertAlpha)
 {
-	cacheMutex.lock();
-	LoadAndCacheTexture(model, 0, invertAxis, invertAlpha, true);
-	LoadAndCacheTexture(model, 1, invertAxis,       false, true); // never invert alpha for tex2
-	cacheMutex.unlock();
+	// called from model-preload workers; the (comparatively slow) file
+	// read and decode happen outside cacheMutex so that several models
+	// can have their textures prepared at the same time
+	PreloadBitmap(model, 0, invertAxis, invertAlpha);
+	PreloadBitmap(model, 1, invertAxis,       false); // never invert alpha for tex2
+}
+
+void CS3OTextureHandler::PreloadBitmap(const S3DModel* model, unsigned int texNum, bool invertAxis, bool invertAlpha)
+{
+	const auto& textureName = model->texs[texNum];
+
+	{
+		std::lock_guard<spring::mutex> lck(cacheMutex);
+
+		bitmapFlags.emplace(textureName, std::make_pair(invertAxis, invertAlpha));
+
+		if (textureCache.find(textureName) != textureCache.end())
+			return;
+		if (bitmapCache.find(textureName) != bitmapCache.end())
+			return;
+	}
+
+	CBitmap bitmap;
+	LoadBitmap(model, texNum, invertAxis, invertAlpha, bitmap);
+
+	std::lock_guard<spring::mutex> lck(cacheMutex);
+
+	// another model sharing this texture may have beaten us to it
+	if (textureCache.find(textureName) != textureCache.end())
+		return;
+
+	bitmapCache.emplace(textureName, std::move(bitmap));
+}
+
+void CS3OTextureHandler::LoadBitmap(
+	const S3DModel* model,
+	unsigned int texNum,
+	bool invertAxis,
+	bool invertAlpha,
+	CBitmap& bitmap
+) {
+	const auto& textureName = model->texs[texNum];
+
+	if (!bitmap.Load(textureName) && !bitmap.Load("unittextures/" + textureName)) {
+		if (texNum == 0)
+			LOG_L(L_WARNING, "[%s] could not load primary texture \"%s\" from model \"%s\"", __func__, textureName.c_str(), model->name.c_str());
+
+		// file not found (or headless build), set a single pixel so model is visible
+		bitmap.AllocDummy(SColor(255 * (texNum == 0), 0, 0, 255 * (1 - invertAlpha)));
+	}
+
+	if (invertAxis)
+		bitmap.ReverseYAxis();
+	if (invertAlpha)
+		bitmap.InvertAlpha();
 }
 
 
@@ -76,8 +128,8 @@ void CS3OTextureHandler::LoadTexture(S3DModel* model)
 {
 	cacheMutex.lock();
 
-	const unsigned int tex1ID = LoadAndCacheTexture(model, 0, false, false, false);
-	const unsigned int tex2ID = LoadAndCacheTexture(model, 1, false, false, false);
+	const unsigned int tex1ID = LoadAndCacheTexture(model, 0);
+	const unsigned int tex2ID = LoadAndCacheTexture(model, 1);
 
 	const auto texTableIter = textureTable.find(TEX_MAT_UID(tex1ID, tex2ID));
 
@@ -92,56 +144,33 @@ void CS3OTextureHandler::LoadTexture(S3DModel* model)
 	cacheMutex.unlock();
 }
 
-unsigned int CS3OTextureHandler::LoadAndCacheTexture(
-	const S3DModel* model,
-	unsigned int texNum,
-	bool invertAxis,
-	bool invertAlpha,
-	bool preloadCall
-) {
-	CBitmap* bitmap = nullptr;
-
+unsigned int CS3OTextureHandler::LoadAndCacheTexture(const S3DModel* model, unsigned int texNum)
+{
 	const auto& textureName = model->texs[texNum];
 	const auto textureIt = textureCache.find(textureName);
 
 	if (textureIt != textureCache.end())
 		return textureIt->second.texID;
 
-	const auto bitmapIt = bitmapCache.find(textureName);
-
-	if (bitmapIt != bitmapCache.end()) {
-		// bitmap was previously preloaded but not yet loaded
-		// if !preloading, we will now turn the bitmap into a
-		// texture and cache it
-		bitmap = &(bitmapIt->second);
-	} else {
-		// bitmap was not yet preloaded, meaning we are the
-		// first to (all non-3DO model textures are always
-		// preloaded)
-		assert(preloadCall);
-
-		auto pair = bitmapCache.emplace(textureName, {});
-		auto iter = pair.first;
-
-		bitmap = &(iter->second);
+	// all non-3DO model textures are preloaded by the parser, so the
+	// bitmap should be waiting for us; turn it into a texture and cache
+	// that instead
+	auto bitmapIt = bitmapCache.find(textureName);
 
-		if (!bitmap->Load(textureName) && !bitmap->Load("unittextures/" + textureName)) {
-			if (texNum == 0)
-				LOG_L(L_WARNING, "[%s] could not load primary texture \"%s\" from model \"%s\"", __func__, textureName.c_str(), model->name.c_str());
+	if (bitmapIt == bitmapCache.end()) {
+		// not (or no longer) preloaded, e.g. the parser failed after its
+		// PreloadTexture call; load it here with the flags it would have
+		// been preloaded with rather than leaving the model untextured
+		const auto flagsIt = bitmapFlags.find(textureName);
+		const std::pair<bool, bool> flags = (flagsIt != bitmapFlags.end())? flagsIt->second: std::make_pair(false, false);
 
-			// file not found (or headless build), set a single pixel so model is visible
-			bitmap->AllocDummy(SColor(255 * (texNum == 0), 0, 0, 255 * (1 - invertAlpha)));
-		}
+		LOG_L(L_WARNING, "[%s] texture \"%s\" of model \"%s\" was not preloaded, loading it now", __func__, textureName.c_str(), model->name.c_str());
 
-		if (invertAxis)
-			bitmap->ReverseYAxis();
-		if (invertAlpha)
-			bitmap->InvertAlpha();
+		bitmapIt = bitmapCache.emplace(textureName, {}).first;
+		LoadBitmap(model, texNum, flags.first, flags.second && (texNum == 0), bitmapIt->second);
 	}
 
-	// don't generate a texture yet, just save the bitmap for later
-	if (preloadCall)
-		return 0;
+	CBitmap* bitmap = &(bitmapIt->second);
 
 	const unsigned int texID = bitmap->CreateMipMapTexture();
 
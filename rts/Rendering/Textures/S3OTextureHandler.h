@@ -50,23 +50,28 @@ public:
 	}
 
 private:
-	unsigned int LoadAndCacheTexture(
+	void PreloadBitmap(const S3DModel* model, unsigned int texNum, bool invertAxis, bool invertAlpha);
+	void LoadBitmap(
 		const S3DModel* model,
 		unsigned int texNum,
 		bool invertAxis,
 		bool invertAlpha,
-		bool preloadCall
+		CBitmap& bitmap
 	);
+
+	unsigned int LoadAndCacheTexture(const S3DModel* model, unsigned int texNum);
 	unsigned int InsertTextureMat(const S3DModel* model);
 
 private:
 	typedef spring::unsynced_map<std::string, CachedS3OTex> TextureCache;
 	typedef spring::unsynced_map<std::string, CBitmap> BitmapCache;
 	typedef spring::unsynced_map<std::uint64_t, unsigned int> TextureTable;
+	typedef spring::unsynced_map<std::string, std::pair<bool, bool> > BitmapFlags;
 
 	TextureCache textureCache; // stores individual primary- and secondary-textures by name
 	TextureTable textureTable; // stores (primary, secondary) texture-pairs by unique ident
 	BitmapCache bitmapCache;
+	BitmapFlags bitmapFlags; // (invertAxis, invertAlpha) each texture was first preloaded with
 
 	spring::mutex cacheMutex;
 
@@ -459,10 +459,15 @@ void CUnitDrawer::Draw(bool drawReflection, bool drawRefraction)
 void CUnitDrawer::DrawOpaquePass(bool deferredPass, bool drawReflection, bool drawRefraction)
 {
 	SetupOpaqueDrawing(deferredPass);
+	CullOpaqueUnits(drawReflection, drawRefraction);
+
+	for (CUnit* unit: unitDrawList.GetFarObjects()) {
+		farTextureHandler->Queue(unit);
+	}
 
 	for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
 		PushModelRenderState(modelType);
-		DrawOpaqueUnits(modelType, drawReflection, drawRefraction);
+		DrawOpaqueUnits(modelType);
 		DrawOpaqueAIUnits(modelType);
 		PopModelRenderState(modelType);
 	}
@@ -476,30 +481,21 @@ void CUnitDrawer::DrawOpaquePass(bool deferredPass, bool drawReflection, bool dr
 
 
 
-void CUnitDrawer::DrawOpaqueUnits(int modelType, bool drawReflection, bool drawRefraction)
+void CUnitDrawer::DrawOpaqueUnits(int modelType)
 {
-	const auto& mdlRenderer = opaqueModelRenderers[modelType];
-	// const auto& unitBinKeys = mdlRenderer.GetObjectBinKeys();
+	for (unsigned int i = 0, n = unitDrawList.GetNumObjectBins(modelType); i < n; i++) {
+		const auto& bin = unitDrawList.GetObjectBin(modelType, i);
 
-	for (unsigned int i = 0, n = mdlRenderer.GetNumObjectBins(); i < n; i++) {
-		BindModelTypeTexture(modelType, mdlRenderer.GetObjectBinKey(i));
+		BindModelTypeTexture(modelType, bin.key);
 
-		for (CUnit* unit: mdlRenderer.GetObjectBin(i)) {
-			DrawOpaqueUnit(unit, drawReflection, drawRefraction);
+		for (CUnit* unit: bin.objects) {
+			DrawOpaqueUnit(unit);
 		}
 	}
 }
 
-inline void CUnitDrawer::DrawOpaqueUnit(CUnit* unit, bool drawReflection, bool drawRefraction)
+inline void CUnitDrawer::DrawOpaqueUnit(CUnit* unit)
 {
-	if (!CanDrawOpaqueUnit(unit, drawReflection, drawRefraction))
-		return;
-
-	if ((unit->pos).SqDistance(camera->GetPos()) > (unit->sqRadius * unitDrawDistSqr)) {
-		farTextureHandler->Queue(unit);
-		return;
-	}
-
 	if (LuaObjectDrawer::AddOpaqueMaterialObject(unit, LUAOBJ_UNIT))
 		return;
 
@@ -621,6 +617,56 @@ void CUnitDrawer::DrawUnitIconsScreen()
 /******************************************************************************/
 /******************************************************************************/
 
+void CUnitDrawer::CullOpaqueUnits(bool drawReflection, bool drawRefraction)
+{
+	const float3 camPos = (CCameraHandler::GetActiveCamera())->GetPos();
+
+	unitDrawList.Clear();
+
+	for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
+		unitDrawList.AddObjects(modelType, opaqueModelRenderers[modelType]);
+	}
+
+	unitDrawList.Cull([&](const CUnit* unit) {
+		if (!CanDrawOpaqueUnit(unit, drawReflection, drawRefraction))
+			return MODEL_DRAW_CULL;
+
+		if ((unit->pos).SqDistance(camPos) > (unit->sqRadius * unitDrawDistSqr))
+			return MODEL_DRAW_FAR;
+
+		return MODEL_DRAW_NEAR;
+	});
+}
+
+void CUnitDrawer::CullOpaqueUnitsShadow()
+{
+	unitDrawList.Clear();
+
+	for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
+		unitDrawList.AddObjects(modelType, opaqueModelRenderers[modelType]);
+	}
+
+	unitDrawList.Cull([&](const CUnit* unit) {
+		return (CanDrawOpaqueUnitShadow(unit)? MODEL_DRAW_NEAR: MODEL_DRAW_CULL);
+	});
+}
+
+void CUnitDrawer::CullAlphaUnits()
+{
+	const CCamera* cam = CCameraHandler::GetActiveCamera();
+
+	unitDrawList.Clear();
+
+	for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
+		unitDrawList.AddObjects(modelType, alphaModelRenderers[modelType]);
+	}
+
+	unitDrawList.Cull([&](const CUnit* unit) {
+		return (cam->InView(unit->drawMidPos, unit->GetDrawRadius())? MODEL_DRAW_NEAR: MODEL_DRAW_CULL);
+	});
+}
+
+
 bool CUnitDrawer::CanDrawOpaqueUnit(
 	const CUnit* unit,
 	bool drawReflection,
@@ -675,9 +721,6 @@ bool CUnitDrawer::CanDrawOpaqueUnitShadow(const CUnit* unit) const
 
 
 void CUnitDrawer::DrawOpaqueUnitShadow(CUnit* unit) {
-	if (!CanDrawOpaqueUnitShadow(unit))
-		return;
-
 	if (LuaObjectDrawer::AddShadowMaterialObject(unit, LUAOBJ_UNIT))
 		return;
 
@@ -686,15 +729,14 @@ void CUnitDrawer::DrawOpaqueUnitShadow(CUnit* unit) {
 
 
 void CUnitDrawer::DrawOpaqueUnitsShadow(int modelType) {
-	const auto& mdlRenderer = opaqueModelRenderers[modelType];
-	// const auto& unitBinKeys = mdlRenderer.GetObjectBinKeys();
+	for (unsigned int i = 0, n = unitDrawList.GetNumObjectBins(modelType); i < n; i++) {
+		const auto& bin = unitDrawList.GetObjectBin(modelType, i);
 
-	for (unsigned int i = 0, n = mdlRenderer.GetNumObjectBins(); i < n; i++) {
 		// only need to bind the atlas once for 3DO's, but KISS
-		assert((modelType != MODELTYPE_3DO) || (mdlRenderer.GetObjectBinKey(i) == 0));
-		shadowTexBindFuncs[modelType](textureHandlerS3O.GetTexture(mdlRenderer.GetObjectBinKey(i)));
+		assert((modelType != MODELTYPE_3DO) || (bin.key == 0));
+		shadowTexBindFuncs[modelType](textureHandlerS3O.GetTexture(bin.key));
 
-		for (CUnit* unit: mdlRenderer.GetObjectBin(i)) {
+		for (CUnit* unit: bin.objects) {
 			DrawOpaqueUnitShadow(unit);
 		}
 
@@ -719,6 +761,8 @@ void CUnitDrawer::DrawShadowPass()
 	{
 		assert((CCameraHandler::GetActiveCamera())->GetCamType() == CCamera::CAMTYPE_SHADOW);
 
+		CullOpaqueUnitsShadow();
+
 		// 3DO's have clockwise-wound faces and
 		// (usually) holes, so disable backface
 		// culling for them
@@ -884,6 +928,7 @@ void CUnitDrawer::DrawAlphaPass()
 {
 	{
 		SetupAlphaDrawing(false);
+		CullAlphaUnits();
 
 		if (UseAdvShading())
 			glDisable(GL_ALPHA_TEST);
@@ -908,13 +953,12 @@ void CUnitDrawer::DrawAlphaPass()
 void CUnitDrawer::DrawAlphaUnits(int modelType)
 {
 	{
-		const auto& mdlRenderer = alphaModelRenderers[modelType];
-		// const auto& unitBinKeys = mdlRenderer.GetObjectBinKeys();
+		for (unsigned int i = 0, n = unitDrawList.GetNumObjectBins(modelType); i < n; i++) {
+			const auto& bin = unitDrawList.GetObjectBin(modelType, i);
 
-		for (unsigned int i = 0, n = mdlRenderer.GetNumObjectBins(); i < n; i++) {
-			BindModelTypeTexture(modelType, mdlRenderer.GetObjectBinKey(i));
+			BindModelTypeTexture(modelType, bin.key);
 
-			for (CUnit* unit: mdlRenderer.GetObjectBin(i)) {
+			for (CUnit* unit: bin.objects) {
 				DrawAlphaUnit(unit, modelType, false);
 			}
 		}
@@ -926,9 +970,6 @@ void CUnitDrawer::DrawAlphaUnits(int modelType)
 }
 
 inline void CUnitDrawer::DrawAlphaUnit(CUnit* unit, int modelType, bool drawGhostBuildingsPass) {
-	if (!camera->InView(unit->drawMidPos, unit->GetDrawRadius()))
-		return;
-
 	if (LuaObjectDrawer::AddAlphaMaterialObject(unit, LUAOBJ_UNIT))
 		return;
 
@@ -1096,6 +1137,9 @@ void CUnitDrawer::DrawGhostedBuildings(int modelType)
 	}
 
 	for (CUnit* u: liveGhostedBuildings) {
+		if (!camera->InView(u->drawMidPos, u->GetDrawRadius()))
+			continue;
+
 		DrawAlphaUnit(u, modelType, true);
 	}
 }
@@ -8,6 +8,7 @@
 
 #include "Rendering/GL/LightHandler.h"
 #include "Rendering/Models/3DModel.h"
+#include "Rendering/Models/ModelDrawList.h"
 #include "Rendering/Models/ModelRenderContainer.h"
 #include "Rendering/UnitDrawerState.hpp"
 #include "Rendering/UnitDefImage.h"
@@ -209,10 +210,15 @@ private:
 	bool CanDrawOpaqueUnit(const CUnit* unit, bool drawReflection, bool drawRefraction) const;
 	bool CanDrawOpaqueUnitShadow(const CUnit* unit) const;
 
-	void DrawOpaqueUnit(CUnit* unit, bool drawReflection, bool drawRefraction);
+	/// fill unitDrawList for the active camera, see ModelDrawList
+	void CullOpaqueUnits(bool drawReflection, bool drawRefraction);
+	void CullOpaqueUnitsShadow();
+	void CullAlphaUnits();
+
+	void DrawOpaqueUnit(CUnit* unit);
 	void DrawOpaqueUnitShadow(CUnit* unit);
 	void DrawOpaqueUnitsShadow(int modelType);
-	void DrawOpaqueUnits(int modelType, bool drawReflection, bool drawRefraction);
+	void DrawOpaqueUnits(int modelType);
 
 	void DrawAlphaUnits(int modelType);
 	void DrawAlphaUnit(CUnit* unit, int modelType, bool drawGhostBuildingsPass);
@@ -304,6 +310,9 @@ private:
 	std::array<ModelRenderContainer<CUnit>, MODELTYPE_OTHER> opaqueModelRenderers;
 	std::array<ModelRenderContainer<CUnit>, MODELTYPE_OTHER> alphaModelRenderers;
 
+	/// units that passed culling for the current pass and camera
+	ModelDrawList<CUnit> unitDrawList;
+
 	/// units being rendered (note that this is a completely
 	/// unsorted set of 3DO, S3O, opaque, and cloaked models!)
 	std::vector<CUnit*> unsortedUnits;
@@ -6,16 +6,20 @@
 #include "Lua/LuaParser.h"
 #include "Map/ReadMap.h"
 #include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/CommonDefHandler.h"
 #include "Sim/Objects/SolidObject.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
+#include "System/UnorderedSet.hpp"
+#include "System/Misc/SpringTime.h"
 
 static CFeatureDefHandler gFeatureDefHandler;
 CFeatureDefHandler* featureDefHandler = &gFeatureDefHandler;
 
 void CFeatureDefHandler::Init(LuaParser* defsParser)
 {
+	const spring_time startTime = spring_gettime();
 	const LuaTable rootTable = defsParser->GetRoot().SubTable("FeatureDefs");
 
 	if (!rootTable.IsValid())
@@ -27,20 +31,48 @@ void CFeatureDefHandler::Init(LuaParser* defsParser)
 
 	// FeatureDef ID's start with 1
 	featureDefIDs.reserve(keys.size());
-	featureDefsVector.reserve(keys.size());
+	featureDefsVector.reserve(keys.size() + 1);
 	featureDefsVector.emplace_back();
 
-	for (unsigned int i = 0; i < keys.size(); i++) {
-		const std::string& nameMixedCase = keys[i];
-		const std::string& nameLowerCase = StringToLower(nameMixedCase);
-		const LuaTable& fdTable = rootTable.SubTable(nameMixedCase);
+	// defs are parsed on the thread-pool, which can not touch the lua_State
+	const LuaTable rootSnapshot = rootTable.Snapshot();
+	const spring_time parseTime = spring_gettime();
+
+	// keys that differ only in case name the same def; the first one wins
+	std::vector<size_t> defKeyIndices;
+	spring::unordered_set<std::string> defNames;
+
+	defKeyIndices.reserve(keys.size());
+	defNames.reserve(keys.size());
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		const std::string& nameLowerCase = StringToLower(keys[i]);
 
-		AddFeatureDef(nameLowerCase, CreateFeatureDef(fdTable, nameLowerCase), false);
+		if (!defNames.insert(nameLowerCase).second)
+			continue;
+
+		defKeyIndices.push_back(i);
+		GetNewFeatureDef().name = nameLowerCase;
+	}
+
+	std::vector<CommonDefHandler::DefParseResult> parseResults(defKeyIndices.size());
+
+	CommonDefHandler::ParseDefsParallel(parseResults, [&](const int i) {
+		ParseFeatureDef(featureDefsVector[i + 1], rootSnapshot.SubTable(keys[ defKeyIndices[i] ]));
+	});
+
+	const spring_time commitTime = spring_gettime();
+
+	for (size_t i = 0; i < defKeyIndices.size(); i++) {
+		FeatureDef& fd = featureDefsVector[i + 1];
+
+		parseResults[i].Commit();
+		AddFeatureDef(fd.name, &fd, false);
 	}
 	for (unsigned int i = 0; i < keys.size(); i++) {
 		const std::string& nameMixedCase = keys[i];
 		const std::string& nameLowerCase = StringToLower(nameMixedCase);
-		const LuaTable& fdTable = rootTable.SubTable(nameMixedCase);
+		const LuaTable& fdTable = rootSnapshot.SubTable(nameMixedCase);
 
 		const FeatureDef* fd = GetFeatureDef(nameLowerCase);
 		const FeatureDef* dfd = GetFeatureDef(fdTable.GetString("featureDead", ""));
@@ -53,6 +85,14 @@ void CFeatureDefHandler::Init(LuaParser* defsParser)
 
 		const_cast<FeatureDef*>(fd)->deathFeatureDefID = dfd->id;
 	}
+
+	LOG("[FeatureDefHandler::%s] loaded %u FeatureDefs in %ims (snapshot=%ims parse=%ims commit=%ims)", __func__,
+		uint32_t(featureDefsVector.size() - 1),
+		int((spring_gettime() - startTime).toMilliSecsi()),
+		int((parseTime - startTime).toMilliSecsi()),
+		int((commitTime - parseTime).toMilliSecsi()),
+		int((spring_gettime() - commitTime).toMilliSecsi())
+	);
 }
 
 
@@ -80,16 +120,8 @@ FeatureDef& CFeatureDefHandler::GetNewFeatureDef()
 }
 
 
-FeatureDef* CFeatureDefHandler::CreateFeatureDef(const LuaTable& fdTable, const std::string& mixedCase)
+void CFeatureDefHandler::ParseFeatureDef(FeatureDef& fd, const LuaTable& fdTable)
 {
-	const std::string& name = StringToLower(mixedCase);
-
-	if (featureDefIDs.find(name) != featureDefIDs.end())
-		return nullptr;
-
-	FeatureDef& fd = GetNewFeatureDef();
-
-	fd.name = name;
 	fd.description = fdTable.GetString("description", "");
 
 	fd.collidable    =  fdTable.GetBool("blocking",        true);
@@ -142,8 +174,6 @@ FeatureDef* CFeatureDefHandler::CreateFeatureDef(const LuaTable& fdTable, const
 
 	// custom parameters table
 	fdTable.SubTable("customParams").GetMap(fd.customParams);
-
-	return &fd;
 }
 
 
@@ -48,7 +48,8 @@ private:
 
 	FeatureDef* CreateDefaultTreeFeatureDef(const std::string& name);
 	FeatureDef* CreateDefaultGeoFeatureDef(const std::string& name);
-	FeatureDef* CreateFeatureDef(const LuaTable& luaTable, const std::string& name);
+	// fills in everything but the name; must not touch handler state
+	static void ParseFeatureDef(FeatureDef& fd, const LuaTable& fdTable);
 
 	FeatureDef& GetNewFeatureDef();
 
@@ -11,6 +11,7 @@
 #include "Sim/Units/CommandAI/BuilderCAI.h"
 #include "System/creg/STL_Set.h"
 #include "System/EventHandler.h"
+#include "System/Sync/SyncedPrimitiveBase.h"
 #include "System/TimeProfiler.h"
 
 /******************************************************************************/
@@ -185,6 +186,8 @@ void CFeatureHandler::Update()
 		deletedFeatureIDs.erase(iter, deletedFeatureIDs.end());
 	}
 	{
+		SYNC_DEBUG_PHASE(SYNC_PHASE_FEATURE_UPDATES);
+
 		const auto& pred = [this](CFeature* feature) { return (this->UpdateFeature(feature)); };
 		const auto& iter = std::remove_if(updateFeatures.begin(), updateFeatures.end(), pred);
 
@@ -212,6 +215,7 @@ bool CFeatureHandler::TryFreeFeatureID(int id)
 bool CFeatureHandler::UpdateFeature(CFeature* feature)
 {
 	assert(feature->inUpdateQue);
+	SYNC_DEBUG_OBJECT(feature->id);
 
 	if (feature->deleteMe) {
 		eventHandler.RenderFeatureDestroyed(feature);
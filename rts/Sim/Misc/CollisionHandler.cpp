@@ -258,34 +258,51 @@ bool CCollisionHandler::IntersectPiecesHelper(
 	const float3& p1,
 	CollisionQuery* cq
 ) {
+	const LocalModel& lm = o->localModel;
+	const CPieceBVH& bvh = lm.GetPieceBVH();
+
+	// the hierarchy lives in model-space
+	const CMatrix44f mInv = m.InvertAffine();
+	const float3 mp0 = mInv.Mul(p0);
+	const float3 mp1 = mInv.Mul(p1);
+
 	CMatrix44f volMat;
 
 	float minDistSq = std::numeric_limits<float>::max();
 	float curDistSq = minDistSq;
 
-	for (unsigned int n = 0; n < o->localModel.pieces.size(); n++) {
-		const LocalModelPiece* lmp = o->localModel.GetPiece(n);
+	int minPieceIdx = -1;
+
+	// only pieces whose bounds the segment overlaps are visited (in no
+	// particular order), the result is the same as testing all of them
+	const auto testPiece = [&](int n) {
+		const LocalModelPiece* lmp = lm.GetPiece(n);
 		const CollisionVolume* lmpVol = lmp->GetCollisionVolume();
 
 		if (!lmp->scriptSetVisible || lmpVol->IgnoreHits())
-			continue;
+			return false;
 
 		volMat = m * lmp->GetModelSpaceMatrix();
 		volMat.Translate(lmpVol->GetOffsets());
 
 		CollisionQuery cqn;
 		if (!CCollisionHandler::Intersect(lmpVol, volMat, p0, p1, &cqn))
-			continue;
+			return false;
 
 		// skip if neither an ingress nor an egress hit
 		if (!cqn.AnyHit())
-			continue;
+			return false;
 
-		// save the closest intersection (others are not needed)
-		if ((curDistSq = (cqn.GetHitPos()).SqDistance(p0)) >= minDistSq)
-			continue;
+		// save the closest intersection (others are not needed); among
+		// equally close ones the lowest piece index wins as if visiting
+		// the pieces in order
+		if ((curDistSq = (cqn.GetHitPos()).SqDistance(p0)) > minDistSq)
+			return false;
+		if (curDistSq == minDistSq && (minPieceIdx < 0 || n > minPieceIdx))
+			return false;
 
 		minDistSq = curDistSq;
+		minPieceIdx = n;
 
 		// return early if caller only wants to know a collision exists
 		if (cq == nullptr)
@@ -293,7 +310,11 @@ bool CCollisionHandler::IntersectPiecesHelper(
 
 		*cq = cqn;
 		cq->SetHitPiece(lmp);
-	}
+		return false;
+	};
+
+	if (bvh.QuerySegment(mp0, mp1, testPiece))
+		return true;
 
 	// true iff at least one piece was intersected
 	// (query must have been reset by calling code)
@@ -9,13 +9,18 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/Sound/ISound.h"
+#include "System/Log/Backend.h"
 #include "System/Log/ILog.h"
+#include "System/Threading/ThreadPool.h"
 
 static const std::array<std::string, 2> soundExts = {{"wav", "ogg"}};
 
 // UnitDef and WeaponDef sound-sets; [0] is always a dummy
 static std::vector<GuiSoundSetData> soundSetData;
 
+// result of the def currently being parsed by this thread
+static thread_local CommonDefHandler::DefParseResult* curParseResult = nullptr;
+
 
 void CommonDefHandler::InitStatic()
 {
@@ -73,3 +78,38 @@ int CommonDefHandler::LoadSoundFile(const std::string& fileName)
 
 	return 0;
 }
+
+
+
+static void log_sink_record_defParseResult(int level, const char* section, const char* record)
+{
+	assert(curParseResult != nullptr);
+	curParseResult->logRecords.push_back({level, section, record});
+}
+
+void CommonDefHandler::DefParseResult::Commit() const
+{
+	for (const LogRecord& record: logRecords) {
+		LOG_SI(record.section, record.level, "%s", record.text.c_str());
+	}
+
+	if (exception != nullptr)
+		std::rethrow_exception(exception);
+}
+
+void CommonDefHandler::ParseDefsParallel(std::vector<DefParseResult>& results, const std::function<void(int)>& parseFunc)
+{
+	for_mt(0, results.size(), [&](const int i) {
+		curParseResult = &results[i];
+		log_backend_setThreadSink(&log_sink_record_defParseResult);
+
+		try {
+			parseFunc(i);
+		} catch (...) {
+			results[i].exception = std::current_exception();
+		}
+
+		log_backend_setThreadSink(nullptr);
+		curParseResult = nullptr;
+	});
+}
@@ -3,7 +3,10 @@
 #ifndef COMMON_DEF_HANDLER_H
 #define COMMON_DEF_HANDLER_H
 
+#include <exception>
+#include <functional>
 #include <string>
+#include <vector>
 
 struct GuiSoundSet;
 struct GuiSoundSetData;
@@ -21,6 +24,35 @@ public:
 
 	// loads a soundfile, adds "sounds/" prefix and ".wav" extension if necessary
 	static int LoadSoundFile(const std::string& fileName);
+
+	// outcome of parsing one def on a worker thread; its log output and
+	// any exception are held back until the loading thread commits defs
+	// in id-order (keeps the log and error handling identical to serial)
+	struct DefParseResult {
+	public:
+		// logs the deferred records, then rethrows the exception (if any)
+		void Commit() const;
+
+	public:
+		struct LogRecord {
+			int level;
+			const char* section;
+			std::string text;
+		};
+
+		std::vector<LogRecord> logRecords;
+		std::exception_ptr exception;
+	};
+
+	// runs parseFunc(i) for every i in [0, results.size()) on the thread-pool;
+	// parseFunc may only read LuaTable snapshots and must not touch anything
+	// whose state depends on the order in which defs are processed
+	//
+	// collision- and selection-volumes are parsed by parseFunc and so also
+	// run here, but models are not: defs only hold their name and load the
+	// model lazily (or through CModelLoader::PreloadModels), which needs the
+	// model-loader's own locking and is not part of def parsing
+	static void ParseDefsParallel(std::vector<DefParseResult>& results, const std::function<void(int)>& parseFunc);
 };
 
 #endif
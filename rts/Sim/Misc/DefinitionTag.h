@@ -267,7 +267,9 @@ private:
 	unsigned int metaDataMemIdx = 0;
 
 	const char* name = nullptr;
-	const LuaTable* luaTable = nullptr;
+
+	// table being loaded by the calling thread; defs can be parsed in parallel
+	static thread_local const LuaTable* luaTable;
 
 private:
 	static std::vector<const DefType*>& GetTypes() {
@@ -48,6 +48,15 @@ static constexpr int UNIT_SLOWUPDATE_RATE = 15;
  */
 static constexpr int TEAM_SLOWUPDATE_RATE = 30;
 
+/**
+ * @brief sync-check timeout
+ *
+ * Defines the number of sim-frames the server waits for a client's
+ * sync-response to a frame before it checks the frame without it, and
+ * thereby the latest a desync can be noticed.
+ */
+static constexpr int SYNCCHECK_TIMEOUT = 300;
+
 
 /**
  * @brief max teams
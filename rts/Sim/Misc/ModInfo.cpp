@@ -97,6 +97,7 @@ void CModInfo::ResetState()
 		pfUpdateRate     = 0.007f;
 
 		allowTake = true;
+		parallelCobThreads = false;
 	}
 }
 
@@ -136,6 +137,7 @@ void CModInfo::Init(const std::string& modFileName)
 		pfUpdateRate = system.GetFloat("pathFinderUpdateRate", pfUpdateRate);
 
 		allowTake = system.GetBool("allowTake", allowTake);
+		parallelCobThreads = system.GetBool("parallelCobThreads", parallelCobThreads);
 	}
 
 	{
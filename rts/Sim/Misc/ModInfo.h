@@ -163,6 +163,9 @@ public:
 	float pfUpdateRate;
 
 	bool allowTake;
+
+	/// if true, COB threads of different units are ticked in parallel
+	bool parallelCobThreads;
 };
 
 extern CModInfo modInfo;
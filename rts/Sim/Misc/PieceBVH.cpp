@@ -0,0 +1,98 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PieceBVH.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+void CPieceBVH::Build()
+{
+	nodes.clear();
+
+	if (pieceMins.empty())
+		return;
+
+	std::vector<int> indices(pieceMins.size());
+
+	for (size_t n = 0; n < indices.size(); n++) {
+		indices[n] = n;
+	}
+
+	// binary tree with one piece per leaf
+	nodes.reserve(indices.size() * 2 - 1);
+
+	BuildRec(indices, 0, indices.size());
+	Refit();
+}
+
+int CPieceBVH::BuildRec(std::vector<int>& indices, int first, int count)
+{
+	const int nodeIndex = nodes.size();
+
+	nodes.emplace_back();
+
+	if (count == 1) {
+		nodes[nodeIndex].pieceIndex = indices[first];
+		return nodeIndex;
+	}
+
+	// split along the longest axis of the centroids' extent
+	float3 cmins = pieceMins[indices[first]] + pieceMaxs[indices[first]];
+	float3 cmaxs = cmins;
+
+	for (int n = first + 1; n < (first + count); n++) {
+		const float3 c = pieceMins[indices[n]] + pieceMaxs[indices[n]];
+
+		cmins = float3::min(cmins, c);
+		cmaxs = float3::max(cmaxs, c);
+	}
+
+	const float3 cext = cmaxs - cmins;
+	const int axis = (cext.x >= cext.y && cext.x >= cext.z)? 0: ((cext.y >= cext.z)? 1: 2);
+
+	// median split keeps the tree balanced even for degenerate poses
+	// (e.g. all pieces at the origin), ties are broken by piece index
+	// so the topology does not depend on the sort implementation
+	const auto pred = [&](int a, int b) {
+		const float ca = pieceMins[a][axis] + pieceMaxs[a][axis];
+		const float cb = pieceMins[b][axis] + pieceMaxs[b][axis];
+		return (ca < cb || (ca == cb && a < b));
+	};
+
+	const int half = count / 2;
+
+	std::nth_element(indices.begin() + first, indices.begin() + first + half, indices.begin() + first + count, pred);
+
+	BuildRec(indices, first, half);
+
+	const int rightChild = BuildRec(indices, first + half, count - half);
+
+	nodes[nodeIndex].rightChild = rightChild;
+	return nodeIndex;
+}
+
+void CPieceBVH::Refit()
+{
+	// children are always stored after their parent, so a reverse
+	// pass visits each node only after both of its children
+	for (size_t n = nodes.size(); n > 0; n--) {
+		Node& node = nodes[n - 1];
+
+		if (node.pieceIndex >= 0) {
+			const float3& mins = pieceMins[node.pieceIndex];
+			const float3& maxs = pieceMaxs[node.pieceIndex];
+			const float3  pads = (maxs - mins) * BOUNDS_PAD_REL + BOUNDS_PAD_ABS;
+
+			node.mins = mins - pads;
+			node.maxs = maxs + pads;
+			continue;
+		}
+
+		const Node& lc = nodes[n    ];
+		const Node& rc = nodes[node.rightChild];
+
+		node.mins = float3::min(lc.mins, rc.mins);
+		node.maxs = float3::max(lc.maxs, rc.maxs);
+	}
+}
@@ -0,0 +1,152 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PIECE_BVH_H
+#define PIECE_BVH_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "System/float3.h"
+
+/**
+ * Bounding-volume hierarchy over the (collision-volume) bounds of a model's
+ * pieces, all in model-space. The topology is built once from the initial
+ * pose, after that pieces only move so Refit is enough to keep every node
+ * enclosing its subtree; ray-queries then descend only into the nodes that
+ * the segment overlaps instead of testing each piece.
+ */
+class CPieceBVH {
+public:
+	struct Node {
+		float3 mins;
+		float3 maxs;
+
+		// leafs: index of the piece; inner nodes: -1
+		int pieceIndex = -1;
+		// inner nodes only, the left child always directly follows its parent
+		int rightChild = -1;
+	};
+
+	// padding added to each piece's bounds in Refit, keeps the culling
+	// conservative wrt. rounding in the exact per-piece intersection tests
+	static constexpr float BOUNDS_PAD_ABS = 0.5f;
+	static constexpr float BOUNDS_PAD_REL = 0.01f;
+
+public:
+	void Clear() {
+		nodes.clear();
+		pieceMins.clear();
+		pieceMaxs.clear();
+	}
+
+	// (re)allocates the per-piece bounds; these must all be set before Build
+	void Init(unsigned int numPieces) {
+		nodes.clear();
+		pieceMins.clear();
+		pieceMins.resize(numPieces, ZeroVector);
+		pieceMaxs.clear();
+		pieceMaxs.resize(numPieces, ZeroVector);
+	}
+
+	void SetPieceBounds(unsigned int pieceIndex, const float3& mins, const float3& maxs) {
+		pieceMins[pieceIndex] = mins;
+		pieceMaxs[pieceIndex] = maxs;
+	}
+
+	// creates the topology from the current piece bounds, then refits
+	void Build();
+	// recalculates the bounds of all nodes from the current piece bounds
+	void Refit();
+
+	/**
+	 * Calls <func(pieceIndex)> for every piece whose (padded) bounds are
+	 * overlapped by the segment <p0, p1>, in no particular order. Stops
+	 * early if <func> returns true.
+	 * @return true iff <func> did
+	 */
+	template<typename F> bool QuerySegment(const float3& p0, const float3& p1, F&& func) const;
+
+	const std::vector<Node>& GetNodes() const { return nodes; }
+	unsigned int GetNumPieces() const { return pieceMins.size(); }
+
+	static bool SegmentOverlapsBox(const float3& p0, const float3& dir, const float3& mins, const float3& maxs);
+
+private:
+	int BuildRec(std::vector<int>& indices, int first, int count);
+
+private:
+	std::vector<Node> nodes;
+
+	std::vector<float3> pieceMins;
+	std::vector<float3> pieceMaxs;
+};
+
+
+inline bool CPieceBVH::SegmentOverlapsBox(const float3& p0, const float3& dir, const float3& mins, const float3& maxs)
+{
+	float tmin = 0.0f;
+	float tmax = 1.0f;
+
+	for (int i = 0; i < 3; i++) {
+		// (nearly) parallel to this slab; the padding covers the rest
+		if (std::fabs(dir[i]) < 1e-6f) {
+			if (p0[i] < mins[i] || p0[i] > maxs[i])
+				return false;
+
+			continue;
+		}
+
+		const float invd = 1.0f / dir[i];
+
+		float t0 = (mins[i] - p0[i]) * invd;
+		float t1 = (maxs[i] - p0[i]) * invd;
+
+		if (t0 > t1)
+			std::swap(t0, t1);
+
+		tmin = std::max(tmin, t0);
+		tmax = std::min(tmax, t1);
+
+		if (tmin > tmax)
+			return false;
+	}
+
+	return true;
+}
+
+template<typename F>
+inline bool CPieceBVH::QuerySegment(const float3& p0, const float3& p1, F&& func) const
+{
+	if (nodes.empty())
+		return false;
+
+	const float3 dir = p1 - p0;
+
+	// Build splits at the median, so depth stays below log2(#pieces) + 1
+	int stack[64];
+	int depth = 0;
+
+	stack[depth++] = 0;
+
+	while (depth > 0) {
+		const Node& node = nodes[stack[--depth]];
+
+		if (!SegmentOverlapsBox(p0, dir, node.mins, node.maxs))
+			continue;
+
+		if (node.pieceIndex >= 0) {
+			if (func(node.pieceIndex))
+				return true;
+
+			continue;
+		}
+
+		stack[depth++] = node.rightChild;
+		stack[depth++] = &node - &nodes[0] + 1;
+	}
+
+	return false;
+}
+
+#endif // PIECE_BVH_H
@@ -579,6 +579,40 @@ void CQuadField::GetUnitsExact(QuadFieldQuery& qfq, const float3& pos, float rad
 	return;
 }
 
+void CQuadField::GetAllyUnitsExact(QuadFieldQuery& qfq, const float3& pos, float radius, int allyTeam, bool allied, bool spherical)
+{
+	QuadFieldQuery qfQuery;
+	GetQuads(qfQuery, pos, radius);
+	const int tempNum = gs->GetTempNum();
+	qfq.units = tempUnits.ReserveVector();
+
+	// walks the same lists in the same order as GetUnitsExact (rather than
+	// Quad::teamUnits) so callers breaking ties by order see identical results
+	for (const int qi: *qfQuery.quads) {
+		for (CUnit* u: baseQuads[qi].units) {
+			if (teamHandler.Ally(allyTeam, u->allyteam) != allied)
+				continue;
+			if (u->tempNum == tempNum)
+				continue;
+
+			u->tempNum = tempNum;
+
+			const float totRad       = radius + u->radius;
+			const float totRadSq     = totRad * totRad;
+			const float posUnitDstSq = spherical?
+				pos.SqDistance(u->pos):
+				pos.SqDistance2D(u->pos);
+
+			if (posUnitDstSq >= totRadSq)
+				continue;
+
+			qfq.units->push_back(u);
+		}
+	}
+
+	return;
+}
+
 void CQuadField::GetUnitsExact(QuadFieldQuery& qfq, const float3& mins, const float3& maxs)
 {
 	QuadFieldQuery qfQuery;
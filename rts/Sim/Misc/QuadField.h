@@ -115,6 +115,11 @@ public:
  	 * and performs the search within a sphere or cylinder depending on @c spherical
 	 */
 	void GetUnitsExact(QuadFieldQuery& qfq, const float3& pos, float radius, bool spherical = true);
+	/**
+	 * As above, but only returns units of allyteams that are allied (if
+	 * @c allied) or not allied with @c allyTeam, in GetUnitsExact order
+	 */
+	void GetAllyUnitsExact(QuadFieldQuery& qfq, const float3& pos, float radius, int allyTeam, bool allied, bool spherical = true);
 	/**
 	 * Returns all units within the rectangle defined by
 	 * mins and maxs, which extends infinitely along the y-axis
@@ -0,0 +1,5 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "IPath.h"
+
+IPath::PoolStats IPath::poolStats;
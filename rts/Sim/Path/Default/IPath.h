@@ -3,7 +3,12 @@
 #ifndef IPATH_H
 #define IPATH_H
 
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
 #include <vector>
+
 #include "System/float3.h"
 #include "System/type2.h"
 
@@ -16,8 +21,210 @@ namespace IPath {
 		Error
 	};
 
-	typedef std::vector<float3> path_list_type;
-	typedef std::vector<int2> square_list_type;
+	// counters for the storage behind PooledList; logged by CPathManager
+	// so changes to path allocation behavior can be measured
+	struct PoolStats {
+		std::atomic<std::uint64_t> numAllocs = {0}; // buffers taken from the heap
+		std::atomic<std::uint64_t> numReuses = {0}; // buffers recycled from a thread's free-list
+		std::atomic<std::uint64_t> numGrows  = {0}; // reallocations of a buffer's storage
+		std::atomic<std::uint64_t> numCopies = {0}; // copy-on-write detaches
+		std::atomic<std::uint64_t> numShares = {0}; // copies that only took a reference
+	};
+
+	extern PoolStats poolStats;
+
+
+	// vector-like list whose storage is reference-counted and recycled
+	// through a per-thread free-list; copies (e.g. between CPathCache and
+	// a MultiPath) share the buffer until one side writes to it
+	//
+	// elements [0, size) of a shared buffer are never modified, which is
+	// what makes pop_back (the common operation on waypoint lists) free
+	// even while a cached copy of the path is still alive
+	template<typename T> class PooledList {
+	private:
+		struct Buffer {
+			std::atomic<std::uint32_t> numRefs = {1};
+			std::vector<T> data;
+		};
+
+		struct BufferPool {
+			~BufferPool() {
+				for (Buffer* b: buffers) {
+					delete b;
+				}
+			}
+
+			std::vector<Buffer*> buffers;
+		};
+
+		static constexpr size_t MAX_POOLED_BUFFERS = 1024;
+		static constexpr size_t MAX_POOLED_CAPACITY = 8192;
+
+	public:
+		typedef T value_type;
+		typedef const T* const_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		PooledList() = default;
+		PooledList(const PooledList& l) { *this = l; }
+		PooledList(PooledList&& l) { *this = std::move(l); }
+		~PooledList() { Release(); }
+
+		PooledList& operator = (const PooledList& l) {
+			if (this == &l)
+				return *this;
+
+			Release();
+
+			if ((buffer = l.buffer) != nullptr) {
+				buffer->numRefs.fetch_add(1);
+				poolStats.numShares.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			length = l.length;
+			return *this;
+		}
+		PooledList& operator = (PooledList&& l) {
+			if (this == &l)
+				return *this;
+
+			Release();
+
+			buffer = l.buffer;
+			length = l.length;
+
+			l.buffer = nullptr;
+			l.length = 0;
+			return *this;
+		}
+
+		bool empty() const { return (length == 0); }
+		size_t size() const { return length; }
+
+		const T& operator [] (size_t i) const { assert(i < length); return buffer->data[i]; }
+		const T& front() const { return (*this)[0]; }
+		const T& back() const { return (*this)[length - 1]; }
+
+		const_iterator begin() const { return ((buffer != nullptr)? buffer->data.data(): nullptr); }
+		const_iterator end() const { return (begin() + length); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		// writable access detaches a shared buffer first, so keep the
+		// const accessors for reads to avoid unnecessary copies
+		T& mutable_at(size_t i) { assert(i < length); MakeUnique(); return buffer->data[i]; }
+		T& mutable_front() { return (mutable_at(0)); }
+		T& mutable_back() { return (mutable_at(length - 1)); }
+
+		void clear() {
+			// keep an unshared buffer around for the next fill
+			if (buffer != nullptr && buffer->numRefs.load() > 1)
+				Release();
+
+			length = 0;
+		}
+		void reserve(size_t n) {
+			MakeUnique();
+
+			if (n > buffer->data.capacity())
+				poolStats.numGrows.fetch_add(1, std::memory_order_relaxed);
+
+			buffer->data.reserve(n);
+		}
+
+		void push_back(const T& v) { emplace_back(v); }
+		template<typename... A> void emplace_back(A&&... a) {
+			MakeUnique();
+
+			if (buffer->data.size() == buffer->data.capacity())
+				poolStats.numGrows.fetch_add(1, std::memory_order_relaxed);
+
+			buffer->data.emplace_back(std::forward<A>(a)...);
+			length += 1;
+		}
+		void pop_back() { assert(length > 0); length -= 1; }
+
+	private:
+		static BufferPool& GetPool() {
+			static thread_local BufferPool pool;
+			return pool;
+		}
+
+		static Buffer* AllocBuffer() {
+			BufferPool& pool = GetPool();
+
+			if (pool.buffers.empty()) {
+				poolStats.numAllocs.fetch_add(1, std::memory_order_relaxed);
+				return (new Buffer());
+			}
+
+			Buffer* b = pool.buffers.back();
+
+			pool.buffers.pop_back();
+			poolStats.numReuses.fetch_add(1, std::memory_order_relaxed);
+
+			b->numRefs.store(1);
+			return b;
+		}
+
+		static void FreeBuffer(Buffer* b) {
+			BufferPool& pool = GetPool();
+
+			if (pool.buffers.size() >= MAX_POOLED_BUFFERS || b->data.capacity() > MAX_POOLED_CAPACITY) {
+				delete b;
+				return;
+			}
+
+			b->data.clear();
+			pool.buffers.push_back(b);
+		}
+
+		void Release() {
+			if (buffer != nullptr && buffer->numRefs.fetch_sub(1) == 1)
+				FreeBuffer(buffer);
+
+			buffer = nullptr;
+			length = 0;
+		}
+
+		void MakeUnique() {
+			if (buffer == nullptr) {
+				buffer = AllocBuffer();
+				return;
+			}
+
+			if (buffer->numRefs.load() == 1) {
+				// drop elements popped by us but possibly still seen by former sharers
+				buffer->data.resize(length);
+				return;
+			}
+
+			Buffer* b = AllocBuffer();
+			b->data.assign(buffer->data.begin(), buffer->data.begin() + length);
+
+			poolStats.numCopies.fetch_add(1, std::memory_order_relaxed);
+
+			const size_t n = length;
+
+			Release();
+
+			buffer = b;
+			length = n;
+		}
+
+	private:
+		Buffer* buffer = nullptr;
+
+		// number of elements visible to *this* list, may be less than
+		// buffer->data.size() after pop_back or while sharing the buffer
+		size_t length = 0;
+	};
+
+
+	typedef PooledList<float3> path_list_type;
+	// squares fit in 16 bits per axis (see CPathManager ctor)
+	typedef PooledList<ushort2> square_list_type;
 
 	struct Path {
 		Path()
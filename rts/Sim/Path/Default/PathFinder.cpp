@@ -560,8 +560,9 @@ void CPathFinder::SmoothMidWaypoint(
 	if (blockStates.fCost[tstSqrIdx] > (COSTMOD * blockStates.fCost[prvSqrIdx]))
 		return;
 
+	// fetch the writable point first; it might detach the path's buffer
+	      float3& p1 = foundPath.path.mutable_at(foundPath.path.size() - 2);
 	const float3& p2 = foundPath.path[foundPath.path.size() - 3];
-	      float3& p1 = foundPath.path[foundPath.path.size() - 2];
 	const float3& p0 = foundPath.path[foundPath.path.size() - 1];
 
 	FixupPath3Pts(moveDef, p0, p1, p2);
@@ -1,5 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <cinttypes>
+
 #include "PathManager.h"
 #include "PathConstants.h"
 #include "PathFinder.h"
@@ -58,6 +60,15 @@ CPathManager::~CPathManager()
 	PathHeatMap::FreeInstance(pathHeatMap);
 	PathFlowMap::FreeInstance(pathFlowMap);
 	IPathFinder::KillStatic();
+
+	{
+		const IPath::PoolStats& ps = IPath::poolStats;
+
+		LOG(
+			"[%s] path-buffers: allocs=%" PRIu64 " reuses=%" PRIu64 " grows=%" PRIu64 " copies=%" PRIu64 " shares=%" PRIu64,
+			__func__, ps.numAllocs.load(), ps.numReuses.load(), ps.numGrows.load(), ps.numCopies.load(), ps.numShares.load()
+		);
+	}
 }
 
 
@@ -103,15 +114,17 @@ void CPathManager::FinalizePath(MultiPath* path, const float3 startPos, const fl
 		sp = &path->maxResPath;
 
 	if (!sp->path.empty()) {
-		sp->path.back() = startPos;
-		sp->path.back().y = CMoveMath::yLevel(*path->moveDef, sp->path.back());
+		float3& startPoint = sp->path.mutable_back();
+
+		startPoint = startPos;
+		startPoint.y = CMoveMath::yLevel(*path->moveDef, startPoint);
 	}
 
 	if (!path->maxResPath.path.empty() && !path->medResPath.path.empty())
-		path->medResPath.path.back() = path->maxResPath.path.front();
+		path->medResPath.path.mutable_back() = path->maxResPath.path.front();
 
 	if (!path->medResPath.path.empty() && !path->lowResPath.path.empty())
-		path->lowResPath.path.back() = path->medResPath.path.front();
+		path->lowResPath.path.mutable_back() = path->medResPath.path.front();
 
 	if (cantGetCloser)
 		return;
@@ -123,8 +136,10 @@ void CPathManager::FinalizePath(MultiPath* path, const float3 startPos, const fl
 		ep = &path->lowResPath;
 
 	if (!ep->path.empty()) {
-		ep->path.front() = goalPos;
-		ep->path.front().y = CMoveMath::yLevel(*path->moveDef, ep->path.front());
+		float3& goalPoint = ep->path.mutable_front();
+
+		goalPoint = goalPos;
+		goalPoint.y = CMoveMath::yLevel(*path->moveDef, goalPoint);
 	}
 }
 
@@ -675,7 +690,7 @@ void CPathManager::GetDetailedPathSquares(unsigned pathID, std::vector<int2>& sq
 	squares.reserve(maxResSquares.size());
 
 	for (auto pvi = maxResSquares.rbegin(); pvi != maxResSquares.rend(); ++pvi) {
-		squares.push_back(*pvi);
+		squares.emplace_back(pvi->x, pvi->y);
 	}
 }
 
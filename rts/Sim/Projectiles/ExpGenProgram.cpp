@@ -0,0 +1,164 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ExpGenProgram.h"
+
+#include <cassert>
+#include <cmath>
+
+
+template<typename T> static T ReadArg(const std::string& byteCode, size_t& pos)
+{
+	T v;
+
+	// byte-code arguments are packed, read them without assuming alignment
+	std::memcpy(&v, &byteCode[pos], sizeof(T));
+	pos += sizeof(T);
+	return v;
+}
+
+
+void CExpGenProgram::Compile(const std::string& byteCode)
+{
+	Clear();
+
+	// value-register as far as it is known at compile-time; it starts out
+	// as zero and is reset by every store and yank, same as at run-time
+	float constVal = 0.0f;
+	bool isConst = true;
+
+	void* ptr = nullptr;
+
+	const auto MaterializeConst = [&]() {
+		if (!isConst)
+			return;
+
+		FlushConstant(constVal);
+		isConst = false;
+	};
+
+	for (size_t pos = 0, len = byteCode.size(); pos < len; ) {
+		Op op;
+
+		switch ((op.code = byteCode[pos++])) {
+			case OP_END: {
+				pos = len;
+			} break;
+
+			case OP_STOREI:
+			case OP_STOREF: {
+				op.size = ReadArg<std::uint8_t>(byteCode, pos);
+				op.offset = ReadArg<std::uint16_t>(byteCode, pos);
+
+				if (isConst) {
+					if (op.code == OP_STOREI) {
+						op.code = OP_STOREIC;
+						op.arg.i = (int) constVal;
+					} else {
+						op.code = OP_STOREFC;
+						op.arg.f = constVal;
+					}
+				}
+
+				ops.push_back(op);
+
+				constVal = 0.0f;
+				isConst = true;
+			} break;
+
+			case OP_ADD: {
+				op.arg.f = ReadArg<float>(byteCode, pos);
+
+				if (isConst) {
+					constVal += op.arg.f;
+				} else {
+					ops.push_back(op);
+				}
+			} break;
+			case OP_RAND:
+			case OP_DAMAGE:
+			case OP_INDEX: {
+				op.arg.f = ReadArg<float>(byteCode, pos);
+
+				MaterializeConst();
+				ops.push_back(op);
+			} break;
+
+			case OP_SAWTOOTH:
+			case OP_DISCRETE:
+			case OP_SINE:
+			case OP_POW: {
+				op.arg.f = ReadArg<float>(byteCode, pos);
+
+				if (!isConst) {
+					ops.push_back(op);
+					break;
+				}
+
+				// fold, using the same expressions as Execute
+				switch (op.code) {
+					case OP_SAWTOOTH: { constVal -= op.arg.f * math::floor(constVal / op.arg.f); } break;
+					case OP_DISCRETE: { constVal = op.arg.f * math::floor(spring::SafeDivide(constVal, op.arg.f)); } break;
+					case OP_SINE    : { constVal = op.arg.f * math::sin(constVal); } break;
+					case OP_POW     : { constVal = math::pow(constVal, op.arg.f); } break;
+					default         : {} break;
+				}
+			} break;
+
+			case OP_YANK:
+			case OP_MULTIPLY:
+			case OP_ADDBUFF:
+			case OP_POWBUFF: {
+				// ParseExplosionCode clamps indices to [0, NUM_BUFFERS - 1]
+				op.arg.i = ReadArg<std::int32_t>(byteCode, pos);
+
+				assert(op.arg.i >= 0 && op.arg.i < NUM_BUFFERS);
+
+				MaterializeConst();
+				ops.push_back(op);
+
+				useBuffers = true;
+
+				if (op.code != OP_YANK)
+					break;
+
+				constVal = 0.0f;
+				isConst = true;
+			} break;
+
+			case OP_LOADP: {
+				ptr = ReadArg<void*>(byteCode, pos);
+			} break;
+			case OP_STOREP: {
+				op.offset = ReadArg<std::uint16_t>(byteCode, pos);
+				op.arg.p = ptr;
+
+				ops.push_back(op);
+
+				ptr = nullptr;
+			} break;
+			case OP_DIR: {
+				op.offset = ReadArg<std::uint16_t>(byteCode, pos);
+
+				ops.push_back(op);
+			} break;
+
+			default: {
+				assert(false);
+				pos = len;
+			} break;
+		}
+	}
+}
+
+void CExpGenProgram::FlushConstant(float val)
+{
+	// the register is already zero wherever a constant can start
+	if (val == 0.0f && !std::signbit(val))
+		return;
+
+	Op op;
+	op.code = OP_SET;
+	op.arg.f = val;
+
+	ops.push_back(op);
+}
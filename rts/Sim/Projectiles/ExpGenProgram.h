@@ -0,0 +1,257 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef EXP_GEN_PROGRAM_H
+#define EXP_GEN_PROGRAM_H
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "System/float3.h"
+#include "System/SafeUtil.h"
+#include "System/SpringMath.h"
+
+
+/**
+ * Pre-decoded form of the byte-code CCustomExplosionGenerator::ParseExplosionCode
+ * emits for the properties of one spawn-class.
+ *
+ * Compile turns the packed (unaligned) byte-code into fixed-size ops, folds
+ * every sequence that does not depend on the damage, spawn-index, RNG or the
+ * yank-buffers into a single constant store and merges LOADP/STOREP pairs.
+ * Execute then runs the ops over a whole batch of freshly created instances,
+ * dispatching once per op instead of once per op and instance.
+ */
+class CExpGenProgram
+{
+public:
+	// byte-code, as written by ParseExplosionCode
+	enum {
+		OP_END      =  0,
+		OP_STOREI   =  1, // int
+		OP_STOREF   =  2, // float
+		OP_ADD      =  4,
+		OP_RAND     =  5,
+		OP_DAMAGE   =  6,
+		OP_INDEX    =  7,
+		OP_LOADP    =  8, // load a void* into the pointer register
+		OP_STOREP   =  9, // store the pointer register into a void*
+		OP_DIR      = 10, // store the float3 direction
+		OP_SAWTOOTH = 11, // Performs a modulo to create a sawtooth wave
+		OP_DISCRETE = 12, // Floors the value to a multiple of its parameter
+		OP_SINE     = 13, // Uses val as the phase of a sine wave
+		OP_YANK     = 14, // Moves the input value into a buffer, returns zero
+		OP_MULTIPLY = 15, // Multiplies with buffer value
+		OP_ADDBUFF  = 16, // Adds buffer value
+		OP_POW      = 17, // Power with code as exponent
+		OP_POWBUFF  = 18, // Power with buffer as exponent
+
+		// decoded-only
+		OP_SET      = 32, // sets the value register to a (folded) constant
+		OP_STOREIC  = 33, // stores a constant int
+		OP_STOREFC  = 34, // stores a constant float
+	};
+
+	static constexpr int MAX_BATCH_SIZE = 64;
+	static constexpr int NUM_BUFFERS = 16;
+
+	struct Op {
+		std::uint8_t code = OP_END;
+		std::uint8_t size = 0;
+		std::uint16_t offset = 0;
+
+		union {
+			float f;
+			std::int32_t i;
+			void* p;
+		} arg = {0.0f};
+	};
+
+public:
+	/// @param byteCode complete OP_END-terminated byte-code of a spawn-class
+	void Compile(const std::string& byteCode);
+	void Clear() { ops.clear(); useBuffers = false; }
+
+	bool Empty() const { return ops.empty(); }
+	const std::vector<Op>& GetOps() const { return ops; }
+
+	/**
+	 * Initializes <count> (at most MAX_BATCH_SIZE) spawnable instances.
+	 * Per instance the op-sequence and hence the order of RNG draws stays
+	 * the same as in the byte-code; across instances the draws interleave.
+	 */
+	template<typename RNG>
+	void Execute(char* const* instances, int count, int firstIndex, float damage, const float3& dir, RNG& rng) const;
+
+private:
+	void FlushConstant(float val);
+
+private:
+	std::vector<Op> ops;
+
+	// true if any op reads or writes the yank-buffers
+	bool useBuffers = false;
+};
+
+
+
+template<typename RNG>
+void CExpGenProgram::Execute(char* const* instances, int count, int firstIndex, float damage, const float3& dir, RNG& rng) const
+{
+	float vals[MAX_BATCH_SIZE];
+	float buffers[NUM_BUFFERS][MAX_BATCH_SIZE];
+
+	assert(count <= MAX_BATCH_SIZE);
+
+	std::memset(&vals[0], 0, sizeof(vals));
+
+	if (useBuffers)
+		std::memset(&buffers[0][0], 0, sizeof(buffers));
+
+	for (const Op& op: ops) {
+		switch (op.code) {
+			case OP_STOREIC: {
+				for (int n = 0; n < count; n++) {
+					char* dst = instances[n] + op.offset;
+
+					switch (op.size) {
+						case 1: { *(std::int8_t* ) dst = op.arg.i; } break;
+						case 2: { *(std::int16_t*) dst = op.arg.i; } break;
+						case 4: { *(std::int32_t*) dst = op.arg.i; } break;
+						case 8: { *(std::int64_t*) dst = op.arg.i; } break;
+						default: { /*no op*/ } break;
+					}
+				}
+			} break;
+			case OP_STOREFC: {
+				for (int n = 0; n < count; n++) {
+					char* dst = instances[n] + op.offset;
+
+					switch (op.size) {
+						case 4: { *(float* ) dst = op.arg.f; } break;
+						case 8: { *(double*) dst = op.arg.f; } break;
+						default: { /*no op*/ } break;
+					}
+				}
+			} break;
+
+			case OP_STOREI: {
+				for (int n = 0; n < count; n++) {
+					char* dst = instances[n] + op.offset;
+
+					switch (op.size) {
+						case 1: { *(std::int8_t* ) dst = (int) vals[n]; } break;
+						case 2: { *(std::int16_t*) dst = (int) vals[n]; } break;
+						case 4: { *(std::int32_t*) dst = (int) vals[n]; } break;
+						case 8: { *(std::int64_t*) dst = (int) vals[n]; } break;
+						default: { /*no op*/ } break;
+					}
+
+					vals[n] = 0.0f;
+				}
+			} break;
+			case OP_STOREF: {
+				for (int n = 0; n < count; n++) {
+					char* dst = instances[n] + op.offset;
+
+					switch (op.size) {
+						case 4: { *(float* ) dst = vals[n]; } break;
+						case 8: { *(double*) dst = vals[n]; } break;
+						default: { /*no op*/ } break;
+					}
+
+					vals[n] = 0.0f;
+				}
+			} break;
+
+			case OP_SET: {
+				for (int n = 0; n < count; n++) {
+					vals[n] = op.arg.f;
+				}
+			} break;
+			case OP_ADD: {
+				for (int n = 0; n < count; n++) {
+					vals[n] += op.arg.f;
+				}
+			} break;
+			case OP_RAND: {
+				for (int n = 0; n < count; n++) {
+					vals[n] += rng.NextFloat() * op.arg.f;
+				}
+			} break;
+			case OP_DAMAGE: {
+				for (int n = 0; n < count; n++) {
+					vals[n] += damage * op.arg.f;
+				}
+			} break;
+			case OP_INDEX: {
+				for (int n = 0; n < count; n++) {
+					vals[n] += (firstIndex + n) * op.arg.f;
+				}
+			} break;
+
+			case OP_STOREP: {
+				for (int n = 0; n < count; n++) {
+					*(void**) (instances[n] + op.offset) = op.arg.p;
+				}
+			} break;
+			case OP_DIR: {
+				for (int n = 0; n < count; n++) {
+					*reinterpret_cast<float3*>(instances[n] + op.offset) = dir;
+				}
+			} break;
+
+			case OP_SAWTOOTH: {
+				// this translates to modulo except it works with floats
+				for (int n = 0; n < count; n++) {
+					vals[n] -= op.arg.f * math::floor(vals[n] / op.arg.f);
+				}
+			} break;
+			case OP_DISCRETE: {
+				for (int n = 0; n < count; n++) {
+					vals[n] = op.arg.f * math::floor(spring::SafeDivide(vals[n], op.arg.f));
+				}
+			} break;
+			case OP_SINE: {
+				for (int n = 0; n < count; n++) {
+					vals[n] = op.arg.f * math::sin(vals[n]);
+				}
+			} break;
+			case OP_POW: {
+				for (int n = 0; n < count; n++) {
+					vals[n] = math::pow(vals[n], op.arg.f);
+				}
+			} break;
+
+			case OP_YANK: {
+				for (int n = 0; n < count; n++) {
+					buffers[op.arg.i][n] = vals[n];
+					vals[n] = 0.0f;
+				}
+			} break;
+			case OP_MULTIPLY: {
+				for (int n = 0; n < count; n++) {
+					vals[n] *= buffers[op.arg.i][n];
+				}
+			} break;
+			case OP_ADDBUFF: {
+				for (int n = 0; n < count; n++) {
+					vals[n] += buffers[op.arg.i][n];
+				}
+			} break;
+			case OP_POWBUFF: {
+				for (int n = 0; n < count; n++) {
+					vals[n] = math::pow(vals[n], buffers[op.arg.i][n]);
+				}
+			} break;
+
+			default: {
+				assert(false);
+			} break;
+		}
+	}
+}
+
+#endif // EXP_GEN_PROGRAM_H
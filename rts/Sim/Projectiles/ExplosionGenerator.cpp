@@ -577,135 +577,6 @@ bool CStdExplosionGenerator::Explosion(
 
 
 
-void CCustomExplosionGenerator::ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir)
-{
-	float val = 0.0f;
-	float buffer[16];
-	void* ptr = nullptr;
-
-	std::memset(&buffer[0], 0, sizeof(buffer));
-
-	for (;;) {
-		switch (*(code++)) {
-			case OP_END: {
-				return;
-			}
-			case OP_STOREI: {
-				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
-				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
-				switch (size) {
-					case 1: { *(std::int8_t*)  (instance + offset) = (int) val; } break;
-					case 2: { *(std::int16_t*) (instance + offset) = (int) val; } break;
-					case 4: { *(std::int32_t*) (instance + offset) = (int) val; } break;
-					case 8: { *(std::int64_t*) (instance + offset) = (int) val; } break;
-					default: { /*no op*/ } break;
-				}
-				val = 0.0f;
-				break;
-			}
-			case OP_STOREF: {
-				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
-				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
-				switch (size) {
-					case 4: { *(float*)  (instance + offset) = val; } break;
-					case 8: { *(double*) (instance + offset) = val; } break;
-					default: { /*no op*/ } break;
-				}
-				val = 0.0f;
-				break;
-			}
-			case OP_ADD: {
-				val += *(float*) code;
-				code += 4;
-				break;
-			}
-			case OP_RAND: {
-				val += guRNG.NextFloat() * (*(float*) code);
-				code += 4;
-				break;
-			}
-			case OP_DAMAGE: {
-				val += damage * (*(float*) code);
-				code += 4;
-				break;
-			}
-			case OP_INDEX: {
-				val += spawnIndex * (*(float*) code);
-				code += 4;
-				break;
-			}
-
-			case OP_LOADP: {
-				ptr = *(void**) code;
-				code += sizeof(void*);
-				break;
-			}
-			case OP_STOREP: {
-				std::uint16_t offset = *(std::uint16_t*) code;
-				code += 2;
-				*(void**) (instance + offset) = ptr;
-				ptr = nullptr;
-				break;
-			}
-
-			case OP_DIR: {
-				std::uint16_t offset = *(std::uint16_t*) code;
-				code += 2;
-				*reinterpret_cast<float3*>(instance + offset) = dir;
-				break;
-			}
-			case OP_SAWTOOTH: {
-				// this translates to modulo except it works with floats
-				val -= (*(float*) code) * math::floor(val / (*(float*) code));
-				code += 4;
-				break;
-			}
-			case OP_DISCRETE: {
-				val = (*(float*) code) * math::floor(spring::SafeDivide(val, (*(float*) code)));
-				code += 4;
-				break;
-			}
-			case OP_SINE: {
-				val = (*(float*) code) * math::sin(val);
-				code += 4;
-				break;
-			}
-			case OP_YANK: {
-				buffer[(*(int*) code)] = val;
-				val = 0;
-				code += 4;
-				break;
-			}
-			case OP_MULTIPLY: {
-				val *= buffer[(*(int*) code)];
-				code += 4;
-				break;
-			}
-			case OP_ADDBUFF: {
-				val += buffer[(*(int*) code)];
-				code += 4;
-				break;
-			}
-			case OP_POW: {
-				val = math::pow(val, (*(float*) code));
-				code += 4;
-				break;
-			}
-			case OP_POWBUFF: {
-				val = math::pow(val, buffer[(*(int*) code)]);
-				code += 4;
-				break;
-			}
-			default: {
-				assert(false);
-				break;
-			}
-		}
-	}
-}
-
-
-
 void CCustomExplosionGenerator::ParseExplosionCode(
 	CCustomExplosionGenerator::ProjectileSpawnInfo* psi,
 	const string& script,
@@ -724,7 +595,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 
 		const std::uint16_t ofs = memberInfo.offset;
 
-		code.append(1, OP_DIR);
+		code.append(1, CExpGenProgram::OP_DIR);
 		code.append((char*) &ofs, (char*) &ofs + sizeof(ofs));
 		return;
 	}
@@ -752,12 +623,12 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 		// Memory is managed by whomever this callback belongs to
 		void* ptr = memberInfo.ptrCallback(content);
 
-		code.append(1, OP_LOADP);
+		code.append(1, CExpGenProgram::OP_LOADP);
 		code.append((char*)(&ptr), ((char*)(&ptr)) + sizeof(void*));
 
 		const std::uint16_t ofs = memberInfo.offset;
 
-		code.append(1, OP_STOREP);
+		code.append(1, CExpGenProgram::OP_STOREP);
 		code.append((char*)&ofs, (char*)&ofs + sizeof(ofs));
 		return;
 	}
@@ -780,7 +651,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 
 	// parse the code
 	for (size_t p = 0, len = script.length(); p < len; ) {
-		char opcode = OP_END;
+		char opcode = CExpGenProgram::OP_END;
 		char c = script[p++];
 
 		// consume whitespace
@@ -789,18 +660,18 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 
 		bool useInt = false;
 
-		     if (c == 'i')   opcode = OP_INDEX;
-		else if (c == 'r')   opcode = OP_RAND;
-		else if (c == 'd')   opcode = OP_DAMAGE;
-		else if (c == 'm')   opcode = OP_SAWTOOTH;
-		else if (c == 'k')   opcode = OP_DISCRETE;
-		else if (c == 's')   opcode = OP_SINE;
-		else if (c == 'p')   opcode = OP_POW;
-		else if (c == 'y') { opcode = OP_YANK;     useInt = true; }
-		else if (c == 'x') { opcode = OP_MULTIPLY; useInt = true; }
-		else if (c == 'a') { opcode = OP_ADDBUFF;  useInt = true; }
-		else if (c == 'q') { opcode = OP_POWBUFF;  useInt = true; }
-		else if (isdigit(c) || c == '.' || c == '-') { opcode = OP_ADD; p--; }
+		     if (c == 'i')   opcode = CExpGenProgram::OP_INDEX;
+		else if (c == 'r')   opcode = CExpGenProgram::OP_RAND;
+		else if (c == 'd')   opcode = CExpGenProgram::OP_DAMAGE;
+		else if (c == 'm')   opcode = CExpGenProgram::OP_SAWTOOTH;
+		else if (c == 'k')   opcode = CExpGenProgram::OP_DISCRETE;
+		else if (c == 's')   opcode = CExpGenProgram::OP_SINE;
+		else if (c == 'p')   opcode = CExpGenProgram::OP_POW;
+		else if (c == 'y') { opcode = CExpGenProgram::OP_YANK;     useInt = true; }
+		else if (c == 'x') { opcode = CExpGenProgram::OP_MULTIPLY; useInt = true; }
+		else if (c == 'a') { opcode = CExpGenProgram::OP_ADDBUFF;  useInt = true; }
+		else if (c == 'q') { opcode = CExpGenProgram::OP_POWBUFF;  useInt = true; }
+		else if (isdigit(c) || c == '.' || c == '-') { opcode = CExpGenProgram::OP_ADD; p--; }
 		else {
 			LOG_L(L_WARNING, "[CCEG::%s] unknown op-code \"%c\" in \"%s\" at index " _STPF_ "", __func__, c, script.c_str(), p);
 			continue;
@@ -820,7 +691,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 			code.append(1, opcode);
 			code.append((char*) &v, ((char*) &v) + sizeof(v));
 		} else {
-			const int v = Clamp(int(strtol(&script[p], &endp, 10)), 0, 16);
+			const int v = Clamp(int(strtol(&script[p], &endp, 10)), 0, CExpGenProgram::NUM_BUFFERS - 1);
 
 			p += (endp - &script[p]);
 
@@ -832,7 +703,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 	// store the final value
 	const std::uint16_t ofs = memberInfo.offset;
 
-	code.push_back(isFloat ? OP_STOREF : OP_STOREI);
+	code.push_back(isFloat ? CExpGenProgram::OP_STOREF : CExpGenProgram::OP_STOREI);
 	code.push_back(memberInfo.size);
 	code.append((char*)&ofs, (char*)&ofs + sizeof(ofs));
 }
@@ -895,9 +766,8 @@ bool CCustomExplosionGenerator::Load(CExplosionGeneratorHandler* handler, const
 			}
 		}
 
-		code += (char)OP_END;
-		psi.code.resize(code.size());
-		copy(code.begin(), code.end(), psi.code.begin());
+		code += (char)CExpGenProgram::OP_END;
+		psi.program.Compile(code);
 
 		expGenParams.projectiles.push_back(psi);
 	}
@@ -962,10 +832,22 @@ bool CCustomExplosionGenerator::Explosion(
 		if (projectileHandler.GetParticleSaturation() > 1.0f)
 			break;
 
-		for (unsigned int c = 0; c < psi.count; c++) {
-			CExpGenSpawnable* projectile = CExpGenSpawnable::CreateSpawnable(psi.spawnableID);
-			ExecuteExplosionCode(&psi.code[0], damage, (char*) projectile, c, dir);
-			projectile->Init(owner, pos);
+		// spawn in batches so the program is dispatched once per op for
+		// all instances, then initialize them in creation order
+		for (unsigned int c = 0; c < psi.count; c += CExpGenProgram::MAX_BATCH_SIZE) {
+			char* projectiles[CExpGenProgram::MAX_BATCH_SIZE];
+
+			const int batchSize = std::min(psi.count - c, unsigned(CExpGenProgram::MAX_BATCH_SIZE));
+
+			for (int n = 0; n < batchSize; n++) {
+				projectiles[n] = (char*) CExpGenSpawnable::CreateSpawnable(psi.spawnableID);
+			}
+
+			psi.program.Execute(&projectiles[0], batchSize, c, damage, dir, guRNG);
+
+			for (int n = 0; n < batchSize; n++) {
+				((CExpGenSpawnable*) projectiles[n])->Init(owner, pos);
+			}
 		}
 	}
 
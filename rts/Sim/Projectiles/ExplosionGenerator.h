@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "ExpGenProgram.h"
 #include "Rendering/GroundFlashInfo.h"
 #include "System/UnorderedMap.hpp"
 
@@ -146,8 +147,8 @@ protected:
 		unsigned int count = 0;
 		unsigned int flags = 0;
 
-		/// parsed explosion script code
-		std::vector<char> code;
+		/// parsed explosion script code, pre-decoded
+		CExpGenProgram program;
 	};
 
 	struct ExpGenParams {
@@ -182,30 +183,8 @@ public:
 		CEG_SPWF_NO_UNIT    = 1 << 7,  // only execute when the explosion doesn't hit a unit (environment)
 	};
 
-	enum {
-		OP_END      =  0,
-		OP_STOREI   =  1, // int
-		OP_STOREF   =  2, // float
-		OP_ADD      =  4,
-		OP_RAND     =  5,
-		OP_DAMAGE   =  6,
-		OP_INDEX    =  7,
-		OP_LOADP    =  8, // load a void* into the pointer register
-		OP_STOREP   =  9, // store the pointer register into a void*
-		OP_DIR      = 10, // store the float3 direction
-		OP_SAWTOOTH = 11, // Performs a modulo to create a sawtooth wave
-		OP_DISCRETE = 12, // Floors the value to a multiple of its parameter
-		OP_SINE     = 13, // Uses val as the phase of a sine wave
-		OP_YANK     = 14, // Moves the input value into a buffer, returns zero
-		OP_MULTIPLY = 15, // Multiplies with buffer value
-		OP_ADDBUFF  = 16, // Adds buffer value
-		OP_POW      = 17, // Power with code as exponent
-		OP_POWBUFF  = 18, // Power with buffer as exponent
-	};
-
 private:
 	void ParseExplosionCode(ProjectileSpawnInfo* psi, const std::string& script, SExpGenSpawnableMemberInfo& memberInfo, std::string& code);
-	void ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir);
 
 protected:
 	ExpGenParams expGenParams;
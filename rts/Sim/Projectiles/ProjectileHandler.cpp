@@ -29,6 +29,7 @@
 #include "System/EventHandler.h"
 #include "System/Log/ILog.h"
 #include "System/SpringMath.h"
+#include "System/Sync/SyncedPrimitiveBase.h"
 #include "System/TimeProfiler.h"
 
 
@@ -215,12 +216,15 @@ void CProjectileHandler::UpdateProjectiles(bool synced)
 	}
 
 	SCOPED_TIMER("Sim::Projectiles::Update");
+	SYNC_DEBUG_PHASE(SYNC_PHASE_PROJECTILE_UPDATES);
 
 	// WARNING: same as above but for p->Update()
 	for (size_t i = 0; i < pc.size(); ++i) {
 		CProjectile* p = pc[i];
 		assert(p != nullptr);
 
+		SYNC_DEBUG_OBJECT(p->id);
+
 		MAPPOS_SANITY_CHECK(p->pos);
 
 		p->Update();
@@ -334,7 +338,10 @@ void CProjectileHandler::Update()
 		SCOPED_TIMER("Sim::Projectiles");
 
 		// check if any projectiles have collided since the previous update
-		CheckCollisions();
+		{
+			SYNC_DEBUG_PHASE(SYNC_PHASE_PROJECTILE_COLLISIONS);
+			CheckCollisions();
+		}
 		UpdateProjectiles();
 
 		UPDATE_PTR_CONTAINER(groundFlashes);
@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "BuilderCAI.h"
+#include "BuilderSearchCandidate.h"
 #include "ExternalAI/EngineOutHandler.h"
 #include "Game/GameHelper.h"
 #include "Game/SelectedUnitsHandler.h"
@@ -53,13 +54,17 @@ CR_REG_METADATA(CBuilderCAI , (
 ))
 
 // not adding to members, should repopulate itself
-spring::unordered_set<int> CBuilderCAI::reclaimers;
-spring::unordered_set<int> CBuilderCAI::featureReclaimers;
-spring::unordered_set<int> CBuilderCAI::resurrecters;
+CBuilderTargetIndex CBuilderCAI::reclaimers;
+CBuilderTargetIndex CBuilderCAI::featureReclaimers;
+CBuilderTargetIndex CBuilderCAI::resurrecters;
 
 std::vector<int> CBuilderCAI::removees;
 
 
+static std::vector< SearchCandidate<const CUnit> > unitCandidates;
+static std::vector< SearchCandidate<const CFeature> > featureCandidates;
+
+
 static std::string GetUnitDefBuildOptionToolTip(const UnitDef* ud, bool disabled) {
 	std::string tooltip;
 
@@ -225,9 +230,9 @@ CBuilderCAI::~CBuilderCAI()
 
 void CBuilderCAI::InitStatic()
 {
-	spring::clear_unordered_set(reclaimers);
-	spring::clear_unordered_set(featureReclaimers);
-	spring::clear_unordered_set(resurrecters);
+	reclaimers.Clear();
+	featureReclaimers.Clear();
+	resurrecters.Clear();
 }
 
 void CBuilderCAI::PostLoad()
@@ -1009,7 +1014,7 @@ void CBuilderCAI::ExecuteReclaim(Command& c)
 					StopMoveAndFinishCommand();
 					RemoveUnitFromFeatureReclaimers(owner);
 				} else {
-					AddUnitToFeatureReclaimers(owner);
+					AddUnitToFeatureReclaimers(owner, feature->id);
 				}
 			} else {
 				StopMoveAndFinishCommand();
@@ -1044,7 +1049,7 @@ void CBuilderCAI::ExecuteReclaim(Command& c)
 				if (!ReclaimObject(unit)) {
 					StopMoveAndFinishCommand();
 				} else {
-					AddUnitToReclaimers(owner);
+					AddUnitToReclaimers(owner, unit->id);
 				}
 			} else {
 				RemoveUnitFromReclaimers(owner);
@@ -1117,7 +1122,7 @@ void CBuilderCAI::ExecuteResurrect(Command& c)
 					StopMoveAndFinishCommand();
 				}
 				else {
-					AddUnitToResurrecters(owner);
+					AddUnitToResurrecters(owner, feature->id);
 				}
 			} else {
 				RemoveUnitFromResurrecters(owner);
@@ -1346,129 +1351,60 @@ int CBuilderCAI::GetDefaultCmd(const CUnit* pointed, const CFeature* feature)
 }
 
 
-void CBuilderCAI::AddUnitToReclaimers(CUnit* unit) { reclaimers.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromReclaimers(CUnit* unit) { reclaimers.erase(unit->id); }
+void CBuilderCAI::AddUnitToReclaimers(CUnit* unit, int unitID) { reclaimers.Add(unit->id, unitID); }
+void CBuilderCAI::RemoveUnitFromReclaimers(CUnit* unit) { reclaimers.Remove(unit->id); }
 
-void CBuilderCAI::AddUnitToFeatureReclaimers(CUnit* unit) { featureReclaimers.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromFeatureReclaimers(CUnit* unit) { featureReclaimers.erase(unit->id); }
+void CBuilderCAI::AddUnitToFeatureReclaimers(CUnit* unit, int featureID) { featureReclaimers.Add(unit->id, featureID); }
+void CBuilderCAI::RemoveUnitFromFeatureReclaimers(CUnit* unit) { featureReclaimers.Remove(unit->id); }
 
-void CBuilderCAI::AddUnitToResurrecters(CUnit* unit) { resurrecters.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromResurrecters(CUnit* unit) { resurrecters.erase(unit->id); }
+void CBuilderCAI::AddUnitToResurrecters(CUnit* unit, int featureID) { resurrecters.Add(unit->id, featureID); }
+void CBuilderCAI::RemoveUnitFromResurrecters(CUnit* unit) { resurrecters.Remove(unit->id); }
 
 
 /**
  * Checks if a unit is being reclaimed by a friendly con.
  *
- * We assume that there will not be a lot of reclaimers, because performance
- * would suck if there were. Ideally, reclaimers should be assigned on a
- * per-unit basis, but this requires tracking of deaths, which albeit
- * already done, is not exactly simple to follow.
- *
- * TODO easy: store reclaiming units per allyteam
- * TODO harder: update reclaimers as they start/finish reclaims and/or die
+ * Builders register their current target when they start or continue a
+ * reclaim, so only the builders registered for <unit> need to be visited.
+ * Entries are verified against the builder's current command and lazily
+ * dropped once they stop matching (e.g. after the command finished).
  */
 bool CBuilderCAI::IsUnitBeingReclaimed(const CUnit* unit, const CUnit* friendUnit)
 {
-	bool retval = false;
-
-	removees.clear();
-	removees.reserve(reclaimers.size());
-
-	for (auto it = reclaimers.begin(); it != reclaimers.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
-
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const Command& c = cq.front();
-		if (c.GetID() != CMD_RECLAIM || (c.GetNumParams() != 1 && c.GetNumParams() != 5)) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdUnitId = (int)c.GetParam(0);
-		if (cmdUnitId == unit->id && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
-
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromReclaimers(unitHandler.GetUnit(*it));
-
-	return retval;
+	return (IsTargetOfBuilders(reclaimers, unit->id, CMD_RECLAIM, unit->id, friendUnit));
 }
 
-
 bool CBuilderCAI::IsFeatureBeingReclaimed(int featureId, const CUnit* friendUnit)
 {
-	bool retval = false;
-
-	removees.clear();
-	removees.reserve(featureReclaimers.size());
-
-	for (auto it = featureReclaimers.begin(); it != featureReclaimers.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
-
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const Command& c = cq.front();
-		if (c.GetID() != CMD_RECLAIM || (c.GetNumParams() != 1 && c.GetNumParams() != 5)) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdFeatureId = (int)c.GetParam(0);
-		if ((cmdFeatureId - unitHandler.MaxUnits()) == featureId && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
-
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromFeatureReclaimers(unitHandler.GetUnit(*it));
-
-	return retval;
+	return (IsTargetOfBuilders(featureReclaimers, featureId, CMD_RECLAIM, featureId + unitHandler.MaxUnits(), friendUnit));
 }
 
-
 bool CBuilderCAI::IsFeatureBeingResurrected(int featureId, const CUnit* friendUnit)
 {
-	bool retval = false;
+	return (IsTargetOfBuilders(resurrecters, featureId, CMD_RESURRECT, featureId + unitHandler.MaxUnits(), friendUnit));
+}
 
-	removees.clear();
-	removees.reserve(resurrecters.size());
+bool CBuilderCAI::IsTargetOfBuilders(CBuilderTargetIndex& index, int targetID, int cmdID, int cmdTargetID, const CUnit* friendUnit)
+{
+	const auto IsWorking = [&](int builderID) {
+		const CUnit* u = unitHandler.GetUnit(builderID);
+		const CCommandQueue& cq = u->commandAI->commandQue;
 
-	for (auto it = resurrecters.begin(); it != resurrecters.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
+		if (cq.empty())
+			return false;
 
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
 		const Command& c = cq.front();
-		if (c.GetID() != CMD_RESURRECT || c.GetNumParams() != 1) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdFeatureId = (int)c.GetParam(0);
-		if ((cmdFeatureId - unitHandler.MaxUnits()) == featureId && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromResurrecters(unitHandler.GetUnit(*it));
+		// area-reclaims are given 5 parameters, resurrects only ever one
+		const bool validParams = (c.GetNumParams() == 1 || (cmdID == CMD_RECLAIM && c.GetNumParams() == 5));
 
-	return retval;
+		return (c.GetID() == cmdID && validParams && (int)c.GetParam(0) == cmdTargetID);
+	};
+	const auto IsFriend = [&](int builderID) {
+		return (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, unitHandler.GetUnit(builderID)->allyteam));
+	};
+
+	return (index.HasMatchingBuilder(targetID, removees, IsWorking, IsFriend));
 }
 
 
@@ -1491,55 +1427,56 @@ int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned cha
 	const bool recEnemyOnly = recoptions & REC_ENEMYONLY;
 	const bool recSpecial   = recoptions & REC_SPECIAL;
 
-	const CSolidObject* best = nullptr;
 	float bestDist = bestStartDist;
 	bool stationary = false;
 	int rid = -1;
 
+	// stationary units are preferred regardless of distance, moving ones have
+	// to be closer than bestStartDist; same for (recSpecial) metal features
 	if (recUnits || recEnemy || recEnemyOnly) {
 		QuadFieldQuery qfQuery;
-		quadField.GetUnitsExact(qfQuery, pos, radius, false);
+
+		if (recEnemy || recEnemyOnly) {
+			quadField.GetAllyUnitsExact(qfQuery, pos, radius, owner->allyteam, false, false);
+		} else {
+			quadField.GetUnitsExact(qfQuery, pos, radius, false);
+		}
+
+		unitCandidates.clear();
+		unitCandidates.reserve(qfQuery.units->size());
 
 		for (const CUnit* u: *qfQuery.units) {
 			if (u == owner)
 				continue;
 			if (!u->unitDef->reclaimable)
 				continue;
-			if (!((!recEnemy && !recEnemyOnly) || !teamHandler.Ally(owner->allyteam, u->allyteam)))
-				continue;
 			if (!(u->losStatus[owner->allyteam] & (LOS_INRADAR|LOS_INLOS)))
 				continue;
 
-			// reclaim stationary targets first
-			if (u->IsMoving() && stationary)
-				continue;
-
 			// do not reclaim friendly builders that are busy
 			if (u->unitDef->builder && teamHandler.Ally(owner->allyteam, u->allyteam) && !u->commandAI->commandQue.empty())
 				continue;
 
-			const float dist = f3SqDist(u->pos, owner->pos);
-			if (dist < bestDist || (!stationary && !u->IsMoving())) {
-				if (owner->immobile && !IsInBuildRange(u))
-					continue;
+			unitCandidates.push_back({u, f3SqDist(u->pos, owner->pos), int(u->IsMoving()), int(unitCandidates.size())});
+		}
 
-				if (!stationary && !u->IsMoving())
-					stationary = true;
+		const auto IsValidUnit = [&](const CUnit* u) { return (!owner->immobile || IsInBuildRange(u)); };
+		const auto* best = FindBestCandidate(unitCandidates, bestDist, IsValidUnit);
 
-				bestDist = dist;
-				best = u;
-			}
+		if (best != nullptr) {
+			stationary = (best->cls == 0);
+			bestDist = best->dist;
+			rid = best->obj->id;
 		}
-		if (best != nullptr)
-			rid = best->id;
 	}
 
-	if ((!best || !stationary) && !recEnemyOnly) {
-		best = nullptr;
+	if ((rid == -1 || !stationary) && !recEnemyOnly) {
 		const CTeam* team = teamHandler.Team(owner->team);
 		QuadFieldQuery qfQuery;
 		quadField.GetFeaturesExact(qfQuery, pos, radius, false);
-		bool metal = false;
+
+		featureCandidates.clear();
+		featureCandidates.reserve(qfQuery.features->size());
 
 		for (const CFeature* f: *qfQuery.features) {
 			if (!f->def->reclaimable)
@@ -1550,34 +1487,31 @@ int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned cha
 			if (recNonRez && f->udef != nullptr)
 				continue;
 
-			if (recSpecial && metal && f->defResources.metal <= 0.0)
+			const bool needMetal  = (f->defResources.metal  > 0.0f) && (team->res.metal  < team->resStorage.metal);
+			const bool needEnergy = (f->defResources.energy > 0.0f) && (team->res.energy < team->resStorage.energy);
+
+			if (!noResCheck && !needMetal && !needEnergy)
 				continue;
 
-			const float dist = f3SqDist(f->pos, owner->pos);
+			const bool metalFirst = (recSpecial && f->defResources.metal > 0.0f);
 
-			if ((dist < bestDist || (recSpecial && !metal && f->defResources.metal > 0.0)) &&
-				(noResCheck ||
-				((f->defResources.metal  > 0.0f) && (team->res.metal  < team->resStorage.metal)) ||
-				((f->defResources.energy > 0.0f) && (team->res.energy < team->resStorage.energy)))
-			) {
-				if (!f->IsInLosForAllyTeam(owner->allyteam))
-					continue;
+			featureCandidates.push_back({f, f3SqDist(f->pos, owner->pos), int(!metalFirst), int(featureCandidates.size())});
+		}
 
-				if (!owner->unitDef->canmove && !IsInBuildRange(f))
-					continue;
+		const auto IsValidFeature = [&](const CFeature* f) {
+			if (!f->IsInLosForAllyTeam(owner->allyteam))
+				return false;
 
-				if (!(cmdopt & CONTROL_KEY) && IsFeatureBeingResurrected(f->id, owner))
-					continue;
+			if (!owner->unitDef->canmove && !IsInBuildRange(f))
+				return false;
 
-				metal |= (recSpecial && !metal && f->defResources.metal > 0.0f);
+			return ((cmdopt & CONTROL_KEY) || !IsFeatureBeingResurrected(f->id, owner));
+		};
 
-				bestDist = dist;
-				best = f;
-			}
-		}
+		const auto* best = FindBestCandidate(featureCandidates, bestDist, IsValidFeature);
 
 		if (best != nullptr)
-			rid = unitHandler.MaxUnits() + best->id;
+			rid = unitHandler.MaxUnits() + best->obj->id;
 	}
 
 	return rid;
@@ -1713,89 +1647,88 @@ bool CBuilderCAI::FindRepairTargetAndRepair(
 	bool attackEnemy,
 	bool builtOnly
 ) {
+	// enemies always take precedence over allies, so without the means to
+	// attack them only the allied allyteams' quad lists need to be visited
+	const bool searchEnemies = (attackEnemy && owner->unitDef->canAttack && (owner->maxRange > 0));
+
 	QuadFieldQuery qfQuery;
-	quadField.GetUnitsExact(qfQuery, pos, radius, false);
-	const CUnit* bestUnit = nullptr;
+
+	if (searchEnemies) {
+		quadField.GetUnitsExact(qfQuery, pos, radius, false);
+	} else {
+		quadField.GetAllyUnitsExact(qfQuery, pos, radius, owner->allyteam, true, false);
+	}
 
 	const float maxSpeed = owner->moveType->GetMaxSpeed();
-	float unitSpeed = 0.0f;
-	float bestDist = 1.0e30f;
 
-	bool haveEnemy = false;
 	bool trySelfRepair = false;
-	bool stationary = false;
 
+	unitCandidates.clear();
+	unitCandidates.reserve(qfQuery.units->size());
+
+	// class 0: enemies, 1: stationary allies, 2: moving allies
 	for (const CUnit* unit: *qfQuery.units) {
 		if (teamHandler.Ally(owner->allyteam, unit->allyteam)) {
-			if (!haveEnemy && (unit->health < unit->maxHealth)) {
-				// don't help allies build unless set on roam
-				if (unit->beingBuilt && owner->team != unit->team && (owner->moveState != MOVESTATE_ROAM))
-					continue;
-
-				// don't help factories produce units when set on hold pos
-				if (unit->beingBuilt && unit->moveDef != nullptr && (owner->moveState == MOVESTATE_HOLDPOS))
-					continue;
+			if (unit->health >= unit->maxHealth)
+				continue;
 
-				// don't assist or repair if can't assist or repair
-				if (!ownerBuilder->CanAssistUnit(unit) && !ownerBuilder->CanRepairUnit(unit))
-					continue;
+			// don't help allies build unless set on roam
+			if (unit->beingBuilt && owner->team != unit->team && (owner->moveState != MOVESTATE_ROAM))
+				continue;
 
-				if (unit == owner) {
-					trySelfRepair = true;
-					continue;
-				}
-				// repair stationary targets first
-				if (unit->IsMoving() && stationary)
-					continue;
+			// don't help factories produce units when set on hold pos
+			if (unit->beingBuilt && unit->moveDef != nullptr && (owner->moveState == MOVESTATE_HOLDPOS))
+				continue;
 
-				if (builtOnly && unit->beingBuilt)
-					continue;
+			// don't assist or repair if can't assist or repair
+			if (!ownerBuilder->CanAssistUnit(unit) && !ownerBuilder->CanRepairUnit(unit))
+				continue;
 
-				float dist = f3SqDist(unit->pos, owner->pos);
+			if (unit == owner) {
+				trySelfRepair = true;
+				continue;
+			}
 
-				// avoid targets that are faster than our max speed
-				if (unit->IsMoving()) {
-					unitSpeed = unit->speed.Length2D();
-					dist *= (1.0f + std::max(unitSpeed - maxSpeed, 0.0f));
-				}
-				if (dist < bestDist || (!stationary && !unit->IsMoving())) {
-					// dont lock-on to units outside of our reach (for immobile builders)
-					if ((owner->immobile || (unit->IsMoving() && !TargetInterceptable(unit, unitSpeed))) && !IsInBuildRange(unit))
-						continue;
+			if (builtOnly && unit->beingBuilt)
+				continue;
 
-					// don't repair stuff that's being reclaimed
-					if (!(options & CONTROL_KEY) && IsUnitBeingReclaimed(unit, owner))
-						continue;
+			float dist = f3SqDist(unit->pos, owner->pos);
 
-					stationary |= (!stationary && !unit->IsMoving());
+			// avoid targets that are faster than our max speed
+			if (unit->IsMoving())
+				dist *= (1.0f + std::max(unit->speed.Length2D() - maxSpeed, 0.0f));
 
-					bestDist = dist;
-					bestUnit = unit;
-				}
-			}
+			unitCandidates.push_back({unit, dist, 1 + int(unit->IsMoving()), int(unitCandidates.size())});
 		} else {
-			if (unit->IsNeutral())
+			if (!searchEnemies)
 				continue;
 
-			if (!attackEnemy || !owner->unitDef->canAttack || (owner->maxRange <= 0) )
+			if (unit->IsNeutral())
 				continue;
 
 			if (!(unit->losStatus[owner->allyteam] & (LOS_INRADAR | LOS_INLOS)))
 				continue;
 
-			const float dist = f3SqDist(unit->pos, owner->pos);
-
-			if ((dist < bestDist) || !haveEnemy) {
-				if (owner->immobile && ((dist - unit->radius) > owner->maxRange))
-					continue;
-
-				bestUnit = unit;
-				bestDist = dist;
-				haveEnemy = true;
-			}
+			unitCandidates.push_back({unit, f3SqDist(unit->pos, owner->pos), 0, int(unitCandidates.size())});
 		}
 	}
 
+	const auto IsValidTarget = [&](const CUnit* unit) {
+		if (!teamHandler.Ally(owner->allyteam, unit->allyteam))
+			return (!owner->immobile || ((f3SqDist(unit->pos, owner->pos) - unit->radius) <= owner->maxRange));
+
+		// dont lock-on to units outside of our reach (for immobile builders)
+		if ((owner->immobile || (unit->IsMoving() && !TargetInterceptable(unit, unit->speed.Length2D()))) && !IsInBuildRange(unit))
+			return false;
+
+		// don't repair stuff that's being reclaimed
+		return ((options & CONTROL_KEY) || !IsUnitBeingReclaimed(unit, owner));
+	};
+
+	const auto* best = FindBestCandidate(unitCandidates, 1.0e30f, IsValidTarget);
+	const CUnit* bestUnit = (best != nullptr)? best->obj: nullptr;
+	const bool haveEnemy = (best != nullptr && best->cls == 0);
+
 	if (bestUnit == nullptr) {
 		if (!trySelfRepair || !owner->unitDef->canSelfRepair || (owner->health >= owner->maxHealth))
 			return false;
@@ -3,6 +3,7 @@
 #ifndef _BUILDER_CAI_H_
 #define _BUILDER_CAI_H_
 
+#include "BuilderTargetIndex.h"
 #include "MobileCAI.h"
 #include "Sim/Units/BuildInfo.h"
 #include "System/Misc/BitwiseEnum.h"
@@ -65,9 +66,9 @@ public:
 public:
 	spring::unordered_set<int> buildOptions;
 
-	static spring::unordered_set<int> reclaimers;
-	static spring::unordered_set<int> featureReclaimers;
-	static spring::unordered_set<int> resurrecters;
+	static CBuilderTargetIndex reclaimers;
+	static CBuilderTargetIndex featureReclaimers;
+	static CBuilderTargetIndex resurrecters;
 
 	static std::vector<int> removees;
 
@@ -125,17 +126,20 @@ private:
 	void ReclaimFeature(CFeature* f);
 
 	/// fix for patrolling cons repairing/resurrecting stuff that's being reclaimed
-	static void AddUnitToReclaimers(CUnit*);
+	static void AddUnitToReclaimers(CUnit*, int unitID);
 	static void RemoveUnitFromReclaimers(CUnit*);
 
 	/// fix for cons wandering away from their target circle
-	static void AddUnitToFeatureReclaimers(CUnit*);
+	static void AddUnitToFeatureReclaimers(CUnit*, int featureID);
 	static void RemoveUnitFromFeatureReclaimers(CUnit*);
 
 	/// fix for patrolling cons reclaiming stuff that is being resurrected
-	static void AddUnitToResurrecters(CUnit*);
+	static void AddUnitToResurrecters(CUnit*, int featureID);
 	static void RemoveUnitFromResurrecters(CUnit*);
 
+	/// true if an (allied) builder in <index> is working on <targetID> with command <cmdID>
+	static bool IsTargetOfBuilders(CBuilderTargetIndex& index, int targetID, int cmdID, int cmdTargetID, const CUnit* friendUnit);
+
 	inline float f3Dist(const float3& a, const float3& b) const {
 		return range3D ? a.distance(b) : a.distance2D(b);
 	}
@@ -0,0 +1,61 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef BUILDER_SEARCH_CANDIDATE_H
+#define BUILDER_SEARCH_CANDIDATE_H
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Candidate of a builder area-search (FindReclaimTarget and friends).
+ * A lower class always wins over a higher one, within a class the smaller
+ * (squared) distance wins and exact ties go to the candidate found first.
+ */
+template<typename T>
+struct SearchCandidate {
+	// inverted for std::*_heap, which keep the largest element on top
+	bool operator < (const SearchCandidate& c) const {
+		if (cls != c.cls)
+			return (cls > c.cls);
+		if (dist != c.dist)
+			return (dist > c.dist);
+
+		// equal keys resolve to the earliest found, like a linear scan would
+		return (idx > c.idx);
+	}
+
+	T* obj;
+	float dist;
+	int cls;
+	int idx;
+};
+
+
+/**
+ * Visits <candidates> best-first and returns the first one accepted by
+ * <isValid>, so the expensive checks (LOS, build-range, reclaimer lookups)
+ * only run on candidates that could still win. Candidates of class 0 may
+ * be at any distance, all others have to be closer than <maxDist>.
+ *
+ * Reorders <candidates>; the returned pointer is into it.
+ */
+template<typename T, typename Pred>
+static const SearchCandidate<T>* FindBestCandidate(std::vector< SearchCandidate<T> >& candidates, float maxDist, Pred isValid)
+{
+	std::make_heap(candidates.begin(), candidates.end());
+
+	for (auto end = candidates.end(); end != candidates.begin(); --end) {
+		std::pop_heap(candidates.begin(), end);
+
+		const SearchCandidate<T>& c = *(end - 1);
+
+		if (c.cls != 0 && c.dist >= maxDist)
+			break;
+		if (isValid(c.obj))
+			return &c;
+	}
+
+	return nullptr;
+}
+
+#endif
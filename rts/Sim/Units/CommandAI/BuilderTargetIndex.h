@@ -0,0 +1,132 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef BUILDER_TARGET_INDEX_H
+#define BUILDER_TARGET_INDEX_H
+
+#include <algorithm>
+#include <vector>
+
+#include "System/UnorderedMap.hpp"
+
+/**
+ * Two-way mapping between builders and the single object (unit or feature)
+ * each of them is currently reclaiming or resurrecting, so "is X being
+ * reclaimed" queries only have to look at the builders registered for X
+ * instead of at every builder doing any reclaiming.
+ *
+ * Entries are hints: callers still verify a builder's current command and
+ * remove the builder when it no longer matches.
+ */
+class CBuilderTargetIndex
+{
+public:
+	void Add(int builderID, int targetID) {
+		const auto iter = builderTargets.find(builderID);
+
+		if (iter != builderTargets.end()) {
+			if (iter->second == targetID)
+				return;
+
+			RemoveFromTarget(builderID, iter->second);
+			iter->second = targetID;
+		} else {
+			builderTargets.emplace(builderID, targetID);
+		}
+
+		targetBuilders[targetID].push_back(builderID);
+	}
+
+	void Remove(int builderID) {
+		const auto iter = builderTargets.find(builderID);
+
+		if (iter == builderTargets.end())
+			return;
+
+		RemoveFromTarget(builderID, iter->second);
+		builderTargets.erase(iter);
+	}
+
+	void Clear() {
+		spring::clear_unordered_map(builderTargets);
+		spring::clear_unordered_map(targetBuilders);
+	}
+
+	/// builders registered for <targetID>, or nullptr if there are none
+	const std::vector<int>* GetBuilders(int targetID) const {
+		const auto iter = targetBuilders.find(targetID);
+
+		if (iter == targetBuilders.end())
+			return nullptr;
+
+		return &iter->second;
+	}
+
+	/**
+	 * Visits the builders registered for <targetID> in registration order and
+	 * returns true as soon as one passes both <isWorking> and <isFriend>.
+	 * Builders failing <isWorking> (their command no longer targets the object)
+	 * are collected in <removees> and unregistered before returning.
+	 */
+	template<typename IsWorkingFunc, typename IsFriendFunc>
+	bool HasMatchingBuilder(
+		int targetID,
+		std::vector<int>& removees,
+		const IsWorkingFunc& isWorking,
+		const IsFriendFunc& isFriend
+	) {
+		const std::vector<int>* builders = GetBuilders(targetID);
+
+		if (builders == nullptr)
+			return false;
+
+		bool retval = false;
+
+		removees.clear();
+		removees.reserve(builders->size());
+
+		for (const int builderID: *builders) {
+			if (!isWorking(builderID)) {
+				removees.push_back(builderID);
+				continue;
+			}
+
+			if (isFriend(builderID)) {
+				retval = true;
+				break;
+			}
+		}
+
+		for (const int builderID: removees) {
+			Remove(builderID);
+		}
+
+		return retval;
+	}
+
+	size_t GetNumBuilders() const { return builderTargets.size(); }
+	size_t GetNumTargets() const { return targetBuilders.size(); }
+
+private:
+	void RemoveFromTarget(int builderID, int targetID) {
+		const auto iter = targetBuilders.find(targetID);
+
+		if (iter == targetBuilders.end())
+			return;
+
+		std::vector<int>& builders = iter->second;
+		const auto bIter = std::find(builders.begin(), builders.end(), builderID);
+
+		// keep registration order, results must not depend on erase history
+		if (bIter != builders.end())
+			builders.erase(bIter);
+
+		if (builders.empty())
+			targetBuilders.erase(iter);
+	}
+
+private:
+	spring::unordered_map<int, int> builderTargets;
+	spring::unordered_map<int, std::vector<int>> targetBuilders;
+};
+
+#endif // BUILDER_TARGET_INDEX_H
@@ -1,9 +1,26 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <algorithm>
+
 #include "CobEngine.h"
 #include "CobThread.h"
 #include "CobFile.h"
+#include "Sim/Misc/ModInfo.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Threading/ThreadPool.h"
+
+CONFIG(int, ParallelCobThreads).defaultValue(-1).minimumValue(-1).maximumValue(1).description(
+	"Overrides the game's system.parallelCobThreads modrule: -1 uses the game setting, 0 ticks COB threads serially, 1 in parallel. "
+	"Both modes give the same results; test/benchmark/cobsync.sh compares them on replays."
+);
+CONFIG(bool, CobSyncTrace).defaultValue(false).description(
+	"Logs a checksum of the COB thread state after every script tick, for diffing serial and parallel runs of the same replay."
+);
+
+
+// fewer threads to tick or wake are not worth the speculation
+static constexpr size_t MIN_PARALLEL_TASKS = 64;
 
 
 CR_BIND(CCobEngine, )
@@ -17,10 +34,27 @@ CR_REG_METADATA(CCobEngine, (
 	// always null/empty when saving
 	CR_IGNORED(waitingThreadIDs),
 
+	CR_IGNORED(threadTasks),
+	CR_IGNORED(taskGroups),
+	CR_IGNORED(shadowThreads),
+
+	CR_IGNORED(threadTaskIndices),
+	CR_IGNORED(taskGroupIndices),
+
+	CR_IGNORED(wakeQueue),
+
+	CR_IGNORED(numCommittedTasks),
+
+	CR_IGNORED(barrierCount),
+	CR_IGNORED(roundBarrierCount),
+
 	CR_IGNORED(curThread),
 
 	CR_MEMBER(currentTime),
-	CR_MEMBER(threadCounter)
+	CR_MEMBER(threadCounter),
+
+	CR_IGNORED(parallelTick),
+	CR_IGNORED(syncTrace)
 ))
 
 CR_BIND(CCobEngine::SleepingThread, )
@@ -30,6 +64,28 @@ CR_REG_METADATA(CCobEngine::SleepingThread, (
 ))
 
 
+void CCobEngine::Init()
+{
+	threadInstances.reserve(2048);
+	tickAddedThreads.reserve(128);
+
+	runningThreadIDs.reserve(512);
+	waitingThreadIDs.reserve(512);
+
+	threadTasks.reserve(1024);
+
+	threadCounter = 0;
+
+	switch (configHandler->GetInt("ParallelCobThreads")) {
+		case  0: { parallelTick = false; } break;
+		case  1: { parallelTick =  true; } break;
+		default: { parallelTick = modInfo.parallelCobThreads; } break;
+	}
+
+	syncTrace = configHandler->GetBool("CobSyncTrace");
+}
+
+
 int CCobEngine::AddThread(CCobThread&& thread)
 {
 	if (thread.GetID() == -1)
@@ -88,8 +144,32 @@ void CCobEngine::TickThread(CCobThread* thread)
 	curThread = nullptr;
 }
 
+void CCobEngine::WakeThread(CCobThread* zzzThread)
+{
+	// wake up the thread and tick it (if not dead)
+	// this can quite possibly re-add the thread to <sleepingThreadIDs>
+	// again, but any thread is guaranteed to sleep for at least 1 tick
+	switch (zzzThread->GetState()) {
+		case CCobThread::Sleep: {
+			zzzThread->SetState(CCobThread::Run);
+			TickThread(zzzThread);
+		} break;
+		case CCobThread::Dead: {
+			RemoveThread(zzzThread->GetID());
+		} break;
+		default: {
+			LOG_L(L_ERROR, "[COBEngine::%s] unknown state %d for thread %d", __func__, zzzThread->GetState(), zzzThread->GetID());
+		} break;
+	}
+}
+
 void CCobEngine::WakeSleepingThreads()
 {
+	if (parallelTick) {
+		PredictWakeTasks();
+		SpeculateThreadTasks();
+	}
+
 	// check on the sleeping threads, remove any whose owner died
 	while (!sleepingThreadIDs.empty()) {
 		CCobThread* zzzThread = GetThread((sleepingThreadIDs.top()).id);
@@ -106,24 +186,327 @@ void CCobEngine::WakeSleepingThreads()
 		// remove executing thread from the queue
 		sleepingThreadIDs.pop();
 
-		// wake up the thread and tick it (if not dead)
-		// this can quite possibly re-add the thread to <sleepingThreadIDs>
-		// again, but any thread is guaranteed to sleep for at least 1 tick
-		switch (zzzThread->GetState()) {
-			case CCobThread::Sleep: {
-				zzzThread->SetState(CCobThread::Run);
-				TickThread(zzzThread);
-			} break;
-			case CCobThread::Dead: {
-				RemoveThread(zzzThread->GetID());
-			} break;
-			default: {
-				LOG_L(L_ERROR, "[COBEngine::%s] unknown state %d for thread %d", __func__, zzzThread->GetState(), zzzThread->GetID());
-			} break;
+		if (!CommitWakeTask(zzzThread)) {
+			InvalidateTaskGroup(zzzThread);
+			WakeThread(zzzThread);
+		}
+
+		if (!SpeculationInvalidated())
+			continue;
+
+		if (!EndSpeculationRound(threadTaskIndices.size()))
+			continue;
+
+		PredictWakeTasks();
+		SpeculateThreadTasks();
+	}
+
+	FinishThreadTasks();
+}
+
+
+/*
+ * Parallel ticking speculates: SpeculateThreadTasks ticks copies of the
+ * threads concurrently, recording their effects instead of applying them.
+ * The real threads are then advanced in exactly the order and way of the
+ * serial engine (the loops in TickRunningThreadsParallel and
+ * WakeSleepingThreads), and a speculative tick takes the place of a real
+ * one only when nothing it read can have changed since:
+ *
+ *   - no thread running for real has passed a barrier (Lua, other units,
+ *     weapons) since the speculation; afterwards the remaining threads are
+ *     speculated again if enough of the previous round got committed
+ *   - all earlier threads of the same instance were replaced by their
+ *     speculative ticks, in the speculated order
+ *   - the thread is still in the state the speculation began from
+ *
+ * Committing replays the recorded effects on the instance and copies the
+ * speculated thread back. A speculative tick that had to stop (e.g. at a
+ * RAND or a Lua call) is committed up to there and then continued for real.
+ * Threads without a valid speculation are run for real, which invalidates
+ * the rest of their instance's speculation.
+ */
+void CCobEngine::TickRunningThreadsParallel()
+{
+	for (size_t i = 0, roundBegin = 0, n = runningThreadIDs.size(); i < n; i++) {
+		if (i == roundBegin) {
+			for (size_t j = i; j < n; j++) {
+				threadTasks.push_back({runningThreadIDs[j], ThreadTask::Tick});
+			}
+
+			SpeculateThreadTasks();
+		}
+
+		CCobThread* thread = GetThread(runningThreadIDs[i]);
+
+		if (thread == nullptr)
+			continue;
+
+		if (!CommitThreadTask(i - roundBegin, thread)) {
+			InvalidateTaskGroup(thread);
+			TickThread(thread);
+		}
+
+		if (!SpeculationInvalidated())
+			continue;
+
+		// no new round also means no further speculation for this pass
+		if (EndSpeculationRound(n - (i + 1))) {
+			roundBegin = i + 1;
+		} else {
+			roundBegin = n;
 		}
 	}
+
+	FinishThreadTasks();
 }
 
+void CCobEngine::PredictWakeTasks()
+{
+	// the threads WakeSleepingThreads will wake up, in its order, except
+	// for those that sleep for a negative time and are woken up again
+	wakeQueue = sleepingThreadIDs;
+
+	while (!wakeQueue.empty()) {
+		const CCobThread* zzzThread = GetThread((wakeQueue.top()).id);
+
+		if (zzzThread != nullptr) {
+			if (zzzThread->GetWakeTime() >= currentTime)
+				break;
+
+			threadTasks.push_back({zzzThread->GetID(), ThreadTask::Wake});
+		}
+
+		wakeQueue.pop();
+	}
+}
+
+
+void CCobEngine::SpeculateThreadTasks()
+{
+	roundBarrierCount = barrierCount;
+	numCommittedTasks = 0;
+
+	if (threadTasks.size() < MIN_PARALLEL_TASKS) {
+		threadTasks.clear();
+		return;
+	}
+
+	if (shadowThreads.size() < threadTasks.size())
+		shadowThreads.resize(threadTasks.size());
+
+	size_t numTaskGroups = 0;
+
+	for (size_t i = 0; i < threadTasks.size(); i++) {
+		ThreadTask& task = threadTasks[i];
+
+		task.thread = nullptr;
+		task.group = -1;
+		task.result = -1;
+
+		// a thread woken up twice is only speculated the first time
+		if (!threadTaskIndices.emplace(task.threadID, i).second)
+			continue;
+		if ((task.thread = GetThread(task.threadID)) == nullptr)
+			continue;
+
+		const auto pair = taskGroupIndices.emplace(task.thread->cobInst, numTaskGroups);
+
+		if (pair.second) {
+			if ((numTaskGroups += 1) > taskGroups.size())
+				taskGroups.emplace_back();
+
+			TaskGroup& group = taskGroups[numTaskGroups - 1];
+
+			group.taskIndices.clear();
+			group.numCommittedTasks = 0;
+			group.numCommittedEffects = 0;
+			group.valid = true;
+		}
+
+		taskGroups[task.group = pair.first->second].taskIndices.push_back(i);
+	}
+
+	// only reads the real threads and instances, and writes nothing but
+	// the group's log and the copies of its threads
+	for_mt(0, int(numTaskGroups), [&](const int groupIdx) {
+		TaskGroup& group = taskGroups[groupIdx];
+		CCobThread::EffectLog& effectLog = group.effectLog;
+
+		effectLog.Clear(threadTasks[group.taskIndices[0]].thread->cobInst);
+
+		for (const int taskIdx: group.taskIndices) {
+			ThreadTask& task = threadTasks[taskIdx];
+			CCobThread& shadow = shadowThreads[taskIdx];
+
+			const CCobThread* thread = task.thread;
+			const CCobThread::State state = thread->GetState();
+
+			// WakeThread removes dead threads and wakes sleeping ones, TickThread
+			// expects running threads; leave anything unusual to them
+			if (state != CCobThread::Dead && state != ((task.type == ThreadTask::Wake)? CCobThread::Sleep: CCobThread::Run))
+				break;
+
+			shadow.Assign(*thread);
+
+			if (state == CCobThread::Dead) {
+				task.result = CCobThread::TickDead;
+			} else {
+				shadow.SetState(CCobThread::Run);
+				task.result = shadow.TickParallel(effectLog);
+			}
+
+			task.state = state;
+			task.numEffects = effectLog.effects.size();
+
+			if (task.result == CCobThread::TickDeferred)
+				break;
+		}
+	});
+}
+
+bool CCobEngine::CommitThreadTask(size_t taskIdx, CCobThread* thread)
+{
+	if (taskIdx >= threadTasks.size())
+		return false;
+
+	ThreadTask& task = threadTasks[taskIdx];
+
+	if (task.result == -1 || barrierCount != roundBarrierCount)
+		return false;
+
+	TaskGroup& group = taskGroups[task.group];
+
+	if (!group.valid || group.numCommittedTasks >= group.taskIndices.size())
+		return false;
+	if (group.taskIndices[group.numCommittedTasks] != int(taskIdx))
+		return false;
+	if (thread->GetState() != task.state)
+		return false;
+
+	CCobThread& shadow = shadowThreads[taskIdx];
+
+	// for error messages originating in CUnitScript
+	curThread = thread;
+	thread->ApplyEffects(group.effectLog, group.numCommittedEffects, task.numEffects);
+	thread->Assign(shadow);
+	curThread = nullptr;
+
+	shadow.MakeGarbage();
+
+	group.numCommittedTasks += 1;
+	group.numCommittedEffects = task.numEffects;
+
+	numCommittedTasks += 1;
+
+	switch (task.result) {
+		case CCobThread::TickDead: {
+			RemoveThread(task.threadID);
+		} break;
+		case CCobThread::TickAlive: {
+			if (thread->GetState() == CCobThread::Sleep)
+				ScheduleThread(thread);
+		} break;
+		case CCobThread::TickDeferred: {
+			group.valid = false;
+			TickThread(thread);
+		} break;
+		default: {
+			assert(false);
+		} break;
+	}
+
+	return true;
+}
+
+bool CCobEngine::CommitWakeTask(CCobThread* thread)
+{
+	const auto it = threadTaskIndices.find(thread->GetID());
+
+	if (it == threadTaskIndices.end())
+		return false;
+
+	const size_t taskIdx = it->second;
+
+	// a thread that went back to sleep and is woken again runs for real
+	threadTaskIndices.erase(it);
+
+	return (CommitThreadTask(taskIdx, thread));
+}
+
+void CCobEngine::InvalidateTaskGroup(const CCobThread* thread)
+{
+	const auto it = taskGroupIndices.find(thread->cobInst);
+
+	if (it == taskGroupIndices.end())
+		return;
+
+	taskGroups[it->second].valid = false;
+}
+
+
+bool CCobEngine::EndSpeculationRound(size_t numRemainingTasks)
+{
+	// speculating again only pays off if most of this round was not wasted,
+	// which also bounds the total number of speculated ticks per pass
+	const bool newRound = (numCommittedTasks * 2 >= threadTasks.size() && numRemainingTasks >= MIN_PARALLEL_TASKS);
+
+	FinishThreadTasks();
+	return newRound;
+}
+
+void CCobEngine::FinishThreadTasks()
+{
+	for (size_t i = 0; i < threadTasks.size(); i++) {
+		shadowThreads[i].MakeGarbage();
+	}
+
+	threadTasks.clear();
+	threadTaskIndices.clear();
+	taskGroupIndices.clear();
+}
+
+
+unsigned int CCobEngine::CalcChecksum()
+{
+	std::vector<int> threadIDs;
+	threadIDs.reserve(threadInstances.size());
+
+	for (const auto& p: threadInstances) {
+		threadIDs.push_back(p.first);
+	}
+
+	std::sort(threadIDs.begin(), threadIDs.end());
+
+	unsigned int checksum = 0;
+
+	const auto Mix = [&](int v) { checksum = (checksum ^ static_cast<unsigned int>(v)) * 16777619u; };
+
+	for (const int threadID: threadIDs) {
+		const CCobThread* t = GetThread(threadID);
+
+		Mix(threadID);
+		Mix(t->GetState());
+		Mix(t->GetWakeTime());
+		Mix(t->GetRetCode());
+		Mix(t->GetSignalMask());
+
+		if (t->cobInst == nullptr)
+			continue;
+
+		for (const int v: t->cobInst->staticVars) {
+			Mix(v);
+		}
+	}
+
+	for (const int threadID: runningThreadIDs) {
+		Mix(threadID);
+	}
+
+	return checksum;
+}
+
+
 void CCobEngine::Tick(int deltaTime)
 {
 	currentTime += deltaTime;
@@ -133,6 +516,11 @@ void CCobEngine::Tick(int deltaTime)
 
 	WakeSleepingThreads();
 	AddQueuedThreads();
+
+	if (!syncTrace)
+		return;
+
+	LOG("[COBEngine::%s] time=%d threads=%u checksum=0x%08x", __func__, currentTime, unsigned(threadInstances.size()), CalcChecksum());
 }
 
 
@@ -40,16 +40,41 @@ private:
 		}
 	};
 
-public:
-	void Init() {
-		threadInstances.reserve(2048);
-		tickAddedThreads.reserve(128);
+	// a thread to run (from runningThreadIDs) or wake up (from sleepingThreadIDs)
+	// in one round of speculation, in the order the serial engine would get to it
+	struct ThreadTask {
+		enum {Tick, Wake};
+
+		int threadID;
+		int type;
+
+		// set by SpeculateThreadTasks
+		CCobThread* thread = nullptr;
+
+		int group = -1;
+		// result of the speculative tick, -1 if there was none
+		int result = -1;
+		// state of the thread when speculation began
+		int state = -1;
+		// end of this task's effects in its group's log
+		int numEffects = 0;
+	};
 
-		runningThreadIDs.reserve(512);
-		waitingThreadIDs.reserve(512);
+	// speculated tasks of one script instance, committed in their order
+	struct TaskGroup {
+		CCobThread::EffectLog effectLog;
 
-		threadCounter = 0;
-	}
+		std::vector<int> taskIndices;
+
+		size_t numCommittedTasks = 0;
+		size_t numCommittedEffects = 0;
+
+		// false once a thread of the instance has run non-speculatively
+		bool valid = true;
+	};
+
+public:
+	void Init();
 	void Kill() {
 		// threadInstances is never explicitly iterated, so
 		// calling clear_unordered_map (between reloads) is
@@ -60,6 +85,10 @@ public:
 		runningThreadIDs.clear();
 		waitingThreadIDs.clear();
 
+		threadTasks.clear();
+		threadTaskIndices.clear();
+		taskGroupIndices.clear();
+
 		while (!sleepingThreadIDs.empty()) {
 			sleepingThreadIDs.pop();
 		}
@@ -108,14 +137,26 @@ public:
 	void ScheduleThread(const CCobThread* thread);
 	void SanityCheckThreads(const CCobInstance* owner);
 
+	/**
+	 * Called by threads running non-speculatively before anything that can
+	 * reach other script instances (Lua, other units, weapons), which makes
+	 * all speculative results that were not committed yet invalid.
+	 */
+	void AddBarrier() { barrierCount += 1; }
+
 private:
 	void TickThread(CCobThread* thread);
+	void WakeThread(CCobThread* thread);
 
 	void WakeSleepingThreads();
 	void TickRunningThreads() {
-		// advance all currently running threads
-		for (const int threadID: runningThreadIDs) {
-			TickThread(GetThread(threadID));
+		if (parallelTick) {
+			TickRunningThreadsParallel();
+		} else {
+			// advance all currently running threads
+			for (const int threadID: runningThreadIDs) {
+				TickThread(GetThread(threadID));
+			}
 		}
 
 		// a thread can never go from running->running, so clear the list
@@ -128,6 +169,20 @@ private:
 		std::swap(runningThreadIDs, waitingThreadIDs);
 	}
 
+	void TickRunningThreadsParallel();
+	void PredictWakeTasks();
+
+	void SpeculateThreadTasks();
+	bool CommitThreadTask(size_t taskIdx, CCobThread* thread);
+	bool CommitWakeTask(CCobThread* thread);
+	void InvalidateTaskGroup(const CCobThread* thread);
+
+	bool SpeculationInvalidated() const { return (!threadTasks.empty() && barrierCount != roundBarrierCount); }
+	bool EndSpeculationRound(size_t numRemainingTasks);
+	void FinishThreadTasks();
+
+	unsigned int CalcChecksum();
+
 private:
 	// registry of every thread across all script instances
 	spring::unordered_map<int, CCobThread> threadInstances;
@@ -141,10 +196,30 @@ private:
 	// for validity; thread owner might get removed while a thread is sleeping
 	std::priority_queue<SleepingThread, std::vector<SleepingThread>, CCobThreadComp> sleepingThreadIDs;
 
+	// parallel-tick state, see SpeculateThreadTasks
+	std::vector<ThreadTask> threadTasks;
+	std::vector<TaskGroup> taskGroups;
+	// speculative copies of the threads, indexed like threadTasks
+	std::vector<CCobThread> shadowThreads;
+
+	spring::unordered_map<int, int> threadTaskIndices;
+	spring::unordered_map<const CCobInstance*, int> taskGroupIndices;
+
+	// copy of sleepingThreadIDs for PredictWakeTasks
+	std::priority_queue<SleepingThread, std::vector<SleepingThread>, CCobThreadComp> wakeQueue;
+
+	size_t numCommittedTasks = 0;
+
+	unsigned int barrierCount = 0;
+	unsigned int roundBarrierCount = 0;
+
 	CCobThread* curThread = nullptr;
 
 	int currentTime = 0;
 	int threadCounter = 0;
+
+	bool parallelTick = false;
+	bool syncTrace = false;
 };
 
 
@@ -118,6 +118,14 @@ CCobThread& CCobThread::operator = (const CCobThread& t) {
 	return *this;
 }
 
+void CCobThread::Assign(const CCobThread& t)
+{
+	*this = t;
+
+	callStack = t.callStack;
+	dataStack = t.dataStack;
+}
+
 
 void CCobThread::Start(int functionId, int sigMask, const std::array<int, 1 + MAX_COB_ARGS>& args, bool schedule)
 {
@@ -196,6 +204,17 @@ void CCobThread::InitStack(unsigned int n, CCobThread* t)
 	}
 }
 
+void CCobThread::InitStack(unsigned int n, const int* args)
+{
+	assert(dataStackSize == 0);
+	dataStack.fill(0);
+
+	// arguments popped from the caller's stack by a speculative START
+	for (unsigned int i = 0; i < n; ++i) {
+		PushDataStack(args[i]);
+	}
+}
+
 
 
 // Command documentation from http://visualta.tauniverse.com/Downloads/cob-commands.txt
@@ -290,6 +309,32 @@ constexpr int DROP   = 0x10084000;
 #define LUA8 118
 #define LUA9 119
 
+// Indices for GET and GET_UNIT_VALUE, see CobDefines.h
+// pure functions of their arguments, or constant during a tick
+#define GET_ATAN        14
+#define GET_HYPOT       15
+#define GET_MAX_ID      70
+#define GET_MY_ID       71
+#define GET_POW         80
+#define GET_MIN        131
+#define GET_MAX        132
+#define GET_ABS        133
+#define GET_GAME_FRAME 134
+#define GET_KSIN       135
+#define GET_KCOS       136
+#define GET_KTAN       137
+#define GET_SQRT       138
+// can kill units or retarget weapons, i.e. reach Lua and other units
+#define GET_KILL_UNIT                102
+#define GET_SET_WEAPON_UNIT_TARGET   106
+#define GET_SET_WEAPON_GROUND_TARGET 107
+
+// Indices for EMIT_SFX that fire or detonate a weapon, see CobDefines.h
+#define SFX_CEG             1024
+#define SFX_FIRE_WEAPON     2048
+#define SFX_DETONATE_WEAPON 4096
+#define SFX_GLOBAL         16384
+
 #if 0
 #define GET_LONG_PC() (cobFile->code[pc++])
 #else
@@ -376,19 +421,241 @@ static const char* GetOpcodeName(int opcode)
 #endif
 
 
+static bool IsLuaUnitVal(int val) { return (val >= LUA0 && val <= LUA9); }
+
+static bool IsPureUnitVal(int val)
+{
+	switch (val) {
+		case GET_ATAN:
+		case GET_HYPOT:
+		case GET_MAX_ID:
+		case GET_MY_ID:
+		case GET_POW:
+		case GET_MIN:
+		case GET_MAX:
+		case GET_ABS:
+		case GET_GAME_FRAME:
+		case GET_KSIN:
+		case GET_KCOS:
+		case GET_KTAN:
+		case GET_SQRT: {
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	return false;
+}
+
+static bool IsBarrierUnitVal(int val)
+{
+	return (val == GET_KILL_UNIT || val == GET_SET_WEAPON_UNIT_TARGET || val == GET_SET_WEAPON_GROUND_TARGET);
+}
+
+// only creates particles or CEGs, see CUnitScript::EmitAbsSFX
+static bool IsVisualSfx(int sfxType)
+{
+	return (sfxType < SFX_CEG || (sfxType & (SFX_GLOBAL | SFX_CEG)) != 0);
+}
+
+
+bool CCobThread::CanExecuteParallel(const EffectLog& log) const
+{
+	const std::vector<int>& code = cobFile->code;
+
+	// opcode plus at most two immediates; GET_LONG_PC throws beyond the end
+	if (static_cast<size_t>(pc + 3) > code.size())
+		return false;
+
+	switch (code[pc]) {
+		case PUSH_CONSTANT:
+		case PUSH_LOCAL_VAR:
+		case PUSH_STATIC:
+		case CREATE_LOCAL_VAR:
+		case POP_LOCAL_VAR:
+		case POP_STATIC:
+		case POP_STACK:
+
+		case ADD:
+		case SUB:
+		case MUL:
+		case BITWISE_AND:
+		case BITWISE_OR:
+		case BITWISE_XOR:
+		case BITWISE_NOT:
+
+		case SET_LESS:
+		case SET_LESS_OR_EQUAL:
+		case SET_GREATER:
+		case SET_GREATER_OR_EQUAL:
+		case SET_EQUAL:
+		case SET_NOT_EQUAL:
+		case LOGICAL_AND:
+		case LOGICAL_OR:
+		case LOGICAL_XOR:
+		case LOGICAL_NOT:
+
+		case REAL_CALL:
+		case JUMP:
+		case JUMP_NOT_EQUAL:
+		case RETURN:
+		case SET_SIGNAL_MASK:
+
+		case SHADE:
+		case DONT_SHADE:
+		case CACHE:
+		case DONT_CACHE:
+
+		// recorded into the log
+		case SLEEP:
+		case STOP_SPIN:
+		case PLAY_SOUND: {
+			return true;
+		} break;
+		case START: {
+			return (code[pc + 2] >= 0);
+		} break;
+
+		// the anim-lists are only current until our own first anim-op
+		case WAIT_TURN:
+		case WAIT_MOVE: {
+			return (!log.animsChanged);
+		} break;
+
+		// division by zero reports an error
+		case DIV:
+		case MOD: {
+			return (dataStackSize > 0 && dataStack[dataStackSize - 1] != 0);
+		} break;
+
+		// thread-local Lua return values and pure functions
+		case GET_UNIT_VALUE: {
+			return (dataStackSize > 0 && (IsLuaUnitVal(dataStack[dataStackSize - 1]) || IsPureUnitVal(dataStack[dataStackSize - 1])));
+		} break;
+		case GET: {
+			return (dataStackSize >= 5 && (IsLuaUnitVal(dataStack[dataStackSize - 5]) || IsPureUnitVal(dataStack[dataStackSize - 5])));
+		} break;
+		case SET: {
+			return (dataStackSize >= 2 && IsLuaUnitVal(dataStack[dataStackSize - 2]));
+		} break;
+
+		// invalid pieces report an error, with the pc of the thread
+		case MOVE:
+		case TURN:
+		case SPIN:
+		case MOVE_NOW:
+		case TURN_NOW:
+		case HIDE:
+		case SHOW: {
+			return (cobInst->PieceExists(code[pc + 1]));
+		} break;
+		case EMIT_SFX: {
+			return (IsVisualSfx((dataStackSize > 0)? dataStack[dataStackSize - 1]: 0) && cobInst->PieceExists(code[pc + 1]));
+		} break;
+
+		// CALL rewrites the (shared) code, RAND needs the global order of
+		// the synced RNG, SIGNAL kills threads that might have been copied
+		// already; everything else reaches outside the owner (explosions
+		// create synced projectiles and thereby call into Lua)
+		default: {
+		} break;
+	}
+
+	return false;
+}
+
+
 bool CCobThread::Tick()
+{
+	return (Execute<false>(nullptr) != TickDead);
+}
+
+CCobThread::TickResult CCobThread::TickParallel(EffectLog& log)
+{
+	return (Execute<true>(&log));
+}
+
+
+void CCobThread::ApplyEffects(const EffectLog& log, size_t begin, size_t end)
+{
+	for (size_t i = begin; i < end; i++) {
+		const EffectLog::Effect& e = log.effects[i];
+		const int* args = e.args;
+
+		switch (e.opcode) {
+			case MOVE     : { cobInst->Move    (args[0], args[1], args[2], args[3]); } break;
+			case TURN     : { cobInst->Turn    (args[0], args[1], args[2], args[3]); } break;
+			case SPIN     : { cobInst->Spin    (args[0], args[1], args[2], args[3]); } break;
+			case STOP_SPIN: { cobInst->StopSpin(args[0], args[1], args[2]         ); } break;
+			case MOVE_NOW : { cobInst->MoveNow (args[0], args[1], args[2]         ); } break;
+			case TURN_NOW : { cobInst->TurnNow (args[0], args[1], args[2]         ); } break;
+
+			case HIDE: {
+				cobInst->SetVisibility(args[0], false);
+			} break;
+			case SHOW: {
+				if (args[1] != 0) {
+					cobInst->ShowFlare(args[0]);
+				} else {
+					cobInst->SetVisibility(args[0], true);
+				}
+			} break;
+
+			case EMIT_SFX: {
+				cobInst->EmitSfx(args[0], args[1]);
+			} break;
+			case PLAY_SOUND: {
+				cobInst->PlayUnitSound(args[0], args[1]);
+			} break;
+
+			case POP_STATIC: {
+				cobInst->staticVars[args[0]] = args[1];
+			} break;
+
+			case START: {
+				CCobThread t(cobInst);
+
+				t.SetID(cobEngine->GenThreadID());
+				t.InitStack(args[1], log.startArgs.data() + args[2]);
+				t.Start(args[0], args[3], {{0}}, true);
+
+				cobEngine->QueueAddThread(std::move(t));
+			} break;
+
+			// flags the anim as waited on
+			case WAIT_TURN: {
+				cobInst->NeedsWait(CCobInstance::ATurn, args[0], args[1]);
+			} break;
+			case WAIT_MOVE: {
+				cobInst->NeedsWait(CCobInstance::AMove, args[0], args[1]);
+			} break;
+
+			default: {
+				assert(false);
+			} break;
+		}
+	}
+}
+
+
+template<bool parallel>
+CCobThread::TickResult CCobThread::Execute(EffectLog* log)
 {
 	assert(state != Sleep);
 	assert(cobInst != nullptr);
 
 	if (IsDead())
-		return false;
+		return TickDead;
 
 	state = Run;
 
 	int r1, r2, r3, r4, r5, r6;
 
 	while (state == Run) {
+		if (parallel && !CanExecuteParallel(*log))
+			return TickDeferred;
+
 		const int opcode = GET_LONG_PC();
 
 		switch (opcode) {
@@ -401,14 +668,23 @@ bool CCobThread::Tick()
 				wakeTime = cobEngine->GetCurrentTime() + r1;
 				state = Sleep;
 
-				cobEngine->ScheduleThread(this);
-				return true;
+				if (!parallel)
+					cobEngine->ScheduleThread(this);
+
+				return TickAlive;
 			} break;
 			case SPIN: {
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = PopDataStack();         // speed
 				r4 = PopDataStack();         // accel
+
+				if (parallel) {
+					log->Add(SPIN, r1, r2, r3, r4);
+					log->animsChanged = true;
+					break;
+				}
+
 				cobInst->Spin(r1, r2, r3, r4);
 			} break;
 			case STOP_SPIN: {
@@ -416,6 +692,12 @@ bool CCobThread::Tick()
 				r2 = GET_LONG_PC();
 				r3 = PopDataStack();         // decel
 
+				if (parallel) {
+					log->Add(STOP_SPIN, r1, r2, r3);
+					log->animsChanged = true;
+					break;
+				}
+
 				cobInst->StopSpin(r1, r2, r3);
 			} break;
 			case RETURN: {
@@ -426,7 +708,7 @@ bool CCobThread::Tick()
 
 					// leave values intact on stack in case caller wants to check them
 					// callStackSize -= 1;
-					return false;
+					return TickDead;
 				}
 
 				// return to caller
@@ -491,6 +773,14 @@ bool CCobThread::Tick()
 				r1 = GET_LONG_PC();
 				r2 = PopDataStack();
 
+				if (parallel) {
+					if (static_cast<size_t>(r1) < log->staticVars.size()) {
+						log->staticVars[r1] = r2;
+						log->Add(POP_STATIC, r1, r2);
+					}
+					break;
+				}
+
 				if (static_cast<size_t>(r1) < cobInst->staticVars.size())
 					cobInst->staticVars[r1] = r2;
 			} break;
@@ -506,6 +796,15 @@ bool CCobThread::Tick()
 				if (cobFile->scriptLengths[r1] == 0)
 					break;
 
+				if (parallel) {
+					log->Add(START, r1, r2, int(log->startArgs.size()), signalMask);
+
+					for (int i = 0; i < r2; i++) {
+						log->startArgs.push_back(PopDataStack());
+					}
+					break;
+				}
+
 
 				CCobThread t(cobInst);
 
@@ -530,6 +829,9 @@ bool CCobThread::Tick()
 					PushDataStack(luaArgs[r1 - LUA0]);
 					break;
 				}
+				if (!parallel && IsBarrierUnitVal(r1))
+					cobEngine->AddBarrier();
+
 				r1 = cobInst->GetUnitVal(r1, 0, 0, 0, 0);
 				PushDataStack(r1);
 			} break;
@@ -586,18 +888,32 @@ bool CCobThread::Tick()
 			case EXPLODE: {
 				r1 = GET_LONG_PC();
 				r2 = PopDataStack();
+
+				cobEngine->AddBarrier();
 				cobInst->Explode(r1, r2);
 			} break;
 
 			case PLAY_SOUND: {
 				r1 = GET_LONG_PC();
 				r2 = PopDataStack();
+
+				if (parallel) {
+					log->Add(PLAY_SOUND, r1, r2);
+					break;
+				}
+
 				cobInst->PlayUnitSound(r1, r2);
 			} break;
 
 			case PUSH_STATIC: {
 				r1 = GET_LONG_PC();
 
+				if (parallel) {
+					if (static_cast<size_t>(r1) < log->staticVars.size())
+						PushDataStack(log->staticVars[r1]);
+					break;
+				}
+
 				if (static_cast<size_t>(r1) < cobInst->staticVars.size())
 					PushDataStack(cobInst->staticVars[r1]);
 			} break;
@@ -650,6 +966,16 @@ bool CCobThread::Tick()
 			case EMIT_SFX: {
 				r1 = PopDataStack();
 				r2 = GET_LONG_PC();
+
+				if (parallel) {
+					log->Add(EMIT_SFX, r1, r2);
+					break;
+				}
+
+				// weapons deal damage right away
+				if (!IsVisualSfx(r1))
+					cobEngine->AddBarrier();
+
 				cobInst->EmitSfx(r1, r2);
 			} break;
 			case MUL: {
@@ -675,6 +1001,12 @@ bool CCobThread::Tick()
 				r3 = GET_LONG_PC(); // piece
 				r4 = GET_LONG_PC(); // axis
 
+				if (parallel) {
+					log->Add(TURN, r3, r4, r1, r2);
+					log->animsChanged = true;
+					break;
+				}
+
 				cobInst->Turn(r3, r4, r1, r2);
 			} break;
 			case GET: {
@@ -687,6 +1019,9 @@ bool CCobThread::Tick()
 					PushDataStack(luaArgs[r1 - LUA0]);
 					break;
 				}
+				if (!parallel && IsBarrierUnitVal(r1))
+					cobEngine->AddBarrier();
+
 				r6 = cobInst->GetUnitVal(r1, r2, r3, r4, r5);
 				PushDataStack(r6);
 			} break;
@@ -732,18 +1067,37 @@ bool CCobThread::Tick()
 				r2 = GET_LONG_PC();
 				r4 = PopDataStack();
 				r3 = PopDataStack();
+
+				if (parallel) {
+					log->Add(MOVE, r1, r2, r3, r4);
+					log->animsChanged = true;
+					break;
+				}
+
 				cobInst->Move(r1, r2, r3, r4);
 			} break;
 			case MOVE_NOW: {
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = PopDataStack();
+
+				if (parallel) {
+					log->Add(MOVE_NOW, r1, r2, r3);
+					break;
+				}
+
 				cobInst->MoveNow(r1, r2, r3);
 			} break;
 			case TURN_NOW: {
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = PopDataStack();
+
+				if (parallel) {
+					log->Add(TURN_NOW, r1, r2, r3);
+					break;
+				}
+
 				cobInst->TurnNow(r1, r2, r3);
 			} break;
 
@@ -752,22 +1106,44 @@ bool CCobThread::Tick()
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 
+				if (parallel) {
+					if (cobInst->IsInAnimation(CCobInstance::ATurn, r1, r2)) {
+						log->Add(WAIT_TURN, r1, r2);
+						state = WaitTurn;
+						waitPiece = r1;
+						waitAxis = r2;
+						return TickAlive;
+					}
+					break;
+				}
+
 				if (cobInst->NeedsWait(CCobInstance::ATurn, r1, r2)) {
 					state = WaitTurn;
 					waitPiece = r1;
 					waitAxis = r2;
-					return true;
+					return TickAlive;
 				}
 			} break;
 			case WAIT_MOVE: {
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 
+				if (parallel) {
+					if (cobInst->IsInAnimation(CCobInstance::AMove, r1, r2)) {
+						log->Add(WAIT_MOVE, r1, r2);
+						state = WaitMove;
+						waitPiece = r1;
+						waitAxis = r2;
+						return TickAlive;
+					}
+					break;
+				}
+
 				if (cobInst->NeedsWait(CCobInstance::AMove, r1, r2)) {
 					state = WaitMove;
 					waitPiece = r1;
 					waitAxis = r2;
-					return true;
+					return TickAlive;
 				}
 			} break;
 
@@ -781,6 +1157,7 @@ bool CCobThread::Tick()
 					break;
 				}
 
+				cobEngine->AddBarrier();
 				cobInst->SetUnitVal(r1, r2);
 			} break;
 
@@ -789,10 +1166,14 @@ bool CCobThread::Tick()
 				r3 = PopDataStack();
 				r2 = PopDataStack();
 				r1 = PopDataStack();
+
+				cobEngine->AddBarrier();
 				cobInst->AttachUnit(r2, r1);
 			} break;
 			case DROP: {
 				r1 = PopDataStack();
+
+				cobEngine->AddBarrier();
 				cobInst->DropUnit(r1);
 			} break;
 
@@ -820,6 +1201,12 @@ bool CCobThread::Tick()
 
 			case HIDE: {
 				r1 = GET_LONG_PC();
+
+				if (parallel) {
+					log->Add(HIDE, r1);
+					break;
+				}
+
 				cobInst->SetVisibility(r1, false);
 			} break;
 
@@ -832,7 +1219,9 @@ bool CCobThread::Tick()
 						break;
 
 				// if true, we are in a Fire-script and should show a special flare effect
-				if (i < MAX_WEAPONS_PER_UNIT) {
+				if (parallel) {
+					log->Add(SHOW, r1, int(i < MAX_WEAPONS_PER_UNIT));
+				} else if (i < MAX_WEAPONS_PER_UNIT) {
 					cobInst->ShowFlare(r1);
 				} else {
 					cobInst->SetVisibility(r1, true);
@@ -854,13 +1243,13 @@ bool CCobThread::Tick()
 				#endif
 
 				state = Dead;
-				return false;
+				return TickDead;
 			} break;
 		}
 	}
 
 	// can arrive here as dead, through CCobInstance::Signal()
-	return (state != Dead);
+	return ((state != Dead)? TickAlive: TickDead);
 }
 
 void CCobThread::ShowError(const char* msg)
@@ -913,6 +1302,7 @@ void CCobThread::LuaCall()
 	}
 
 	int argsCount = argCount;
+	cobEngine->AddBarrier();
 	luaRules->Cob2Lua(cobFile->luaScripts[r1], cobInst->GetUnit(), argsCount, luaArgs);
 	retCode = luaArgs[0];
 }
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <array>
+#include <vector>
 
 #include "CobInstance.h"
 #include "Lua/LuaRules.h"
@@ -31,12 +32,69 @@ public:
 	CCobThread& operator = (CCobThread&& t);
 	CCobThread& operator = (const CCobThread& t);
 
+	/**
+	 * Like the copy-assignment, but also copies both stacks beyond their
+	 * live parts (which scripts can read through bad local-variable indices)
+	 * so the copy executes exactly like <t> would.
+	 */
+	void Assign(const CCobThread& t);
+
 	enum State {Init, Sleep, Run, Dead, WaitTurn, WaitMove};
+	enum TickResult {TickDead, TickAlive, TickDeferred};
+
+	/**
+	 * Effects of speculative ticks (see TickParallel) on the owning script
+	 * instance and the engine, in execution order. One log is shared by the
+	 * speculated threads of an instance; staticVars starts as a copy of the
+	 * instance's and reflects all writes recorded so far.
+	 */
+	struct EffectLog {
+		struct Effect {
+			int opcode;
+			int args[4];
+		};
+
+		void Clear(const CCobInstance* inst) {
+			effects.clear();
+			startArgs.clear();
+
+			staticVars = inst->staticVars;
+			animsChanged = false;
+		}
+
+		void Add(int opcode, int a0 = 0, int a1 = 0, int a2 = 0, int a3 = 0) {
+			effects.push_back({opcode, {a0, a1, a2, a3}});
+		}
+
+		std::vector<Effect> effects;
+		// stack arguments of STARTed threads, in popping order
+		std::vector<int> startArgs;
+		std::vector<int> staticVars;
+
+		// true once a recorded effect changes the anim-lists
+		bool animsChanged = false;
+	};
 
 	/**
 	 * Returns false if this thread is dead and needs to be killed.
 	 */
 	bool Tick();
+	/**
+	 * Speculative Tick on a copy of a thread, safe to call concurrently for
+	 * threads owned by different script instances. Reads only this thread,
+	 * <log> and the immutable parts of its instance; anything the regular
+	 * interpreter would write outside the thread is recorded into <log>, for
+	 * ApplyEffects to replay on the instance. Stops in front of the first
+	 * opcode that needs state it can not see, or that has effects which can
+	 * not be replayed in order (TickDeferred); Tick continues from there.
+	 * Does not schedule the thread if it goes to sleep.
+	 */
+	TickResult TickParallel(EffectLog& log);
+	/**
+	 * Replays effects [begin, end) of <log> on this thread's instance, in
+	 * the same order the regular interpreter would have caused them.
+	 */
+	void ApplyEffects(const EffectLog& log, size_t begin, size_t end);
 	/**
 	 * This function sets the thread in motion. Should only be called once.
 	 * If schedule is false the thread is not added to the scheduler, and thus
@@ -68,6 +126,7 @@ public:
 	 */
 	int CheckStack(unsigned int size, bool warn);
 	void InitStack(unsigned int n, CCobThread* t);
+	void InitStack(unsigned int n, const int* args);
 
 	/**
 	 * Shows an errormessage which includes the current state of the script
@@ -105,6 +164,10 @@ protected:
 		int stackTop = -1;
 	};
 
+	template<bool parallel> TickResult Execute(EffectLog* log);
+
+	bool CanExecuteParallel(const EffectLog& log) const;
+
 	void LuaCall();
 
 	bool PushCallStack(CallInfo v) { return (callStackSize < callStack.size() && PushCallStackRaw(v)); }
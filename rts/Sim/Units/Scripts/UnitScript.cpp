@@ -8,6 +8,8 @@
 #include "CobInstance.h"
 #include "UnitScriptEngine.h"
 
+#include <algorithm>
+
 #ifndef _CONSOLE
 
 #include "Game/GameHelper.h"
@@ -53,7 +55,7 @@ CR_BIND_INTERFACE(CUnitScript)
 CR_REG_METADATA(CUnitScript, (
 	CR_MEMBER(unit),
 	CR_MEMBER(busy),
-	CR_MEMBER(anims),
+	CR_MEMBER(animSlots),
 
 	//Populated by children
 	CR_IGNORED(pieces),
@@ -62,18 +64,6 @@ CR_REG_METADATA(CUnitScript, (
 	CR_IGNORED(hasStartBuilding)
 ))
 
-CR_BIND(CUnitScript::AnimInfo,)
-
-CR_REG_METADATA_SUB(CUnitScript, AnimInfo,(
-	CR_MEMBER(axis),
-	CR_MEMBER(piece),
-	CR_MEMBER(speed),
-	CR_MEMBER(dest),
-	CR_MEMBER(accel),
-	CR_MEMBER(done),
-	CR_MEMBER(hasWaiting)
-))
-
 
 CUnitScript::CUnitScript(CUnit* unit)
 	: unit(unit)
@@ -86,172 +76,52 @@ CUnitScript::CUnitScript(CUnit* unit)
 
 CUnitScript::~CUnitScript()
 {
-	// Remove us from possible animation ticking
-	if (!HaveAnimations())
-		return;
-
-	unitScriptEngine->RemoveInstance(this);
-}
-
-
-/******************************************************************************/
-
-
-/**
- * @brief Updates move animations
- * @param cur float value to update
- * @param dest float final value
- * @param speed float max increment per tick
- * @return returns true if destination was reached, false otherwise
- */
-bool CUnitScript::MoveToward(float& cur, float dest, float speed)
-{
-	const float delta = dest - cur;
-
-	if (math::fabsf(delta) <= speed) {
-		cur = dest;
-		return true;
-	}
-
-	cur += (speed * Sign(delta));
-	return false;
-}
-
-
-/**
- * @brief Updates turn animations
- * @param cur float value to update
- * @param dest float final value
- * @param speed float max increment per tick
- * @return returns true if destination was reached, false otherwise
- */
-bool CUnitScript::TurnToward(float& cur, float dest, float speed)
-{
-	float delta = dest - cur;
-
-	// clamp: -pi .. 0 .. +pi (fmod(x,TWOPI) would do the same but is slower due to streflop)
-	if (delta > math::PI) {
-		delta -= math::TWOPI;
-	} else if (delta <= -math::PI) {
-		delta += math::TWOPI;
-	}
-
-	if (math::fabsf(delta) <= speed) {
-		cur = dest;
-		return true;
+	// Remove us from animation ticking, back to front
+	// so swap-removal never moves one of our own slots
+	for (int animType = ATurn; animType <= AMove; animType++) {
+		while (!animSlots[animType].empty()) {
+			unitScriptEngine->RemoveAnim(animType, *std::max_element(animSlots[animType].begin(), animSlots[animType].end()));
+		}
 	}
-
-	cur = ClampRad(cur + speed * Sign(delta));
-	return false;
 }
 
 
-/**
- * @brief Updates spin animations
- * @param cur float value to update
- * @param dest float the final desired speed (NOT the final angle!)
- * @param speed float is updated if it is not equal to dest
- * @param divisor int is the deltatime, it is not added before the call because speed may have to be updated
- * @return true if the desired speed is 0 and it is reached, false otherwise
- */
-bool CUnitScript::DoSpin(float& cur, float dest, float& speed, float accel, int divisor)
-{
-	const float delta = dest - speed;
-
-	// Check if we are not at the final speed and
-	// make sure we do not go past desired speed
-	if (math::fabsf(delta) <= accel) {
-		if ((speed = dest) == 0.0f)
-			return true;
-	} else {
-		// accelerations are defined in speed/frame (at GAME_SPEED fps)
-		speed += (accel * (GAME_SPEED * 1.0f / divisor) * Sign(delta));
-	}
-
-	cur = ClampRad(cur + (speed / divisor));
-	return false;
-}
-
-
-
-void CUnitScript::TickAnims(int tickRate, const TickAnimFunc& tickAnimFunc, AnimContainerType& liveAnims, AnimContainerType& doneAnims) {
-	for (size_t i = 0; i < liveAnims.size(); ) {
-		AnimInfo& ai = liveAnims[i];
-		LocalModelPiece& lmp = *pieces[ai.piece];
-
-		if ((ai.done |= (this->*tickAnimFunc)(tickRate, lmp, ai))) {
-			if (ai.hasWaiting)
-				doneAnims.push_back(ai);
-
-			ai = liveAnims.back();
-			liveAnims.pop_back();
-			continue;
-		}
+/******************************************************************************/
 
-		++i;
-	}
-}
 
-/**
- * @brief Called by the engine when we are registered as animating.
-          If we return false there are no active animations left.
- * @param deltaTime int delta time to update
- * @return true if there are still active animations
- */
-bool CUnitScript::Tick(int deltaTime)
+int CUnitScript::FindAnim(AnimType type, int piece, int axis) const
 {
-	// vector of indexes of finished animations,
-	// so we can get rid of them in constant time
-	static AnimContainerType doneAnims[AMove + 1];
-	// tick-functions; these never change address
-	static constexpr TickAnimFunc tickAnimFuncs[AMove + 1] = {&CUnitScript::TickTurnAnim, &CUnitScript::TickSpinAnim, &CUnitScript::TickMoveAnim};
+	const CUnitScriptEngine::AnimTable& animTable = unitScriptEngine->GetAnimTable(type);
 
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		TickAnims(1000 / deltaTime, tickAnimFuncs[animType], anims[animType], doneAnims[animType]);
-	}
-
-	// Tell listeners to unblock, and remove finished animations from the unit/script.
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (AnimInfo& ai: doneAnims[animType]) {
-			AnimFinished((AnimType) animType, ai.piece, ai.axis);
-		}
-
-		doneAnims[animType].clear();
+	for (const int animSlot: animSlots[type]) {
+		if (animTable.pieces[animSlot] == piece && animTable.axes[animSlot] == axis)
+			return animSlot;
 	}
 
-	return (HaveAnimations());
-}
-
-
-
-CUnitScript::AnimContainerTypeIt CUnitScript::FindAnim(AnimType type, int piece, int axis)
-{
-	const auto& pred = [&](const AnimInfo& ai) { return (ai.piece == piece && ai.axis == axis); };
-	const auto& iter = std::find_if(anims[type].begin(), anims[type].end(), pred);
-	return iter;
+	return -1;
 }
 
-void CUnitScript::RemoveAnim(AnimType type, const AnimContainerTypeIt& animInfoIt)
+void CUnitScript::RemoveAnim(AnimType type, int animSlot)
 {
-	if (animInfoIt == anims[type].end())
+	if (animSlot == -1)
 		return;
 
-	AnimInfo& ai = *animInfoIt;
+	const CUnitScriptEngine::AnimTable& animTable = unitScriptEngine->GetAnimTable(type);
 
-	// We need to unblock threads waiting on this animation, otherwise they will be lost in the void
-	// NOTE: AnimFinished might result in new anims being added
-	if (ai.hasWaiting)
-		AnimFinished(type, ai.piece, ai.axis);
+	const int piece = animTable.pieces[animSlot];
+	const int axis = animTable.axes[animSlot];
 
-	ai = anims[type].back();
-	anims[type].pop_back();
+	// We need to unblock threads waiting on this animation, otherwise they will be lost in the void
+	// NOTE: AnimFinished might result in new anims being added (or this one being removed), so the
+	// slot is looked up again afterwards
+	if (animTable.waiting[animSlot]) {
+		AnimFinished(type, piece, axis);
 
-	// If this was the last animation, remove from currently animating list
-	// FIXME: this could be done in a cleaner way
-	if (HaveAnimations())
-		return;
+		if ((animSlot = FindAnim(type, piece, axis)) == -1)
+			return;
+	}
 
-	unitScriptEngine->RemoveInstance(this);
+	unitScriptEngine->RemoveAnim(type, animSlot);
 }
 
 
@@ -274,8 +144,7 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 		destf = mix(dest, ClampRad(dest), type == ATurn);
 	}
 
-	AnimContainerTypeIt animInfoIt;
-	AnimInfo* ai = nullptr;
+	int animSlot = -1;
 	AnimType overrideType = ANone;
 
 	// first find an animation of a type we override
@@ -285,64 +154,53 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 	switch (type) {
 		case ATurn: {
 			overrideType = ASpin;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animSlot = FindAnim(overrideType, piece, axis);
 		} break;
 		case ASpin: {
 			overrideType = ATurn;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animSlot = FindAnim(overrideType, piece, axis);
 		} break;
 		case AMove: {
 			// ensure we never remove an animation of this type
 			overrideType = AMove;
-			animInfoIt = anims[overrideType].end();
+			animSlot = -1;
 		} break;
 		default: {
 		} break;
 	}
 	assert(overrideType >= 0);
 
-	if (animInfoIt != anims[overrideType].end())
-		RemoveAnim(overrideType, animInfoIt);
+	if (animSlot != -1)
+		RemoveAnim(overrideType, animSlot);
 
 	// now find an animation of our own type
-	animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt == anims[type].end()) {
-		// If we were not animating before, inform the engine of this so it can schedule us
-		// FIXME: this could be done in a cleaner way
-		if (!HaveAnimations())
-			unitScriptEngine->AddInstance(this);
-
-		anims[type].emplace_back();
-		ai = &anims[type].back();
-		ai->piece = piece;
-		ai->axis = axis;
-	} else {
-		ai = &(*animInfoIt);
-	}
+	if ((animSlot = FindAnim(type, piece, axis)) == -1)
+		animSlot = unitScriptEngine->AddAnim(this, type, piece, axis);
 
-	ai->dest  = destf;
-	ai->speed = speed;
-	ai->accel = accel;
-	ai->done = false;
+	CUnitScriptEngine::AnimTable& animTable = unitScriptEngine->GetAnimTable(type);
+
+	animTable.dests[animSlot] = destf;
+	animTable.speeds[animSlot] = speed;
+	animTable.accels[animSlot] = accel;
 }
 
 
 void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 {
-	auto animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animSlot = FindAnim(ASpin, piece, axis);
 
 	// if we are already spinning, we may have to decelerate to the new speed
-	if (animInfoIt != anims[ASpin].end()) {
-		AnimInfo* ai = &(*animInfoIt);
-		ai->dest = speed;
+	if (animSlot != -1) {
+		CUnitScriptEngine::AnimTable& animTable = unitScriptEngine->GetAnimTable(ASpin);
+
+		animTable.dests[animSlot] = speed;
 
 		if (accel > 0.0f) {
-			ai->accel = accel;
+			animTable.accels[animSlot] = accel;
 		} else {
 			// Go there instantly. Or have a defaul accel?
-			ai->speed = speed;
-			ai->accel = 0.0f;
+			animTable.speeds[animSlot] = speed;
+			animTable.accels[animSlot] = 0.0f;
 		}
 
 		return;
@@ -359,17 +217,18 @@ void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 
 void CUnitScript::StopSpin(int piece, int axis, float decel)
 {
-	auto animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animSlot = FindAnim(ASpin, piece, axis);
 
 	if (decel <= 0.0f) {
-		RemoveAnim(ASpin, animInfoIt);
+		RemoveAnim(ASpin, animSlot);
 	} else {
-		if (animInfoIt == anims[ASpin].end())
+		if (animSlot == -1)
 			return;
 
-		AnimInfo* ai = &(*animInfoIt);
-		ai->dest = 0.0f;
-		ai->accel = decel;
+		CUnitScriptEngine::AnimTable& animTable = unitScriptEngine->GetAnimTable(ASpin);
+
+		animTable.dests[animSlot] = 0.0f;
+		animTable.accels[animSlot] = decel;
 	}
 }
 
@@ -665,28 +524,15 @@ void CUnitScript::DropUnit(int u)
 //Returns true if there was an animation to listen to
 bool CUnitScript::NeedsWait(AnimType type, int piece, int axis)
 {
-	auto animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt == anims[type].end())
-		return false;
+	const int animSlot = FindAnim(type, piece, axis);
 
-	AnimInfo& ai = *animInfoIt;
-
-	// if the animation is already finished, listening for
-	// it just adds some overhead since either the current
-	// or the next Tick will remove it and call UnblockAll
-	// (which calls AnimFinished for each listener)
-	//
-	// we could notify the listener here, but a cleaner way
-	// is to treat the animation as if it did not exist and
-	// simply disregard the WaitFor* (no side-effects)
-	//
-	// if (ai.hasWaiting)
-	// 		AnimFinished(ai.type, ai.piece, ai.axis);
-	if (ai.done)
+	if (animSlot == -1)
 		return false;
 
-	return (ai.hasWaiting = true);
+	// finished animations are removed during the same tick
+	// they complete in, so anything still here is running
+	unitScriptEngine->GetAnimTable(type).waiting[animSlot] = 1;
+	return true;
 }
 
 
@@ -18,7 +18,10 @@ class CPlasmaRepulser;
 class CUnitScript
 {
 	CR_DECLARE(CUnitScript)
-	CR_DECLARE_SUB(AnimInfo)
+
+	// owns the animation data, see CUnitScriptEngine::AnimTable
+	friend class CUnitScriptEngine;
+
 public:
 	enum AnimType {ANone = -1, ATurn = 0, ASpin = 1, AMove = 2};
 
@@ -26,35 +29,17 @@ protected:
 	CUnit* unit;
 	bool busy;
 
-	struct AnimInfo {
-		CR_DECLARE_STRUCT(AnimInfo)
-		int axis;
-		int piece;
-		float speed;
-		float dest;     // means final position when turning or moving, final speed when spinning
-		float accel;    // used for spinning, can be negative
-		bool done;
-		bool hasWaiting;
-	};
-
-	typedef std::vector<AnimInfo> AnimContainerType;
-	typedef AnimContainerType::iterator AnimContainerTypeIt;
-
-	typedef bool(CUnitScript::*TickAnimFunc)(int, LocalModelPiece&, AnimInfo&);
-
-	AnimContainerType anims[AMove + 1];
+	// slots of our live animations in the engine's per-type tables
+	std::vector<int> animSlots[AMove + 1];
 
 
 	bool hasSetSFXOccupy;
 	bool hasRockUnit;
 	bool hasStartBuilding;
 
-	bool MoveToward(float& cur, float dest, float speed);
-	bool TurnToward(float& cur, float dest, float speed);
-	bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor);
-
-	AnimContainerTypeIt FindAnim(AnimType type, int piece, int axis);
-	void RemoveAnim(AnimType type, const AnimContainerTypeIt& animInfoIt);
+	/// returns the animation's slot, or -1 if there is none
+	int FindAnim(AnimType type, int piece, int axis) const;
+	void RemoveAnim(AnimType type, int animSlot);
 	void AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel);
 
 	virtual void ShowScriptError(const std::string& msg) = 0;
@@ -106,13 +91,6 @@ public:
 	      CUnit* GetUnit()       { return unit; }
 	const CUnit* GetUnit() const { return unit; }
 
-	bool Tick(int tickRate);
-	// note: must copy-and-set here (LMP dirty flag, etc)
-	bool TickMoveAnim(int tickRate, LocalModelPiece& lmp, AnimInfo& ai) { float3 pos = lmp.GetPosition(); const bool ret = MoveToward(pos[ai.axis], ai.dest, ai.speed / tickRate); lmp.SetPosition(pos); return ret; }
-	bool TickTurnAnim(int tickRate, LocalModelPiece& lmp, AnimInfo& ai) { float3 rot = lmp.GetRotation(); const bool ret = TurnToward(rot[ai.axis], ai.dest, ai.speed / tickRate); lmp.SetRotation(rot); return ret; }
-	bool TickSpinAnim(int tickRate, LocalModelPiece& lmp, AnimInfo& ai) { float3 rot = lmp.GetRotation(); const bool ret = DoSpin(rot[ai.axis], ai.dest, ai.speed, ai.accel, tickRate); lmp.SetRotation(rot); return ret; }
-	void TickAnims(int tickRate, const TickAnimFunc& tickAnimFunc, AnimContainerType& liveAnims, AnimContainerType& doneAnims);
-
 	// animation, used by CCobThread
 	void Spin(int piece, int axis, float speed, float accel);
 	void StopSpin(int piece, int axis, float decel);
@@ -138,11 +116,11 @@ public:
 	int GetUnitVal(int val, int p1, int p2, int p3, int p4);
 	void SetUnitVal(int val, int param);
 
-	bool IsInAnimation(AnimType type, int piece, int axis) {
-		return (FindAnim(type, piece, axis) != anims[type].end());
+	bool IsInAnimation(AnimType type, int piece, int axis) const {
+		return (FindAnim(type, piece, axis) != -1);
 	}
 	bool HaveAnimations() const {
-		return (!anims[ATurn].empty() || !anims[ASpin].empty() || !anims[AMove].empty());
+		return (!animSlots[ATurn].empty() || !animSlots[ASpin].empty() || !animSlots[AMove].empty());
 	}
 
 	// checks for callin existence
@@ -0,0 +1,72 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef UNIT_SCRIPT_ANIMS_H
+#define UNIT_SCRIPT_ANIMS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Sim/Misc/GlobalConstants.h"
+#include "System/SpringMath.h"
+
+/*
+ * The per-animation update rules of CUnitScriptEngine::TickAnims, applied
+ * to whole arrays. They are kept branch-free (|x| <= y is written as
+ * (x <= y) & (-x <= y) since math::fabsf is an out-of-line call with
+ * streflop) so the compiler can vectorize them (GCC needs -fno-trapping-math
+ * for the selects), and give bit-identical results to the old per-piece
+ * MoveToward, TurnToward and DoSpin. Wrapping turn and spin angles into
+ * [0, 2pi) needs fmod and is left to the caller (ClampRad on every value
+ * whose done flag is not set).
+ */
+namespace UnitScriptAnims {
+	inline void AdvanceTurns(float* values, std::uint8_t* done, const float* speeds, const float* dests, size_t numAnims, int tickRate)
+	{
+		for (size_t i = 0; i < numAnims; i++) {
+			const float step = speeds[i] / tickRate;
+
+			float delta = dests[i] - values[i];
+
+			// clamp: -pi .. 0 .. +pi
+			delta -= (math::TWOPI * (delta >   math::PI));
+			delta += (math::TWOPI * (delta <= -math::PI));
+
+			const bool reached = ((delta <= step) & (-delta <= step));
+
+			values[i] = reached? dests[i]: (values[i] + step * Sign(delta));
+			done[i] = reached;
+		}
+	}
+
+	inline void AdvanceSpins(float* values, std::uint8_t* done, float* speeds, const float* dests, const float* accels, size_t numAnims, int tickRate)
+	{
+		// accelerations are defined in speed/frame (at GAME_SPEED fps)
+		const float accelScale = GAME_SPEED * 1.0f / tickRate;
+
+		for (size_t i = 0; i < numAnims; i++) {
+			// speed moves toward the final speed (not angle) in <dest>
+			const float delta = dests[i] - speeds[i];
+			const bool reached = ((delta <= accels[i]) & (-delta <= accels[i]));
+
+			speeds[i] = reached? dests[i]: (speeds[i] + accels[i] * accelScale * Sign(delta));
+
+			// only a spin that has come to a stop is finished
+			done[i] = (reached & (dests[i] == 0.0f));
+			values[i] = done[i]? values[i]: (values[i] + speeds[i] / tickRate);
+		}
+	}
+
+	inline void AdvanceMoves(float* values, std::uint8_t* done, const float* speeds, const float* dests, size_t numAnims, int tickRate)
+	{
+		for (size_t i = 0; i < numAnims; i++) {
+			const float step = speeds[i] / tickRate;
+			const float delta = dests[i] - values[i];
+			const bool reached = ((delta <= step) & (-delta <= step));
+
+			values[i] = reached? dests[i]: (values[i] + step * Sign(delta));
+			done[i] = reached;
+		}
+	}
+}
+
+#endif
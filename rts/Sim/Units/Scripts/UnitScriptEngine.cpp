@@ -7,12 +7,17 @@
 #include "CobEngine.h"
 #include "CobFileHandler.h"
 #include "UnitScript.h"
+#include "UnitScriptAnims.h"
 #include "UnitScriptFactory.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitDef.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Units/UnitHandler.h"
 #include "System/ContainerUtil.h"
 #include "System/SafeUtil.h"
+#include "System/SpringMath.h"
+
+#include <algorithm>
 
 static CCobEngine gCobEngine;
 static CCobFileHandler gCobFileHandler;
@@ -26,10 +31,26 @@ CUnitScriptEngine* unitScriptEngine = nullptr;
 CR_BIND(CUnitScriptEngine, )
 
 CR_REG_METADATA(CUnitScriptEngine, (
-	CR_MEMBER(animating),
+	CR_MEMBER(animTables),
+
+	// always empty when saving
+	CR_IGNORED(animEvents),
+	CR_IGNORED(doneSlots)
+))
 
-	// always null when saving
-	CR_IGNORED(currentScript)
+CR_BIND(CUnitScriptEngine::AnimTable, )
+
+CR_REG_METADATA_SUB(CUnitScriptEngine, AnimTable, (
+	CR_MEMBER(scripts),
+	CR_MEMBER(pieces),
+	CR_MEMBER(axes),
+	CR_MEMBER(speeds),
+	CR_MEMBER(dests),
+	CR_MEMBER(accels),
+	CR_MEMBER(waiting),
+
+	CR_IGNORED(values),
+	CR_IGNORED(done)
 ))
 
 
@@ -97,20 +118,74 @@ void CUnitScriptEngine::ReloadScripts(const UnitDef* udef)
 }
 
 
-void CUnitScriptEngine::AddInstance(CUnitScript* instance)
+void CUnitScriptEngine::Init()
 {
-	if (instance == currentScript)
-		return;
+	for (AnimTable& animTable: animTables) {
+		animTable.scripts.reserve(256);
+	}
 
-	spring::VectorInsertUnique(animating, instance/*, true*/);
+	animEvents.reserve(256);
+	doneSlots.reserve(256);
 }
 
-void CUnitScriptEngine::RemoveInstance(CUnitScript* instance)
+void CUnitScriptEngine::Kill()
 {
-	if (instance == currentScript)
-		return;
+	for (AnimTable& animTable: animTables) {
+		animTable = {};
+	}
+
+	animEvents.clear();
+	doneSlots.clear();
+}
+
+
+int CUnitScriptEngine::AddAnim(CUnitScript* script, int type, int piece, int axis)
+{
+	AnimTable& t = animTables[type];
+
+	const int slot = t.size();
+
+	t.scripts.push_back(script);
+	t.pieces.push_back(piece);
+	t.axes.push_back(axis);
+	t.speeds.push_back(0.0f);
+	t.dests.push_back(0.0f);
+	t.accels.push_back(0.0f);
+	t.waiting.push_back(0);
+
+	script->animSlots[type].push_back(slot);
+	return slot;
+}
+
+void CUnitScriptEngine::RemoveAnim(int type, int slot)
+{
+	AnimTable& t = animTables[type];
+
+	const int last = t.size() - 1;
+
+	assert(slot >= 0 && slot <= last);
+	spring::VectorErase(t.scripts[slot]->animSlots[type], slot);
+
+	if (slot != last) {
+		t.scripts[slot] = t.scripts[last];
+		t.pieces[slot] = t.pieces[last];
+		t.axes[slot] = t.axes[last];
+		t.speeds[slot] = t.speeds[last];
+		t.dests[slot] = t.dests[last];
+		t.accels[slot] = t.accels[last];
+		t.waiting[slot] = t.waiting[last];
 
-	spring::VectorErase(animating, instance);
+		std::vector<int>& ownerSlots = t.scripts[slot]->animSlots[type];
+		std::replace(ownerSlots.begin(), ownerSlots.end(), last, slot);
+	}
+
+	t.scripts.pop_back();
+	t.pieces.pop_back();
+	t.axes.pop_back();
+	t.speeds.pop_back();
+	t.dests.pop_back();
+	t.accels.pop_back();
+	t.waiting.pop_back();
 }
 
 
@@ -118,19 +193,76 @@ void CUnitScriptEngine::Tick(int deltaTime)
 {
 	cobEngine->Tick(deltaTime);
 
-	// tick all (COB or LUS) script instances that have registered themselves as animating
-	for (size_t i = 0; i < animating.size(); ) {
-		currentScript = animating[i];
+	// advance all (COB or LUS) script animations
+	TickAnims(1000 / deltaTime);
+}
+
 
-		if (!currentScript->Tick(deltaTime)) {
-			animating[i] = animating.back();
-			animating.pop_back();
-			continue;
+void CUnitScriptEngine::TickAnims(int tickRate)
+{
+	animEvents.clear();
+
+	for (int type = CUnitScript::ATurn; type <= CUnitScript::AMove; type++) {
+		AnimTable& t = animTables[type];
+
+		const size_t numAnims = t.size();
+		const bool isMove = (type == CUnitScript::AMove);
+
+		t.values.resize(numAnims);
+		t.done.resize(numAnims);
+
+		// gather the animated piece coordinates
+		for (size_t i = 0; i < numAnims; i++) {
+			const LocalModelPiece* lmp = t.scripts[i]->pieces[t.pieces[i]];
+			const float3& src = isMove? lmp->GetPosition(): lmp->GetRotation();
+
+			t.values[i] = src[t.axes[i]];
 		}
 
-		i++;
+		switch (type) {
+			case CUnitScript::ATurn: { UnitScriptAnims::AdvanceTurns(t.values.data(), t.done.data(), t.speeds.data(), t.dests.data(),                  numAnims, tickRate); } break;
+			case CUnitScript::ASpin: { UnitScriptAnims::AdvanceSpins(t.values.data(), t.done.data(), t.speeds.data(), t.dests.data(), t.accels.data(), numAnims, tickRate); } break;
+			case CUnitScript::AMove: { UnitScriptAnims::AdvanceMoves(t.values.data(), t.done.data(), t.speeds.data(), t.dests.data(),                  numAnims, tickRate); } break;
+			default: {} break;
+		}
+
+		doneSlots.clear();
+
+		// scatter; must copy-and-set here (LMP dirty flag, etc)
+		for (size_t i = 0; i < numAnims; i++) {
+			LocalModelPiece* lmp = t.scripts[i]->pieces[t.pieces[i]];
+
+			if (isMove) {
+				float3 pos = lmp->GetPosition();
+				pos[t.axes[i]] = t.values[i];
+				lmp->SetPosition(pos);
+			} else {
+				float3 rot = lmp->GetRotation();
+				rot[t.axes[i]] = t.done[i]? t.values[i]: ClampRad(t.values[i]);
+				lmp->SetRotation(rot);
+			}
+
+			if (!t.done[i])
+				continue;
+
+			if (t.waiting[i])
+				animEvents.push_back({t.scripts[i], type, t.pieces[i], t.axes[i]});
+
+			doneSlots.push_back(i);
+		}
+
+		// back to front, so swap-removal only ever moves live animations
+		for (auto it = doneSlots.rbegin(); it != doneSlots.rend(); ++it) {
+			RemoveAnim(type, *it);
+		}
+	}
+
+	// tell listeners to unblock; done after all animations were advanced
+	// since callbacks (e.g. from Lua unit scripts) can start new ones
+	for (const AnimEvent& e: animEvents) {
+		e.script->AnimFinished(static_cast<CUnitScript::AnimType>(e.type), e.piece, e.axis);
 	}
 
-	currentScript = nullptr;
+	animEvents.clear();
 }
 
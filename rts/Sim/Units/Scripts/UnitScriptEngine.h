@@ -5,6 +5,7 @@
 #ifndef UNIT_SCRIPT_ENGINE_H
 #define UNIT_SCRIPT_ENGINE_H
 
+#include <cstdint>
 #include <vector>
 
 #include "System/creg/creg_cond.h"
@@ -17,24 +18,69 @@ class CUnitScript;
 class CUnitScriptEngine
 {
 	CR_DECLARE_STRUCT(CUnitScriptEngine)
+	CR_DECLARE_SUB(AnimTable)
+
+public:
+	/**
+	 * All live animations of one type (turn, spin or move) over all script
+	 * instances, packed struct-of-arrays style so Tick can advance them in a
+	 * single pass. Slots are swap-removed; every CUnitScript keeps the slots
+	 * it owns in its animSlots list.
+	 */
+	struct AnimTable {
+		CR_DECLARE_STRUCT(AnimTable)
+
+		size_t size() const { return scripts.size(); }
+
+		std::vector<CUnitScript*> scripts;
+		std::vector<int> pieces; // script piece indices
+		std::vector<int> axes;
+
+		std::vector<float> speeds;
+		std::vector<float> dests; // final position when turning or moving, final speed when spinning
+		std::vector<float> accels; // used for spinning, can be negative
+		std::vector<std::uint8_t> waiting; // set if a script thread is waiting for completion
+
+		// per-tick scratch, current piece values and completion flags
+		std::vector<float> values;
+		std::vector<std::uint8_t> done;
+	};
 
 public:
-	void AddInstance(CUnitScript* instance);
-	void RemoveInstance(CUnitScript* instance);
 	void ReloadScripts(const UnitDef* udef);
 
+	/// returns the slot of the new animation in GetAnimTable(type)
+	int AddAnim(CUnitScript* script, int type, int piece, int axis);
+	/// frees <slot> without notifying anyone
+	void RemoveAnim(int type, int slot);
+
+	      AnimTable& GetAnimTable(int type)       { return animTables[type]; }
+	const AnimTable& GetAnimTable(int type) const { return animTables[type]; }
+
 	void Tick(int deltaTime);
 
-	void Init() { animating.reserve(256); }
-	void Kill() { animating.clear(); }
+	void Init();
+	void Kill();
 
 	static void InitStatic();
 	static void KillStatic();
 
 private:
-	CUnitScript* currentScript = nullptr;
+	void TickAnims(int tickRate);
+
+	struct AnimEvent {
+		CUnitScript* script;
+		int type;
+		int piece;
+		int axis;
+	};
+
+	// indexed by CUnitScript::AnimType
+	AnimTable animTables[3];
 
-	std::vector<CUnitScript*> animating;
+	// finished animations with waiting threads, collected during TickAnims
+	std::vector<AnimEvent> animEvents;
+	std::vector<int> doneSlots;
 };
 
 extern CUnitScriptEngine* unitScriptEngine;
@@ -39,12 +39,7 @@ UnitDefWeapon::UnitDefWeapon(const WeaponDef* weaponDef, const LuaTable& weaponT
 	//     (arcs are always symmetric around mainDir)
 	this->maxMainDirAngleDif = math::cos((weaponTable.GetFloat("maxAngleDif", 360.0f) * 0.5f) * math::DEG_TO_RAD);
 
-	const string& btcString = weaponTable.GetString("badTargetCategory", "");
-	const string& otcString = weaponTable.GetString("onlyTargetCategory", "");
-
-	this->badTargetCat =                                   CCategoryHandler::Instance()->GetCategories(btcString);
-	this->onlyTargetCat = (otcString.empty())? 0xffffffff: CCategoryHandler::Instance()->GetCategories(otcString);
-
+	// {bad,only}TargetCat are set by UnitDef::ResolveCategories
 	this->mainDir = weaponTable.GetFloat3("mainDir", FwdVector);
 	this->mainDir.SafeNormalize();
 }
@@ -480,11 +475,10 @@ UnitDef::UnitDef(const LuaTable& udTable, const std::string& unitName, int id)
 	maxThisUnit = std::min(maxThisUnit, gameSetup->GetRestrictedUnitLimit(name, MAX_UNITS));
 
 	categoryString = udTable.GetString("category", "");
+	noChaseCategoryString = udTable.GetString("noChaseCategory", "");
 
-	category = CCategoryHandler::Instance()->GetCategories(udTable.GetString("category", ""));
-	noChaseCategory = CCategoryHandler::Instance()->GetCategories(udTable.GetString("noChaseCategory", ""));
-
-	iconType = icon::iconHandler.GetIcon(udTable.GetString("iconType", "default"));
+	// resolved by ResolveIconType, CIcon refcounting is not thread-safe
+	iconTypeName = udTable.GetString("iconType", "default");
 
 	shieldWeaponDef    = nullptr;
 	stockpileWeaponDef = nullptr;
@@ -688,6 +682,7 @@ void UnitDef::ParseWeaponsTable(const LuaTable& weaponsTable)
 			weapons[k++] = {noWeaponDef};
 		}
 
+		weaponCategoryNames.emplace_back(k, wTable.GetString("badTargetCategory", ""), wTable.GetString("onlyTargetCategory", ""));
 		weapons[k++] = {wd, wTable};
 
 		maxWeaponRange = std::max(maxWeaponRange, wd->range);
@@ -711,6 +706,33 @@ void UnitDef::ParseWeaponsTable(const LuaTable& weaponsTable)
 
 
 
+void UnitDef::ResolveIconType()
+{
+	iconType = icon::iconHandler.GetIcon(iconTypeName);
+}
+
+void UnitDef::ResolveCategories()
+{
+	CCategoryHandler* categoryHandler = CCategoryHandler::Instance();
+
+	category = categoryHandler->GetCategories(categoryString);
+	noChaseCategory = categoryHandler->GetCategories(noChaseCategoryString);
+
+	for (const auto& names: weaponCategoryNames) {
+		UnitDefWeapon& udw = weapons[std::get<0>(names)];
+
+		const std::string& btcString = std::get<1>(names);
+		const std::string& otcString = std::get<2>(names);
+
+		udw.badTargetCat =                                   categoryHandler->GetCategories(btcString);
+		udw.onlyTargetCat = (otcString.empty())? 0xffffffff: categoryHandler->GetCategories(otcString);
+	}
+
+	weaponCategoryNames.clear();
+}
+
+
+
 void UnitDef::CreateYardMap(std::string&& yardMapStr)
 {
 	// if a unit is immobile but does *not* have a yardmap
@@ -789,7 +811,7 @@ void UnitDef::CreateYardMap(std::string&& yardMapStr)
 void UnitDef::SetNoCost(bool noCost)
 {
 	if (noCost) {
-		// initialized from UnitDefHandler::PushNewUnitDef
+		// initialized from UnitDefHandler::CommitUnitDef
 		realMetalCost    = metal;
 		realEnergyCost   = energy;
 		realMetalUpkeep  = metalUpkeep;
@@ -3,6 +3,7 @@
 #ifndef UNITDEF_H
 #define UNITDEF_H
 
+#include <tuple>
 #include <vector>
 
 #include "Rendering/Icon.h"
@@ -53,6 +54,12 @@ public:
 
 	void SetNoCost(bool noCost);
 
+	// turns the category names read by the ctor into bits; must be called
+	// in id-order since CCategoryHandler assigns bits in order of first use
+	void ResolveCategories();
+	// looks up the icon named by the ctor; must be called on the main thread
+	void ResolveIconType();
+
 	bool IsTransportUnit()     const { return (transportCapacity > 0 && transportMass > 0.0f); }
 	bool IsImmobileUnit()      const { return (pathType == -1U && !canfly && speed <= 0.0f); }
 	bool IsBuildingUnit()      const { return (IsImmobileUnit() && !yardmap.empty()); }
@@ -378,6 +385,11 @@ private:
 	void ParseWeaponsTable(const LuaTable& weaponsTable);
 	void CreateYardMap(std::string&& yardMapStr);
 
+	std::string noChaseCategoryString;
+	std::string iconTypeName;
+	// {weapon index, badTargetCategory, onlyTargetCategory}, until resolved
+	std::vector<std::tuple<unsigned int, std::string, std::string>> weaponCategoryNames;
+
 	float realMetalCost;
 	float realEnergyCost;
 	float realMetalUpkeep;
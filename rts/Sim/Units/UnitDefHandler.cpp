@@ -12,6 +12,7 @@
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
+#include "System/Misc/SpringTime.h"
 #include "System/Sound/ISound.h"
 
 
@@ -30,6 +31,7 @@ void CUnitDefHandler::Init(LuaParser* defsParser)
 {
 	noCost = false;
 
+	const spring_time startTime = spring_gettime();
 	const LuaTable& rootTable = defsParser->GetRoot().SubTable("UnitDefs");
 
 	if (!rootTable.IsValid())
@@ -38,25 +40,47 @@ void CUnitDefHandler::Init(LuaParser* defsParser)
 	std::vector<std::string> unitDefNames;
 	rootTable.GetKeys(unitDefNames);
 
+	// defs are parsed on the thread-pool, which can not touch the lua_State
+	const LuaTable rootSnapshot = rootTable.Snapshot();
+	const spring_time parseTime = spring_gettime();
+
+	std::vector<UnitDef> parsedDefs(unitDefNames.size());
+	std::vector<DefParseResult> parseResults(unitDefNames.size());
+
+	// parse the unitdef data (but don't load buildpics, etc...); IDs are
+	// only known after the failed defs have been skipped when committing
+	ParseDefsParallel(parseResults, [&](const int i) {
+		parsedDefs[i] = UnitDef(rootSnapshot.SubTable(unitDefNames[i]), StringToLower(unitDefNames[i]), 0);
+	});
+
+	const spring_time commitTime = spring_gettime();
+
 	unitDefIDs.reserve(unitDefNames.size() + 1);
 	unitDefsVector.reserve(unitDefNames.size() + 1);
 	unitDefsVector.emplace_back();
 
 	for (unsigned int a = 0; a < unitDefNames.size(); ++a) {
 		const string& unitName = unitDefNames[a];
-		const LuaTable& udTable = rootTable.SubTable(unitName);
+		const LuaTable& udTable = rootSnapshot.SubTable(unitName);
 
-		// parse the unitdef data (but don't load buildpics, etc...)
-		PushNewUnitDef(StringToLower(unitName), udTable);
+		CommitUnitDef(StringToLower(unitName), udTable, parsedDefs[a], parseResults[a]);
 	}
 
 	CleanBuildOptions();
 	ProcessDecoys();
+
+	LOG("[UnitDefHandler::%s] loaded %u UnitDefs in %ims (snapshot=%ims parse=%ims commit=%ims)", __func__,
+		NumUnitDefs(),
+		int((spring_gettime() - startTime).toMilliSecsi()),
+		int((parseTime - startTime).toMilliSecsi()),
+		int((commitTime - parseTime).toMilliSecsi()),
+		int((spring_gettime() - commitTime).toMilliSecsi())
+	);
 }
 
 
 
-int CUnitDefHandler::PushNewUnitDef(const std::string& unitName, const LuaTable& udTable)
+int CUnitDefHandler::CommitUnitDef(const std::string& unitName, const LuaTable& udTable, UnitDef& parsedDef, const DefParseResult& parseResult)
 {
 	if (std::find_if(unitName.begin(), unitName.end(), isblank) != unitName.end())
 		LOG_L(L_WARNING, "[%s] UnitDef name \"%s\" contains white-spaces", __func__, unitName.c_str());
@@ -64,8 +88,13 @@ int CUnitDefHandler::PushNewUnitDef(const std::string& unitName, const LuaTable&
 	const int defID = unitDefsVector.size();
 
 	try {
-		unitDefsVector.emplace_back(udTable, unitName, defID);
+		parseResult.Commit();
+
+		unitDefsVector.emplace_back(std::move(parsedDef));
 		UnitDef& newDef = unitDefsVector.back();
+		newDef.id = defID;
+		newDef.ResolveCategories();
+		newDef.ResolveIconType();
 		UnitDefLoadSounds(&newDef, udTable);
 
 		// map unitName to newDef.decoyName
@@ -52,13 +52,13 @@ public:
 	// id=0 is not a valid UnitDef, hence the -1
 	unsigned int NumUnitDefs() const { return (unitDefsVector.size() - 1); }
 
-	int PushNewUnitDef(const std::string& unitName, const LuaTable& udTable);
-
 	const std::vector<UnitDef>& GetUnitDefsVec() const { return unitDefsVector; }
 	const spring::unordered_map<std::string, int>& GetUnitDefIDs() const { return unitDefIDs; }
 	const spring::unordered_map<int, std::vector<int> >& GetDecoyDefIDs() const { return decoyMap; }
 
 protected:
+	int CommitUnitDef(const std::string& unitName, const LuaTable& udTable, UnitDef& parsedDef, const DefParseResult& parseResult);
+
 	void UnitDefLoadSounds(UnitDef*, const LuaTable&);
 	void LoadSounds(const LuaTable&, GuiSoundSet&, const std::string& soundName);
 
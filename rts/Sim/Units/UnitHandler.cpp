@@ -19,6 +19,7 @@
 #include "System/Log/ILog.h"
 #include "System/SpringMath.h"
 #include "System/TimeProfiler.h"
+#include "System/Sync/SyncedPrimitiveBase.h"
 #include "System/Sync/SyncTracer.h"
 #include "System/creg/STL_Deque.h"
 #include "System/creg/STL_Set.h"
@@ -38,6 +39,8 @@ CR_REG_METADATA(CUnitHandler, (
 	CR_MEMBER(activeSlowUpdateUnit),
 	CR_MEMBER(activeUpdateUnit),
 
+	CR_IGNORED(numBoundingVolumeUpdates),
+
 	CR_MEMBER(maxUnits),
 	CR_MEMBER(maxUnitRadius),
 
@@ -98,6 +101,8 @@ void CUnitHandler::Init() {
 	{
 		activeSlowUpdateUnit = 0;
 		activeUpdateUnit = 0;
+
+		numBoundingVolumeUpdates = {0, 0};
 	}
 	{
 		units.resize(maxUnits, nullptr);
@@ -301,11 +306,14 @@ void CUnitHandler::DeleteUnit(CUnit* delUnit)
 void CUnitHandler::UpdateUnitMoveTypes()
 {
 	SCOPED_TIMER("Sim::Unit::MoveType");
+	SYNC_DEBUG_PHASE(SYNC_PHASE_UNIT_MOVETYPES);
 
 	for (activeUpdateUnit = 0; activeUpdateUnit < activeUnits.size(); ++activeUpdateUnit) {
 		CUnit* unit = activeUnits[activeUpdateUnit];
 		AMoveType* moveType = unit->moveType;
 
+		SYNC_DEBUG_OBJECT(unit->id);
+
 		unit->SanityCheck();
 		unit->PreUpdate();
 
@@ -324,7 +332,11 @@ void CUnitHandler::UpdateUnitMoveTypes()
 
 void CUnitHandler::UpdateUnitLosStates()
 {
+	SYNC_DEBUG_PHASE(SYNC_PHASE_UNIT_LOSSTATES);
+
 	for (CUnit* unit: activeUnits) {
+		SYNC_DEBUG_OBJECT(unit->id);
+
 		for (int at = 0; at < teamHandler.ActiveAllyTeams(); ++at) {
 			unit->UpdateLosStatus(at);
 		}
@@ -341,14 +353,23 @@ void CUnitHandler::SlowUpdateUnits()
 	if ((gs->frameNum % UNIT_SLOWUPDATE_RATE) == 0)
 		activeSlowUpdateUnit = 0;
 
+	numBoundingVolumeUpdates = {0, 0};
+
+	SYNC_DEBUG_PHASE(SYNC_PHASE_UNIT_SLOWUPDATES);
+
 	// stagger the SlowUpdate's
 	for (size_t n = (activeUnits.size() / UNIT_SLOWUPDATE_RATE) + 1; (activeSlowUpdateUnit < activeUnits.size() && n != 0); ++activeSlowUpdateUnit) {
 		CUnit* unit = activeUnits[activeSlowUpdateUnit];
 
+		SYNC_DEBUG_OBJECT(unit->id);
+
 		unit->SanityCheck();
 		unit->SlowUpdate();
 		unit->SlowUpdateWeapons();
-		unit->localModel.UpdateBoundingVolume();
+
+		numBoundingVolumeUpdates.x += unit->localModel.UpdateBoundingVolume();
+		numBoundingVolumeUpdates.y += 1;
+
 		unit->SanityCheck();
 
 		n--;
@@ -358,10 +379,13 @@ void CUnitHandler::SlowUpdateUnits()
 void CUnitHandler::UpdateUnits()
 {
 	SCOPED_TIMER("Sim::Unit::Update");
+	SYNC_DEBUG_PHASE(SYNC_PHASE_UNIT_UPDATES);
 
 	for (activeUpdateUnit = 0; activeUpdateUnit < activeUnits.size(); ++activeUpdateUnit) {
 		CUnit* unit = activeUnits[activeUpdateUnit];
 
+		SYNC_DEBUG_OBJECT(unit->id);
+
 		unit->SanityCheck();
 		unit->Update();
 		// unsynced; done on-demand when drawing unit
@@ -375,7 +399,10 @@ void CUnitHandler::UpdateUnits()
 void CUnitHandler::UpdateUnitWeapons()
 {
 	SCOPED_TIMER("Sim::Unit::Weapon");
+	SYNC_DEBUG_PHASE(SYNC_PHASE_UNIT_WEAPONS);
+
 	for (activeUpdateUnit = 0; activeUpdateUnit < activeUnits.size(); ++activeUpdateUnit) {
+		SYNC_DEBUG_OBJECT(activeUnits[activeUpdateUnit]->id);
 		activeUnits[activeUpdateUnit]->UpdateWeapons();
 	}
 }
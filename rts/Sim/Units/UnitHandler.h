@@ -8,6 +8,7 @@
 
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/SimObjectIDPool.h"
+#include "System/type2.h"
 #include "System/creg/STL_Map.h"
 
 struct UnitDef;
@@ -73,6 +74,9 @@ public:
 
 	const spring::unordered_map<unsigned int, CBuilderCAI*>& GetBuilderCAIs() const { return builderCAIs; }
 
+	/// {rebuilt, checked} unit bounding-volumes during the last SlowUpdateUnits
+	int2 GetNumBoundingVolumeUpdates() const { return numBoundingVolumeUpdates; }
+
 private:
 	void InsertActiveUnit(CUnit* unit);
 	bool QueueDeleteUnit(CUnit* unit);
@@ -100,6 +104,8 @@ private:
 	size_t activeSlowUpdateUnit = 0;  ///< first unit of batch that will be SlowUpdate'd this frame
 	size_t activeUpdateUnit = 0;      ///< first unit of batch that will be SlowUpdate'd this frame
 
+	int2 numBoundingVolumeUpdates;    ///< per-frame debug counter, see GetNumBoundingVolumeUpdates
+
 
 	///< global unit-limit (derived from the per-team limit)
 	///< units.size() is equal to this and constant at runtime
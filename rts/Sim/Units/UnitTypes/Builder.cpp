@@ -432,7 +432,10 @@ bool CBuilder::UpdateResurrect(const Command& fCommand)
 		// TODO: make configurable if this should happen
 		resurrectee->health *= 0.05f;
 
-		for (const int resurrecterID: cai->resurrecters) {
+		const std::vector<int>* resurrecters = cai->resurrecters.GetBuilders(curResurrectee->id);
+		const std::vector<int> noResurrecters;
+
+		for (const int resurrecterID: (resurrecters != nullptr)? *resurrecters: noResurrecters) {
 			CBuilder* resurrecter = static_cast<CBuilder*>(unitHandler.GetUnit(resurrecterID));
 			CCommandAI* resurrecterCAI = resurrecter->commandAI;
 
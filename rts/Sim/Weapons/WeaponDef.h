@@ -262,8 +262,11 @@ public:
 	};
 	Visuals visuals;
 
-private:
+	// not done by the ctor; sound-set data is indexed in the order
+	// it is added, so CWeaponDefHandler calls this in id-order
 	void ParseWeaponSounds(const LuaTable& wdTable);
+
+private:
 	void LoadSound(const LuaTable& wdTable, const std::string& soundKey, GuiSoundSet& soundSet);
 };
 
@@ -11,6 +11,8 @@
 #include "Sim/Misc/DamageArrayHandler.h"
 #include "System/Exceptions.h"
 #include "System/StringUtil.h"
+#include "System/Log/ILog.h"
+#include "System/Misc/SpringTime.h"
 
 
 static CWeaponDefHandler gWeaponDefHandler;
@@ -19,6 +21,7 @@ CWeaponDefHandler* weaponDefHandler = &gWeaponDefHandler;
 
 void CWeaponDefHandler::Init(LuaParser* defsParser)
 {
+	const spring_time startTime = spring_gettime();
 	const LuaTable& rootTable = defsParser->GetRoot().SubTable("WeaponDefs");
 
 	if (!rootTable.IsValid())
@@ -27,15 +30,38 @@ void CWeaponDefHandler::Init(LuaParser* defsParser)
 	std::vector<std::string> weaponNames;
 	rootTable.GetKeys(weaponNames);
 
+	// defs are parsed on the thread-pool, which can not touch the lua_State
+	const LuaTable rootSnapshot = rootTable.Snapshot();
+	const spring_time parseTime = spring_gettime();
+
+	std::vector<WeaponDef> parsedDefs(weaponNames.size());
+	std::vector<DefParseResult> parseResults(weaponNames.size());
+
+	ParseDefsParallel(parseResults, [&](const int wid) {
+		parsedDefs[wid] = WeaponDef(rootSnapshot.SubTable(weaponNames[wid]), weaponNames[wid], wid);
+	});
+
+	const spring_time commitTime = spring_gettime();
+
 	weaponDefsVector.reserve(weaponNames.size());
 	weaponDefIDs.reserve(weaponNames.size());
 
 	for (int wid = 0; wid < weaponNames.size(); wid++) {
 		const std::string& name = weaponNames[wid];
-		const LuaTable wdTable = rootTable.SubTable(name);
-		weaponDefsVector.emplace_back(wdTable, name, wid);
+
+		parseResults[wid].Commit();
+		weaponDefsVector.emplace_back(std::move(parsedDefs[wid]));
+		weaponDefsVector.back().ParseWeaponSounds(rootSnapshot.SubTable(name));
 		weaponDefIDs[name] = wid;
 	}
+
+	LOG("[WeaponDefHandler::%s] loaded %u WeaponDefs in %ims (snapshot=%ims parse=%ims commit=%ims)", __func__,
+		uint32_t(weaponDefsVector.size()),
+		int((spring_gettime() - startTime).toMilliSecsi()),
+		int((parseTime - startTime).toMilliSecsi()),
+		int((commitTime - parseTime).toMilliSecsi()),
+		int((spring_gettime() - commitTime).toMilliSecsi())
+	);
 }
 
 
@@ -0,0 +1,95 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <new>
+
+#include "AllocCounter.h"
+#include "System/SpringFormat.h"
+#include "System/Sync/SyncChecksumTree.h"
+
+// only the thread inside a ScopedPhase (normally the sim thread) counts;
+// workers picking up for_mt jobs on its behalf are not attributed
+static thread_local int curPhaseID = -1;
+
+static std::array<AllocCounter::PhaseStats, NUM_SYNC_PHASES> phaseStats = {};
+static unsigned int numFrames = 0;
+
+
+#ifdef ALLOC_COUNTING
+static inline void* CountedAlloc(std::size_t size)
+{
+	if (curPhaseID >= 0) {
+		phaseStats[curPhaseID].numAllocs += 1;
+		phaseStats[curPhaseID].numBytes += size;
+	}
+
+	return std::malloc(std::max(size, std::size_t(1)));
+}
+
+void* operator new  (std::size_t size) {
+	void* p = CountedAlloc(size);
+
+	if (p == nullptr)
+		throw std::bad_alloc();
+
+	return p;
+}
+void* operator new[](std::size_t size) {
+	void* p = CountedAlloc(size);
+
+	if (p == nullptr)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+
+void operator delete  (void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete  (void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete  (void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
+
+
+AllocCounter::ScopedPhase::ScopedPhase(unsigned int phaseID): prevPhaseID(curPhaseID)
+{
+	curPhaseID = phaseID;
+}
+
+AllocCounter::ScopedPhase::~ScopedPhase()
+{
+	curPhaseID = prevPhaseID;
+}
+
+
+void AllocCounter::EndFrame() { numFrames += 1; }
+void AllocCounter::Reset()
+{
+	phaseStats.fill({0, 0});
+	numFrames = 0;
+}
+
+unsigned int AllocCounter::GetNumFrames() { return numFrames; }
+AllocCounter::PhaseStats AllocCounter::GetPhaseStats(unsigned int phaseID) { return phaseStats[phaseID]; }
+
+
+std::string AllocCounter::GetReport()
+{
+	std::string report;
+
+	const double invNumFrames = 1.0 / std::max(numFrames, 1u);
+
+	for (unsigned int phaseID = 0; phaseID < NUM_SYNC_PHASES; phaseID++) {
+		const PhaseStats& stats = phaseStats[phaseID];
+
+		report += spring::format("allocs[%s]: %.1f %.0f\n", CSyncChecksumTree::GetPhaseName(phaseID), stats.numAllocs * invNumFrames, stats.numBytes * invNumFrames);
+	}
+
+	return report;
+}
@@ -0,0 +1,54 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+#include <string>
+
+#include "System/Sync/SyncChecksumTree.h"
+
+// attribute heap allocations made by this thread to a sim phase (see
+// SyncDebugPhase); only compiled in with -DALLOC_COUNTING=TRUE, which
+// replaces the global operator new to do the counting
+#ifdef ALLOC_COUNTING
+#  define ALLOC_COUNTER_PHASE(phaseID) AllocCounter::ScopedPhase allocCounterPhase(phaseID)
+#else
+#  define ALLOC_COUNTER_PHASE(phaseID)
+#endif
+
+namespace AllocCounter {
+	struct PhaseStats {
+		std::uint64_t numAllocs;
+		std::uint64_t numBytes;
+	};
+
+	class ScopedPhase {
+	public:
+		ScopedPhase(unsigned int phaseID);
+		~ScopedPhase();
+
+	private:
+		int prevPhaseID;
+	};
+
+	constexpr bool IsEnabled() {
+		#ifdef ALLOC_COUNTING
+		return true;
+		#else
+		return false;
+		#endif
+	}
+
+	/// marks the end of a sim-frame, the report averages over frames
+	void EndFrame();
+	void Reset();
+
+	unsigned int GetNumFrames();
+	PhaseStats GetPhaseStats(unsigned int phaseID);
+
+	/// one "allocs[<phase>]: <allocs/frame> <bytes/frame>" line per phase
+	std::string GetReport();
+}
+
+#endif
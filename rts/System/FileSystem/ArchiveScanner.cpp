@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdio>
 #include <memory>
 
@@ -18,10 +19,13 @@
 #include "DataDirsAccess.h"
 #include "FileSystem.h"
 #include "FileQueryFlags.h"
+#include "MemoryMappedFile.h"
 #include "Lua/LuaParser.h"
 #include "System/ContainerUtil.h"
 #include "System/StringUtil.h"
 #include "System/Exceptions.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Misc/SpringTime.h"
 #include "System/Threading/ThreadPool.h"
 #include "System/FileSystem/RapidHandler.h"
 #include "System/Log/ILog.h"
@@ -38,6 +42,12 @@
 LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_ARCHIVESCANNER)
 
 
+CONFIG(int, ArchiveScannerMaxConcurrentIO)
+	.defaultValue(4)
+	.minimumValue(1)
+	.description("Maximum number of archives opened at the same time while scanning or checksumming.");
+
+
 /*
  * The archive scanner is used to find stuff in archives
  * which are needed before building the virtual filesystem.
@@ -54,6 +64,141 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_ARCHIVESCANNER)
 constexpr static int INTERNAL_VER = 16;
 
 
+/*
+ * Layout of ArchiveCache<INTERNAL_VER>.bin, in native byte-order (the cache
+ * is never shared between machines):
+ *
+ *   header | archives | brokenArchives | infoItems | dependencies | strings
+ *
+ * Archive and broken-archive records are sorted by lower-case name so they
+ * can be binary-searched directly in the mapped file. All strings live in a
+ * table of NUL-terminated entries and are referenced by byte offset; offset
+ * 0 is the empty string.
+ */
+namespace binary_cache {
+	constexpr static uint32_t MAGIC = 0x43415353; // "SSAC"
+	constexpr static uint32_t VERSION = 1;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t internalVer;
+		uint32_t fileSize;
+
+		uint32_t numArchives;
+		uint32_t numBrokenArchives;
+		uint32_t numInfoItems;
+		uint32_t numDependencies;
+		uint32_t stringTableSize;
+	};
+
+	struct Archive {
+		uint32_t lcName;
+		uint32_t origName;
+		uint32_t path;
+		uint32_t archiveDataPath;
+
+		uint32_t modified;
+		uint32_t modifiedArchiveData;
+
+		uint32_t firstInfoItem;
+		uint32_t numInfoItems;
+		uint32_t firstDependency;
+		uint32_t numDependencies;
+
+		uint8_t checksum[sha512::SHA_LEN];
+	};
+
+	struct BrokenArchive {
+		uint32_t name;
+		uint32_t path;
+		uint32_t problem;
+		uint32_t modified;
+	};
+
+	struct InfoItem {
+		uint32_t key;
+		uint32_t valueType;
+		uint32_t value; // string offset, or the bits of an int/float/bool
+	};
+
+	static_assert((sizeof(Header) % 4) == 0, "");
+	static_assert((sizeof(Archive) % 4) == 0, "");
+
+
+	struct View {
+		const Header* header = nullptr;
+		const Archive* archives = nullptr;
+		const BrokenArchive* brokenArchives = nullptr;
+		const InfoItem* infoItems = nullptr;
+		const uint32_t* dependencies = nullptr;
+		const char* strings = nullptr;
+
+		bool Init(const uint8_t* data, size_t size) {
+			if (size < sizeof(Header))
+				return false;
+
+			header = reinterpret_cast<const Header*>(data);
+
+			if (header->magic != MAGIC || header->version != VERSION || header->internalVer != INTERNAL_VER)
+				return false;
+			if (header->fileSize != size)
+				return false;
+
+			const uint64_t archivesOffset = sizeof(Header);
+			const uint64_t brokenArchivesOffset = archivesOffset + uint64_t(header->numArchives) * sizeof(Archive);
+			const uint64_t infoItemsOffset = brokenArchivesOffset + uint64_t(header->numBrokenArchives) * sizeof(BrokenArchive);
+			const uint64_t dependenciesOffset = infoItemsOffset + uint64_t(header->numInfoItems) * sizeof(InfoItem);
+			const uint64_t stringsOffset = dependenciesOffset + uint64_t(header->numDependencies) * sizeof(uint32_t);
+
+			if ((stringsOffset + header->stringTableSize) != size)
+				return false;
+			// table must contain at least the empty string and end with a terminator
+			if (header->stringTableSize == 0 || data[size - 1] != 0)
+				return false;
+
+			archives = reinterpret_cast<const Archive*>(data + archivesOffset);
+			brokenArchives = reinterpret_cast<const BrokenArchive*>(data + brokenArchivesOffset);
+			infoItems = reinterpret_cast<const InfoItem*>(data + infoItemsOffset);
+			dependencies = reinterpret_cast<const uint32_t*>(data + dependenciesOffset);
+			strings = reinterpret_cast<const char*>(data + stringsOffset);
+			return true;
+		}
+
+		// out-of-range offsets (corrupted file) resolve to the empty string
+		const char* GetString(uint32_t offset) const { return ((offset < header->stringTableSize)? (strings + offset): strings); }
+
+		bool IsValidSpan(uint32_t first, uint32_t count, uint32_t total) const { return (uint64_t(first) + count <= total); }
+	};
+
+
+	struct StringTable {
+		StringTable() { data.push_back(0); }
+
+		uint32_t Add(const std::string& str) {
+			if (str.empty())
+				return 0;
+
+			const auto iter = offsets.find(str);
+
+			if (iter != offsets.end())
+				return iter->second;
+
+			const uint32_t offset = data.size();
+
+			data.insert(data.end(), str.begin(), str.end());
+			data.push_back(0);
+
+			offsets.insert(str, offset);
+			return offset;
+		}
+
+		std::vector<char> data;
+		spring::unordered_map<std::string, uint32_t> offsets;
+	};
+}
+
+
 /*
  * Engine known (and used?) tags in [map|mod]info.lua
  */
@@ -388,7 +533,7 @@ CArchiveScanner::CArchiveScanner()
 {
 	Clear();
 	// the "cache" dir is created in DataDirLocater
-	ReadCacheData(cachefile = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + IntToString(INTERNAL_VER, "ArchiveCache%i.lua"));
+	ReadCacheData(cachefile = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + IntToString(INTERNAL_VER, "ArchiveCache%i"));
 	ScanAllDirs();
 }
 
@@ -418,7 +563,10 @@ void CArchiveScanner::Clear()
 	brokenArchives.reserve(16);
 	brokenArchivesIndex.clear();
 	brokenArchivesIndex.reserve(16);
+	completeChecksums.clear();
 	cachefile.clear();
+
+	ReleaseCacheFile();
 }
 
 void CArchiveScanner::Reload()
@@ -432,7 +580,7 @@ void CArchiveScanner::Reload()
 
 	// ctor
 	Clear();
-	ReadCacheData(cachefile = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + IntToString(INTERNAL_VER, "ArchiveCache%i.lua"));
+	ReadCacheData(cachefile = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + IntToString(INTERNAL_VER, "ArchiveCache%i"));
 	ScanAllDirs();
 }
 
@@ -462,6 +610,8 @@ void CArchiveScanner::ScanAllDirs()
 #endif
 
 	ScanDirs(scanDirs);
+	// every archive on disk has been looked up, remaining records are stale
+	ReleaseCacheFile();
 	WriteCacheData(GetFilepath());
 }
 
@@ -470,8 +620,12 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs)
 {
 	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
 	std::deque<std::string> foundArchives;
+	std::vector<ArchiveScanResult> scanResults;
 
 	isDirty = true;
+	completeChecksums.clear();
+
+	const spring_time findStartTime = spring_gettime();
 
 	// scan for all archives
 	for (const std::string& dir: scanDirs) {
@@ -498,14 +652,65 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs)
 		}
 	}*/
 
-	// Create archiveInfos etc. if not in cache already
+	const spring_time cacheStartTime = spring_gettime();
+
+	// skip archives whose cached info is still valid, this only needs a stat
 	for (const std::string& archive: foundArchives) {
-		ScanArchive(archive, false);
-	#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer(WDT_MAIN);
-	#endif
+		unsigned modified = 0;
+
+		if (CheckCachedData(archive, modified, false))
+			continue;
+
+		scanResults.emplace_back();
+		scanResults.back().fullName = archive;
+		scanResults.back().modified = modified;
 	}
 
+	const spring_time scanStartTime = spring_gettime();
+	const int numScanLanes = std::min(GetMaxConcurrentArchives(), int(scanResults.size()));
+
+	// open and parse all uncached archives concurrently; each lane pulls the
+	// next archive from a shared counter so no more than numScanLanes are open
+	// at any time (spinning disks degrade quickly under random access)
+	{
+		std::atomic<int> nextResultIdx = {0};
+
+		for_mt(0, numScanLanes, [&](const int laneIdx) {
+			for (int i = nextResultIdx.fetch_add(1); i < int(scanResults.size()); i = nextResultIdx.fetch_add(1)) {
+				ScanArchiveData(scanResults[i], false);
+
+				#if !defined(DEDICATED) && !defined(UNITSYNC)
+				Watchdog::ClearTimer(WDT_MAIN);
+				#endif
+			}
+		});
+	}
+
+	const spring_time commitStartTime = spring_gettime();
+
+	// create archiveInfos etc. in discovery order, s.t. duplicates are resolved
+	// exactly as a serial scan would (the first archive found with a name wins)
+	for (ArchiveScanResult& result: scanResults) {
+		unsigned modified = 0;
+
+		if (CheckCachedData(result.fullName, modified, false))
+			continue;
+
+		CommitScanResult(result);
+	}
+
+	const spring_time commitEndTime = spring_gettime();
+
+	LOG(
+		"[AS::%s] %u archives (%u uncached, %d lanes) in %ims: find=%ims cache=%ims scan=%ims commit=%ims",
+		__func__, unsigned(foundArchives.size()), unsigned(scanResults.size()), numScanLanes,
+		int((commitEndTime - findStartTime).toMilliSecsi()),
+		int((cacheStartTime - findStartTime).toMilliSecsi()),
+		int((scanStartTime - cacheStartTime).toMilliSecsi()),
+		int((commitStartTime - scanStartTime).toMilliSecsi()),
+		int((commitEndTime - commitStartTime).toMilliSecsi())
+	);
+
 	// Now we'll have to parse the replaces-stuff found in the mods
 	for (const auto& archiveInfo: archiveInfos) {
 		const std::string& lcOriginalName = StringToLower(archiveInfo.origName);
@@ -562,8 +767,12 @@ static void AddDependency(std::vector<std::string>& deps, const std::string& dep
 	spring::VectorInsertUnique(deps, dependency, true);
 }
 
-bool CArchiveScanner::CheckCompression(const IArchive* ar, const std::string& fullName, std::string& error)
-{
+bool CArchiveScanner::CheckCompression(
+	const IArchive* ar,
+	const std::string& fullName,
+	std::string& error,
+	std::vector<std::string>& warnings
+) {
 	if (!ar->CheckForSolid())
 		return true;
 
@@ -580,7 +789,7 @@ bool CArchiveScanner::CheckCompression(const IArchive* ar, const std::string& fu
 				return false;
 			} break;
 			case 2: {
-				LOG_SL(LOG_SECTION_ARCHIVESCANNER, L_WARNING, "Archive %s: reading secondary meta-file %s too expensive", fullName.c_str(), info.first.c_str());
+				warnings.emplace_back("Archive " + fullName + ": reading secondary meta-file " + info.first + " too expensive");
 			} break;
 			case 0:
 			default: {
@@ -640,11 +849,11 @@ CArchiveScanner::BrokenArchive& CArchiveScanner::GetAddBrokenArchive(const std::
 
 void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 {
-	unsigned modifiedTime = 0;
+	ArchiveScanResult result;
 
 	assert(!isInScan);
 
-	if (CheckCachedData(fullName, modifiedTime, doChecksum))
+	if (CheckCachedData(fullName, result.modified, doChecksum))
 		return;
 
 	isDirty = true;
@@ -659,28 +868,28 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 
 	const ScanScope scanScope(&isInScan);
 
-	const std::string& fname = FileSystem::GetFilename(fullName);
-	const std::string& fpath = FileSystem::GetDirectory(fullName);
-	const std::string& lcfn  = StringToLower(fname);
+	result.fullName = fullName;
+
+	ScanArchiveData(result, doChecksum);
+	CommitScanResult(result);
+}
+
+
+void CArchiveScanner::ScanArchiveData(ArchiveScanResult& result, bool doChecksum)
+{
+	const std::string& fullName = result.fullName;
 
 	std::unique_ptr<IArchive> ar(archiveLoader.OpenArchive(fullName));
 
 	if (ar == nullptr || !ar->IsOpen()) {
-		LOG_L(L_WARNING, "[AS::%s] unable to open archive \"%s\"", __func__, fullName.c_str());
-
 		// record it as broken, so we don't need to look inside everytime
-		BrokenArchive& ba = GetAddBrokenArchive(lcfn);
-		ba.name = lcfn;
-		ba.path = fpath;
-		ba.modified = modifiedTime;
-		ba.updated = true;
-		ba.problem = "Unable to open archive";
-
-		// does not count as a scan
-		// numScannedArchives += 1;
+		result.warnings.emplace_back("[AS::ScanArchive] unable to open archive \"" + fullName + "\"");
+		result.problem = "Unable to open archive";
 		return;
 	}
 
+	result.opened = true;
+
 	std::string error;
 	std::string arMapFile; // file in archive with "smf" extension
 	std::string miMapFile; // value for the 'mapfile' key parsed from mapinfo
@@ -690,7 +899,7 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 	const bool hasMapInfo = ar->FileExists("mapinfo.lua");
 
 
-	ArchiveInfo ai;
+	ArchiveInfo& ai = result.archiveInfo;
 	ArchiveData& ad = ai.archiveData;
 
 	// execute the respective .lua, otherwise assume this archive is a map
@@ -699,7 +908,7 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 
 		if ((miMapFile = ad.GetMapFile()).empty()) {
 			if (ar->GetType() != ARCHIVE_TYPE_SDV)
-				LOG_L(L_WARNING, "[AS::%s] set the 'mapfile' key in mapinfo.lua of archive \"%s\" for faster loading!", __func__, fullName.c_str());
+				result.warnings.emplace_back("[AS::ScanArchive] set the 'mapfile' key in mapinfo.lua of archive \"" + fullName + "\" for faster loading!");
 
 			arMapFile = SearchMapFile(ar.get(), error);
 		}
@@ -709,19 +918,10 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 		arMapFile = SearchMapFile(ar.get(), error);
 	}
 
-	if (!CheckCompression(ar.get(), fullName, error)) {
-		LOG_L(L_WARNING, "[AS::%s] failed to scan \"%s\" (%s)", __func__, fullName.c_str(), error.c_str());
-
+	if (!CheckCompression(ar.get(), fullName, error, result.warnings)) {
 		// mark archive as broken, so we don't need to look inside everytime
-		BrokenArchive& ba = GetAddBrokenArchive(lcfn);
-		ba.name = lcfn;
-		ba.path = fpath;
-		ba.modified = modifiedTime;
-		ba.updated = true;
-		ba.problem = error;
-
-		// does count as a scan
-		numScannedArchives += 1;
+		result.warnings.emplace_back("[AS::ScanArchive] failed to scan \"" + fullName + "\" (" + error + ")");
+		result.problem = error;
 		return;
 	}
 
@@ -739,21 +939,21 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 		AddDependency(ad.GetDependencies(), GetMapHelperContentName());
 		ad.SetInfoItemValueInteger("modType", modtype::map);
 
-		LOG_S(LOG_SECTION_ARCHIVESCANNER, "Found new map: %s", ad.GetNameVersioned().c_str());
+		result.messages.emplace_back("Found new map: " + ad.GetNameVersioned());
 	} else if (hasModInfo) {
 		// game or base-type (cursors, bitmaps, ...) archive
 		// babysitting like this is really no longer required
 		if (ad.IsGame() || ad.IsMenu())
 			AddDependency(ad.GetDependencies(), GetSpringBaseContentName());
 
-		LOG_S(LOG_SECTION_ARCHIVESCANNER, "Found new game: %s", ad.GetNameVersioned().c_str());
+		result.messages.emplace_back("Found new game: " + ad.GetNameVersioned());
 	} else {
 		// neither a map nor a mod: error
-		LOG_S(LOG_SECTION_ARCHIVESCANNER, "missing modinfo.lua/mapinfo.lua");
+		result.messages.emplace_back("missing modinfo.lua/mapinfo.lua");
 	}
 
-	ai.path = fpath;
-	ai.modified = modifiedTime;
+	ai.path = FileSystem::GetDirectory(fullName);
+	ai.modified = result.modified;
 
 	// Store modinfo.lua/mapinfo.lua modified timestamp for directory archives, as only they can change.
 	if (ar->GetType() == ARCHIVE_TYPE_SDD && !luaInfoFile.empty()) {
@@ -761,16 +961,53 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 		ai.modifiedArchiveData = FileSystemAbstraction::GetFileModificationTime(ai.archiveDataPath);
 	}
 
-	ai.origName = fname;
+	ai.origName = FileSystem::GetFilename(fullName);
 	ai.updated = true;
-	ai.hashed = doChecksum && GetArchiveChecksum(fullName, ai);
+	ai.hashed = doChecksum && GetArchiveChecksum(fullName, ai.checksum, true);
+}
+
+void CArchiveScanner::CommitScanResult(ArchiveScanResult& result)
+{
+	const std::string& fname = FileSystem::GetFilename(result.fullName);
+	const std::string& lcfn  = StringToLower(fname);
+
+	for (const std::string& warning: result.warnings) {
+		LOG_L(L_WARNING, "%s", warning.c_str());
+	}
+	for (const std::string& message: result.messages) {
+		LOG_S(LOG_SECTION_ARCHIVESCANNER, "%s", message.c_str());
+	}
+
+	// any scan can change the dependency-closure of a memoized checksum
+	completeChecksums.clear();
+
+	if (!result.problem.empty()) {
+		BrokenArchive& ba = GetAddBrokenArchive(lcfn);
+		ba.name = lcfn;
+		ba.path = FileSystem::GetDirectory(result.fullName);
+		ba.modified = result.modified;
+		ba.updated = true;
+		ba.problem = result.problem;
+
+		// archives that could not be opened do not count as a scan
+		numScannedArchives += result.opened;
+		return;
+	}
 
 	archiveInfosIndex.insert(lcfn, archiveInfos.size());
-	archiveInfos.emplace_back(std::move(ai));
+	archiveInfos.emplace_back(std::move(result.archiveInfo));
 
 	numScannedArchives += 1;
 }
 
+int CArchiveScanner::GetMaxConcurrentArchives()
+{
+	if (configHandler == nullptr)
+		return 1;
+
+	return (std::max(1, configHandler->GetInt("ArchiveScannerMaxConcurrentIO")));
+}
+
 
 bool CArchiveScanner::CheckCachedData(const std::string& fullName, unsigned& modified, bool doChecksum)
 {
@@ -790,6 +1027,8 @@ bool CArchiveScanner::CheckCachedData(const std::string& fullName, unsigned& mod
 	const std::string& fileNameLower = StringToLower(fileName);
 
 
+	LoadCachedArchive(fileNameLower);
+
 	const auto baIter = brokenArchivesIndex.find(fileNameLower);
 	const auto aiIter = archiveInfosIndex.find(fileNameLower);
 
@@ -832,6 +1071,9 @@ bool CArchiveScanner::CheckCachedData(const std::string& fullName, unsigned& mod
 		return true;
 	}
 
+	// cached info is about to be dropped, memoized digests may include it
+	completeChecksums.clear();
+
 	if (ai.updated) {
 		LOG_L(L_ERROR, "[AS::%s] found a \"%s\" already in \"%s\", ignoring.", __func__, fullName.c_str(), (ai.path + ai.origName).c_str());
 
@@ -916,7 +1158,7 @@ IFileFilter* CArchiveScanner::CreateIgnoreFilter(IArchive* ar)
  * Get checksum of the data in the specified archive.
  * Returns 0 if file could not be opened.
  */
-bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, ArchiveInfo& archiveInfo)
+bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, uint8_t* checksum, bool parallelFiles)
 {
 	// try to open an archive
 	std::unique_ptr<IArchive> ar(archiveLoader.OpenArchive(archiveName));
@@ -948,24 +1190,33 @@ bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, Archive
 	std::stable_sort(fileNames.begin(), fileNames.end());
 
 	// compute hashes of the files
-	for_mt(0, fileNames.size(), [&](const int i) {
-		ar->CalcHash(ar->FindFile(fileNames[i]), fileHashes[i].data(), fileBuffers[ ThreadPool::GetThreadNum() ]);
+	if (parallelFiles) {
+		for_mt(0, fileNames.size(), [&](const int i) {
+			ar->CalcHash(ar->FindFile(fileNames[i]), fileHashes[i].data(), fileBuffers[ ThreadPool::GetThreadNum() ]);
 
-		#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer(WDT_MAIN);
-		#endif
-	});
+			#if !defined(DEDICATED) && !defined(UNITSYNC)
+			Watchdog::ClearTimer(WDT_MAIN);
+			#endif
+		});
+	} else {
+		// caller is already running on a worker (see HashArchives), do not nest for_mt's
+		for (size_t i = 0; i < fileNames.size(); i++) {
+			ar->CalcHash(ar->FindFile(fileNames[i]), fileHashes[i].data(), fileBuffers[0]);
+		}
+	}
 
 	// combine individual hashes, initialize to hash(name)
 	for (size_t i = 0; i < fileNames.size(); i++) {
-		sha512::calc_digest(reinterpret_cast<const uint8_t*>(fileNames[i].c_str()), fileNames[i].size(), archiveInfo.checksum);
+		sha512::calc_digest(reinterpret_cast<const uint8_t*>(fileNames[i].c_str()), fileNames[i].size(), checksum);
 
 		for (uint8_t j = 0; j < sha512::SHA_LEN; j++) {
-			archiveInfo.checksum[j] ^= fileHashes[i][j];
+			checksum[j] ^= fileHashes[i][j];
 		}
 
 		#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer();
+		// workers are not registered with the watchdog
+		if (parallelFiles)
+			Watchdog::ClearTimer();
 		#endif
 	}
 
@@ -976,6 +1227,20 @@ bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, Archive
 void CArchiveScanner::ReadCacheData(const std::string& filename)
 {
 	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
+
+	const spring_time startTime = spring_gettime();
+
+	if (ReadBinaryCacheData(filename + ".bin")) {
+		LOG("[AS::%s] mapped binary ArchiveCache in %ims", __func__, int((spring_gettime() - startTime).toMilliSecsi()));
+		return;
+	}
+
+	ReadLuaCacheData(filename + ".lua");
+	LOG("[AS::%s] parsed Lua ArchiveCache in %ims", __func__, int((spring_gettime() - startTime).toMilliSecsi()));
+}
+
+void CArchiveScanner::ReadLuaCacheData(const std::string& filename)
+{
 	if (!FileSystem::FileExists(filename)) {
 		LOG_L(L_INFO, "[AS::%s] ArchiveCache %s doesn't exist", __func__, filename.c_str());
 		return;
@@ -1053,6 +1318,259 @@ void CArchiveScanner::ReadCacheData(const std::string& filename)
 	isDirty = false;
 }
 
+bool CArchiveScanner::ReadBinaryCacheData(const std::string& filename)
+{
+	binary_cache::View view;
+
+	ReleaseCacheFile();
+
+	if (!FileSystem::FileExists(filename)) {
+		LOG_L(L_INFO, "[AS::%s] ArchiveCache %s doesn't exist", __func__, filename.c_str());
+		return false;
+	}
+
+	cacheFileMap.reset(new CMemoryMappedFile());
+
+	if (!cacheFileMap->Open(filename) || !view.Init(cacheFileMap->GetData(), cacheFileMap->GetSize())) {
+		LOG_L(L_WARNING, "[AS::%s] ignoring invalid ArchiveCache \"%s\"", __func__, filename.c_str());
+		ReleaseCacheFile();
+		return false;
+	}
+
+	LOG_S(
+		LOG_SECTION_ARCHIVESCANNER, "[AS::%s] %u archives and %u broken archives in \"%s\"",
+		__func__, view.header->numArchives, view.header->numBrokenArchives, filename.c_str()
+	);
+
+	isDirty = false;
+	return true;
+}
+
+void CArchiveScanner::LoadCachedArchive(const std::string& lcfn)
+{
+	binary_cache::View view;
+
+	if (cacheFileMap == nullptr || !view.Init(cacheFileMap->GetData(), cacheFileMap->GetSize()))
+		return;
+
+	const auto ArchiveCmp = [&](const binary_cache::Archive& a, const std::string& name) { return (strcmp(view.GetString(a.lcName), name.c_str()) < 0); };
+	const auto BrokenCmp = [&](const binary_cache::BrokenArchive& a, const std::string& name) { return (strcmp(view.GetString(a.name), name.c_str()) < 0); };
+
+	const binary_cache::Archive* archivesEnd = view.archives + view.header->numArchives;
+	const binary_cache::Archive* archiveRec = std::lower_bound(view.archives, archivesEnd, lcfn, ArchiveCmp);
+
+	const binary_cache::BrokenArchive* brokenEnd = view.brokenArchives + view.header->numBrokenArchives;
+	const binary_cache::BrokenArchive* brokenRec = std::lower_bound(view.brokenArchives, brokenEnd, lcfn, BrokenCmp);
+
+	if (archiveRec != archivesEnd && lcfn == view.GetString(archiveRec->lcName) && archiveInfosIndex.find(lcfn) == archiveInfosIndex.end()) {
+		ArchiveInfo& ai = GetAddArchiveInfo(lcfn);
+		ArchiveInfo tmp; // used to compare against all-zero hash
+		ArchiveData& ad = ai.archiveData;
+
+		ai.origName            = view.GetString(archiveRec->origName);
+		ai.path                = view.GetString(archiveRec->path);
+		ai.archiveDataPath     = view.GetString(archiveRec->archiveDataPath);
+		ai.modified            = archiveRec->modified;
+		ai.modifiedArchiveData = archiveRec->modifiedArchiveData;
+
+		std::memcpy(ai.checksum, archiveRec->checksum, sha512::SHA_LEN);
+
+		ai.updated = false;
+		ai.hashed = (memcmp(ai.checksum, tmp.checksum, sha512::SHA_LEN) != 0);
+
+		if (view.IsValidSpan(archiveRec->firstInfoItem, archiveRec->numInfoItems, view.header->numInfoItems)) {
+			for (uint32_t i = archiveRec->firstInfoItem, n = i + archiveRec->numInfoItems; i < n; i++) {
+				const binary_cache::InfoItem& item = view.infoItems[i];
+				const std::string key = view.GetString(item.key);
+
+				switch (item.valueType) {
+					case INFO_VALUE_TYPE_STRING: {
+						ad.SetInfoItemValueString(key, view.GetString(item.value));
+					} break;
+					case INFO_VALUE_TYPE_INTEGER: {
+						int32_t value;
+						std::memcpy(&value, &item.value, sizeof(value));
+						ad.SetInfoItemValueInteger(key, value);
+					} break;
+					case INFO_VALUE_TYPE_FLOAT: {
+						float value;
+						std::memcpy(&value, &item.value, sizeof(value));
+						ad.SetInfoItemValueFloat(key, value);
+					} break;
+					case INFO_VALUE_TYPE_BOOL: {
+						ad.SetInfoItemValueBool(key, item.value != 0);
+					} break;
+					default: {
+					} break;
+				}
+			}
+		}
+
+		if (view.IsValidSpan(archiveRec->firstDependency, archiveRec->numDependencies, view.header->numDependencies)) {
+			for (uint32_t i = archiveRec->firstDependency, n = i + archiveRec->numDependencies; i < n; i++) {
+				ad.GetDependencies().emplace_back(view.GetString(view.dependencies[i]));
+			}
+		}
+	}
+
+	if (brokenRec != brokenEnd && lcfn == view.GetString(brokenRec->name) && brokenArchivesIndex.find(lcfn) == brokenArchivesIndex.end()) {
+		BrokenArchive& ba = GetAddBrokenArchive(lcfn);
+
+		ba.name     = lcfn;
+		ba.path     = view.GetString(brokenRec->path);
+		ba.problem  = view.GetString(brokenRec->problem);
+		ba.modified = brokenRec->modified;
+		ba.updated  = false;
+	}
+}
+
+void CArchiveScanner::ReleaseCacheFile()
+{
+	cacheFileMap.reset();
+}
+
+void CArchiveScanner::WriteBinaryCacheData(const std::string& filename)
+{
+	binary_cache::Header header;
+	binary_cache::StringTable stringTable;
+
+	std::vector<binary_cache::Archive> archiveRecs;
+	std::vector<binary_cache::BrokenArchive> brokenRecs;
+	std::vector<binary_cache::InfoItem> infoItemRecs;
+	std::vector<uint32_t> dependencyRecs;
+
+	std::vector<std::string> lcNames;
+	std::vector<size_t> archiveOrder;
+
+	lcNames.reserve(archiveInfos.size());
+	archiveOrder.reserve(archiveInfos.size());
+	archiveRecs.reserve(archiveInfos.size());
+	brokenRecs.reserve(brokenArchives.size());
+
+	for (const ArchiveInfo& ai: archiveInfos) {
+		archiveOrder.push_back(lcNames.size());
+		lcNames.push_back(StringToLower(ai.origName));
+	}
+
+	// records are binary-searched by LoadCachedArchive
+	std::sort(archiveOrder.begin(), archiveOrder.end(), [&](size_t a, size_t b) { return (lcNames[a] < lcNames[b]); });
+
+	for (const size_t archiveIdx: archiveOrder) {
+		const ArchiveInfo& ai = archiveInfos[archiveIdx];
+		const ArchiveData& ad = ai.archiveData;
+
+		binary_cache::Archive rec;
+		memset(&rec, 0, sizeof(rec));
+
+		rec.lcName              = stringTable.Add(lcNames[archiveIdx]);
+		rec.origName            = stringTable.Add(ai.origName);
+		rec.path                = stringTable.Add(ai.path);
+		rec.archiveDataPath     = stringTable.Add(ai.archiveDataPath);
+		rec.modified            = ai.modified;
+		rec.modifiedArchiveData = ai.modifiedArchiveData;
+		rec.firstInfoItem       = infoItemRecs.size();
+		rec.firstDependency     = dependencyRecs.size();
+
+		std::memcpy(rec.checksum, ai.checksum, sha512::SHA_LEN);
+
+		for (const auto& ii: ad.GetInfo()) {
+			binary_cache::InfoItem item;
+
+			item.key = stringTable.Add(ii.second.key);
+			item.valueType = ii.second.valueType;
+			item.value = 0;
+
+			switch (ii.second.valueType) {
+				case INFO_VALUE_TYPE_STRING : { item.value = stringTable.Add(ii.second.valueTypeString);                  } break;
+				case INFO_VALUE_TYPE_INTEGER: { std::memcpy(&item.value, &ii.second.value.typeInteger, sizeof(int32_t)); } break;
+				case INFO_VALUE_TYPE_FLOAT  : { std::memcpy(&item.value, &ii.second.value.typeFloat, sizeof(float));     } break;
+				case INFO_VALUE_TYPE_BOOL   : { item.value = ii.second.value.typeBool;                                    } break;
+				default                     : {                                                                           } break;
+			}
+
+			infoItemRecs.push_back(item);
+		}
+
+		// like the Lua cache, replaces are not persisted
+		for (const std::string& dep: ad.GetDependencies()) {
+			dependencyRecs.push_back(stringTable.Add(dep));
+		}
+
+		rec.numInfoItems = infoItemRecs.size() - rec.firstInfoItem;
+		rec.numDependencies = dependencyRecs.size() - rec.firstDependency;
+
+		archiveRecs.push_back(rec);
+	}
+
+	// already sorted by (lower-case) name in WriteCacheData
+	for (const BrokenArchive& ba: brokenArchives) {
+		binary_cache::BrokenArchive rec;
+
+		rec.name     = stringTable.Add(ba.name);
+		rec.path     = stringTable.Add(ba.path);
+		rec.problem  = stringTable.Add(ba.problem);
+		rec.modified = ba.modified;
+
+		brokenRecs.push_back(rec);
+	}
+
+	// the table is padded s.t. the file size stays a multiple of four
+	while ((stringTable.data.size() % 4) != 0)
+		stringTable.data.push_back(0);
+
+	memset(&header, 0, sizeof(header));
+	header.magic             = binary_cache::MAGIC;
+	header.version           = binary_cache::VERSION;
+	header.internalVer       = INTERNAL_VER;
+	header.numArchives       = archiveRecs.size();
+	header.numBrokenArchives = brokenRecs.size();
+	header.numInfoItems      = infoItemRecs.size();
+	header.numDependencies   = dependencyRecs.size();
+	header.stringTableSize   = stringTable.data.size();
+	header.fileSize          = sizeof(header) +
+		archiveRecs.size() * sizeof(binary_cache::Archive) +
+		brokenRecs.size() * sizeof(binary_cache::BrokenArchive) +
+		infoItemRecs.size() * sizeof(binary_cache::InfoItem) +
+		dependencyRecs.size() * sizeof(uint32_t) +
+		stringTable.data.size();
+
+	// write to a temporary and swap it in, other processes (unitsync, a
+	// second engine instance) might have the current file mapped
+	const std::string tmpFileName = filename + ".tmp";
+
+	FILE* out = fopen(tmpFileName.c_str(), "wb");
+
+	if (out == nullptr) {
+		LOG_L(L_ERROR, "[AS::%s] failed to write to \"%s\"!", __func__, tmpFileName.c_str());
+		return;
+	}
+
+	const auto WriteData = [&](const void* data, size_t size, size_t count) { return (count == 0 || fwrite(data, size, count, out) == count); };
+
+	bool success = true;
+
+	success &= WriteData(&header, sizeof(header), 1);
+	success &= WriteData(archiveRecs.data(), sizeof(binary_cache::Archive), archiveRecs.size());
+	success &= WriteData(brokenRecs.data(), sizeof(binary_cache::BrokenArchive), brokenRecs.size());
+	success &= WriteData(infoItemRecs.data(), sizeof(binary_cache::InfoItem), infoItemRecs.size());
+	success &= WriteData(dependencyRecs.data(), sizeof(uint32_t), dependencyRecs.size());
+	success &= WriteData(stringTable.data.data(), 1, stringTable.data.size());
+	success &= (fclose(out) == 0);
+
+	if (success && std::rename(tmpFileName.c_str(), filename.c_str()) != 0) {
+		// rename does not replace existing files on Windows
+		std::remove(filename.c_str());
+		success = (std::rename(tmpFileName.c_str(), filename.c_str()) == 0);
+	}
+
+	if (success)
+		return;
+
+	LOG_L(L_ERROR, "[AS::%s] failed to write to \"%s\"!", __func__, filename.c_str());
+	std::remove(tmpFileName.c_str());
+}
+
+
 static inline void SafeStr(FILE* out, const char* prefix, const std::string& str)
 {
 	if (str.empty())
@@ -1077,11 +1595,8 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 	if (!isDirty)
 		return;
 
-	FILE* out = fopen(filename.c_str(), "wt");
-	if (out == nullptr) {
-		LOG_L(L_ERROR, "[AS::%s] failed to write to \"%s\"!", __func__, filename.c_str());
-		return;
-	}
+	// the file is about to be replaced, and any records not yet loaded are outdated
+	ReleaseCacheFile();
 
 	// First delete all outdated information
 	{
@@ -1106,6 +1621,19 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 		}
 	}
 
+	WriteBinaryCacheData(filename + ".bin");
+	WriteLuaCacheData(filename + ".lua");
+
+	isDirty = false;
+}
+
+void CArchiveScanner::WriteLuaCacheData(const std::string& filename)
+{
+	FILE* out = fopen(filename.c_str(), "wt");
+	if (out == nullptr) {
+		LOG_L(L_ERROR, "[AS::%s] failed to write to \"%s\"!", __func__, filename.c_str());
+		return;
+	}
 
 	fprintf(out, "local archiveCache = {\n\n");
 	fprintf(out, "\tinternalver = %i,\n\n", INTERNAL_VER);
@@ -1181,8 +1709,6 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 
 	if (fclose(out) == EOF)
 		LOG_L(L_ERROR, "[AS::%s] failed to write to \"%s\"!", __func__, filename.c_str());
-
-	isDirty = false;
 }
 
 
@@ -1417,13 +1943,34 @@ sha512::raw_digest CArchiveScanner::GetArchiveSingleChecksumBytes(const std::str
 
 sha512::raw_digest CArchiveScanner::GetArchiveCompleteChecksumBytes(const std::string& name)
 {
+	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
+
+	const spring_time startTime = spring_gettime();
+
 	sha512::raw_digest checksum;
 	std::fill(checksum.begin(), checksum.end(), 0);
 
+	// game and map share most of their dependencies, and both are checked
+	// repeatedly by PreGame / unitsync; memoized until the next (re)scan or
+	// until any cached ArchiveInfo is rewritten (see CheckCachedData)
+	const auto ccIter = completeChecksums.find(name);
+
+	if (ccIter != completeChecksums.end())
+		return ccIter->second;
+
+	std::vector<std::string> archivePaths;
+
 	for (const std::string& depName: GetAllArchivesUsedBy(name)) {
 		const std::string& archiveName = ArchiveFromName(depName);
-		const std::string  archivePath = GetArchivePath(archiveName) + archiveName;
 
+		archivePaths.emplace_back(GetArchivePath(archiveName) + archiveName);
+	}
+
+	// hash all dependencies at once so they can be processed concurrently,
+	// the single-checksum lookups below will then only hit cached digests
+	HashArchives(archivePaths);
+
+	for (const std::string& archivePath: archivePaths) {
 		const sha512::raw_digest& archiveChecksum = GetArchiveSingleChecksumBytes(archivePath);
 
 		for (uint8_t i = 0; i < sha512::SHA_LEN; i++) {
@@ -1431,9 +1978,83 @@ sha512::raw_digest CArchiveScanner::GetArchiveCompleteChecksumBytes(const std::s
 		}
 	}
 
+	LOG_S(
+		LOG_SECTION_ARCHIVESCANNER, "[AS::%s] checksummed \"%s\" (%u archives) in %ims",
+		__func__, name.c_str(), unsigned(archivePaths.size()), int((spring_gettime() - startTime).toMilliSecsi())
+	);
+
+	completeChecksums.insert(name, checksum);
 	return checksum;
 }
 
+void CArchiveScanner::HashArchives(const std::vector<std::string>& archivePaths)
+{
+	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
+
+	std::vector< std::pair<std::string, size_t> > hashJobs;
+	std::vector<uint8_t> hashResults;
+
+	// make sure every ArchiveInfo exists and is current; this can reshuffle
+	// archiveInfos so indices are only gathered once all scans are finished
+	for (const std::string& archivePath: archivePaths) {
+		// virtual archives are never cached, leave them to ScanArchive
+		if (FileSystem::GetExtension(archivePath) == "sva")
+			continue;
+
+		ScanArchive(archivePath, false);
+	}
+
+	for (const std::string& archivePath: archivePaths) {
+		if (FileSystem::GetExtension(archivePath) == "sva")
+			continue;
+
+		const auto aiIter = archiveInfosIndex.find(StringToLower(FileSystem::GetFilename(archivePath)));
+
+		if (aiIter == archiveInfosIndex.end())
+			continue;
+
+		const ArchiveInfo& ai = archiveInfos[aiIter->second];
+
+		if (ai.hashed || !ai.replaced.empty())
+			continue;
+
+		hashJobs.emplace_back(archivePath, aiIter->second);
+	}
+
+	// a single archive is better served by hashing its files in parallel
+	if (hashJobs.size() <= 1)
+		return;
+
+	hashResults.resize(hashJobs.size(), 0);
+
+	const spring_time startTime = spring_gettime();
+	const int numHashLanes = std::min(GetMaxConcurrentArchives(), int(hashJobs.size()));
+
+	{
+		std::atomic<int> nextJobIdx = {0};
+
+		// every job writes only to its own ArchiveInfo, archiveInfos is not resized here
+		for_mt(0, numHashLanes, [&](const int laneIdx) {
+			for (int i = nextJobIdx.fetch_add(1); i < int(hashJobs.size()); i = nextJobIdx.fetch_add(1)) {
+				hashResults[i] = GetArchiveChecksum(hashJobs[i].first, archiveInfos[hashJobs[i].second].checksum, false);
+
+				#if !defined(DEDICATED) && !defined(UNITSYNC)
+				Watchdog::ClearTimer(WDT_MAIN);
+				#endif
+			}
+		});
+	}
+
+	for (size_t i = 0; i < hashJobs.size(); i++) {
+		isDirty |= (archiveInfos[hashJobs[i].second].hashed = hashResults[i]);
+	}
+
+	LOG_S(
+		LOG_SECTION_ARCHIVESCANNER, "[AS::%s] hashed %u archives (%d lanes) in %ims",
+		__func__, unsigned(hashJobs.size()), numHashLanes, int((spring_gettime() - startTime).toMilliSecsi())
+	);
+}
+
 
 void CArchiveScanner::CheckArchive(
 	const std::string& name,
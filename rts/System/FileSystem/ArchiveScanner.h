@@ -6,6 +6,7 @@
 #include <cstring> // memset
 #include <string>
 #include <deque>
+#include <memory>
 #include <vector>
 
 #include "System/Info.h"
@@ -15,6 +16,7 @@
 class IArchive;
 class IFileFilter;
 class LuaTable;
+class CMemoryMappedFile;
 
 /*
  * This class searches through a given directory and its sub-directories looking
@@ -115,6 +117,7 @@ public:
 	~CArchiveScanner();
 
 public:
+	/// path of the archive cache, without extension (".bin" and ".lua" are appended)
 	const std::string& GetFilepath() const { return cachefile; }
 
 	static const char* GetMapHelperContentName() { return "Map Helper v1"; }
@@ -184,6 +187,17 @@ private:
 		uint32_t modified = 0;
 		bool updated = false;
 	};
+	struct ArchiveScanResult {
+		std::string fullName;
+		std::string problem;                // if not empty, archive is broken
+		std::vector<std::string> warnings;  // deferred, workers must not log
+		std::vector<std::string> messages;
+
+		ArchiveInfo archiveInfo;
+
+		uint32_t modified = 0;
+		bool opened = false;
+	};
 
 private:
 	ArchiveInfo& GetAddArchiveInfo(const std::string& lcfn);
@@ -192,26 +206,59 @@ private:
 	void ScanDirs(const std::vector<std::string>& dirs);
 	void ScanDir(const std::string& curPath, std::deque<std::string>& foundArchives);
 
+	/**
+	 * Opens the archive and extracts its info into result without touching
+	 * any scanner state, so multiple archives can be processed concurrently.
+	 * CommitScanResult has to be called (serially) afterwards.
+	 */
+	static void ScanArchiveData(ArchiveScanResult& result, bool doChecksum);
+	void CommitScanResult(ArchiveScanResult& result);
+
+	/// hashes all archives in archivePaths that do not yet have a checksum
+	void HashArchives(const std::vector<std::string>& archivePaths);
+
+	/// number of archives opened at the same time by ScanDirs and HashArchives
+	static int GetMaxConcurrentArchives();
+
 	/// scan mapinfo / modinfo lua files
-	bool ScanArchiveLua(IArchive* ar, const std::string& fileName, ArchiveInfo& ai, std::string& err);
+	static bool ScanArchiveLua(IArchive* ar, const std::string& fileName, ArchiveInfo& ai, std::string& err);
 
 	/**
 	 * scan archive for map file
 	 * @return file name if found, empty string if not
 	 */
-	std::string SearchMapFile(const IArchive* ar, std::string& error);
+	static std::string SearchMapFile(const IArchive* ar, std::string& error);
 
 
 	void ReadCacheData(const std::string& filename);
 	void WriteCacheData(const std::string& filename);
 
-	IFileFilter* CreateIgnoreFilter(IArchive* ar);
+	/**
+	 * The binary cache is memory-mapped and only validated on read; records
+	 * are turned into ArchiveInfo's on demand (by LoadCachedArchive) when the
+	 * scan looks up an archive, s.t. startup cost does not depend on library
+	 * size. The Lua cache is still written for tools and read as a fallback.
+	 */
+	bool ReadBinaryCacheData(const std::string& filename);
+	void ReadLuaCacheData(const std::string& filename);
+	void WriteBinaryCacheData(const std::string& filename);
+	void WriteLuaCacheData(const std::string& filename);
+
+	void LoadCachedArchive(const std::string& lcfn);
+	void ReleaseCacheFile();
+
+	static IFileFilter* CreateIgnoreFilter(IArchive* ar);
 
 	/**
 	 * Get hash of the data in the specified archive.
 	 * Returns false if file could not be opened.
+	 * If parallelFiles is true, the files inside the archive are hashed by
+	 * the ThreadPool; otherwise the calling thread does all of the work.
 	 */
-	bool GetArchiveChecksum(const std::string& filename, ArchiveInfo& archiveInfo);
+	static bool GetArchiveChecksum(const std::string& filename, uint8_t* checksum, bool parallelFiles);
+	bool GetArchiveChecksum(const std::string& filename, ArchiveInfo& archiveInfo) {
+		return (GetArchiveChecksum(filename, archiveInfo.checksum, true));
+	}
 
 	bool CheckCachedData(const std::string& fullName, unsigned& modified, bool doChecksum);
 
@@ -234,7 +281,7 @@ private:
 	 *         2 if the file is a second class meta-file
 	 */
 	static int GetMetaFileClass(const std::string& filePath);
-	static bool CheckCompression(const IArchive* ar, const std::string& fullName, std::string& error);
+	static bool CheckCompression(const IArchive* ar, const std::string& fullName, std::string& error, std::vector<std::string>& warnings);
 
 private:
 	spring::unordered_map<std::string, size_t> archiveInfosIndex;
@@ -243,8 +290,14 @@ private:
 	std::vector<ArchiveInfo> archiveInfos;
 	std::vector<BrokenArchive> brokenArchives;
 
+	/// memoized results of GetArchiveCompleteChecksumBytes, keyed by root-archive name
+	spring::unordered_map<std::string, sha512::raw_digest> completeChecksums;
+
 	std::string cachefile;
 
+	/// mapped binary cache; only held from ReadCacheData until the end of the scan
+	std::unique_ptr<CMemoryMappedFile> cacheFileMap;
+
 	bool isDirty = false;
 	bool isInScan = false;
 };
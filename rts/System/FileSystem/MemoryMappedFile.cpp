@@ -0,0 +1,100 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+bool CMemoryMappedFile::Open(const std::string& fileName)
+{
+	Close();
+
+	#ifdef _WIN32
+	HANDLE hFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0) {
+		CloseHandle(hFile);
+		return false;
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (hMapping == nullptr) {
+		CloseHandle(hFile);
+		return false;
+	}
+
+	if ((data = reinterpret_cast<const uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0))) == nullptr) {
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	fileHandle = hFile;
+	mappingHandle = hMapping;
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	#else
+
+	if ((fileDesc = open(fileName.c_str(), O_RDONLY)) == -1)
+		return false;
+
+	struct stat info;
+
+	if (fstat(fileDesc, &info) != 0 || info.st_size <= 0) {
+		Close();
+		return false;
+	}
+
+	void* addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fileDesc, 0);
+
+	if (addr == MAP_FAILED) {
+		Close();
+		return false;
+	}
+
+	data = reinterpret_cast<const uint8_t*>(addr);
+	size = static_cast<size_t>(info.st_size);
+	#endif
+
+	return true;
+}
+
+void CMemoryMappedFile::Close()
+{
+	#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mappingHandle != nullptr)
+		CloseHandle(mappingHandle);
+	if (fileHandle != nullptr)
+		CloseHandle(fileHandle);
+
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+
+	#else
+
+	if (data != nullptr)
+		munmap(const_cast<uint8_t*>(data), size);
+	if (fileDesc != -1)
+		close(fileDesc);
+
+	fileDesc = -1;
+	#endif
+
+	data = nullptr;
+	size = 0;
+}
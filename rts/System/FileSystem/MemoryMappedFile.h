@@ -0,0 +1,45 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _MEMORY_MAPPED_FILE_H
+#define _MEMORY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Read-only memory-mapping of a file on the raw filesystem (not the VFS).
+ * Empty files can not be mapped and fail to open.
+ */
+class CMemoryMappedFile
+{
+public:
+	CMemoryMappedFile() = default;
+	CMemoryMappedFile(const CMemoryMappedFile& f) = delete;
+	CMemoryMappedFile(CMemoryMappedFile&& f) = delete;
+	~CMemoryMappedFile() { Close(); }
+
+	CMemoryMappedFile& operator = (const CMemoryMappedFile& f) = delete;
+	CMemoryMappedFile& operator = (CMemoryMappedFile&& f) = delete;
+
+	bool Open(const std::string& fileName);
+	void Close();
+
+	bool IsOpen() const { return (data != nullptr); }
+
+	const uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+
+	#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+	#else
+	int fileDesc = -1;
+	#endif
+};
+
+#endif // _MEMORY_MAPPED_FILE_H
@@ -71,15 +71,20 @@ extern "C" {
 #endif
 
 
-// note: no real point to TLS, sinks themselves are not thread-safe
+// note: no real point to TLS, most sinks themselves are not thread-safe
+// (the file-sink is once its writer thread runs, see FileSink.h)
 static _threadlocal log_record_t cur_record = {{0}, "", "",  0, 0};
 static _threadlocal log_record_t prv_record = {{0}, "", "",  0, 0};
 
+// set by worker threads which want to collect their own records
+static _threadlocal log_sink_ptr thread_sink = nullptr;
+
 
 extern void log_formatter_format(log_record_t* log, va_list arguments);
 
 void log_backend_registerSink(log_sink_ptr sink) { log_formatter::insert_sink(sink); }
 void log_backend_unregisterSink(log_sink_ptr sink) { log_formatter::remove_sink(sink); }
+void log_backend_setThreadSink(log_sink_ptr sink) { thread_sink = sink; }
 
 void log_backend_registerCleanup(log_cleanup_ptr cleanupFunc) { log_formatter::insert_func(cleanupFunc); }
 void log_backend_unregisterCleanup(log_cleanup_ptr cleanupFunc) { log_formatter::remove_func(cleanupFunc); }
@@ -96,6 +101,12 @@ void log_backend_record(int level, const char* section, const char* fmt, va_list
 {
 	const auto& sinks = log_formatter::sinks;
 
+	if (thread_sink != nullptr) {
+		VSNPRINTF(cur_record.msg, sizeof(cur_record.msg), fmt, arguments);
+		thread_sink(level, section, cur_record.msg);
+		return;
+	}
+
 	if (log_formatter::numSinks == 0)
 		return;
 
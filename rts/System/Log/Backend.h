@@ -26,6 +26,14 @@ void log_backend_registerSink(log_sink_ptr sink);
 /// Stop routing log records to the supplied sink
 void log_backend_unregisterSink(log_sink_ptr sink);
 
+/**
+ * Route all records logged by the calling thread to the supplied sink
+ * instead of the registered ones (which are not thread-safe); records are
+ * passed on unformatted, so they can be logged again later from the main
+ * thread. NULL restores the normal routing.
+ */
+void log_backend_setThreadSink(log_sink_ptr sink);
+
 
 typedef void (*log_cleanup_ptr)();
 
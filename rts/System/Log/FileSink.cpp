@@ -9,10 +9,18 @@
 #include "System/Log/Level.h"
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 
@@ -48,6 +56,173 @@ namespace log_file {
 		int flushLevel;
 	};
 
+	/**
+	 * Bounded multi-producer single-consumer queue of (formatted) records.
+	 * A record occupies as many consecutive slots as it needs, so even the
+	 * longest ones are queued without allocating. Slots are freed strictly
+	 * in order by the consumer, which lets a producer claim a whole run of
+	 * them by checking only the last one.
+	 */
+	class RecordRing {
+	public:
+		static constexpr uint32_t NUM_SLOTS = 8192;
+		static constexpr uint32_t SLOT_SIZE = 128;
+
+		struct RecordHeader {
+			int level;
+			uint32_t numSlots;
+			uint32_t prefixLen;
+			uint32_t sectionLen;
+			uint32_t recordLen;
+		};
+
+		// longest record that is queued, anything beyond is cut off
+		static constexpr uint32_t MAX_RECORD_SIZE = (NUM_SLOTS / 4) * SLOT_SIZE - sizeof(RecordHeader) - 256;
+
+	public:
+		RecordRing() {
+			for (uint32_t n = 0; n < NUM_SLOTS; n++) {
+				slotSeqs[n].store(n, std::memory_order_relaxed);
+			}
+		}
+
+		// producers; false if there are not enough free slots right now
+		bool TryPush(int level, const char* prefix, const char* section, const char* record) {
+			RecordHeader header;
+			header.level = level;
+			header.prefixLen = std::min(strlen(prefix), size_t(255));
+			header.sectionLen = std::min(strlen(section), size_t(255 - header.prefixLen));
+			header.recordLen = std::min(strlen(record), size_t(MAX_RECORD_SIZE));
+			header.numSlots = (sizeof(header) + header.prefixLen + header.sectionLen + header.recordLen + SLOT_SIZE - 1) / SLOT_SIZE;
+
+			uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+			for (;;) {
+				const uint32_t lastPos = pos + header.numSlots - 1;
+				const uint32_t lastSeq = slotSeqs[lastPos % NUM_SLOTS].load(std::memory_order_acquire);
+				const int32_t diff = int32_t(lastSeq - lastPos);
+
+				// consumer has not yet freed this run of slots
+				if (diff < 0)
+					return false;
+
+				// another producer claimed it first
+				if (diff > 0) {
+					pos = enqueuePos.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (enqueuePos.compare_exchange_weak(pos, pos + header.numSlots, std::memory_order_relaxed))
+					break;
+			}
+
+			uint32_t ofs = SlotByteOfs(pos);
+
+			ofs = Write(ofs, &header, sizeof(header));
+			ofs = Write(ofs, prefix, header.prefixLen);
+			ofs = Write(ofs, section, header.sectionLen);
+			ofs = Write(ofs, record, header.recordLen);
+
+			// publish trailing slots first; once the consumer sees the
+			// first one the whole record is visible
+			for (uint32_t n = header.numSlots; n > 0; n--) {
+				slotSeqs[(pos + n - 1) % NUM_SLOTS].store(pos + n, std::memory_order_release);
+			}
+
+			return true;
+		}
+
+		// consumer; copies the next record into <buf> (which it resizes)
+		bool TryPop(RecordHeader& header, std::vector<char>& buf) {
+			const uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+
+			if (slotSeqs[pos % NUM_SLOTS].load(std::memory_order_acquire) != (pos + 1))
+				return false;
+
+			uint32_t ofs = Read(SlotByteOfs(pos), &header, sizeof(header));
+
+			buf.resize(header.prefixLen + header.sectionLen + header.recordLen + 3);
+
+			char* prefix  = &buf[0];
+			char* section = prefix  + header.prefixLen  + 1;
+			char* record  = section + header.sectionLen + 1;
+
+			ofs = Read(ofs, prefix, header.prefixLen);
+			ofs = Read(ofs, section, header.sectionLen);
+			ofs = Read(ofs, record, header.recordLen);
+
+			prefix[header.prefixLen] = 0;
+			section[header.sectionLen] = 0;
+			record[header.recordLen] = 0;
+
+			// free in order, see TryPush
+			for (uint32_t n = 0; n < header.numSlots; n++) {
+				slotSeqs[(pos + n) % NUM_SLOTS].store(pos + n + NUM_SLOTS, std::memory_order_release);
+			}
+
+			dequeuePos.store(pos + header.numSlots, std::memory_order_relaxed);
+			return true;
+		}
+
+		uint32_t GetReadPos() const { return (dequeuePos.load(std::memory_order_relaxed)); }
+
+		// approximate, only used to decide when to wake up the consumer
+		uint32_t NumUsedSlots() const { return (enqueuePos.load(std::memory_order_relaxed) - dequeuePos.load(std::memory_order_relaxed)); }
+
+	private:
+		// data of a record is contiguous in bytes (modulo wrap-around),
+		// starting at the beginning of its first slot
+		static uint32_t SlotByteOfs(uint32_t pos) { return ((pos % NUM_SLOTS) * SLOT_SIZE); }
+
+		uint32_t Write(uint32_t byteOfs, const void* src, uint32_t size) {
+			const uint32_t numHead = std::min(size, NUM_SLOTS * SLOT_SIZE - byteOfs);
+
+			memcpy(&slotData[byteOfs], src, numHead);
+			memcpy(&slotData[0], static_cast<const char*>(src) + numHead, size - numHead);
+			return ((byteOfs + size) % (NUM_SLOTS * SLOT_SIZE));
+		}
+		uint32_t Read(uint32_t byteOfs, void* dst, uint32_t size) const {
+			const uint32_t numHead = std::min(size, NUM_SLOTS * SLOT_SIZE - byteOfs);
+
+			memcpy(dst, &slotData[byteOfs], numHead);
+			memcpy(static_cast<char*>(dst) + numHead, &slotData[0], size - numHead);
+			return ((byteOfs + size) % (NUM_SLOTS * SLOT_SIZE));
+		}
+
+	private:
+		std::atomic<uint32_t> slotSeqs[NUM_SLOTS];
+		char slotData[NUM_SLOTS * SLOT_SIZE];
+
+		alignas(64) std::atomic<uint32_t> enqueuePos = {0};
+		alignas(64) std::atomic<uint32_t> dequeuePos = {0};
+	};
+
+
+	/**
+	 * Moves the actual file I/O off the logging threads. Records below
+	 * LOG_LEVEL_WARNING are dropped (and counted) when the ring is full,
+	 * everything else waits for free slots or writes queued records out
+	 * itself.
+	 */
+	struct WriterThread {
+		std::unique_ptr<RecordRing> ring;
+		std::thread thread;
+
+		// held while records are popped and written; also taken when the
+		// set of log-files changes or the ring is drained synchronously
+		std::mutex consumerMutex;
+
+		std::mutex wakeMutex;
+		std::condition_variable wakeCond;
+
+		std::atomic<bool> active = {false};
+		std::atomic<bool> quit = {false};
+
+		std::atomic<uint32_t> numDroppedRecords = {0};
+		uint32_t numReportedDrops = 0;
+	};
+
+
 	/**
 	 * This is only used to check whether some code tries to access the
 	 * log-files container after it got deleted.
@@ -65,28 +240,37 @@ namespace log_file {
 		typedef std::vector<LogFilePair> LogFilesMap;
 
 		~LogFilesContainer() {
+			log_file_stopWriterThread();
 			log_file_removeAllLogFiles();
 			validTracker = false;
 		}
 		LogFilesMap& GetLogFiles() {
 			return logFiles;
 		}
+		WriterThread& GetWriterThread() {
+			return writerThread;
+		}
 
 	private:
 		std::vector< std::pair<std::string, LogFileDetails> > logFiles;
+
+		WriterThread writerThread;
 	};
 
 	using LogFilePair = LogFilesContainer::LogFilePair;
 	using LogFilesMap = LogFilesContainer::LogFilesMap;
 
 
-	inline LogFilesMap& getLogFiles() {
+	inline LogFilesContainer& getLogFilesContainer() {
 		static LogFilesContainer logFilesContainer;
 
 		assert(validTracker);
-		return (logFilesContainer.GetLogFiles());
+		return logFilesContainer;
 	}
 
+	inline LogFilesMap& getLogFiles() { return (getLogFilesContainer().GetLogFiles()); }
+	inline WriterThread& getWriterThread() { return (getLogFilesContainer().GetWriterThread()); }
+
 
 	/**
 	 * This class allows us to stop logging cleanly, when the application exits,
@@ -120,10 +304,7 @@ namespace log_file {
 		return (!getLogFiles().empty());
 	}
 
-	void writeToFile(FILE* outStream, const char* record, bool flush) {
-		char framePrefix[128] = {'\0'};
-		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
-
+	void writeToFile(FILE* outStream, const char* framePrefix, const char* record, bool flush) {
 		FPRINTF(outStream, "%s%s\n", framePrefix, record);
 
 		if (flush)
@@ -133,7 +314,7 @@ namespace log_file {
 	/**
 	 * Writes to the individual log files, if they do want to log the section.
 	 */
-	void writeToFiles(int level, const char* section, const char* record)
+	void writeToFiles(int level, const char* section, const char* framePrefix, const char* record)
 	{
 		const auto& logFiles = getLogFiles();
 
@@ -143,10 +324,18 @@ namespace log_file {
 			if (p.second.GetOutStream() == nullptr)
 				continue;
 
-			writeToFile(p.second.GetOutStream(), record, p.second.FlushOnWrite(level));
+			writeToFile(p.second.GetOutStream(), framePrefix, record, p.second.FlushOnWrite(level));
 		}
 	}
 
+	void writeToFiles(int level, const char* section, const char* record)
+	{
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
+		writeToFiles(level, section, framePrefix, record);
+	}
+
 	/**
 	 * Flushes the buffers of the individual log files.
 	 */
@@ -184,6 +373,111 @@ namespace log_file {
 
 		logRecords.emplace_back(level, section, record);
 	}
+
+
+	/**
+	 * Writes out all records queued so far; the caller must hold the
+	 * writer's consumerMutex.
+	 */
+	void drainRing(WriterThread& writer) {
+		static std::vector<char> buf;
+
+		RecordRing::RecordHeader header;
+
+		while (writer.ring->TryPop(header, buf)) {
+			const char* prefix  = &buf[0];
+			const char* section = prefix  + header.prefixLen  + 1;
+			const char* record  = section + header.sectionLen + 1;
+
+			writeToFiles(header.level, section, prefix, record);
+		}
+
+		const uint32_t numDrops = writer.numDroppedRecords.load(std::memory_order_relaxed);
+
+		if (numDrops == writer.numReportedDrops)
+			return;
+
+		char dropRecord[128];
+		SNPRINTF(dropRecord, sizeof(dropRecord), "[LogWriter] dropped %u records, log queue was full", numDrops - writer.numReportedDrops);
+
+		writer.numReportedDrops = numDrops;
+		writeToFiles(LOG_LEVEL_WARNING, "", dropRecord);
+	}
+
+	void writerThreadLoop(WriterThread* writer) {
+		while (!writer->quit.load()) {
+			{
+				std::unique_lock<std::mutex> lock(writer->wakeMutex);
+				writer->wakeCond.wait_for(lock, std::chrono::milliseconds(10));
+			}
+			{
+				std::lock_guard<std::mutex> lock(writer->consumerMutex);
+				drainRing(*writer);
+			}
+		}
+	}
+
+	void writeToRing(int level, const char* section, const char* record)
+	{
+		WriterThread& writer = getWriterThread();
+
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
+		uint32_t readPos = writer.ring->GetReadPos();
+
+		for (int numStalls = 0; !writer.ring->TryPush(level, framePrefix, section, record); numStalls++) {
+			// the writer is not keeping up; the sim must not stall on spam
+			if (level < LOG_LEVEL_WARNING) {
+				writer.numDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			// write out some queued records if the writer is not at it
+			if (writer.consumerMutex.try_lock()) {
+				drainRing(writer);
+				writer.consumerMutex.unlock();
+				continue;
+			}
+
+			// other producers may keep beating us to the freed slots, only
+			// give up when the writer made no progress at all for ~1s
+			if (readPos != writer.ring->GetReadPos()) {
+				readPos = writer.ring->GetReadPos();
+				numStalls = 0;
+			}
+
+			if (numStalls >= 1100) {
+				writer.numDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			if (numStalls < 100) {
+				std::this_thread::yield();
+			} else {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		// waking the writer costs a syscall, so only do it when it matters
+		if (level >= LOG_LEVEL_WARNING || writer.ring->NumUsedSlots() >= (RecordRing::NUM_SLOTS / 2))
+			writer.wakeCond.notify_one();
+	}
+
+	/**
+	 * Keeps the writer from touching the files while they change; queued
+	 * records are written out first so they still go where they were meant
+	 * to. Nothing may be logged while this is held.
+	 */
+	std::unique_lock<std::mutex> lockLogFiles() {
+		WriterThread& writer = getWriterThread();
+		std::unique_lock<std::mutex> lock(writer.consumerMutex);
+
+		if (writer.ring != nullptr)
+			drainRing(writer);
+
+		return lock;
+	}
 }
 
 
@@ -220,6 +514,8 @@ void log_file_addLogFile(
 
 	setvbuf(tmpStream, nullptr, _IOFBF, std::min(BUFSIZ, 8192)); // limit buffer to 8kB
 
+	const auto lock = log_file::lockLogFiles();
+
 	logFiles.emplace_back(filePathStr, log_file::LogFileDetails(tmpStream, sectionsStr, minLevel, flushLevel));
 
 	// swap into position; only a handful of files are ever added
@@ -243,6 +539,8 @@ void log_file_removeLogFile(const char* filePath) {
 	if (iter == logFiles.end() || strcmp(iter->first.c_str(), filePath) != 0)
 		return;
 
+	const auto lock = log_file::lockLogFiles();
+
 	// turn off logging to this file
 	fclose(iter->second.GetOutStream());
 
@@ -258,6 +556,8 @@ void log_file_removeLogFile(const char* filePath) {
 void log_file_removeAllLogFiles() {
 	auto& logFiles = log_file::getLogFiles();
 
+	const auto lock = log_file::lockLogFiles();
+
 	for (auto& logFilePair: logFiles) {
 		fclose(logFilePair.second.GetOutStream());
 	}
@@ -280,6 +580,70 @@ FILE* log_file_getLogFileStream(const char* filePath) {
 }
 
 
+void log_file_startWriterThread() {
+	log_file::WriterThread& writer = log_file::getWriterThread();
+
+	if (writer.active.load())
+		return;
+
+	// records logged before the first file was added
+	if (log_file::isActivelyLogging())
+		log_file::writeBufferToFiles();
+
+	if (writer.ring == nullptr)
+		writer.ring.reset(new log_file::RecordRing());
+
+	writer.quit.store(false);
+	writer.thread = std::thread(log_file::writerThreadLoop, &writer);
+	writer.active.store(true, std::memory_order_release);
+}
+
+void log_file_stopWriterThread() {
+	log_file::WriterThread& writer = log_file::getWriterThread();
+
+	if (!writer.active.load())
+		return;
+
+	writer.active.store(false);
+	writer.quit.store(true);
+	writer.wakeCond.notify_one();
+	writer.thread.join();
+
+	// the ring is kept, a thread might still be pushing into it
+	std::lock_guard<std::mutex> lock(writer.consumerMutex);
+	log_file::drainRing(writer);
+	log_file::flushFiles();
+}
+
+void log_file_flushQueuedRecords() {
+	if (!log_file::validTracker || !log_file::isActivelyLogging())
+		return;
+
+	log_file::WriterThread& writer = log_file::getWriterThread();
+
+	if (writer.ring != nullptr) {
+		// called from crash-handlers; the writer might be the thread that
+		// crashed (while holding the lock) so do not wait on it forever
+		for (int numTries = 0; numTries < 1000; numTries++) {
+			if (!writer.consumerMutex.try_lock()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+
+			log_file::drainRing(writer);
+			writer.consumerMutex.unlock();
+			break;
+		}
+	}
+
+	log_file::flushFiles();
+}
+
+unsigned int log_file_getNumDroppedRecords() {
+	return (log_file::getWriterThread().numDroppedRecords.load());
+}
+
+
 
 /**
  * @name logging_sink_file
@@ -290,7 +654,10 @@ FILE* log_file_getLogFileStream(const char* filePath) {
 /// Records a log entry
 static void log_sink_record_file(int level, const char* section, const char* record)
 {
-	if (log_file::validTracker && log_file::isActivelyLogging()) {
+	if (log_file::validTracker && log_file::getWriterThread().active.load(std::memory_order_acquire)) {
+		// the writer thread does the I/O
+		log_file::writeToRing(level, section, record);
+	} else if (log_file::validTracker && log_file::isActivelyLogging()) {
 		// write buffer to log file
 		log_file::writeBufferToFiles();
 
@@ -302,13 +669,9 @@ static void log_sink_record_file(int level, const char* section, const char* rec
 	}
 }
 
-/// Cleans up all log streams, by flushing them.
+/// Cleans up all log streams, by writing out queued records and flushing them.
 static void log_sink_cleanup_file() {
-	if (!log_file::isActivelyLogging())
-		return;
-
-	// flush the log buffers to files
-	log_file::flushFiles();
+	log_file_flushQueuedRecords();
 }
 
 ///@}
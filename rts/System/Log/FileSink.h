@@ -41,6 +41,26 @@ void log_file_removeLogFile(const char* filePath);
 
 void log_file_removeAllLogFiles();
 
+/**
+ * Move all writes to the log files onto a dedicated thread. Records are
+ * then only queued by the logging threads (which makes this sink safe to
+ * use from any of them); when the queue is full records below
+ * LOG_LEVEL_WARNING are dropped and counted, others wait for room.
+ */
+void log_file_startWriterThread();
+
+/// Write out all queued records, stop the writer thread and log synchronously again
+void log_file_stopWriterThread();
+
+/**
+ * Write out all queued records from the calling thread and flush the files.
+ * Meant for crash-handlers, which must not rely on the writer thread.
+ */
+void log_file_flushQueuedRecords();
+
+/// Number of records dropped so far because the writer was not keeping up
+unsigned int log_file_getNumDroppedRecords();
+
 ///@}
 
 #ifdef __cplusplus
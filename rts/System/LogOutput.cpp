@@ -39,6 +39,10 @@ CONFIG(int, LogFlushLevel)
 	.defaultValue(LOG_LEVEL_ERROR)
 	.description("Flush the logfile when a message's level exceeds this value. ERROR is flushed by default, WARNING is not.");
 
+CONFIG(bool, LogAsyncWrites)
+	.defaultValue(true)
+	.description("Write the logfile from a dedicated thread, so logging never waits on disk I/O. Low-priority messages are dropped if the thread can not keep up.");
+
 CONFIG(int, LogRepeatLimit)
 	.defaultValue(10)
 	.description("Allow at most this many consecutive identical messages to be logged.");
@@ -185,6 +189,9 @@ void CLogOutput::Initialize()
 	log_filter_setRepeatLimit(configHandler->GetInt("LogRepeatLimit")); // all sinks
 	log_file_addLogFile(filePath.c_str(), nullptr, LOG_LEVEL_ALL, configHandler->GetInt("LogFlushLevel"));
 
+	if (configHandler->GetBool("LogAsyncWrites"))
+		log_file_startWriterThread();
+
 	LOG("LogOutput initialized. Logging to %s", filePath.c_str());
 }
 
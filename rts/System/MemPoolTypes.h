@@ -4,6 +4,8 @@
 #define MEMPOOL_TYPES_H
 
 #include <cassert>
+#include <cstddef> // max_align_t, offsetof
+#include <cstdint>
 #include <cstring> // memset
 
 #include <array>
@@ -12,7 +14,6 @@
 
 #include <memory>
 
-#include "System/UnorderedMap.hpp"
 #include "System/ContainerUtil.h"
 #include "System/SafeUtil.h"
 
@@ -20,7 +21,7 @@ template<size_t S> struct DynMemPool {
 public:
 	void* allocMem(size_t size) {
 		assert(size <= PAGE_SIZE());
-		uint8_t* m = nullptr;
+		assert(size != 0);
 
 		size_t i = 0;
 
@@ -28,15 +29,19 @@ public:
 			pages.emplace_back();
 
 			i = pages.size() - 1;
+			pages[i].index = i;
 		} else {
 			// must pop before ctor runs; objects can be created recursively
 			i = spring::VectorBackPop(indcs);
 		}
 
-		m = pages[curr_page_index = i].data();
+		t_page& page = pages[curr_page_index = i];
 
-		table.emplace(m, i);
-		return m;
+		assert(page.index == i);
+		assert(page.size == 0);
+
+		page.size = size;
+		return page.mem;
 	}
 
 
@@ -49,13 +54,14 @@ public:
 	void freeMem(void* m) {
 		assert(mapped(m));
 
-		const auto iter = table.find(m);
-		const auto pair = std::pair<void*, size_t>{iter->first, iter->second};
+		t_page& page = page_hdr(m);
 
-		std::memset(pages[pair.second].data(), 0, PAGE_SIZE());
+		// pages are zero-filled on creation, so only what the object
+		// could have touched needs to be cleared again
+		std::memset(page.mem, 0, page.size);
 
-		indcs.push_back(pair.second);
-		table.erase(pair.first);
+		page.size = 0;
+		indcs.push_back(page.index);
 	}
 
 
@@ -75,27 +81,37 @@ public:
 	size_t alloc_size() const { return (pages.size() * PAGE_SIZE()); } // size of total number of pages added over the pool's lifetime
 	size_t freed_size() const { return (indcs.size() * PAGE_SIZE()); } // size of number of pages that were freed and are awaiting reuse
 
-	bool mapped(void* p) const { return (table.find(p) != table.end()); }
-	bool alloced(void* p) const { return ((curr_page_index < pages.size()) && (pages[curr_page_index].data() == p)); }
+	bool mapped(void* p) const {
+		const t_page& page = page_hdr(p);
+		return ((page.index < pages.size()) && (&pages[page.index] == &page) && (page.size != 0));
+	}
+	bool alloced(void* p) const { return ((curr_page_index < pages.size()) && (pages[curr_page_index].mem == p)); }
 
 	void clear() {
 		pages.clear();
 		indcs.clear();
-		table.clear();
 
 		curr_page_index = 0;
 	}
 	void reserve(size_t n) {
 		indcs.reserve(n);
-		table.reserve(n);
 	}
 
 private:
-	std::deque<std::array<uint8_t, S>> pages;
-	std::vector<size_t> indcs;
+	// every page carries its own index (intrusive), freeing is O(1)
+	struct t_page {
+		size_t index;
+		size_t size; // of the live allocation, 0 if free
+
+		alignas(alignof(std::max_align_t)) uint8_t mem[S];
+	};
 
-	// <pointer, page index> (non-intrusive)
-	spring::unsynced_map<void*, size_t> table;
+	static t_page& page_hdr(void* p) { return *reinterpret_cast<t_page*>(reinterpret_cast<uint8_t*>(p) - offsetof(t_page, mem)); }
+	static const t_page& page_hdr(const void* p) { return *reinterpret_cast<const t_page*>(reinterpret_cast<const uint8_t*>(p) - offsetof(t_page, mem)); }
+
+private:
+	std::deque<t_page> pages;
+	std::vector<size_t> indcs;
 
 	size_t curr_page_index = 0;
 };
@@ -240,6 +256,7 @@ public:
 			i = indcs[--free_page_count];
 		}
 
+		sizes[i] = size;
 		return (pages[curr_page_index = i].data());
 	}
 
@@ -253,10 +270,13 @@ public:
 		assert(can_free());
 		assert(mapped(m));
 
-		std::memset(m, 0, PAGE_SIZE());
+		const size_t i = base_offset(m) / PAGE_SIZE();
+
+		// only clear what the object could have touched
+		std::memset(m, 0, sizes[i]);
 
 		// mark page as free
-		indcs[free_page_count++] = base_offset(m) / PAGE_SIZE();
+		indcs[free_page_count++] = i;
 	}
 
 
@@ -277,7 +297,7 @@ public:
 	size_t total_size() const { return (NUM_PAGES() * PAGE_SIZE()); }
 	size_t base_offset(const void* p) const { return (reinterpret_cast<const uint8_t*>(p) - reinterpret_cast<const uint8_t*>(pages[0].data())); }
 
-	bool mapped(const void* p) const { return (((base_offset(p) / PAGE_SIZE()) < total_size()) && ((base_offset(p) % PAGE_SIZE()) == 0)); }
+	bool mapped(const void* p) const { return (((base_offset(p) / PAGE_SIZE()) < NUM_PAGES()) && ((base_offset(p) % PAGE_SIZE()) == 0)); }
 	bool alloced(const void* p) const { return (pages[curr_page_index].data() == p); }
 
 	bool can_alloc() const { return (used_page_count < NUM_PAGES() || free_page_count > 0); }
@@ -286,7 +306,8 @@ public:
 	void reserve(size_t) {} // no-op
 	void clear() {
 		std::memset(pages.data(), 0, total_size());
-		std::memset(indcs.data(), 0, NUM_PAGES());
+		std::memset(indcs.data(), 0, sizeof(indcs));
+		std::memset(sizes.data(), 0, sizeof(sizes));
 
 		used_page_count = 0;
 		free_page_count = 0;
@@ -296,6 +317,7 @@ public:
 private:
 	std::array<std::array<uint8_t, S>, N> pages;
 	std::array<size_t, N> indcs;
+	std::array<uint32_t, N> sizes; // of the live allocation per page
 
 	size_t used_page_count = 0;
 	size_t free_page_count = 0; // indcs[fpc-1] is the last recycled page
@@ -24,6 +24,7 @@
 #include "Game/GameVersion.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/SpringExitCode.h"
+#include "System/Log/FileSink.h"
 #include "System/Log/ILog.h"
 #include "System/Log/LogSinkHandler.h"
 #include "System/LogOutput.h"
@@ -931,7 +932,8 @@ namespace CrashHandler
     }
 
 
-	void PrepareStacktrace(const int logLevel) {}
+	// records still queued for the writer-thread go before the trace
+	void PrepareStacktrace(const int logLevel) { log_file_flushQueuedRecords(); }
 	void CleanupStacktrace(const int logLevel) { LOG_CLEANUP(); }
 
 
@@ -17,6 +17,7 @@
 	#include <shlobj.h>
 	#include <shlwapi.h>
 	#include <iphlpapi.h>
+	#include <psapi.h>
 
 	#ifndef SHGFP_TYPE_CURRENT
 		#define SHGFP_TYPE_CURRENT 0
@@ -40,6 +41,7 @@
 #if !defined(_WIN32)
 #include <dlfcn.h> // for dladdr(), dlopen()
 #include <pwd.h> // for getpw*()
+#include <sys/resource.h> // for getrusage()
 #include <sys/statvfs.h>
 #include <sys/types.h>
 #include <sys/utsname.h> // for uname()
@@ -513,6 +515,37 @@ namespace Platform
 		#endif
 	}
 
+	uint64_t PeakMemoryUsage() {
+		#ifdef _WIN32
+		// psapi is not linked, look K32GetProcessMemoryInfo up at runtime (Win7+)
+		typedef BOOL (WINAPI *LPFN_GETPROCESSMEMORYINFO) (HANDLE, PPROCESS_MEMORY_COUNTERS, DWORD);
+
+		HMODULE hModule = GetModuleHandle(TEXT("kernel32"));
+		LPFN_GETPROCESSMEMORYINFO getProcMemInfoFn = (LPFN_GETPROCESSMEMORYINFO) GetProcAddress(hModule, "K32GetProcessMemoryInfo");
+
+		PROCESS_MEMORY_COUNTERS pmc;
+
+		if (getProcMemInfoFn == nullptr || !getProcMemInfoFn(GetCurrentProcess(), &pmc, sizeof(pmc)))
+			return 0;
+
+		return (pmc.PeakWorkingSetSize / 1024);
+
+		#else
+
+		struct rusage ru;
+
+		if (getrusage(RUSAGE_SELF, &ru) != 0)
+			return 0;
+
+		#ifdef __APPLE__
+		// bytes on OSX, KB everywhere else
+		return (ru.ru_maxrss / 1024);
+		#else
+		return (ru.ru_maxrss);
+		#endif
+		#endif
+	}
+
 
 	uint32_t NativeWordSize() { return (sizeof(void*)); }
 	uint32_t SystemWordSize() { return ((Is32BitEmulation())? 8: NativeWordSize()); }
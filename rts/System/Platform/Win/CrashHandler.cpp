@@ -401,6 +401,9 @@ void PrepareStacktrace(const int logLevel) {
 	EnterCriticalSection(&stackLock);
 	InitImageHlpDll();
 
+	// records still queued for the writer-thread go before the trace
+	log_file_flushQueuedRecords();
+
 	// sidestep any kind of hidden allocation which might cause a deadlock
 	// this does mean the "[f=123456] Error:" prefixes will not be present
 	logFile = log_file_getLogFileStream((logOutput.GetFilePath()).c_str());
@@ -0,0 +1,77 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace spring {
+	/**
+	 * Stable LSD radix-sort of <items> into ascending order of the 32-bit
+	 * keys returned by <keyFunc>, eight bits per pass. Passes over digits
+	 * that are the same for every item are skipped, so keys quantized to
+	 * 16 bits cost two scatter passes. <scratch> is the ping-pong buffer;
+	 * keep it around between calls to avoid reallocating.
+	 */
+	template<typename T, typename KeyFunc>
+	static void RadixSort(std::vector<T>& items, std::vector<T>& scratch, KeyFunc&& keyFunc)
+	{
+		constexpr unsigned int NUM_PASSES = 4;
+		constexpr unsigned int NUM_BUCKETS = 256;
+
+		const size_t numItems = items.size();
+
+		if (numItems <= 1)
+			return;
+
+		// one histogram per digit, gathered in a single sweep
+		std::array< std::array<size_t, NUM_BUCKETS>, NUM_PASSES > counts;
+
+		for (auto& digitCounts: counts) {
+			digitCounts.fill(0);
+		}
+
+		for (const T& item: items) {
+			const std::uint32_t key = keyFunc(item);
+
+			for (unsigned int pass = 0; pass < NUM_PASSES; pass++) {
+				counts[pass][(key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		scratch.resize(numItems);
+
+		T* src = items.data();
+		T* dst = scratch.data();
+
+		for (unsigned int pass = 0; pass < NUM_PASSES; pass++) {
+			auto& digitCounts = counts[pass];
+
+			if (digitCounts[(keyFunc(src[0]) >> (pass * 8)) & 0xFF] == numItems)
+				continue;
+
+			size_t offset = 0;
+
+			for (size_t& count: digitCounts) {
+				const size_t n = count;
+				count = offset;
+				offset += n;
+			}
+
+			for (size_t i = 0; i < numItems; i++) {
+				dst[ digitCounts[(keyFunc(src[i]) >> (pass * 8)) & 0xFF]++ ] = src[i];
+			}
+
+			std::swap(src, dst);
+		}
+
+		if (src != items.data())
+			items.swap(scratch);
+	}
+}
+
+#endif
@@ -36,6 +36,7 @@
 #include "Game/Game.h"
 #include "Game/GlobalUnsynced.h"
 #include "Game/PreGame.h"
+#include "Game/SimBenchmark.h"
 #include "Game/UI/KeyBindings.h"
 #include "Game/UI/KeyCodes.h"
 #include "Game/UI/InfoConsole.h"
@@ -135,6 +136,7 @@ DEFINE_string   (map,                                      "",    "Specify the m
 DEFINE_string   (menu,                                     "",    "Specify a lua menu archive to be used by spring");
 DEFINE_string   (name,                                     "",    "Set your player name");
 DEFINE_bool     (oldmenu,                                  false, "Start the old menu");
+DEFINE_uint32   (simbench,                                 0,     "Simulate this many frames as fast as possible once the game starts, write simbench.txt and quit");
 
 
 
@@ -470,6 +472,7 @@ void SpringApp::ParseCmdLine(int argc, char* argv[])
 	}
 
 	CTextureAtlas::SetDebug(FLAGS_textureatlas);
+	simBenchmark.SetNumFrames(FLAGS_simbench);
 
 	// if this fails, configHandler remains null
 	// logOutput's init depends on configHandler
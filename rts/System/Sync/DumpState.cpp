@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <vector>
@@ -28,6 +29,16 @@
 #include "System/StringUtil.h"
 #include "System/Log/ILog.h"
 
+#define DUMP_UNIT_DATA
+#define DUMP_UNIT_PIECE_DATA
+#define DUMP_UNIT_WEAPON_DATA
+#define DUMP_UNIT_COMMANDAI_DATA
+#define DUMP_UNIT_MOVETYPE_DATA
+#define DUMP_FEATURE_DATA
+#define DUMP_PROJECTILE_DATA
+#define DUMP_TEAM_DATA
+// #define DUMP_ALLYTEAM_DATA
+
 static std::fstream file;
 
 static int gMinFrameNum = -1;
@@ -35,6 +46,115 @@ static int gMaxFrameNum = -1;
 static int gFramePeriod =  1;
 
 
+static void DumpUnit(std::ostream& out, const CUnit* u)
+{
+	const std::vector<CWeapon*>& weapons = u->weapons;
+	const LocalModel& lm = u->localModel;
+	const std::vector<LocalModelPiece>& pieces = lm.pieces;
+
+	const float3& pos = u->pos;
+	const float3& xdir = u->rightdir;
+	const float3& ydir = u->updir;
+	const float3& zdir = u->frontdir;
+
+	out << "\t\tunitID: " << u->id << " (name: " << u->unitDef->name << ")\n";
+	out << "\t\t\tpos: <" << pos.x << ", " << pos.y << ", " << pos.z << ">\n";
+	out << "\t\t\txdir: <" << xdir.x << ", " << xdir.y << ", " << xdir.z << ">\n";
+	out << "\t\t\tydir: <" << ydir.x << ", " << ydir.y << ", " << ydir.z << ">\n";
+	out << "\t\t\tzdir: <" << zdir.x << ", " << zdir.y << ", " << zdir.z << ">\n";
+	out << "\t\t\theading: " << int(u->heading) << ", mapSquare: " << u->mapSquare << "\n";
+	out << "\t\t\thealth: " << u->health << ", experience: " << u->experience << "\n";
+	out << "\t\t\tisDead: " << u->isDead << ", activated: " << u->activated << "\n";
+	out << "\t\t\tphysicalState: " << u->physicalState << "\n";
+	out << "\t\t\tfireState: " << u->fireState << ", moveState: " << u->moveState << "\n";
+	out << "\t\t\tpieces: " << pieces.size() << "\n";
+
+	#ifdef DUMP_UNIT_PIECE_DATA
+	for (const LocalModelPiece& lmp: pieces) {
+		const S3DModelPiece* omp = lmp.original;
+		const S3DModelPiece* par = omp->parent;
+		const float3& ppos = lmp.GetPosition();
+		const float3& prot = lmp.GetRotation();
+
+		out << "\t\t\t\tname: " << omp->name << " (parentName: " << ((par != nullptr)? par->name: "[null]") << ")\n";
+		out << "\t\t\t\tpos: <" << ppos.x << ", " << ppos.y << ", " << ppos.z << ">\n";
+		out << "\t\t\t\trot: <" << prot.x << ", " << prot.y << ", " << prot.z << ">\n";
+		out << "\t\t\t\tvisible: " << lmp.scriptSetVisible << "\n";
+		out << "\n";
+	}
+	#endif
+
+	out << "\t\t\tweapons: " << weapons.size() << "\n";
+
+	#ifdef DUMP_UNIT_WEAPON_DATA
+	for (const CWeapon* w: weapons) {
+		const float3& awp = w->aimFromPos;
+		const float3& rwp = w->relAimFromPos;
+		const float3& amp = w->weaponMuzzlePos;
+		const float3& rmp = w->relWeaponMuzzlePos;
+
+		out << "\t\t\t\tweaponID: " << w->weaponNum << " (name: " << w->weaponDef->name << ")\n";
+		out << "\t\t\t\tweaponDir: <" << w->weaponDir.x << ", " << w->weaponDir.y << ", " << w->weaponDir.z << ">\n";
+		out << "\t\t\t\tabsWeaponPos: <" << awp.x << ", " << awp.y << ", " << awp.z << ">\n";
+		out << "\t\t\t\trelAimFromPos: <" << rwp.x << ", " << rwp.y << ", " << rwp.z << ">\n";
+		out << "\t\t\t\tabsWeaponMuzzlePos: <" << amp.x << ", " << amp.y << ", " << amp.z << ">\n";
+		out << "\t\t\t\trelWeaponMuzzlePos: <" << rmp.x << ", " << rmp.y << ", " << rmp.z << ">\n";
+		out << "\n";
+	}
+	#endif
+
+	#ifdef DUMP_UNIT_COMMANDAI_DATA
+	const CCommandAI* cai = u->commandAI;
+	const CCommandQueue& cq = cai->commandQue;
+
+	out << "\t\t\tcommandAI:\n";
+	out << "\t\t\t\torderTarget->id: " << ((cai->orderTarget != nullptr)? cai->orderTarget->id: -1) << "\n";
+	out << "\t\t\t\tcommandQue.size(): " << cq.size() << "\n";
+
+	for (const Command& c: cq) {
+		out << "\t\t\t\t\tcommandID: " << c.GetID() << "\n";
+		out << "\t\t\t\t\ttag: " << c.GetTag() << ", options: " << c.GetOpts() << "\n";
+		out << "\t\t\t\t\tparams: " << c.GetNumParams() << "\n";
+
+		for (unsigned int n = 0; n < c.GetNumParams(); n++) {
+			out << "\t\t\t\t\t\t" << c.GetParam(n) << "\n";
+		}
+	}
+	#endif
+
+	#ifdef DUMP_UNIT_MOVETYPE_DATA
+	const AMoveType* amt = u->moveType;
+	const float3& goalPos = amt->goalPos;
+	const float3& oldUpdatePos = amt->oldPos;
+	const float3& oldSlowUpPos = amt->oldSlowUpdatePos;
+
+	out << "\t\t\tmoveType:\n";
+	out << "\t\t\t\tgoalPos: <" << goalPos.x << ", " << goalPos.y << ", " << goalPos.z << ">\n";
+	out << "\t\t\t\toldUpdatePos: <" << oldUpdatePos.x << ", " << oldUpdatePos.y << ", " << oldUpdatePos.z << ">\n";
+	out << "\t\t\t\toldSlowUpPos: <" << oldSlowUpPos.x << ", " << oldSlowUpPos.y << ", " << oldSlowUpPos.z << ">\n";
+	out << "\t\t\t\tmaxSpeed: " << amt->GetMaxSpeed() << ", maxWantedSpeed: " << amt->GetMaxWantedSpeed() << "\n";
+	out << "\t\t\t\tprogressState: " << amt->progressState << "\n";
+	#endif
+}
+
+static void DumpFeature(std::ostream& out, const CFeature* f)
+{
+	out << "\t\tfeatureID: " << f->id << " (name: " << f->def->name << ")\n";
+	out << "\t\t\tpos: <" << f->pos.x << ", " << f->pos.y << ", " << f->pos.z << ">\n";
+	out << "\t\t\thealth: " << f->health << ", reclaimLeft: " << f->reclaimLeft << "\n";
+}
+
+static void DumpProjectile(std::ostream& out, const CProjectile* p)
+{
+	out << "\t\tprojectileID: " << p->id << "\n";
+	out << "\t\t\tpos: <" << p->pos.x << ", " << p->pos.y << ", " << p->pos.z << ">\n";
+	out << "\t\t\tdir: <" << p->dir.x << ", " << p->dir.y << ", " << p->dir.z << ">\n";
+	out << "\t\t\tspeed: <" << p->speed.x << ", " << p->speed.y << ", " << p->speed.z << ">\n";
+	out << "\t\t\tweapon: " << p->weapon << ", piece: " << p->piece << "\n";
+	out << "\t\t\tcheckCol: " << p->checkCol << ", deleteMe: " << p->deleteMe << "\n";
+}
+
+
 void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 {
 	#ifdef NDEBUG
@@ -104,105 +224,9 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 	file << "frame: " << gs->frameNum << ", seed: " << gsRNG.GetLastSeed() << "\n";
 	file << "\tunits: " << activeUnits.size() << "\n";
 
-	#define DUMP_UNIT_DATA
-	#define DUMP_UNIT_PIECE_DATA
-	#define DUMP_UNIT_WEAPON_DATA
-	#define DUMP_UNIT_COMMANDAI_DATA
-	#define DUMP_UNIT_MOVETYPE_DATA
-	#define DUMP_FEATURE_DATA
-	#define DUMP_PROJECTILE_DATA
-	#define DUMP_TEAM_DATA
-	// #define DUMP_ALLYTEAM_DATA
-
 	#ifdef DUMP_UNIT_DATA
 	for (const CUnit* u: activeUnits) {
-		const std::vector<CWeapon*>& weapons = u->weapons;
-		const LocalModel& lm = u->localModel;
-		const std::vector<LocalModelPiece>& pieces = lm.pieces;
-
-		const float3& pos = u->pos;
-		const float3& xdir = u->rightdir;
-		const float3& ydir = u->updir;
-		const float3& zdir = u->frontdir;
-
-		file << "\t\tunitID: " << u->id << " (name: " << u->unitDef->name << ")\n";
-		file << "\t\t\tpos: <" << pos.x << ", " << pos.y << ", " << pos.z << ">\n";
-		file << "\t\t\txdir: <" << xdir.x << ", " << xdir.y << ", " << xdir.z << ">\n";
-		file << "\t\t\tydir: <" << ydir.x << ", " << ydir.y << ", " << ydir.z << ">\n";
-		file << "\t\t\tzdir: <" << zdir.x << ", " << zdir.y << ", " << zdir.z << ">\n";
-		file << "\t\t\theading: " << int(u->heading) << ", mapSquare: " << u->mapSquare << "\n";
-		file << "\t\t\thealth: " << u->health << ", experience: " << u->experience << "\n";
-		file << "\t\t\tisDead: " << u->isDead << ", activated: " << u->activated << "\n";
-		file << "\t\t\tphysicalState: " << u->physicalState << "\n";
-		file << "\t\t\tfireState: " << u->fireState << ", moveState: " << u->moveState << "\n";
-		file << "\t\t\tpieces: " << pieces.size() << "\n";
-
-		#ifdef DUMP_UNIT_PIECE_DATA
-		for (const LocalModelPiece& lmp: pieces) {
-			const S3DModelPiece* omp = lmp.original;
-			const S3DModelPiece* par = omp->parent;
-			const float3& ppos = lmp.GetPosition();
-			const float3& prot = lmp.GetRotation();
-
-			file << "\t\t\t\tname: " << omp->name << " (parentName: " << ((par != nullptr)? par->name: "[null]") << ")\n";
-			file << "\t\t\t\tpos: <" << ppos.x << ", " << ppos.y << ", " << ppos.z << ">\n";
-			file << "\t\t\t\trot: <" << prot.x << ", " << prot.y << ", " << prot.z << ">\n";
-			file << "\t\t\t\tvisible: " << lmp.scriptSetVisible << "\n";
-			file << "\n";
-		}
-		#endif
-
-		file << "\t\t\tweapons: " << weapons.size() << "\n";
-
-		#ifdef DUMP_UNIT_WEAPON_DATA
-		for (const CWeapon* w: weapons) {
-			const float3& awp = w->aimFromPos;
-			const float3& rwp = w->relAimFromPos;
-			const float3& amp = w->weaponMuzzlePos;
-			const float3& rmp = w->relWeaponMuzzlePos;
-
-			file << "\t\t\t\tweaponID: " << w->weaponNum << " (name: " << w->weaponDef->name << ")\n";
-			file << "\t\t\t\tweaponDir: <" << w->weaponDir.x << ", " << w->weaponDir.y << ", " << w->weaponDir.z << ">\n";
-			file << "\t\t\t\tabsWeaponPos: <" << awp.x << ", " << awp.y << ", " << awp.z << ">\n";
-			file << "\t\t\t\trelAimFromPos: <" << rwp.x << ", " << rwp.y << ", " << rwp.z << ">\n";
-			file << "\t\t\t\tabsWeaponMuzzlePos: <" << amp.x << ", " << amp.y << ", " << amp.z << ">\n";
-			file << "\t\t\t\trelWeaponMuzzlePos: <" << rmp.x << ", " << rmp.y << ", " << rmp.z << ">\n";
-			file << "\n";
-		}
-		#endif
-
-		#ifdef DUMP_UNIT_COMMANDAI_DATA
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
-
-		file << "\t\t\tcommandAI:\n";
-		file << "\t\t\t\torderTarget->id: " << ((cai->orderTarget != nullptr)? cai->orderTarget->id: -1) << "\n";
-		file << "\t\t\t\tcommandQue.size(): " << cq.size() << "\n";
-
-		for (const Command& c: cq) {
-			file << "\t\t\t\t\tcommandID: " << c.GetID() << "\n";
-			file << "\t\t\t\t\ttag: " << c.GetTag() << ", options: " << c.GetOpts() << "\n";
-			file << "\t\t\t\t\tparams: " << c.GetNumParams() << "\n";
-
-			for (unsigned int n = 0; n < c.GetNumParams(); n++) {
-				file << "\t\t\t\t\t\t" << c.GetParam(n) << "\n";
-			}
-		}
-		#endif
-
-		#ifdef DUMP_UNIT_MOVETYPE_DATA
-		const AMoveType* amt = u->moveType;
-		const float3& goalPos = amt->goalPos;
-		const float3& oldUpdatePos = amt->oldPos;
-		const float3& oldSlowUpPos = amt->oldSlowUpdatePos;
-
-		file << "\t\t\tmoveType:\n";
-		file << "\t\t\t\tgoalPos: <" << goalPos.x << ", " << goalPos.y << ", " << goalPos.z << ">\n";
-		file << "\t\t\t\toldUpdatePos: <" << oldUpdatePos.x << ", " << oldUpdatePos.y << ", " << oldUpdatePos.z << ">\n";
-		file << "\t\t\t\toldSlowUpPos: <" << oldSlowUpPos.x << ", " << oldSlowUpPos.y << ", " << oldSlowUpPos.z << ">\n";
-		file << "\t\t\t\tmaxSpeed: " << amt->GetMaxSpeed() << ", maxWantedSpeed: " << amt->GetMaxWantedSpeed() << "\n";
-		file << "\t\t\t\tprogressState: " << amt->progressState << "\n";
-		#endif
+		DumpUnit(file, u);
 	}
 	#endif
 
@@ -210,11 +234,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 
 	#ifdef DUMP_FEATURE_DATA
 	for (const int featureID: activeFeatureIDs) {
-		const CFeature* f = featureHandler.GetFeature(featureID);
-
-		file << "\t\tfeatureID: " << f->id << " (name: " << f->def->name << ")\n";
-		file << "\t\t\tpos: <" << f->pos.x << ", " << f->pos.y << ", " << f->pos.z << ">\n";
-		file << "\t\t\thealth: " << f->health << ", reclaimLeft: " << f->reclaimLeft << "\n";
+		DumpFeature(file, featureHandler.GetFeature(featureID));
 	}
 	#endif
 
@@ -222,12 +242,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 
 	#ifdef DUMP_PROJECTILE_DATA
 	for (const CProjectile* p: projectiles) {
-		file << "\t\tprojectileID: " << p->id << "\n";
-		file << "\t\t\tpos: <" << p->pos.x << ", " << p->pos.y << ", " << p->pos.z << ">\n";
-		file << "\t\t\tdir: <" << p->dir.x << ", " << p->dir.y << ", " << p->dir.z << ">\n";
-		file << "\t\t\tspeed: <" << p->speed.x << ", " << p->speed.y << ", " << p->speed.z << ">\n";
-		file << "\t\t\tweapon: " << p->weapon << ", piece: " << p->piece << "\n";
-		file << "\t\t\tcheckCol: " << p->checkCol << ", deleteMe: " << p->deleteMe << "\n";
+		DumpProjectile(file, p);
 	}
 	#endif
 
@@ -265,3 +280,71 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 
 	file.flush();
 }
+
+
+void DumpObjectState(int objectType, int objectID, int frameNum, const std::vector<std::uint32_t>& writes)
+{
+	static const char* typeNames[] = {"unit", "feature", "projectile"};
+
+	if (objectType < DUMP_OBJECT_UNIT || objectType > DUMP_OBJECT_PROJECTILE)
+		return;
+
+	std::string name = (gameServer != nullptr)? "Server": "Client";
+	name += "ObjectState-";
+	name += IntToString(frameNum);
+	name += "-";
+	name += typeNames[objectType];
+	name += IntToString(objectID);
+	name += ".txt";
+
+	std::fstream objFile(name.c_str(), std::ios::out);
+
+	if (!objFile.is_open())
+		return;
+
+	// the state changes in the (desync-)frame, in assignment order; values
+	// of more than 32 bits are XOR'ed together
+	objFile << "frame: " << frameNum << ", synced writes: " << writes.size() << "\n";
+
+	for (size_t n = 0; n < writes.size(); n++) {
+		float f;
+		std::memcpy(&f, &writes[n], sizeof(f));
+
+		objFile << "\t#" << n << ": " << IntToString(writes[n], "0x%08X") << " (" << f << ")\n";
+	}
+
+	// no snapshot of the rest is kept, it can only be dumped as it is now
+	objFile << "frame: " << gs->frameNum << ", seed: " << gsRNG.GetLastSeed() << "\n";
+
+	switch (objectType) {
+		case DUMP_OBJECT_UNIT: {
+			const CUnit* u = unitHandler.GetUnit(objectID);
+
+			if (u != nullptr) {
+				DumpUnit(objFile, u);
+			} else {
+				objFile << "\t\tunitID: " << objectID << " (dead)\n";
+			}
+		} break;
+		case DUMP_OBJECT_FEATURE: {
+			const CFeature* f = featureHandler.GetFeature(objectID);
+
+			if (f != nullptr) {
+				DumpFeature(objFile, f);
+			} else {
+				objFile << "\t\tfeatureID: " << objectID << " (dead)\n";
+			}
+		} break;
+		case DUMP_OBJECT_PROJECTILE: {
+			const CProjectile* p = projectileHandler.GetProjectileBySyncedID(objectID);
+
+			if (p != nullptr) {
+				DumpProjectile(objFile, p);
+			} else {
+				objFile << "\t\tprojectileID: " << objectID << " (dead)\n";
+			}
+		} break;
+	}
+
+	LOG("[%s] dumped state of %s %d to \"%s\"", __func__, typeNames[objectType], objectID, name.c_str());
+}
@@ -3,6 +3,21 @@
 #ifndef DUMPSTATE_H
 #define DUMPSTATE_H
 
+#include <cinttypes>
+#include <vector>
+
+enum DumpObjectType {
+	DUMP_OBJECT_UNIT       = 0,
+	DUMP_OBJECT_FEATURE    = 1,
+	DUMP_OBJECT_PROJECTILE = 2,
+};
+
 extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod);
+/**
+ * Writes the values assigned to the synced variables of a single object
+ * during <frameNum> (as recorded by the sync checker), followed by the
+ * object's current state, to its own file; used to examine a desync.
+ */
+extern void DumpObjectState(int objectType, int objectID, int frameNum, const std::vector<std::uint32_t>& writes);
 
 #endif /* DUMPSTATE_H */
@@ -4,10 +4,95 @@
 #ifdef SYNCCHECK
 
 #include "SyncChecker.h"
+#include "System/Threading/SpringThreading.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 
 unsigned CSyncChecker::g_checksum;
+CSyncChecksumTree CSyncChecker::checksumTree;
+_threadlocal CSyncChecker::Lane* CSyncChecker::activeLane = nullptr;
 int CSyncChecker::inSyncedCode;
 
 
+// lanes closed by each thread during the current phase; a thread registers
+// its buffer the first time it opens a lane and keeps it for its lifetime
+static std::vector< std::unique_ptr< std::vector<CSyncChecker::Lane> > > laneBuffers;
+static spring::spinlock laneBuffersLock;
+
+static _threadlocal std::vector<CSyncChecker::Lane>* threadLanes = nullptr;
+
+static std::vector<CSyncChecker::Lane> mergedLanes;
+
+static bool inParallelPhase = false;
+
+
+void CSyncChecker::BeginParallelPhase()
+{
+	assert(!inParallelPhase);
+	assert(activeLane == nullptr);
+
+	inParallelPhase = true;
+}
+
+void CSyncChecker::EndParallelPhase()
+{
+	assert(inParallelPhase);
+	assert(activeLane == nullptr);
+
+	inParallelPhase = false;
+	mergedLanes.clear();
+
+	{
+		std::lock_guard<spring::spinlock> lock(laneBuffersLock);
+
+		for (const auto& buffer: laneBuffers) {
+			mergedLanes.insert(mergedLanes.end(), buffer->begin(), buffer->end());
+			buffer->clear();
+		}
+	}
+
+	std::sort(mergedLanes.begin(), mergedLanes.end());
+
+	for (const Lane& lane: mergedLanes) {
+		Fold(g_checksum, &lane.key, sizeof(lane.key));
+		Fold(g_checksum, &lane.checksum, sizeof(lane.checksum));
+
+		checksumTree.Sync(lane.key);
+		checksumTree.Sync(lane.checksum);
+	}
+}
+
+
+void CSyncChecker::BeginLane(unsigned key)
+{
+	assert(inParallelPhase);
+	assert(activeLane == nullptr);
+
+	if (threadLanes == nullptr) {
+		std::lock_guard<spring::spinlock> lock(laneBuffersLock);
+
+		laneBuffers.emplace_back(new std::vector<Lane>());
+		threadLanes = laneBuffers.back().get();
+	}
+
+	threadLanes->push_back({key, 0xfade1eaf});
+	activeLane = &threadLanes->back();
+}
+
+void CSyncChecker::EndLane()
+{
+	assert(activeLane != nullptr);
+
+	// nothing synced, keeps phases without synced writes from changing the checksum
+	if (activeLane->checksum == 0xfade1eaf)
+		threadLanes->pop_back();
+
+	activeLane = nullptr;
+}
+
+
 #endif // SYNCDEBUG
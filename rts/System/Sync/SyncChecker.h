@@ -13,16 +13,68 @@
 	#include "HsiehHash.h"
 #endif
 
+#include "SyncChecksumTree.h"
+#include "System/MainDefines.h"
+
 #include <assert.h>
 
 /**
  * @brief sync checker class
  *
  * A Lightweight sync debugger that just keeps a running checksum over all
- * assignments to synced variables.
+ * assignments to synced variables. The assignments are also recorded in a
+ * CSyncChecksumTree, to locate a desync once the running checksums differ.
+ *
+ * Synced code that runs on several threads at once accumulates into lanes
+ * instead: between BeginParallelPhase and EndParallelPhase each task opens
+ * a lane (ScopedLane) keyed by something deterministic such as an object
+ * id, and EndParallelPhase folds the lanes into the running checksum in key
+ * order. The result then only depends on what each task synced and never
+ * on which thread ran it or when.
  */
 class CSyncChecker {
 
+	public:
+		struct Lane {
+			bool operator < (const Lane& l) const { return ((key < l.key) || (key == l.key && checksum < l.checksum)); }
+
+			unsigned key;
+			unsigned checksum;
+		};
+
+		class ScopedLane {
+			public:
+				ScopedLane(unsigned key) { BeginLane(key); }
+				~ScopedLane() { EndLane(); }
+
+				ScopedLane(const ScopedLane&) = delete;
+				ScopedLane& operator = (const ScopedLane&) = delete;
+		};
+
+		/**
+		 * @brief attributes synced writes to a sim phase
+		 * @see SYNC_DEBUG_PHASE
+		 */
+		class ScopedPhase {
+			public:
+				ScopedPhase(unsigned phaseID): prevPhaseID(checksumTree.SetPhase(phaseID)) {}
+				~ScopedPhase() { checksumTree.SetPhase(prevPhaseID); }
+			private:
+				unsigned prevPhaseID;
+		};
+
+		/**
+		 * @brief attributes synced writes to the object being updated
+		 * @see SYNC_DEBUG_OBJECT
+		 */
+		class ScopedObject {
+			public:
+				ScopedObject(int objectID): prevObjectID(checksumTree.SetObject(objectID)) {}
+				~ScopedObject() { checksumTree.SetObject(prevObjectID); }
+			private:
+				int prevObjectID;
+		};
+
 	public:
 		/**
 		 * Whether one thread (doesn't have to be the current thread!!!) is currently processing a SimFrame.
@@ -37,48 +89,97 @@ class CSyncChecker {
 		static unsigned GetChecksum() { return g_checksum; }
 		static void NewFrame() { g_checksum = 0xfade1eaf; }
 
+		/**
+		 * Per frame, phase and object record of the last frames' assignments.
+		 */
+		static CSyncChecksumTree& GetChecksumTree() { return checksumTree; }
+
+		/**
+		 * Called by the thread that starts and finishes a parallel phase, with
+		 * no lanes open; lanes that nothing was synced into are left out.
+		 */
+		static void BeginParallelPhase();
+		static void EndParallelPhase();
+
+		/**
+		 * Lanes can not nest; within one phase the same key may be used by
+		 * several tasks, the merge-order then also goes by lane checksum.
+		 */
+		static void BeginLane(unsigned key);
+		static void EndLane();
+
 		static void Sync(const void* p, unsigned size) {
+			if (activeLane != nullptr) {
+				Fold(activeLane->checksum, p, size);
+				return;
+			}
+
+			Fold(g_checksum, p, size);
+			checksumTree.Sync(GetWord(p, size));
+		}
+
+	private:
+		/**
+		 * The value itself if it fits into 32 bits, else the XOR of its words;
+		 * same as what CSyncDebugger keeps per assignment.
+		 */
+		static unsigned GetWord(const void* p, unsigned size) {
+			if (size == 4)
+				return *(const unsigned*)p;
+
+			unsigned i = 0;
+			unsigned word = 0;
+
+			for (; i < (size & ~3); i += 4)
+				word ^= *(const unsigned*)((const unsigned char*)p + i);
+			for (; i < size; ++i)
+				word ^= *((const unsigned char*)p + i);
+
+			return word;
+		}
+
+		static void Fold(unsigned& checksum, const void* p, unsigned size) {
 			// most common cases first, make it easy for compiler to optimize for it
 			// simple xor is not enough to detect multiple zeroes, e.g.
 #ifdef TRACE_SYNC_HSIEH
-			g_checksum = HsiehHash((const char*)p, size, g_checksum);
+			checksum = HsiehHash((const char*)p, size, checksum);
 #else
 			switch(size) {
 			case 1:
-				g_checksum += *(const unsigned char*)p;
-				g_checksum ^= g_checksum << 10;
-				g_checksum += g_checksum >> 1;
+				checksum += *(const unsigned char*)p;
+				checksum ^= checksum << 10;
+				checksum += checksum >> 1;
 				break;
 			case 2:
-				g_checksum += *(const unsigned short*)(const char*)p;
-				g_checksum ^= g_checksum << 11;
-				g_checksum += g_checksum >> 17;
+				checksum += *(const unsigned short*)(const char*)p;
+				checksum ^= checksum << 11;
+				checksum += checksum >> 17;
 				break;
 			case 3:
 				// just here to make the switch statements contiguous (so it can be optimized)
 				for (unsigned i = 0; i < 3; ++i) {
-					g_checksum += *(const unsigned char*)p + i;
-					g_checksum ^= g_checksum << 10;
-					g_checksum += g_checksum >> 1;
+					checksum += *(const unsigned char*)p + i;
+					checksum ^= checksum << 10;
+					checksum += checksum >> 1;
 				}
 				break;
 			case 4:
-				g_checksum += *(const unsigned int*)(const char*)p;
-				g_checksum ^= g_checksum << 16;
-				g_checksum += g_checksum >> 11;
+				checksum += *(const unsigned int*)(const char*)p;
+				checksum ^= checksum << 16;
+				checksum += checksum >> 11;
 				break;
 			default:
 			{
 				unsigned i = 0;
 				for (; i < (size & ~3) / 4; ++i) {
-					g_checksum += *(reinterpret_cast<const unsigned int*>(p) + i);
-					g_checksum ^= g_checksum << 16;
-					g_checksum += g_checksum >> 11;
+					checksum += *(reinterpret_cast<const unsigned int*>(p) + i);
+					checksum ^= checksum << 16;
+					checksum += checksum >> 11;
 				}
 				for (; i < size; ++i) {
-					g_checksum += *(const unsigned char*)p + i;
-					g_checksum ^= g_checksum << 10;
-					g_checksum += g_checksum >> 1;
+					checksum += *(const unsigned char*)p + i;
+					checksum ^= checksum << 10;
+					checksum += checksum >> 1;
 				}
 				break;
 			}
@@ -93,6 +194,16 @@ class CSyncChecker {
 		 */
 		static unsigned g_checksum;
 
+		/**
+		 * Recorded alongside g_checksum, lanes are added when merged
+		 */
+		static CSyncChecksumTree checksumTree;
+
+		/**
+		 * Lane the current thread syncs into, if any
+		 */
+		static _threadlocal Lane* activeLane;
+
 		/**
 		 * @brief in synced code
 		 *
@@ -0,0 +1,260 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SyncChecksumTree.h"
+
+#include <algorithm>
+
+
+static constexpr std::uint32_t FNV_BASIS = 2166136261u;
+static constexpr std::uint32_t FNV_PRIME = 16777619u;
+
+static inline std::uint32_t HashWord(std::uint32_t hash, std::uint32_t word) {
+	return ((hash ^ word) * FNV_PRIME);
+}
+
+
+void CSyncChecksumTree::Clear()
+{
+	for (Frame& frame: frames) {
+		frame.frameNum = -1;
+		frame.phases.clear();
+		frame.leaves.clear();
+		frame.writes.clear();
+	}
+
+	curFrameIdx = 0;
+	curPhaseID = SYNC_PHASE_OTHER;
+	curObjectID = -1;
+
+	phaseOpen = false;
+	leafOpen = false;
+	frozen = false;
+}
+
+void CSyncChecksumTree::NewFrame(int frameNum)
+{
+	if (frozen)
+		return;
+
+	curFrameIdx = (curFrameIdx + 1) % NUM_FRAMES;
+
+	// keeps the capacity, recording stays allocation-free after a while
+	Frame& frame = frames[curFrameIdx];
+	frame.frameNum = frameNum;
+	frame.phases.clear();
+	frame.leaves.clear();
+	frame.writes.clear();
+
+	phaseOpen = false;
+	leafOpen = false;
+}
+
+void CSyncChecksumTree::OpenLeaf()
+{
+	Frame& frame = frames[curFrameIdx];
+
+	if (!phaseOpen) {
+		frame.phases.push_back({curPhaseID, std::uint32_t(frame.leaves.size()), 0});
+		phaseOpen = true;
+	}
+
+	frame.leaves.push_back({curObjectID, FNV_BASIS, 0, std::uint32_t(frame.writes.size())});
+	frame.phases.back().numLeaves += 1;
+
+	leafOpen = true;
+}
+
+
+const CSyncChecksumTree::Frame* CSyncChecksumTree::GetFrame(int frameNum) const
+{
+	for (const Frame& frame: frames) {
+		if (frame.frameNum == frameNum)
+			return &frame;
+	}
+
+	return nullptr;
+}
+
+std::uint32_t CSyncChecksumTree::HashPhase(const Frame& frame, const Phase& phase)
+{
+	std::uint32_t hash = HashWord(FNV_BASIS, phase.phaseID);
+
+	for (std::uint32_t n = phase.firstLeaf; n < (phase.firstLeaf + phase.numLeaves); n++) {
+		const Leaf& leaf = frame.leaves[n];
+
+		hash = HashWord(hash, leaf.objectID);
+		hash = HashWord(hash, leaf.checksum);
+		hash = HashWord(hash, leaf.numWrites);
+	}
+
+	return hash;
+}
+
+
+void CSyncChecksumTree::GetFrameChecksums(std::vector<std::uint32_t>& data) const
+{
+	data.clear();
+
+	// the oldest frame follows the current one
+	for (unsigned int i = 1; i <= NUM_FRAMES; i++) {
+		const Frame& frame = frames[(curFrameIdx + i) % NUM_FRAMES];
+
+		if (frame.frameNum < 0 && frame.phases.empty())
+			continue;
+
+		std::uint32_t hash = FNV_BASIS;
+
+		for (const Phase& phase: frame.phases) {
+			hash = HashWord(hash, phase.numLeaves);
+			hash = HashWord(hash, HashPhase(frame, phase));
+		}
+
+		data.push_back(frame.frameNum);
+		data.push_back(hash);
+	}
+}
+
+bool CSyncChecksumTree::GetPhaseChecksums(int frameNum, std::vector<std::uint32_t>& data) const
+{
+	const Frame* frame = GetFrame(frameNum);
+
+	data.clear();
+
+	if (frame == nullptr)
+		return false;
+
+	for (const Phase& phase: frame->phases) {
+		data.push_back(phase.phaseID);
+		data.push_back(phase.numLeaves);
+		data.push_back(HashPhase(*frame, phase));
+	}
+
+	return true;
+}
+
+bool CSyncChecksumTree::GetLeafChecksums(
+	int frameNum,
+	std::uint32_t phaseIdx,
+	std::uint32_t begin,
+	std::uint32_t end,
+	std::uint32_t numChunks,
+	std::vector<std::uint32_t>& data
+) const {
+	const Frame* frame = GetFrame(frameNum);
+
+	data.clear();
+
+	if (frame == nullptr || begin >= end || numChunks == 0)
+		return false;
+
+	const Phase* phase = (phaseIdx < frame->phases.size())? &frame->phases[phaseIdx]: nullptr;
+	const std::uint32_t numLeaves = (phase != nullptr)? phase->numLeaves: 0;
+	const std::uint32_t chunkSize = GetChunkSize(begin, end, numChunks);
+
+	for (std::uint32_t chunkBeg = begin; chunkBeg < end; chunkBeg += chunkSize) {
+		const std::uint32_t chunkEnd = std::min(end, chunkBeg + chunkSize);
+
+		std::uint32_t hash = FNV_BASIS;
+
+		for (std::uint32_t n = chunkBeg; n < chunkEnd; n++) {
+			if (n >= numLeaves) {
+				hash = HashWord(hash, 0xffffffffu);
+				continue;
+			}
+
+			const Leaf& leaf = frame->leaves[phase->firstLeaf + n];
+
+			hash = HashWord(hash, leaf.objectID);
+			hash = HashWord(hash, leaf.checksum);
+			hash = HashWord(hash, leaf.numWrites);
+		}
+
+		data.push_back(hash);
+	}
+
+	return true;
+}
+
+bool CSyncChecksumTree::GetLeaf(int frameNum, std::uint32_t phaseIdx, std::uint32_t leafIdx, Leaf& leaf) const
+{
+	const Frame* frame = GetFrame(frameNum);
+
+	if (frame == nullptr || phaseIdx >= frame->phases.size())
+		return false;
+
+	const Phase& phase = frame->phases[phaseIdx];
+
+	if (leafIdx >= phase.numLeaves)
+		return false;
+
+	leaf = frame->leaves[phase.firstLeaf + leafIdx];
+	return true;
+}
+
+bool CSyncChecksumTree::GetLeafWrites(int frameNum, std::uint32_t phaseIdx, std::uint32_t leafIdx, std::vector<std::uint32_t>& writes) const
+{
+	Leaf leaf;
+
+	writes.clear();
+
+	if (!GetLeaf(frameNum, phaseIdx, leafIdx, leaf))
+		return false;
+
+	const Frame* frame = GetFrame(frameNum);
+	const size_t beg = std::min(size_t(leaf.firstWrite), frame->writes.size());
+	const size_t end = std::min(size_t(leaf.firstWrite) + leaf.numWrites, frame->writes.size());
+
+	writes.assign(frame->writes.begin() + beg, frame->writes.begin() + end);
+	return true;
+}
+
+
+int CSyncChecksumTree::FindFirstMismatch(const std::vector< const std::vector<std::uint32_t>* >& responses, unsigned int recordSize)
+{
+	if (responses.size() < 2)
+		return -1;
+
+	size_t minSize = responses[0]->size();
+	size_t maxSize = responses[0]->size();
+
+	for (const std::vector<std::uint32_t>* response: responses) {
+		minSize = std::min(minSize, response->size());
+		maxSize = std::max(maxSize, response->size());
+	}
+
+	for (size_t i = 0; i < (minSize / recordSize); i++) {
+		for (size_t j = 1; j < responses.size(); j++) {
+			if (!std::equal(responses[0]->begin() + i * recordSize, responses[0]->begin() + (i + 1) * recordSize, responses[j]->begin() + i * recordSize))
+				return i;
+		}
+	}
+
+	if (minSize != maxSize)
+		return (minSize / recordSize);
+
+	return -1;
+}
+
+
+const char* CSyncChecksumTree::GetPhaseName(std::uint32_t phaseID)
+{
+	constexpr const char* names[NUM_SYNC_PHASES] = {
+		"Other",
+		"GameFrame",
+		"Pathing",
+		"UnitMoveTypes",
+		"UnitLosStates",
+		"UnitSlowUpdates",
+		"UnitUpdates",
+		"UnitWeapons",
+		"ProjectileCollisions",
+		"ProjectileUpdates",
+		"FeatureUpdates",
+		"UnitScripts",
+	};
+
+	if (phaseID >= NUM_SYNC_PHASES)
+		return "Unknown";
+
+	return names[phaseID];
+}
@@ -0,0 +1,175 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SYNC_CHECKSUM_TREE_H
+#define SYNC_CHECKSUM_TREE_H
+
+#include <cinttypes>
+#include <vector>
+
+#include "Sim/Misc/GlobalConstants.h"
+
+/// sim phases that are recorded separately (see SYNC_DEBUG_PHASE)
+enum SyncDebugPhase {
+	SYNC_PHASE_OTHER = 0,
+	SYNC_PHASE_GAMEFRAME,
+	SYNC_PHASE_PATHING,
+	SYNC_PHASE_UNIT_MOVETYPES,
+	SYNC_PHASE_UNIT_LOSSTATES,
+	SYNC_PHASE_UNIT_SLOWUPDATES,
+	SYNC_PHASE_UNIT_UPDATES,
+	SYNC_PHASE_UNIT_WEAPONS,
+	SYNC_PHASE_PROJECTILE_COLLISIONS,
+	SYNC_PHASE_PROJECTILE_UPDATES,
+	SYNC_PHASE_FEATURE_UPDATES,
+	SYNC_PHASE_UNIT_SCRIPTS,
+	NUM_SYNC_PHASES
+};
+
+
+/**
+ * @brief hierarchical record of synced writes
+ *
+ * Keeps the synced writes of the last NUM_FRAMES frames, split per sim
+ * phase and within a phase per object (e.g. unit) that was being updated
+ * at the time; this is cheap enough to always record (see CSyncChecker).
+ * After a desync, clients compare frame checksums, then the phases of the
+ * first differing frame, and then bisect the object list of the first
+ * differing phase in chunks, each step costing only one small packet per
+ * client (see CSyncTreeBisector). The written values of the object found
+ * last are kept as well, they are its state changes in the desync frame.
+ *
+ * Checksums of frames, phases and leaf-ranges are only computed when asked
+ * for; recording a write just folds it into the current leaf.
+ */
+class CSyncChecksumTree {
+public:
+	enum {
+		/// Number of (most recent) frames kept; the server may see a desync up
+		/// to SYNCCHECK_TIMEOUT frames late, plus a second for its request to
+		/// reach the clients (which stop recording once it arrives).
+		NUM_FRAMES = SYNCCHECK_TIMEOUT + GAME_SPEED,
+		NUM_CHUNKS = 64,     ///< Number of leaf-ranges compared per bisection step.
+		/// Number of written values kept per frame (at most ~85MB over all
+		/// frames), later writes still count towards the checksums.
+		MAX_FRAME_WRITES = 1 << 16,
+	};
+
+	/// all writes done for one object during (one stretch of) a phase
+	struct Leaf {
+		int objectID;        ///< -1 for writes outside of any object
+		std::uint32_t checksum;
+		std::uint32_t numWrites;
+		std::uint32_t firstWrite; ///< index of the first write in Frame::writes
+	};
+
+	struct Phase {
+		std::uint32_t phaseID;
+		std::uint32_t firstLeaf;
+		std::uint32_t numLeaves;
+	};
+
+	struct Frame {
+		int frameNum = -1;
+
+		std::vector<Phase> phases;
+		std::vector<Leaf> leaves;
+		std::vector<std::uint32_t> writes;
+	};
+
+public:
+	CSyncChecksumTree() { Clear(); }
+
+	void Clear();
+
+	/// starts recording a new frame, overwriting the oldest one
+	void NewFrame(int frameNum);
+
+	/// @return the previous phase, to be restored by the caller
+	std::uint32_t SetPhase(std::uint32_t phaseID) {
+		const std::uint32_t prevPhaseID = curPhaseID;
+
+		curPhaseID = phaseID;
+		phaseOpen = false;
+		leafOpen = false;
+		return prevPhaseID;
+	}
+	/// @return the previous object, to be restored by the caller
+	int SetObject(int objectID) {
+		const int prevObjectID = curObjectID;
+
+		curObjectID = objectID;
+		leafOpen = false;
+		return prevObjectID;
+	}
+
+	void Sync(std::uint32_t data) {
+		if (frozen)
+			return;
+		if (!leafOpen)
+			OpenLeaf();
+
+		Frame& frame = frames[curFrameIdx];
+		Leaf& leaf = frame.leaves.back();
+
+		// FNV-1a over words, order-dependent within a leaf
+		leaf.checksum = (leaf.checksum ^ data) * 16777619u;
+		leaf.numWrites += 1;
+
+		if (frame.writes.size() < MAX_FRAME_WRITES)
+			frame.writes.push_back(data);
+	}
+
+	/// stops (or resumes) recording, so nothing is overwritten during a desync-hunt
+	void SetFrozen(bool b) { frozen = b; }
+	bool IsFrozen() const { return frozen; }
+
+	const Frame* GetFrame(int frameNum) const;
+
+	/// [frameNum, checksum] for each recorded frame, oldest first
+	void GetFrameChecksums(std::vector<std::uint32_t>& data) const;
+	/// [phaseID, numLeaves, checksum] for each phase of <frameNum>, in order
+	bool GetPhaseChecksums(int frameNum, std::vector<std::uint32_t>& data) const;
+	/**
+	 * Checksum for each of (at most) <numChunks> consecutive ranges which the
+	 * leaves [begin, end) of phase <phaseIdx> in <frameNum> are split into.
+	 * Indices beyond the last leaf are hashed as well, so clients which ran
+	 * a phase for a different number of objects still differ.
+	 */
+	bool GetLeafChecksums(int frameNum, std::uint32_t phaseIdx, std::uint32_t begin, std::uint32_t end, std::uint32_t numChunks, std::vector<std::uint32_t>& data) const;
+	bool GetLeaf(int frameNum, std::uint32_t phaseIdx, std::uint32_t leafIdx, Leaf& leaf) const;
+	/// the values written for leaf <leafIdx> of phase <phaseIdx> in <frameNum>, in order (if kept)
+	bool GetLeafWrites(int frameNum, std::uint32_t phaseIdx, std::uint32_t leafIdx, std::vector<std::uint32_t>& writes) const;
+
+	static std::uint32_t GetChunkSize(std::uint32_t begin, std::uint32_t end, std::uint32_t numChunks) {
+		return ((end - begin + numChunks - 1) / numChunks);
+	}
+
+	/**
+	 * Compares the responses of several clients, each a sequence of records
+	 * of <recordSize> words.
+	 * @return index of the first record which differs between any two
+	 *   responses (or is missing from one of them), -1 if all are equal
+	 */
+	static int FindFirstMismatch(const std::vector< const std::vector<std::uint32_t>* >& responses, unsigned int recordSize);
+
+	static const char* GetPhaseName(std::uint32_t phaseID);
+
+private:
+	void OpenLeaf();
+
+	static std::uint32_t HashPhase(const Frame& frame, const Phase& phase);
+
+private:
+	Frame frames[NUM_FRAMES];
+
+	unsigned int curFrameIdx;
+
+	std::uint32_t curPhaseID;
+	int curObjectID;
+
+	bool phaseOpen;
+	bool leafOpen;
+	bool frozen;
+};
+
+#endif // SYNC_CHECKSUM_TREE_H
@@ -0,0 +1,257 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SyncTreeBisector.h"
+#include "SyncChecksumTree.h"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+
+
+void CSyncTreeBisector::GetResponse(const CSyncChecksumTree& tree, const Request& request, std::vector<std::uint32_t>& data)
+{
+	data.clear();
+
+	switch (request.level) {
+		case SD_TREE_FRAMES: {
+			tree.GetFrameChecksums(data);
+		} break;
+		case SD_TREE_PHASES: {
+			tree.GetPhaseChecksums(request.frameNum, data);
+		} break;
+		case SD_TREE_LEAVES: {
+			tree.GetLeafChecksums(request.frameNum, request.phaseIdx, request.begin, request.end, CSyncChecksumTree::NUM_CHUNKS, data);
+		} break;
+		case SD_TREE_LEAF: {
+			CSyncChecksumTree::Leaf leaf;
+			std::vector<std::uint32_t> writes;
+
+			if (!tree.GetLeaf(request.frameNum, request.phaseIdx, request.begin, leaf))
+				break;
+
+			tree.GetLeafWrites(request.frameNum, request.phaseIdx, request.begin, writes);
+			writes.resize(std::min(writes.size(), size_t(MAX_LEAF_WRITES)));
+
+			data = {tree.GetFrame(request.frameNum)->phases[request.phaseIdx].phaseID, std::uint32_t(leaf.objectID), leaf.checksum, leaf.numWrites};
+			data.insert(data.end(), writes.begin(), writes.end());
+		} break;
+		default: {
+		} break;
+	}
+}
+
+
+const CSyncTreeBisector::Request& CSyncTreeBisector::Start(int errorFrameNum, const std::vector<int>& playerNums)
+{
+	responses.clear();
+	responses.reserve(playerNums.size());
+
+	for (const int playerNum: playerNums) {
+		responses.push_back({playerNum, false, {}});
+	}
+
+	result = Result();
+
+	this->errorFrameNum = errorFrameNum;
+
+	LOG_L(L_WARNING, "[SyncTreeBisector::%s] desync in frame %d, comparing the checksum trees of %u clients", __func__, errorFrameNum, unsigned(playerNums.size()));
+
+	SetRequest(SD_TREE_FRAMES, errorFrameNum, 0, 0, 0);
+	return request;
+}
+
+bool CSyncTreeBisector::AddResponse(int playerNum, unsigned int level, std::vector<std::uint32_t>&& data)
+{
+	if (!IsActive() || level != request.level)
+		return false;
+
+	const auto pred = [&](const Response& r) { return (r.playerNum == playerNum); };
+	const auto iter = std::find_if(responses.begin(), responses.end(), pred);
+
+	if (iter == responses.end() || iter->received)
+		return false;
+
+	iter->data = std::move(data);
+	iter->received = true;
+
+	if (!HaveAllResponses())
+		return false;
+
+	NextRequest();
+	return true;
+}
+
+bool CSyncTreeBisector::RemovePlayer(int playerNum)
+{
+	const auto pred = [&](const Response& r) { return (r.playerNum == playerNum); };
+	const auto iter = std::find_if(responses.begin(), responses.end(), pred);
+
+	if (iter == responses.end())
+		return false;
+
+	responses.erase(iter);
+
+	if (!IsActive() || !HaveAllResponses())
+		return false;
+
+	NextRequest();
+	return true;
+}
+
+
+bool CSyncTreeBisector::HaveAllResponses() const
+{
+	return (std::all_of(responses.begin(), responses.end(), [](const Response& r) { return r.received; }));
+}
+
+void CSyncTreeBisector::SetRequest(unsigned int level, int frameNum, unsigned int phaseIdx, unsigned int begin, unsigned int end)
+{
+	request = {level, frameNum, phaseIdx, begin, end};
+
+	for (Response& r: responses) {
+		r.received = false;
+		r.data.clear();
+	}
+}
+
+
+void CSyncTreeBisector::NextRequest()
+{
+	std::vector< const std::vector<std::uint32_t>* > data;
+
+	for (const Response& r: responses) {
+		data.push_back(&r.data);
+	}
+
+	switch (request.level) {
+		case SD_TREE_FRAMES: {
+			// [frameNum, checksum] records; clients that connected later
+			// have fewer frames, so only compare those all of them have
+			const std::vector<std::uint32_t>* first = data.empty()? nullptr: data[0];
+			const auto FindFrame = [](const std::vector<std::uint32_t>& d, std::uint32_t frameNum) {
+				for (size_t n = 0; (n + 1) < d.size(); n += 2) {
+					if (d[n] == frameNum)
+						return &d[n + 1];
+				}
+
+				return static_cast<const std::uint32_t*>(nullptr);
+			};
+
+			bool oldestCommon = true;
+
+			for (size_t n = 0; first != nullptr && (n + 1) < first->size(); n += 2) {
+				const std::uint32_t frameNum = (*first)[n];
+				const std::uint32_t checksum = (*first)[n + 1];
+
+				const auto hasFrame = [&](const std::vector<std::uint32_t>* d) { return (FindFrame(*d, frameNum) != nullptr); };
+				const auto sameFrame = [&](const std::vector<std::uint32_t>* d) { return (*FindFrame(*d, frameNum) == checksum); };
+
+				if (!std::all_of(data.begin() + 1, data.end(), hasFrame))
+					continue;
+
+				if (std::all_of(data.begin() + 1, data.end(), sameFrame)) {
+					oldestCommon = false;
+					continue;
+				}
+
+				LOG_L(L_WARNING, "[SyncTreeBisector::%s] first differing frame is %d%s", __func__, int(frameNum), oldestCommon? " (the oldest one recorded, the desync may be older)": "");
+
+				result.frameNum = frameNum;
+
+				SetRequest(SD_TREE_PHASES, frameNum, 0, 0, 0);
+				return;
+			}
+
+			LOG_L(L_WARNING, "[SyncTreeBisector::%s] all recorded frames are equal", __func__);
+		} break;
+
+		case SD_TREE_PHASES: {
+			// [phaseID, numLeaves, checksum] records
+			const int mismatch = CSyncChecksumTree::FindFirstMismatch(data, 3);
+
+			if (mismatch < 0) {
+				LOG_L(L_WARNING, "[SyncTreeBisector::%s] all phases of frame %d are equal", __func__, request.frameNum);
+				break;
+			}
+
+			std::uint32_t maxNumLeaves = 0;
+
+			for (size_t j = 0; j < data.size(); ++j) {
+				const std::vector<std::uint32_t>& r = *data[j];
+
+				if (r.size() < (mismatch + 1) * 3u) {
+					LOG_L(L_WARNING, "[SyncTreeBisector::%s] player %d: phase #%d missing", __func__, responses[j].playerNum, mismatch);
+					continue;
+				}
+
+				LOG_L(L_WARNING, "[SyncTreeBisector::%s] player %d: phase #%d (%s), %u objects, checksum 0x%08X", __func__,
+					responses[j].playerNum, mismatch, CSyncChecksumTree::GetPhaseName(r[mismatch * 3]), r[mismatch * 3 + 1], r[mismatch * 3 + 2]);
+
+				result.phaseID = r[mismatch * 3];
+				maxNumLeaves = std::max(maxNumLeaves, r[mismatch * 3 + 1]);
+			}
+
+			if (maxNumLeaves == 0)
+				break;
+
+			SetRequest(SD_TREE_LEAVES, request.frameNum, mismatch, 0, maxNumLeaves);
+			return;
+		} break;
+
+		case SD_TREE_LEAVES: {
+			// one checksum per chunk of leaves
+			const int mismatch = CSyncChecksumTree::FindFirstMismatch(data, 1);
+
+			if (mismatch < 0) {
+				LOG_L(L_ERROR, "[SyncTreeBisector::%s] objects [%u, %u) of phase #%u are equal", __func__, request.begin, request.end, request.phaseIdx);
+				break;
+			}
+
+			const unsigned int chunkSize = CSyncChecksumTree::GetChunkSize(request.begin, request.end, CSyncChecksumTree::NUM_CHUNKS);
+			const unsigned int begin = request.begin + mismatch * chunkSize;
+			const unsigned int end = std::min(request.end, begin + chunkSize);
+
+			SetRequest(((end - begin) <= 1)? SD_TREE_LEAF: SD_TREE_LEAVES, request.frameNum, request.phaseIdx, begin, end);
+			return;
+		} break;
+
+		case SD_TREE_LEAF: {
+			// [phaseID, objectID, checksum, numWrites, writes...]
+			const std::vector<std::uint32_t>* first = nullptr;
+
+			for (size_t j = 0; j < data.size(); ++j) {
+				const std::vector<std::uint32_t>& r = *data[j];
+
+				if (r.size() < 4) {
+					LOG_L(L_WARNING, "[SyncTreeBisector::%s] player %d: object #%u of phase #%u missing", __func__, responses[j].playerNum, request.begin, request.phaseIdx);
+					continue;
+				}
+
+				LOG_L(L_WARNING, "[SyncTreeBisector::%s] player %d: frame %d, phase %s, object %d: checksum 0x%08X after %u writes", __func__,
+					responses[j].playerNum, request.frameNum, CSyncChecksumTree::GetPhaseName(r[0]), int(r[1]), r[2], r[3]);
+
+				if (first == nullptr) {
+					first = &r;
+					result.objectID = int(r[1]);
+					continue;
+				}
+
+				// first write whose value (or existence) differs from the first client's
+				const size_t numWrites = std::min(r.size(), first->size()) - 4;
+				const auto iters = std::mismatch(r.begin() + 4, r.begin() + 4 + numWrites, first->begin() + 4);
+				const int writeIdx = iters.first - (r.begin() + 4);
+
+				if (size_t(writeIdx) == numWrites && r[3] == (*first)[3])
+					continue;
+
+				if (size_t(writeIdx) < numWrites) {
+					LOG_L(L_WARNING, "[SyncTreeBisector::%s] player %d: write #%d is 0x%08X instead of 0x%08X", __func__,
+						responses[j].playerNum, writeIdx, *iters.first, *iters.second);
+				}
+
+				result.writeIdx = (result.writeIdx < 0)? writeIdx: std::min(result.writeIdx, writeIdx);
+			}
+		} break;
+	}
+
+	SetRequest(SD_TREE_DONE, errorFrameNum, 0, 0, 0);
+}
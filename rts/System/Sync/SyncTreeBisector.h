@@ -0,0 +1,105 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SYNC_TREE_BISECTOR_H
+#define SYNC_TREE_BISECTOR_H
+
+#include <cinttypes>
+#include <vector>
+
+class CSyncChecksumTree;
+
+/**
+ * @brief locates a desync through the clients' CSyncChecksumTree's
+ *
+ * Server side of the NETMSG_SD_TREEREQUEST / NETMSG_SD_TREERESPONSE
+ * exchange: narrows a desync down to the first differing frame, then sim
+ * phase and then object, one request to all clients per step, and finally
+ * compares the values that object was assigned in that frame. Clients
+ * answer each request through GetResponse.
+ */
+class CSyncTreeBisector {
+public:
+	/// levels of a NETMSG_SD_TREEREQUEST
+	enum {
+		SD_TREE_FRAMES = 0, ///< checksums of all recorded frames
+		SD_TREE_PHASES = 1, ///< checksums of the phases of one frame
+		SD_TREE_LEAVES = 2, ///< checksums of ranges of objects within one phase
+		SD_TREE_LEAF   = 3, ///< a single object and the values written for it
+		SD_TREE_DONE   = 4, ///< not answered, clients resume recording
+	};
+
+	enum {
+		/// written values per SD_TREE_LEAF response, keeps it in one packet
+		MAX_LEAF_WRITES = 4096,
+	};
+
+	struct Request {
+		unsigned int level;
+		int frameNum;
+		unsigned int phaseIdx;
+		unsigned int begin;
+		unsigned int end;
+	};
+
+	/// where the desync was found; -1 for what the bisection did not get to
+	struct Result {
+		int frameNum = -1;
+		int phaseID = -1;
+		int objectID = -1;
+		int writeIdx = -1; ///< first differing write, or the smaller count if only that differs
+	};
+
+public:
+	/// client side, the answer to <request> from the local <tree>
+	static void GetResponse(const CSyncChecksumTree& tree, const Request& request, std::vector<std::uint32_t>& data);
+
+	/**
+	 * Begins a new bisection (abandoning the current one), expecting each
+	 * request to be answered by every player in <playerNums>.
+	 * @return the first request to send to all clients
+	 */
+	const Request& Start(int errorFrameNum, const std::vector<int>& playerNums);
+
+	/**
+	 * Takes the response of <playerNum> to the current request.
+	 * @return true if this completed the set, GetRequest then returns the
+	 *   next request to send to all clients (SD_TREE_DONE at the end)
+	 */
+	bool AddResponse(int playerNum, unsigned int level, std::vector<std::uint32_t>&& data);
+	/**
+	 * Stops waiting for <playerNum>, e.g. because it left.
+	 * @return like AddResponse
+	 */
+	bool RemovePlayer(int playerNum);
+
+	bool IsActive() const { return (request.level != SD_TREE_DONE); }
+
+	const Request& GetRequest() const { return request; }
+	const Result& GetResult() const { return result; }
+
+	int GetErrorFrameNum() const { return errorFrameNum; }
+
+private:
+	struct Response {
+		int playerNum;
+		bool received;
+
+		std::vector<std::uint32_t> data;
+	};
+
+	bool HaveAllResponses() const;
+	void SetRequest(unsigned int level, int frameNum, unsigned int phaseIdx, unsigned int begin, unsigned int end);
+
+	/// compares the complete set of responses and moves on to the next request
+	void NextRequest();
+
+private:
+	std::vector<Response> responses;
+
+	Request request = {SD_TREE_DONE, 0, 0, 0, 0};
+	Result result;
+
+	int errorFrameNum = 0;
+};
+
+#endif // SYNC_TREE_BISECTOR_H
@@ -11,6 +11,8 @@
 	#include "SyncDebugger.h"
 #endif
 
+#include "System/AllocCounter.h"
+
 #include <assert.h>
 
 
@@ -76,4 +78,16 @@ namespace Sync {
 #  define ASSERT_SYNCED(x)
 #endif
 
+// attribute synced writes to a frame, sim phase and object (see CSyncChecksumTree)
+// sim phases double as the buckets for ALLOC_COUNTING
+#ifdef SYNCCHECK
+#  define SYNC_DEBUG_NEW_FRAME(frameNum) CSyncChecker::GetChecksumTree().NewFrame(frameNum)
+#  define SYNC_DEBUG_PHASE(phaseID) CSyncChecker::ScopedPhase syncDebugPhase(phaseID); ALLOC_COUNTER_PHASE(phaseID)
+#  define SYNC_DEBUG_OBJECT(objectID) CSyncChecker::ScopedObject syncDebugObject(objectID)
+#else
+#  define SYNC_DEBUG_NEW_FRAME(frameNum)
+#  define SYNC_DEBUG_PHASE(phaseID) ALLOC_COUNTER_PHASE(phaseID)
+#  define SYNC_DEBUG_OBJECT(objectID)
+#endif
+
 #endif
@@ -0,0 +1,129 @@
+function gadget:GetInfo()
+return {
+	name    = "Sim-Benchmark",
+	desc    = "Spawns two mirrored armies and keeps them fighting, for spring-headless --simbench",
+	author  = "",
+	date    = "",
+	license = "GNU GPL, v2 or later",
+	layer   = 0,
+	enabled = true,
+}
+end
+
+if (not gadgetHandler:IsSyncedCode()) then
+	return false
+end
+
+local modOptions = Spring.GetModOptions() or {}
+
+local unitsPerTeam = tonumber(modOptions.simbench_units) or 100 -- size of each wave
+local waveInterval = 30 * 10 -- check for (and send) reinforcements every 10 seconds
+local orderInterval = 30 * 30 -- re-issue fight orders to stragglers every 30 seconds
+local spacing = 48
+
+local armyDefIDs = {}
+local benchTeams = {}
+
+-- all mobile armed ground units that are not builders; sorted by
+-- name so every run on every machine spawns the exact same mix
+local function GetArmyDefIDs()
+	local names = {}
+
+	for unitDefID, unitDef in pairs(UnitDefs) do
+		if (unitDef.canMove and unitDef.speed > 0 and not unitDef.canFly and not unitDef.isBuilder and #unitDef.weapons > 0) then
+			names[#names + 1] = unitDef.name
+		end
+	end
+
+	table.sort(names)
+
+	local defIDs = {}
+	for i = 1, #names do
+		defIDs[i] = UnitDefNames[names[i]].id
+	end
+	return defIDs
+end
+
+-- the first two non-gaia teams fight each other on opposite halves of the map
+local function GetBenchTeams()
+	local teams = {}
+	local gaiaTeamID = Spring.GetGaiaTeamID()
+
+	for _, teamID in ipairs(Spring.GetTeamList()) do
+		if (teamID ~= gaiaTeamID and #teams < 2) then
+			teams[#teams + 1] = {
+				teamID = teamID,
+				x = Game.mapSizeX * ((#teams == 0) and 0.3 or 0.7),
+				z = Game.mapSizeZ * 0.5,
+			}
+		end
+	end
+
+	if (#teams == 2) then
+		teams[1].enemy = teams[2]
+		teams[2].enemy = teams[1]
+	end
+
+	return teams
+end
+
+local function GiveFightOrders(team, unitIDs)
+	local x = team.enemy.x
+	local z = team.enemy.z
+
+	Spring.GiveOrderToUnitArray(unitIDs, CMD.FIGHT, {x, Spring.GetGroundHeight(x, z), z}, {})
+end
+
+local function SpawnWave(team, numUnits)
+	local cols = math.ceil(math.sqrt(numUnits))
+	local unitIDs = {}
+
+	for i = 0, numUnits - 1 do
+		local unitDefID = armyDefIDs[(i % #armyDefIDs) + 1]
+		local x = team.x + ((i % cols) - cols * 0.5) * spacing
+		local z = team.z + (math.floor(i / cols) - cols * 0.5) * spacing
+
+		x = math.max(spacing, math.min(Game.mapSizeX - spacing, x))
+		z = math.max(spacing, math.min(Game.mapSizeZ - spacing, z))
+
+		local unitID = Spring.CreateUnit(unitDefID, x, Spring.GetGroundHeight(x, z), z, 0, team.teamID)
+
+		if (unitID ~= nil) then
+			unitIDs[#unitIDs + 1] = unitID
+		end
+	end
+
+	GiveFightOrders(team, unitIDs)
+end
+
+function gadget:Initialize()
+	armyDefIDs = GetArmyDefIDs()
+	benchTeams = GetBenchTeams()
+
+	if (#armyDefIDs == 0 or #benchTeams < 2) then
+		Spring.Log(gadget:GetInfo().name, LOG.ERROR, "need two teams and at least one armed mobile unit type, disabling")
+		gadgetHandler:RemoveGadget(self)
+		return
+	end
+
+	Spring.Log(gadget:GetInfo().name, LOG.INFO, string.format("%i unit types, %i units per wave", #armyDefIDs, unitsPerTeam))
+end
+
+function gadget:GameFrame(n)
+	if ((n % waveInterval) == 1) then
+		for _, team in ipairs(benchTeams) do
+			local numUnits = Spring.GetTeamUnitCount(team.teamID)
+
+			-- top up armies that have lost most of their units
+			if (numUnits < unitsPerTeam / 4) then
+				SpawnWave(team, unitsPerTeam)
+			end
+		end
+	end
+
+	if ((n % orderInterval) == 0) then
+		for _, team in ipairs(benchTeams) do
+			GiveFightOrders(team, Spring.GetTeamUnits(team.teamID))
+		end
+	end
+end
@@ -0,0 +1,95 @@
+#!/bin/sh
+
+# replays each demo with serially and with parallel ticked COB threads and
+# fails if the two runs' per-tick COB checksums or sync checksums differ
+
+set -e # abort on error
+
+if [ $# -lt 3 ]; then
+	echo "Usage: $0 /path/to/spring-headless /path/to/demotool DemoDir"
+	echo "Env: [WRITEDIR]"
+	exit 1
+fi
+
+SPRING="$1"
+DEMOTOOL="$2"
+DEMODIR="$3"
+
+for EXE in "$SPRING" "$DEMOTOOL"; do
+	if [ ! -x "$EXE" ]; then
+		echo "$EXE isn't executable!"
+		exit 1
+	fi
+done
+
+WRITEDIR=${WRITEDIR:-$(pwd)/cobsync-replays}
+
+echo "Env: DEMODIR=$DEMODIR WRITEDIR=$WRITEDIR"
+
+value() {
+	sed -n "s/^$1: //p" "$2"
+}
+
+mkdir -p "$WRITEDIR"
+
+# the exclusive config of each mode, see CobEngine.cpp
+for MODE in 0 1; do
+	printf "ParallelCobThreads = %s\nCobSyncTrace = 1\n" "$MODE" > "$WRITEDIR/cob$MODE.cfg"
+done
+
+# max 30 min cpu time per replay
+ulimit -t 1800
+
+FAILED=0
+
+for DEMO in "$DEMODIR"/*.sdfz; do
+	NAME=$(basename "$DEMO" .sdfz)
+	FRAMES=$("$DEMOTOOL" --frames "$DEMO")
+
+	for MODE in 0 1; do
+		echo "$NAME: replaying $FRAMES frames with ParallelCobThreads=$MODE"
+
+		LOG="$WRITEDIR/$NAME.cob$MODE.log"
+		rm -f "$WRITEDIR/simbench.txt"
+
+		set +e #temp disable abort on error
+		"$SPRING" --nocolor --config "$WRITEDIR/cob$MODE.cfg" --write-dir "$WRITEDIR" --simbench "$FRAMES" "$DEMO" > "$LOG" 2>&1
+		EXIT=$?
+		set -e
+
+		if [ $EXIT -ne 0 ] || [ ! -f "$WRITEDIR/simbench.txt" ]; then
+			echo "$NAME: spring-headless exited with $EXIT, see $LOG"
+			FAILED=1
+			continue 2
+		fi
+
+		mv "$WRITEDIR/simbench.txt" "$WRITEDIR/$NAME.cob$MODE.txt"
+		# strip the timestamps, keep the checksums in tick order
+		sed -n 's/^.*\[COBEngine::Tick\] //p' "$LOG" > "$WRITEDIR/$NAME.cob$MODE.trace"
+	done
+
+	SERIAL="$WRITEDIR/$NAME.cob0"
+	PARALLEL="$WRITEDIR/$NAME.cob1"
+
+	if [ ! -s "$SERIAL.trace" ]; then
+		echo "$NAME: no COB checksums were logged, see $SERIAL.log"
+		FAILED=1
+		continue
+	fi
+
+	if ! cmp -s "$SERIAL.trace" "$PARALLEL.trace"; then
+		echo "$NAME: COB state diverged, first difference (serial <, parallel >):"
+		diff "$SERIAL.trace" "$PARALLEL.trace" | head -n 4
+		FAILED=1
+	fi
+
+	# only written by builds with SYNCCHECK
+	if [ "$(value syncChecksum "$SERIAL.txt")" != "$(value syncChecksum "$PARALLEL.txt")" ]; then
+		echo "$NAME: syncChecksum $(value syncChecksum "$SERIAL.txt") (serial) differs from $(value syncChecksum "$PARALLEL.txt") (parallel)"
+		FAILED=1
+	fi
+
+	echo "$NAME: timer[Sim::Script] serial $(value "timer\[Sim::Script\]" "$SERIAL.txt"), parallel $(value "timer\[Sim::Script\]" "$PARALLEL.txt")"
+done
+
+exit $FAILED
@@ -0,0 +1,93 @@
+#!/bin/sh
+
+set -e #abort on error
+
+if [ $# -lt 3 ]; then
+	echo "Usage: $0 WriteDir Game Map [UnitsPerTeam]"
+	exit 1
+fi
+WRITEDIR="$1"
+GAME="$2"
+MAP="$3"
+UNITS="${4:-100}"
+
+SRCDIR=$(dirname "$0")
+MUTATOR="$WRITEDIR/games/simbench.sdd"
+
+# mutator archive: everything from $GAME plus the benchmark gadget
+rm -rf "$MUTATOR"
+mkdir -p "$MUTATOR"
+cp -r "$SRCDIR/LuaRules" "$MUTATOR/"
+
+cat > "$MUTATOR/modinfo.lua" <<EOD
+return {
+	name = "SimBench",
+	shortname = "SB",
+	version = "$GAME",
+	description = "$GAME with the spring-headless --simbench armies",
+	modtype = 1,
+	depend = {
+		"$GAME",
+	},
+}
+EOD
+
+# a fixed GameID seeds the synced RNG, so every run simulates the same game
+cat <<EOD
+// a sim benchmark script
+// runs $UNITS vs $UNITS units of $GAME on $MAP
+[GAME]
+{
+	IsHost=1;
+	MyPlayerName=SimBench;
+	GameID=53696d42656e63680000000000000000;
+
+	Mapname=$MAP;
+	GameType=SimBench $GAME;
+
+	StartPosType=0;
+	[mapoptions]
+	{
+	}
+	[modoptions]
+	{
+		deathmode=neverend;
+		maxunits=10000;
+		simbench_units=$UNITS;
+	}
+	NumRestrictions=0;
+	[RESTRICT]
+	{
+	}
+	[PLAYER0]
+	{
+		Name=SimBench;
+		Spectator=1;
+		Team=0;
+	}
+
+	[TEAM0]
+	{
+		TeamLeader=0;
+		AllyTeam=0;
+		RGBColor=0.976471 1 0;
+		Handicap=0;
+	}
+	[TEAM1]
+	{
+		TeamLeader=0;
+		AllyTeam=1;
+		RGBColor=0.509804 0.498039 1;
+		Handicap=0;
+	}
+
+	[ALLYTEAM0]
+	{
+		NumAllies=0;
+	}
+	[ALLYTEAM1]
+	{
+		NumAllies=0;
+	}
+}
+EOD
@@ -0,0 +1,110 @@
+#!/bin/sh
+
+set -e # abort on error
+
+if [ $# -lt 3 ]; then
+	echo "Usage: $0 /path/to/spring-headless /path/to/demotool DemoDir [BaselineDir]"
+	echo "Env: [WRITEDIR MAXSLOWDOWN TIMERS RECORD]"
+	exit 1
+fi
+
+SPRING="$1"
+DEMOTOOL="$2"
+DEMODIR="$3"
+BASELINEDIR="$4"
+
+for EXE in "$SPRING" "$DEMOTOOL"; do
+	if [ ! -x "$EXE" ]; then
+		echo "$EXE isn't executable!"
+		exit 1
+	fi
+done
+
+WRITEDIR=${WRITEDIR:-$(pwd)/simbench-replays}
+# percentage each compared value may grow over the baseline before failing
+MAXSLOWDOWN=${MAXSLOWDOWN:-10}
+# per-phase SCOPED_TIMER totals compared besides the mean frame time
+TIMERS=${TIMERS:-"Sim::Unit::MoveType Sim::Projectiles::Collisions Sim::Path"}
+# RECORD=1 (re)writes the baselines instead of comparing against them
+RECORD=${RECORD:-0}
+
+echo "Env: DEMODIR=$DEMODIR BASELINEDIR=$BASELINEDIR WRITEDIR=$WRITEDIR MAXSLOWDOWN=$MAXSLOWDOWN RECORD=$RECORD"
+
+if [ "$RECORD" = "1" ] && [ -z "$BASELINEDIR" ]; then
+	echo "RECORD=1 needs a BaselineDir"
+	exit 1
+fi
+
+value() {
+	awk -F': ' -v key="$1" '$1 == key { print $2 }' "$2"
+}
+
+# compare KEY REPORT BASELINE, returns non-zero on a regression
+compare() {
+	OLD=$(value "$1" "$3")
+	NEW=$(value "$1" "$2")
+
+	if [ -z "$OLD" ] || [ -z "$NEW" ]; then
+		return 0
+	fi
+
+	echo "  $1: ${OLD} -> ${NEW}"
+	awk -v old="$OLD" -v new="$NEW" -v max="$MAXSLOWDOWN" 'BEGIN { exit !(new <= old * (1 + max / 100)) }'
+}
+
+mkdir -p "$WRITEDIR"
+
+# max 30 min cpu time per replay
+ulimit -t 1800
+
+FAILED=0
+
+for DEMO in "$DEMODIR"/*.sdfz; do
+	NAME=$(basename "$DEMO" .sdfz)
+	FRAMES=$("$DEMOTOOL" --frames "$DEMO")
+	REPORT="$WRITEDIR/$NAME.txt"
+
+	echo "$NAME: replaying $FRAMES frames"
+
+	rm -f "$WRITEDIR/simbench.txt"
+
+	set +e #temp disable abort on error
+	"$SPRING" --nocolor --write-dir "$WRITEDIR" --simbench "$FRAMES" "$DEMO" > "$WRITEDIR/$NAME.log" 2>&1
+	EXIT=$?
+	set -e
+
+	if [ $EXIT -ne 0 ] || [ ! -f "$WRITEDIR/simbench.txt" ]; then
+		echo "$NAME: spring-headless exited with $EXIT, see $WRITEDIR/$NAME.log"
+		FAILED=1
+		continue
+	fi
+
+	mv "$WRITEDIR/simbench.txt" "$REPORT"
+
+	if [ -z "$BASELINEDIR" ]; then
+		cat "$REPORT"
+		continue
+	fi
+
+	if [ "$RECORD" = "1" ]; then
+		echo "$NAME: recording $BASELINEDIR/$NAME.txt"
+		mkdir -p "$BASELINEDIR"
+		cp "$REPORT" "$BASELINEDIR/$NAME.txt"
+		continue
+	fi
+
+	if [ ! -f "$BASELINEDIR/$NAME.txt" ]; then
+		echo "$NAME: $BASELINEDIR/$NAME.txt doesn't exist, record it with RECORD=1"
+		FAILED=1
+		continue
+	fi
+
+	for KEY in frameTimeMean $(for TIMER in $TIMERS; do echo "timer[$TIMER]"; done); do
+		if ! compare "$KEY" "$REPORT" "$BASELINEDIR/$NAME.txt"; then
+			echo "$NAME: $KEY is more than $MAXSLOWDOWN% slower than the baseline"
+			FAILED=1
+		fi
+	done
+done
+
+exit $FAILED
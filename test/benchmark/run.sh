@@ -0,0 +1,103 @@
+#!/bin/sh
+
+set -e # abort on error
+
+if [ $# -le 0 ]; then
+	echo "Usage: $0 /path/to/spring-headless"
+	echo "Env: GAME MAP [FRAMES UNITS WRITEDIR GOLDEN RECORD BASELINE MAXSLOWDOWN]"
+	exit 1
+fi
+
+if [ ! -x "$1" ]; then
+	echo "Parameter 1 $1 isn't executable!"
+	exit 1
+fi
+
+if [ -z "$GAME" ] || [ -z "$MAP" ]; then
+	echo "GAME and MAP have to be set"
+	exit 1
+fi
+
+FRAMES=${FRAMES:-3000}
+UNITS=${UNITS:-100}
+WRITEDIR=${WRITEDIR:-$(pwd)/simbench}
+# expected syncChecksum, one committed file per GAME MAP FRAMES UNITS
+GOLDEN=${GOLDEN:-$(dirname "$0")/golden/$(echo "$GAME-$MAP-$FRAMES-$UNITS" | tr -c 'A-Za-z0-9._\n-' '_').txt}
+# RECORD=1 (re)writes $GOLDEN instead of checking against it
+RECORD=${RECORD:-0}
+# percentage the mean frame time may grow over $BASELINE before failing
+MAXSLOWDOWN=${MAXSLOWDOWN:-10}
+
+echo "Env: GAME=$GAME MAP=$MAP FRAMES=$FRAMES UNITS=$UNITS WRITEDIR=$WRITEDIR GOLDEN=$GOLDEN RECORD=$RECORD"
+
+if [ "$RECORD" != "1" ] && [ ! -f "$GOLDEN" ]; then
+	echo "$GOLDEN doesn't exist, record it with RECORD=1"
+	exit 1
+fi
+
+mkdir -p "$WRITEDIR"
+$(dirname "$0")/prepare.sh "$WRITEDIR" "$GAME" "$MAP" "$UNITS" > "$WRITEDIR/script.txt"
+rm -f "$WRITEDIR/simbench.txt"
+
+# max 30 min cpu time
+ulimit -t 1800
+
+set +e #temp disable abort on error
+"$1" --nocolor --write-dir "$WRITEDIR" --simbench "$FRAMES" "$WRITEDIR/script.txt"
+EXIT=$?
+set -e
+
+if [ $EXIT -ne 0 ]; then
+	echo "spring-headless exited with $EXIT"
+	exit $EXIT
+fi
+
+REPORT="$WRITEDIR/simbench.txt"
+
+if [ ! -f "$REPORT" ]; then
+	echo "$REPORT wasn't written"
+	exit 1
+fi
+
+cat "$REPORT"
+
+value() {
+	sed -n "s/^$1: //p" "$2"
+}
+
+if [ "$(value frames "$REPORT")" != "$FRAMES" ]; then
+	echo "only $(value frames "$REPORT") of $FRAMES frames were simulated"
+	exit 1
+fi
+
+# desyncs: the checksum over all frames has to match the recorded one
+CHECKSUM=$(value syncChecksum "$REPORT")
+
+if [ -z "$CHECKSUM" ] || [ "$CHECKSUM" = "none" ]; then
+	echo "$REPORT has no syncChecksum, spring-headless has to be built with SYNCCHECK"
+	exit 1
+fi
+
+if [ "$RECORD" = "1" ]; then
+	mkdir -p "$(dirname "$GOLDEN")"
+	echo "$CHECKSUM" > "$GOLDEN"
+	echo "recorded syncChecksum $CHECKSUM in $GOLDEN"
+elif [ "$(cat "$GOLDEN")" != "$CHECKSUM" ]; then
+	echo "syncChecksum $CHECKSUM differs from $(cat "$GOLDEN") in $GOLDEN"
+	exit 1
+fi
+
+# perf regressions: compare against the report of a previous run
+if [ -n "$BASELINE" ] && [ -f "$BASELINE" ]; then
+	OLD=$(value frameTimeMean "$BASELINE")
+	NEW=$(value frameTimeMean "$REPORT")
+
+	if ! awk -v old="$OLD" -v new="$NEW" -v max="$MAXSLOWDOWN" 'BEGIN { exit !(new <= old * (1 + max / 100)) }'; then
+		echo "frameTimeMean went from ${OLD}ms to ${NEW}ms (more than $MAXSLOWDOWN% slower)"
+		exit 1
+	fi
+
+	echo "frameTimeMean went from ${OLD}ms to ${NEW}ms"
+fi
+
+exit 0
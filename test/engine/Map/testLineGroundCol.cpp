@@ -0,0 +1,444 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Map/Ground.h"
+#include "Map/HeightBoundsPyramid.h"
+#include "Map/MapDimensions.h"
+#include "Map/ReadMap.h"
+#include "Map/SMF/SMFFormat.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "System/SpringMath.h"
+#include "System/float3.h"
+#include "System/Log/ILog.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+// Ground.cpp references these, but none are reached via LineGroundColRaw
+CReadMap* readMap = nullptr;
+MapDimensions mapDims;
+
+std::vector<float> CReadMap::originalHeightMap;
+
+bool ClampLineInMap(float3& start, float3& end) { return false; }
+float2 GetMapBoundaryIntersectionPoints(const float3 start, const float3 dir) { return {-1.0f, -1.0f}; }
+
+
+struct TestMap {
+	std::vector<float> cornerHeights;
+	std::vector<float> centerHeights;
+	std::vector<float3> faceNormals;
+};
+
+static void SetMapDims(int mapx, int mapy)
+{
+	mapDims.mapx = mapx;
+	mapDims.mapy = mapy;
+	mapDims.mapxm1 = mapx - 1;
+	mapDims.mapym1 = mapy - 1;
+	mapDims.mapxp1 = mapx + 1;
+	mapDims.mapyp1 = mapy + 1;
+
+	float3::maxxpos = mapx * SQUARE_SIZE - 1;
+	float3::maxzpos = mapy * SQUARE_SIZE - 1;
+}
+
+// same as CReadMap::UpdateCenterHeightmap and UpdateFaceNormals
+static void CalcDerivedMaps(TestMap& map)
+{
+	map.centerHeights.resize(mapDims.mapx * mapDims.mapy);
+	map.faceNormals.resize(mapDims.mapx * mapDims.mapy * 2);
+
+	for (int y = 0; y < mapDims.mapy; y++) {
+		for (int x = 0; x < mapDims.mapx; x++) {
+			const float hTL = map.cornerHeights[(y    ) * mapDims.mapxp1 + x    ];
+			const float hTR = map.cornerHeights[(y    ) * mapDims.mapxp1 + x + 1];
+			const float hBL = map.cornerHeights[(y + 1) * mapDims.mapxp1 + x    ];
+			const float hBR = map.cornerHeights[(y + 1) * mapDims.mapxp1 + x + 1];
+
+			map.centerHeights[y * mapDims.mapx + x] = (hTL + hTR + hBL + hBR) * 0.25f;
+
+			float3 fnTL = {-(hTR - hTL), SQUARE_SIZE * 1.0f, -(hBL - hTL)};
+			float3 fnBR = { (hBL - hBR), SQUARE_SIZE * 1.0f,  (hTR - hBR)};
+
+			map.faceNormals[(y * mapDims.mapx + x) * 2    ] = fnTL.Normalize();
+			map.faceNormals[(y * mapDims.mapx + x) * 2 + 1] = fnBR.Normalize();
+		}
+	}
+}
+
+// set SPRING_TEST_SMF to an extracted .smf to test (or with bench_LineGroundCol
+// benchmark) against a real map instead of the synthetic one
+static bool LoadSMFMap(TestMap& map)
+{
+	const char* smfPath = std::getenv("SPRING_TEST_SMF");
+
+	if (smfPath == nullptr)
+		return false;
+
+	std::ifstream ifs(smfPath, std::ios::binary);
+	SMFHeader header;
+
+	if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) || strcmp(header.magic, "spring map file") != 0) {
+		LOG_L(L_WARNING, "[%s] could not read SMF header from \"%s\"", __func__, smfPath);
+		return false;
+	}
+
+	std::vector<unsigned short> rawHeights((header.mapx + 1) * (header.mapy + 1));
+
+	ifs.seekg(header.heightmapPtr);
+
+	if (!ifs.read(reinterpret_cast<char*>(rawHeights.data()), rawHeights.size() * sizeof(unsigned short))) {
+		LOG_L(L_WARNING, "[%s] could not read heightmap from \"%s\"", __func__, smfPath);
+		return false;
+	}
+
+	SetMapDims(header.mapx, header.mapy);
+
+	const float scale = (header.maxHeight - header.minHeight) / 65536.0f;
+
+	map.cornerHeights.resize(rawHeights.size());
+
+	for (size_t i = 0; i < rawHeights.size(); i++) {
+		map.cornerHeights[i] = header.minHeight + rawHeights[i] * scale;
+	}
+
+	LOG("[%s] loaded \"%s\" (%dx%d squares)", __func__, smfPath, header.mapx, header.mapy);
+	return true;
+}
+
+// hills, a diagonal ridge and some high-frequency noise on a 16x16 (1024^2 squares) map
+static void GenSyntheticMap(TestMap& map)
+{
+	SetMapDims(1024, 1024);
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> noise(-2.0f, 2.0f);
+
+	map.cornerHeights.resize(mapDims.mapxp1 * mapDims.mapyp1);
+
+	for (int z = 0; z <= mapDims.mapy; z++) {
+		for (int x = 0; x <= mapDims.mapx; x++) {
+			const float fx = x / float(mapDims.mapx);
+			const float fz = z / float(mapDims.mapy);
+
+			float h = 0.0f;
+			h += 180.0f * std::sin(fx * 6.0f) * std::cos(fz * 5.0f);
+			h +=  60.0f * std::sin(fx * 31.0f + fz * 17.0f);
+			h += 250.0f * std::max(0.0f, 1.0f - std::fabs(fx - fz) * 12.0f);
+			h += noise(rng);
+
+			map.cornerHeights[z * mapDims.mapxp1 + x] = h;
+		}
+	}
+}
+
+static void InitTestMap(TestMap& map)
+{
+	if (!LoadSMFMap(map))
+		GenSyntheticMap(map);
+
+	CalcDerivedMaps(map);
+}
+
+
+struct TestRay {
+	float3 from;
+	float3 to;
+};
+
+// mix of weapon-style line-of-fire checks (short-to-long, mostly level)
+// and camera-style traces (high above the map, pointing down)
+static std::vector<TestRay> GenRays(const TestMap& map, size_t numRays, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> posx(0.0f, float3::maxxpos);
+	std::uniform_real_distribution<float> posz(0.0f, float3::maxzpos);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<TestRay> rays;
+	rays.reserve(numRays);
+
+	const auto GroundHeight = [&](float x, float z) {
+		const int sx = std::min(int(x / SQUARE_SIZE), mapDims.mapx);
+		const int sz = std::min(int(z / SQUARE_SIZE), mapDims.mapy);
+		return map.cornerHeights[sz * mapDims.mapxp1 + sx];
+	};
+
+	for (size_t i = 0; i < numRays; i++) {
+		TestRay ray;
+
+		ray.from.x = posx(rng);
+		ray.from.z = posz(rng);
+
+		if ((i % 4) != 3) {
+			const float range = 200.0f + unit(rng) * 2800.0f;
+			const float angle = unit(rng) * math::TWOPI;
+
+			ray.to.x = Clamp(ray.from.x + std::cos(angle) * range, 0.0f, float3::maxxpos);
+			ray.to.z = Clamp(ray.from.z + std::sin(angle) * range, 0.0f, float3::maxzpos);
+
+			ray.from.y = GroundHeight(ray.from.x, ray.from.z) + 10.0f + unit(rng) * 40.0f;
+			ray.to.y = GroundHeight(ray.to.x, ray.to.z) + 10.0f + unit(rng) * 40.0f;
+		} else {
+			ray.from.y = 1500.0f + unit(rng) * 2000.0f;
+
+			ray.to.x = posx(rng);
+			ray.to.z = posz(rng);
+			ray.to.y = -500.0f;
+		}
+
+		// some axis-parallel ones, these take separate paths through the DDA
+		switch (i % 16) {
+			case 1: { ray.to.x = ray.from.x; } break;
+			case 2: { ray.to.z = ray.from.z; } break;
+			case 7: { ray.to.x = ray.from.x; } break;
+			default: {} break;
+		}
+
+		rays.push_back(ray);
+	}
+
+	return rays;
+}
+
+struct TestShot {
+	float3 pos;
+	float3 dir;
+
+	float linCoeff;
+	float qdrCoeff;
+	float length;
+};
+
+// artillery-style target tests, lofted and direct arcs that (absent any
+// terrain in between) reach ground-level targets at up to 3000 elmos
+static std::vector<TestShot> GenShots(const TestMap& map, size_t numShots, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> posx(0.0f, float3::maxxpos);
+	std::uniform_real_distribution<float> posz(0.0f, float3::maxzpos);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<TestShot> shots;
+	shots.reserve(numShots);
+
+	const auto GroundHeight = [&](float x, float z) {
+		const int sx = std::min(int(x / SQUARE_SIZE), mapDims.mapxm1);
+		const int sz = std::min(int(z / SQUARE_SIZE), mapDims.mapym1);
+		return map.centerHeights[sz * mapDims.mapx + sx];
+	};
+
+	while (shots.size() < numShots) {
+		TestShot shot;
+
+		const float3 src = {posx(rng), 0.0f, posz(rng)};
+		const float range = 300.0f + unit(rng) * 2700.0f;
+		const float angle = unit(rng) * math::TWOPI;
+		const float3 tgt = {src.x + std::cos(angle) * range, 0.0f, src.z + std::sin(angle) * range};
+
+		if (tgt.x < 0.0f || tgt.z < 0.0f || tgt.x > float3::maxxpos || tgt.z > float3::maxzpos)
+			continue;
+
+		// gravity and speed as used by CCannon::HaveFreeLineOfFire
+		const float gravity = -0.1f - unit(rng) * 0.1f;
+		const float speed = 5.0f + unit(rng) * 10.0f;
+
+		shot.pos = {src.x, GroundHeight(src.x, src.z) + 20.0f, src.z};
+		shot.dir = (tgt - src).Normalize2D();
+		shot.length = range - 10.0f;
+		shot.qdrCoeff = (gravity * 0.5f) / (speed * speed);
+		shot.linCoeff = (GroundHeight(tgt.x, tgt.z) - shot.pos.y - shot.qdrCoeff * range * range) / range;
+
+		shots.push_back(shot);
+	}
+
+	return shots;
+}
+
+static void TraceShots(const TestMap& map, const CHeightBoundsPyramid* hbp, const std::vector<TestShot>& shots, std::vector<float>& dists)
+{
+	for (size_t i = 0; i < shots.size(); i++) {
+		const TestShot& s = shots[i];
+		dists[i] = CGround::TrajectoryGroundColRaw(map.centerHeights.data(), hbp, s.pos, s.dir, s.linCoeff, s.qdrCoeff, 0.0f, s.length);
+	}
+}
+
+static void TraceRays(const TestMap& map, const CHeightBoundsPyramid* hbp, const std::vector<TestRay>& rays, std::vector<float>& dists)
+{
+	for (size_t i = 0; i < rays.size(); i++) {
+		dists[i] = CGround::LineGroundColRaw(map.cornerHeights.data(), map.faceNormals.data(), hbp, rays[i].from, rays[i].to);
+	}
+}
+
+
+
+TEST_CASE("HeightBoundsPyramid")
+{
+	TestMap map;
+	InitTestMap(map);
+
+	CHeightBoundsPyramid pyramid;
+	pyramid.Init(map.cornerHeights.data(), mapDims.mapx, mapDims.mapy);
+
+	CHECK(pyramid.GetLevelSize(0) == int2(mapDims.mapx, mapDims.mapy));
+	CHECK(pyramid.GetLevelSize(pyramid.GetNumLevels() - 1) == int2(1, 1));
+
+	// deform a crater and compare the incremental update with a rebuild
+	const int cx = mapDims.mapx / 3;
+	const int cz = mapDims.mapy / 2;
+
+	for (int z = cz - 20; z <= cz + 20; z++) {
+		for (int x = cx - 20; x <= cx + 20; x++) {
+			map.cornerHeights[z * mapDims.mapxp1 + x] -= 300.0f - (Square(x - cx) + Square(z - cz)) * 0.25f;
+		}
+	}
+
+	pyramid.Update(map.cornerHeights.data(), cx - 20, cz - 20, cx + 20, cz + 20);
+
+	CHeightBoundsPyramid rebuilt;
+	rebuilt.Init(map.cornerHeights.data(), mapDims.mapx, mapDims.mapy);
+
+	bool equal = true;
+
+	for (int level = 0; level < pyramid.GetNumLevels(); level++) {
+		const int2 size = pyramid.GetLevelSize(level);
+
+		for (int bz = 0; bz < size.y; bz++) {
+			for (int bx = 0; bx < size.x; bx++) {
+				equal &= (pyramid.GetBounds(level, bx, bz) == rebuilt.GetBounds(level, bx, bz));
+			}
+		}
+	}
+
+	CHECK(equal);
+}
+
+
+TEST_CASE("LineGroundCol")
+{
+	TestMap map;
+	InitTestMap(map);
+
+	CHeightBoundsPyramid pyramid;
+	pyramid.Init(map.cornerHeights.data(), mapDims.mapx, mapDims.mapy);
+
+	const std::vector<TestRay> rays = GenRays(map, 50000, 5678);
+
+	std::vector<float> refDists(rays.size());
+	std::vector<float> hbpDists(rays.size());
+
+	TraceRays(map, nullptr, rays, refDists);
+	TraceRays(map, &pyramid, rays, hbpDists);
+
+	size_t numHits = 0;
+	size_t numDiffs = 0;
+
+	for (size_t i = 0; i < rays.size(); i++) {
+		numHits += (refDists[i] >= 0.0f);
+		numDiffs += (std::memcmp(&refDists[i], &hbpDists[i], sizeof(float)) != 0);
+	}
+
+	// some rays have to actually hit the ground for this to mean anything
+	CHECK(numHits > 0);
+	// results must be bit-identical
+	CHECK(numDiffs == 0);
+}
+
+
+TEST_CASE("TrajectoryGroundCol")
+{
+	TestMap map;
+	InitTestMap(map);
+
+	CHeightBoundsPyramid pyramid;
+	pyramid.Init(map.cornerHeights.data(), mapDims.mapx, mapDims.mapy);
+
+	const std::vector<TestShot> shots = GenShots(map, 50000, 9012);
+
+	std::vector<float> refDists(shots.size());
+	std::vector<float> hbpDists(shots.size());
+
+	TraceShots(map, nullptr, shots, refDists);
+	TraceShots(map, &pyramid, shots, hbpDists);
+
+	size_t numHits = 0;
+	size_t numDiffs = 0;
+
+	for (size_t i = 0; i < shots.size(); i++) {
+		numHits += (refDists[i] >= 0.0f);
+		numDiffs += (std::memcmp(&refDists[i], &hbpDists[i], sizeof(float)) != 0);
+	}
+
+	CHECK(numHits > 0);
+	// skipped samples are never the first underground one
+	CHECK(numDiffs == 0);
+}
+
+
+#ifdef UNIT_BENCHMARK
+template<typename TraceFunc>
+static float TimeTrace(const TraceFunc& traceFunc)
+{
+	// first pass only warms the caches
+	traceFunc();
+
+	const auto t0 = std::chrono::high_resolution_clock::now();
+	traceFunc();
+	const auto t1 = std::chrono::high_resolution_clock::now();
+
+	return (std::chrono::duration<float, std::milli>(t1 - t0).count());
+}
+
+TEST_CASE("LineGroundColThroughput")
+{
+	TestMap map;
+	InitTestMap(map);
+
+	CHeightBoundsPyramid pyramid;
+	pyramid.Init(map.cornerHeights.data(), mapDims.mapx, mapDims.mapy);
+
+	const std::vector<TestRay> rays = GenRays(map, 200000, 3456);
+
+	std::vector<float> refDists(rays.size());
+	std::vector<float> hbpDists(rays.size());
+
+	const float refTime = TimeTrace([&]() { TraceRays(map, nullptr, rays, refDists); });
+	const float hbpTime = TimeTrace([&]() { TraceRays(map, &pyramid, rays, hbpDists); });
+
+	CHECK(std::memcmp(refDists.data(), hbpDists.data(), refDists.size() * sizeof(float)) == 0);
+
+	LOG("[LineGroundColThroughput] %u rays: full trace %.2fms, pyramid %.2fms (%.2fx)",
+		unsigned(rays.size()), refTime, hbpTime, refTime / std::max(hbpTime, 0.001f));
+}
+
+TEST_CASE("TrajectoryGroundColThroughput")
+{
+	TestMap map;
+	InitTestMap(map);
+
+	CHeightBoundsPyramid pyramid;
+	pyramid.Init(map.cornerHeights.data(), mapDims.mapx, mapDims.mapy);
+
+	// ~a few thousand artillery units re-evaluating targets for 15 frames
+	const std::vector<TestShot> shots = GenShots(map, 50000, 9012);
+
+	std::vector<float> refDists(shots.size());
+	std::vector<float> hbpDists(shots.size());
+
+	const float refTime = TimeTrace([&]() { TraceShots(map, nullptr, shots, refDists); });
+	const float hbpTime = TimeTrace([&]() { TraceShots(map, &pyramid, shots, hbpDists); });
+
+	CHECK(std::memcmp(refDists.data(), hbpDists.data(), refDists.size() * sizeof(float)) == 0);
+
+	LOG("[TrajectoryGroundColThroughput] %u trajectories: full sampling %.2fms, pyramid %.2fms (%.2fx)",
+		unsigned(shots.size()), refTime, hbpTime, refTime / std::max(hbpTime, 0.001f));
+}
+#endif
@@ -0,0 +1,127 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Rendering/Models/ModelDrawList.h"
+
+#include <algorithm>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+struct TestObject {
+	int id;
+	int texType;
+	float dist;
+	float alpha;
+};
+
+// stands in for ModelRenderContainer: objects binned by texture-type
+struct TestContainer {
+	unsigned int GetNumObjectBins() const { return keys.size(); }
+	int GetObjectBinKey(unsigned int i) const { return keys[i]; }
+	const std::vector<TestObject*>& GetObjectBin(unsigned int i) const { return bins[i]; }
+
+	void AddObject(TestObject* o) {
+		for (unsigned int i = 0; i < keys.size(); i++) {
+			if (keys[i] == o->texType) {
+				bins[i].push_back(o);
+				return;
+			}
+		}
+
+		keys.push_back(o->texType);
+		bins.emplace_back(1, o);
+	}
+
+	std::vector<int> keys;
+	std::vector< std::vector<TestObject*> > bins;
+};
+
+static int CullObject(TestObject* o)
+{
+	if (o->dist < 0.0f)
+		return MODEL_DRAW_CULL;
+	if (o->dist > 100.0f)
+		return MODEL_DRAW_FAR;
+
+	// fade out between 50 and 100
+	o->alpha = std::min(1.0f, (100.0f - o->dist) / 50.0f);
+
+	return ((o->alpha < 1.0f)? MODEL_DRAW_FADE: MODEL_DRAW_NEAR);
+}
+
+
+TEST_CASE("ModelDrawList")
+{
+	constexpr int numObjects = 1000;
+
+	std::vector<TestObject> objects(numObjects);
+	TestContainer containers[2];
+
+	for (int i = 0; i < numObjects; i++) {
+		objects[i] = {i, i % 3, float((i * 37) % 160) - 20.0f, 0.0f};
+		containers[i & 1].AddObject(&objects[i]);
+	}
+
+	ModelDrawList<TestObject> drawList;
+
+	for (int pass = 0; pass < 2; pass++) {
+		drawList.Clear();
+		drawList.AddObjects(0, containers[0]);
+		drawList.AddObjects(1, containers[1]);
+		drawList.Cull(CullObject);
+
+		int numNear = 0;
+		int numFade = 0;
+
+		for (int modelType = 0; modelType < 2; modelType++) {
+			for (int drawType: {MODEL_DRAW_NEAR, MODEL_DRAW_FADE}) {
+				CHECK(drawList.GetNumObjectBins(modelType, drawType) <= 3);
+
+				for (unsigned int i = 0, n = drawList.GetNumObjectBins(modelType, drawType); i < n; i++) {
+					const auto& bin = drawList.GetObjectBin(modelType, i, drawType);
+					int prevID = -1;
+
+					// no empty bins, no foreign objects, container order is kept
+					CHECK(!bin.objects.empty());
+
+					for (const TestObject* o: bin.objects) {
+						CHECK(o->texType == bin.key);
+						CHECK((o->id & 1) == modelType);
+						CHECK(CullObject(const_cast<TestObject*>(o)) == drawType);
+						CHECK(o->id > prevID);
+
+						prevID = o->id;
+					}
+
+					numNear += (drawType == MODEL_DRAW_NEAR) * bin.objects.size();
+					numFade += (drawType == MODEL_DRAW_FADE) * bin.objects.size();
+				}
+			}
+		}
+
+		int expNear = 0;
+		int expFade = 0;
+		int expFar = 0;
+
+		for (TestObject& o: objects) {
+			switch (CullObject(&o)) {
+				case MODEL_DRAW_NEAR: { expNear++; } break;
+				case MODEL_DRAW_FADE: { expFade++; } break;
+				case MODEL_DRAW_FAR : { expFar++; } break;
+				default: {} break;
+			}
+		}
+
+		CHECK(numNear == expNear);
+		CHECK(numFade == expFade);
+		CHECK(drawList.GetFarObjects().size() == expFar);
+		CHECK(drawList.GetNumObjectBins(2) == 0);
+
+		// second pass sees everything moved closer; bins are rebuilt from scratch
+		for (TestObject& o: objects) {
+			o.dist -= 30.0f;
+		}
+	}
+}
@@ -0,0 +1,285 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/PieceBVH.h"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// oriented box standing in for a piece's collision-volume
+struct TestPiece {
+	float3 pos;
+	float3 axes[3];
+	float3 hs;
+};
+
+static unsigned int rngState = 0;
+
+static float NextFloat(float lo, float hi)
+{
+	rngState = rngState * 1664525u + 1013904223u;
+	return (lo + (hi - lo) * ((rngState >> 8) / float(1 << 24)));
+}
+
+static void SetRotation(TestPiece& p, float yaw, float pitch)
+{
+	const float cy = std::cos(yaw), sy = std::sin(yaw);
+	const float cp = std::cos(pitch), sp = std::sin(pitch);
+
+	p.axes[0] = float3(cy, 0.0f, -sy);
+	p.axes[1] = float3(sy * sp, cp, cy * sp);
+	p.axes[2] = float3(sy * cp, -sp, cy * cp);
+}
+
+// pieces spread over and above a long hull, like a battleship's turrets and details
+static std::vector<TestPiece> MakeShip(int numPieces)
+{
+	std::vector<TestPiece> pieces(numPieces);
+
+	for (TestPiece& p: pieces) {
+		p.pos = float3(NextFloat(-40.0f, 40.0f), NextFloat(0.0f, 30.0f), NextFloat(-300.0f, 300.0f));
+		p.hs = float3(NextFloat(1.0f, 8.0f), NextFloat(1.0f, 8.0f), NextFloat(1.0f, 12.0f));
+
+		SetRotation(p, NextFloat(-3.0f, 3.0f), NextFloat(-0.5f, 0.5f));
+	}
+
+	return pieces;
+}
+
+static void SetBVHBounds(CPieceBVH& bvh, const std::vector<TestPiece>& pieces)
+{
+	for (size_t n = 0; n < pieces.size(); n++) {
+		const TestPiece& p = pieces[n];
+		const float3 ext =
+			float3(std::fabs(p.axes[0].x), std::fabs(p.axes[0].y), std::fabs(p.axes[0].z)) * p.hs.x +
+			float3(std::fabs(p.axes[1].x), std::fabs(p.axes[1].y), std::fabs(p.axes[1].z)) * p.hs.y +
+			float3(std::fabs(p.axes[2].x), std::fabs(p.axes[2].y), std::fabs(p.axes[2].z)) * p.hs.z;
+
+		bvh.SetPieceBounds(n, p.pos - ext, p.pos + ext);
+	}
+}
+
+// exact segment vs. oriented box, what CCollisionHandler::Intersect amounts to
+static bool IntersectPiece(const TestPiece& p, const float3& p0, const float3& p1)
+{
+	const float3 d0 = p0 - p.pos;
+	const float3 d1 = p1 - p.pos;
+	const float3 q0 = float3(d0.dot(p.axes[0]), d0.dot(p.axes[1]), d0.dot(p.axes[2]));
+	const float3 q1 = float3(d1.dot(p.axes[0]), d1.dot(p.axes[1]), d1.dot(p.axes[2]));
+
+	return (CPieceBVH::SegmentOverlapsBox(q0, q1 - q0, -p.hs, p.hs));
+}
+
+static void MakeRays(std::vector<float3>& rays, int numRays)
+{
+	rays.clear();
+	rays.reserve(numRays * 2);
+
+	// shots from all around, most of them aimed somewhere at the hull
+	for (int n = 0; n < numRays; n++) {
+		const float3 tgt(NextFloat(-50.0f, 50.0f), NextFloat(-5.0f, 40.0f), NextFloat(-320.0f, 320.0f));
+		const float3 src(NextFloat(-600.0f, 600.0f), NextFloat(0.0f, 300.0f), NextFloat(-600.0f, 600.0f));
+
+		rays.push_back(src);
+		rays.push_back(src + (tgt - src) * NextFloat(0.5f, 1.5f));
+	}
+}
+
+static int ClosestHitLinear(const std::vector<TestPiece>& pieces, const float3& p0, const float3& p1)
+{
+	float minDistSq = 1e30f;
+	int minPieceIdx = -1;
+
+	for (size_t n = 0; n < pieces.size(); n++) {
+		if (!IntersectPiece(pieces[n], p0, p1))
+			continue;
+
+		const float distSq = pieces[n].pos.SqDistance(p0);
+
+		if (distSq >= minDistSq)
+			continue;
+
+		minDistSq = distSq;
+		minPieceIdx = n;
+	}
+
+	return minPieceIdx;
+}
+
+static int ClosestHitBVH(const CPieceBVH& bvh, const std::vector<TestPiece>& pieces, const float3& p0, const float3& p1)
+{
+	float minDistSq = 1e30f;
+	int minPieceIdx = -1;
+
+	bvh.QuerySegment(p0, p1, [&](int n) {
+		if (!IntersectPiece(pieces[n], p0, p1))
+			return false;
+
+		const float distSq = pieces[n].pos.SqDistance(p0);
+
+		if (distSq > minDistSq)
+			return false;
+		if (distSq == minDistSq && (minPieceIdx < 0 || n > minPieceIdx))
+			return false;
+
+		minDistSq = distSq;
+		minPieceIdx = n;
+		return false;
+	});
+
+	return minPieceIdx;
+}
+
+
+TEST_CASE("PieceBVH")
+{
+	rngState = 1;
+
+	for (const int numPieces: {1, 2, 3, 7, 64, 300}) {
+		std::vector<TestPiece> pieces = MakeShip(numPieces);
+		std::vector<float3> rays;
+
+		CPieceBVH bvh;
+		bvh.Init(pieces.size());
+		SetBVHBounds(bvh, pieces);
+		bvh.Build();
+
+		// binary tree, one piece per leaf
+		CHECK(bvh.GetNodes().size() == size_t(numPieces * 2 - 1));
+
+		for (int pass = 0; pass < 2; pass++) {
+			MakeRays(rays, 2000);
+
+			for (size_t n = 0; n < rays.size(); n += 2) {
+				// no piece that is hit may be culled
+				std::vector<int> visited;
+				bvh.QuerySegment(rays[n], rays[n + 1], [&](int i) { visited.push_back(i); return false; });
+				std::sort(visited.begin(), visited.end());
+
+				for (int i = 0; i < numPieces; i++) {
+					if (IntersectPiece(pieces[i], rays[n], rays[n + 1]))
+						CHECK(std::binary_search(visited.begin(), visited.end(), i));
+				}
+
+				CHECK(ClosestHitLinear(pieces, rays[n], rays[n + 1]) == ClosestHitBVH(bvh, pieces, rays[n], rays[n + 1]));
+			}
+
+			// turrets rotate and pieces slide around; the topology stays
+			for (TestPiece& p: pieces) {
+				p.pos += float3(NextFloat(-20.0f, 20.0f), NextFloat(-5.0f, 5.0f), NextFloat(-20.0f, 20.0f));
+				SetRotation(p, NextFloat(-3.0f, 3.0f), NextFloat(-1.5f, 1.5f));
+			}
+
+			SetBVHBounds(bvh, pieces);
+			bvh.Refit();
+		}
+	}
+
+	// early-out
+	{
+		std::vector<TestPiece> pieces = MakeShip(16);
+		CPieceBVH bvh;
+		bvh.Init(pieces.size());
+		SetBVHBounds(bvh, pieces);
+		bvh.Build();
+
+		// straight down through the first piece
+		const float3 p0 = pieces[0].pos + UpVector * 1000.0f;
+		const float3 p1 = pieces[0].pos - UpVector * 1000.0f;
+
+		int numCalls = 0;
+		CHECK(bvh.QuerySegment(p0, p1, [&](int) { return (++numCalls == 1); }));
+		CHECK(numCalls == 1);
+		CHECK(!bvh.QuerySegment(p0, p0 - UpVector, [&](int) { return true; }));
+	}
+}
+
+
+TEST_CASE("PieceBVHRays")
+{
+	constexpr int numPieces = 150;
+	constexpr int numRays = 20000;
+
+	rngState = 2;
+
+	const std::vector<TestPiece> pieces = MakeShip(numPieces);
+	std::vector<float3> rays;
+	MakeRays(rays, numRays);
+
+	CPieceBVH bvh;
+	bvh.Init(pieces.size());
+	SetBVHBounds(bvh, pieces);
+	bvh.Build();
+
+	int numHits = 0;
+	int numDiffs = 0;
+
+	for (size_t n = 0; n < rays.size(); n += 2) {
+		const int linearHit = ClosestHitLinear(pieces, rays[n], rays[n + 1]);
+		const int bvhHit = ClosestHitBVH(bvh, pieces, rays[n], rays[n + 1]);
+
+		numHits += (linearHit >= 0);
+		numDiffs += (linearHit != bvhHit);
+	}
+
+	CHECK(numHits > 0);
+	CHECK(numDiffs == 0);
+}
+
+
+#ifdef UNIT_BENCHMARK
+TEST_CASE("PieceBVHThroughput")
+{
+	constexpr int numPieces = 150;
+	constexpr int numRays = 20000;
+	constexpr int numRounds = 5;
+
+	rngState = 2;
+
+	const std::vector<TestPiece> pieces = MakeShip(numPieces);
+	std::vector<float3> rays;
+	MakeRays(rays, numRays);
+
+	CPieceBVH bvh;
+	bvh.Init(pieces.size());
+	SetBVHBounds(bvh, pieces);
+	bvh.Build();
+
+	long linearTime = 0;
+	long bvhTime = 0;
+
+	int linearSum = 0;
+	int bvhSum = 0;
+
+	// interleaved, best of N to keep noise out
+	for (int round = 0; round < numRounds; round++) {
+		const auto t0 = std::chrono::high_resolution_clock::now();
+		for (size_t n = 0; n < rays.size(); n += 2) {
+			linearSum += ClosestHitLinear(pieces, rays[n], rays[n + 1]);
+		}
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		for (size_t n = 0; n < rays.size(); n += 2) {
+			bvhSum += ClosestHitBVH(bvh, pieces, rays[n], rays[n + 1]);
+		}
+		const auto t2 = std::chrono::high_resolution_clock::now();
+
+		const long lt = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+		const long bt = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+		linearTime = (round == 0)? lt: std::min(linearTime, lt);
+		bvhTime = (round == 0)? bt: std::min(bvhTime, bt);
+	}
+
+	// also keeps the loops from being optimized out
+	CHECK(linearSum == bvhSum);
+
+	LOG("[PieceBVHThroughput] %d pieces, %d rays: linear=%ldus bvh=%ldus (%.2fx)",
+		numPieces, numRays, linearTime, bvhTime, linearTime / std::max(1.0, double(bvhTime)));
+}
+#endif
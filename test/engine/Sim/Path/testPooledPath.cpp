@@ -0,0 +1,103 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Path/Default/IPath.h"
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+TEST_CASE("PooledPath")
+{
+	typedef IPath::PooledList<int> IntList;
+
+	SECTION("copies share storage until written") {
+		IntList a;
+
+		for (int i = 0; i < 8; i++) {
+			a.push_back(i);
+		}
+
+		const std::uint64_t numCopies = IPath::poolStats.numCopies.load();
+
+		IntList b = a;
+
+		CHECK(b.size() == a.size());
+		CHECK(b.begin() == a.begin());
+
+		// popping never writes, so both lists keep their view
+		b.pop_back();
+		b.pop_back();
+
+		CHECK(a.size() == 8);
+		CHECK(b.size() == 6);
+		CHECK(a.back() == 7);
+		CHECK(b.back() == 5);
+		CHECK(IPath::poolStats.numCopies.load() == numCopies);
+
+		// writing detaches
+		b.mutable_front() = 100;
+
+		CHECK(b.begin() != a.begin());
+		CHECK(a.front() == 0);
+		CHECK(b.front() == 100);
+		CHECK(IPath::poolStats.numCopies.load() == numCopies + 1);
+
+		// appending after a pop must not resurrect the popped element
+		a.pop_back();
+		a.push_back(42);
+
+		CHECK(a.size() == 8);
+		CHECK(a.back() == 42);
+	}
+
+	SECTION("released buffers are recycled") {
+		{
+			IntList a;
+			a.push_back(1);
+		}
+
+		const std::uint64_t numAllocs = IPath::poolStats.numAllocs.load();
+		const std::uint64_t numReuses = IPath::poolStats.numReuses.load();
+
+		for (int n = 0; n < 100; n++) {
+			IntList a;
+
+			for (int i = 0; i < 16; i++) {
+				a.push_back(i);
+			}
+		}
+
+		CHECK(IPath::poolStats.numAllocs.load() == numAllocs);
+		CHECK(IPath::poolStats.numReuses.load() == numReuses + 100);
+	}
+
+	SECTION("clear keeps an unshared buffer") {
+		IntList a;
+		a.push_back(1);
+		a.push_back(2);
+
+		const int* data = a.begin();
+
+		a.clear();
+		CHECK(a.empty());
+
+		a.push_back(3);
+		CHECK(a.begin() == data);
+		CHECK(a.size() == 1);
+		CHECK(a.front() == 3);
+	}
+
+	SECTION("reverse iteration") {
+		IntList a;
+
+		for (int i = 0; i < 4; i++) {
+			a.push_back(i);
+		}
+
+		int expected = 3;
+
+		for (auto it = a.rbegin(); it != a.rend(); ++it) {
+			CHECK(*it == expected--);
+		}
+	}
+}
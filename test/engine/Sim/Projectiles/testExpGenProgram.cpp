@@ -0,0 +1,327 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Projectiles/ExpGenProgram.h"
+#include "System/float3.h"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// deterministic stand-in for guRNG
+struct TestRNG {
+	float NextFloat() {
+		state = state * 1664525u + 1013904223u;
+		return ((state >> 8) * (1.0f / 16777216.0f));
+	}
+
+	unsigned int state = 12345;
+};
+
+// always yields the same value, so batched and per-instance runs match
+struct FixedRNG {
+	float NextFloat() { return 0.375f; }
+};
+
+
+// layout resembling a CSimpleParticleSystem
+struct TestSpawnable {
+	float3 emitVector;
+	float3 emitMul;
+	float3 gravity;
+	float emitRot;
+	float emitRotSpread;
+	float particleSpeed;
+	float particleSpeedSpread;
+	float particleSize;
+	float particleSizeSpread;
+	float airDrag;
+	float sizeGrowth;
+	float sizeMod;
+	int numParticles;
+	int particleLife;
+	int particleLifeSpread;
+	short directional;
+	void* texture;
+	void* colorMap;
+	float phase;
+};
+
+// bitwise per member; the padding bytes are never written by either side
+static bool EqualSpawnables(const TestSpawnable& a, const TestSpawnable& b)
+{
+	const auto Equal = [](const auto& x, const auto& y) { return (std::memcmp(&x, &y, sizeof(x)) == 0); };
+
+	return
+		Equal(a.emitVector, b.emitVector) && Equal(a.emitMul, b.emitMul) && Equal(a.gravity, b.gravity) &&
+		Equal(a.emitRot, b.emitRot) && Equal(a.emitRotSpread, b.emitRotSpread) &&
+		Equal(a.particleSpeed, b.particleSpeed) && Equal(a.particleSpeedSpread, b.particleSpeedSpread) &&
+		Equal(a.particleSize, b.particleSize) && Equal(a.particleSizeSpread, b.particleSizeSpread) &&
+		Equal(a.airDrag, b.airDrag) && Equal(a.sizeGrowth, b.sizeGrowth) && Equal(a.sizeMod, b.sizeMod) &&
+		Equal(a.numParticles, b.numParticles) && Equal(a.particleLife, b.particleLife) && Equal(a.particleLifeSpread, b.particleLifeSpread) &&
+		Equal(a.directional, b.directional) && Equal(a.texture, b.texture) && Equal(a.colorMap, b.colorMap) &&
+		Equal(a.phase, b.phase);
+}
+
+
+// emits byte-code the way CCustomExplosionGenerator::ParseExplosionCode does
+struct ByteCodeWriter {
+	template<typename T> void Arg(T v) { code.append((const char*) &v, ((const char*) &v) + sizeof(T)); }
+
+	ByteCodeWriter& Op(char op) { code.push_back(op); return *this; }
+	ByteCodeWriter& OpF(char op, float v) { Op(op); Arg(v); return *this; }
+	ByteCodeWriter& OpI(char op, int v) { Op(op); Arg(v); return *this; }
+
+	ByteCodeWriter& StoreF(size_t offset) { Op(CExpGenProgram::OP_STOREF); Arg<std::uint8_t>(4); Arg<std::uint16_t>(offset); return *this; }
+	ByteCodeWriter& StoreI(size_t offset, size_t size) { Op(CExpGenProgram::OP_STOREI); Arg<std::uint8_t>(size); Arg<std::uint16_t>(offset); return *this; }
+	ByteCodeWriter& StoreP(size_t offset, void* ptr) { Op(CExpGenProgram::OP_LOADP); Arg(ptr); Op(CExpGenProgram::OP_STOREP); Arg<std::uint16_t>(offset); return *this; }
+	ByteCodeWriter& Dir(size_t offset) { Op(CExpGenProgram::OP_DIR); Arg<std::uint16_t>(offset); return *this; }
+
+	std::string code;
+};
+
+#define OFS(member) offsetof(TestSpawnable, member)
+
+static std::string GenTestByteCode()
+{
+	static int texture = 0;
+	static int colorMap = 0;
+
+	typedef CExpGenProgram P;
+	ByteCodeWriter w;
+
+	// emitvector = dir
+	w.Dir(OFS(emitVector));
+	// emitmul = 1, 0.5 r0.5, 1
+	w.OpF(P::OP_ADD, 1.0f).StoreF(OFS(emitMul.x));
+	w.OpF(P::OP_ADD, 0.5f).OpF(P::OP_RAND, 0.5f).StoreF(OFS(emitMul.y));
+	w.OpF(P::OP_ADD, 1.0f).StoreF(OFS(emitMul.z));
+	// gravity = 0, -0.1 r0.05, 0
+	w.OpF(P::OP_ADD, 0.0f).StoreF(OFS(gravity.x));
+	w.OpF(P::OP_ADD, -0.1f).OpF(P::OP_RAND, 0.05f).StoreF(OFS(gravity.y));
+	w.OpF(P::OP_ADD, 0.0f).StoreF(OFS(gravity.z));
+	// emitrot = 45, emitrotspread = 32 r8
+	w.OpF(P::OP_ADD, 45.0f).StoreF(OFS(emitRot));
+	w.OpF(P::OP_ADD, 32.0f).OpF(P::OP_RAND, 8.0f).StoreF(OFS(emitRotSpread));
+	// particlespeed = 1 i0.25 d0.01, particlespeedspread = 3
+	w.OpF(P::OP_ADD, 1.0f).OpF(P::OP_INDEX, 0.25f).OpF(P::OP_DAMAGE, 0.01f).StoreF(OFS(particleSpeed));
+	w.OpF(P::OP_ADD, 3.0f).StoreF(OFS(particleSpeedSpread));
+	// particlesize = 4 r2 y0 2 x0, particlesizespread = 0.5 p2
+	w.OpF(P::OP_ADD, 4.0f).OpF(P::OP_RAND, 2.0f).OpI(P::OP_YANK, 0).OpF(P::OP_ADD, 2.0f).OpI(P::OP_MULTIPLY, 0).StoreF(OFS(particleSize));
+	w.OpF(P::OP_ADD, 0.5f).OpF(P::OP_POW, 2.0f).StoreF(OFS(particleSizeSpread));
+	// airdrag = 0.97, sizegrowth = 0.2 m0.15, sizemod = 1 k0.3
+	w.OpF(P::OP_ADD, 0.97f).StoreF(OFS(airDrag));
+	w.OpF(P::OP_ADD, 0.2f).OpF(P::OP_SAWTOOTH, 0.15f).StoreF(OFS(sizeGrowth));
+	w.OpF(P::OP_ADD, 1.0f).OpF(P::OP_DISCRETE, 0.3f).StoreF(OFS(sizeMod));
+	// numparticles = 6 r4, particlelife = 20, particlelifespread = 10 i1
+	w.OpF(P::OP_ADD, 6.0f).OpF(P::OP_RAND, 4.0f).StoreI(OFS(numParticles), 4);
+	w.OpF(P::OP_ADD, 20.0f).StoreI(OFS(particleLife), 4);
+	w.OpF(P::OP_ADD, 10.0f).OpF(P::OP_INDEX, 1.0f).StoreI(OFS(particleLifeSpread), 4);
+	// directional = 1
+	w.OpF(P::OP_ADD, 1.0f).StoreI(OFS(directional), 2);
+	// texture = ..., colormap = ...
+	w.StoreP(OFS(texture), &texture);
+	w.StoreP(OFS(colorMap), &colorMap);
+	// phase = i0.7 s1.5
+	w.OpF(P::OP_INDEX, 0.7f).OpF(P::OP_SINE, 1.5f).StoreF(OFS(phase));
+
+	w.Op(P::OP_END);
+	return w.code;
+}
+
+
+// the byte-code interpreter CCustomExplosionGenerator used before
+template<typename RNG>
+static void ExecuteByteCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir, RNG& rng)
+{
+	typedef CExpGenProgram P;
+
+	float val = 0.0f;
+	float buffer[16];
+	void* ptr = nullptr;
+
+	std::memset(&buffer[0], 0, sizeof(buffer));
+
+	for (;;) {
+		switch (*(code++)) {
+			case P::OP_END: {
+				return;
+			}
+			case P::OP_STOREI: {
+				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
+				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
+				switch (size) {
+					case 1: { *(std::int8_t*)  (instance + offset) = (int) val; } break;
+					case 2: { *(std::int16_t*) (instance + offset) = (int) val; } break;
+					case 4: { *(std::int32_t*) (instance + offset) = (int) val; } break;
+					case 8: { *(std::int64_t*) (instance + offset) = (int) val; } break;
+					default: { /*no op*/ } break;
+				}
+				val = 0.0f;
+				break;
+			}
+			case P::OP_STOREF: {
+				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
+				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
+				switch (size) {
+					case 4: { *(float*)  (instance + offset) = val; } break;
+					case 8: { *(double*) (instance + offset) = val; } break;
+					default: { /*no op*/ } break;
+				}
+				val = 0.0f;
+				break;
+			}
+			case P::OP_ADD     : { val += *(float*) code; code += 4; } break;
+			case P::OP_RAND    : { val += rng.NextFloat() * (*(float*) code); code += 4; } break;
+			case P::OP_DAMAGE  : { val += damage * (*(float*) code); code += 4; } break;
+			case P::OP_INDEX   : { val += spawnIndex * (*(float*) code); code += 4; } break;
+			case P::OP_LOADP   : { ptr = *(void**) code; code += sizeof(void*); } break;
+			case P::OP_STOREP  : { *(void**) (instance + *(std::uint16_t*) code) = ptr; ptr = nullptr; code += 2; } break;
+			case P::OP_DIR     : { *reinterpret_cast<float3*>(instance + *(std::uint16_t*) code) = dir; code += 2; } break;
+			case P::OP_SAWTOOTH: { val -= (*(float*) code) * math::floor(val / (*(float*) code)); code += 4; } break;
+			case P::OP_DISCRETE: { val = (*(float*) code) * math::floor(spring::SafeDivide(val, (*(float*) code))); code += 4; } break;
+			case P::OP_SINE    : { val = (*(float*) code) * math::sin(val); code += 4; } break;
+			case P::OP_YANK    : { buffer[(*(int*) code)] = val; val = 0; code += 4; } break;
+			case P::OP_MULTIPLY: { val *= buffer[(*(int*) code)]; code += 4; } break;
+			case P::OP_ADDBUFF : { val += buffer[(*(int*) code)]; code += 4; } break;
+			case P::OP_POW     : { val = math::pow(val, (*(float*) code)); code += 4; } break;
+			case P::OP_POWBUFF : { val = math::pow(val, buffer[(*(int*) code)]); code += 4; } break;
+			default: { assert(false); } break;
+		}
+	}
+}
+
+
+static constexpr int NUM_SPAWNS = 2000; // explosions (benchmark only)
+static constexpr int SPAWN_COUNT = 150; // instances per spawn-class and explosion
+
+static const float3 TEST_DIR = {0.0f, 1.0f, 0.0f};
+static const float TEST_DAMAGE = 250.0f;
+
+
+TEST_CASE("ExpGenProgramFolding")
+{
+	CExpGenProgram program;
+	program.Compile(GenTestByteCode());
+
+	size_t numConstStores = 0;
+
+	for (const CExpGenProgram::Op& op: program.GetOps()) {
+		numConstStores += (op.code == CExpGenProgram::OP_STOREFC || op.code == CExpGenProgram::OP_STOREIC);
+
+		// pointer loads are merged into their stores
+		CHECK(op.code != CExpGenProgram::OP_LOADP);
+	}
+
+	// emitmul.x/z, gravity.x/z, emitrot, particlespeedspread, particlesizespread,
+	// airdrag, sizegrowth, sizemod, particlelife, directional
+	CHECK(numConstStores == 12);
+}
+
+
+TEST_CASE("ExpGenProgramEquivalence")
+{
+	const std::string byteCode = GenTestByteCode();
+
+	CExpGenProgram program;
+	program.Compile(byteCode);
+
+	// one instance per batch keeps the RNG draw order of the interpreter
+	{
+		TestRNG refRNG;
+		TestRNG prgRNG;
+
+		bool equal = true;
+
+		for (int i = 0; i < SPAWN_COUNT; i++) {
+			TestSpawnable refInst = {};
+			TestSpawnable prgInst = {};
+
+			char* inst = (char*) &prgInst;
+
+			ExecuteByteCode(byteCode.data(), TEST_DAMAGE, (char*) &refInst, i, TEST_DIR, refRNG);
+			program.Execute(&inst, 1, i, TEST_DAMAGE, TEST_DIR, prgRNG);
+
+			equal &= EqualSpawnables(refInst, prgInst);
+		}
+
+		CHECK(equal);
+	}
+
+	// full batches, only the interleaving of RNG draws differs
+	{
+		FixedRNG rng;
+
+		std::vector<TestSpawnable> refInsts(SPAWN_COUNT);
+		std::vector<TestSpawnable> prgInsts(SPAWN_COUNT);
+		std::vector<char*> instPtrs(SPAWN_COUNT);
+
+		for (int i = 0; i < SPAWN_COUNT; i++) {
+			ExecuteByteCode(byteCode.data(), TEST_DAMAGE, (char*) &refInsts[i], i, TEST_DIR, rng);
+			instPtrs[i] = (char*) &prgInsts[i];
+		}
+
+		for (int i = 0; i < SPAWN_COUNT; i += CExpGenProgram::MAX_BATCH_SIZE) {
+			program.Execute(&instPtrs[i], std::min(SPAWN_COUNT - i, CExpGenProgram::MAX_BATCH_SIZE), i, TEST_DAMAGE, TEST_DIR, rng);
+		}
+
+		CHECK(std::equal(refInsts.begin(), refInsts.end(), prgInsts.begin(), EqualSpawnables));
+	}
+}
+
+
+#ifdef UNIT_BENCHMARK
+TEST_CASE("ExpGenProgramThroughput")
+{
+	const std::string byteCode = GenTestByteCode();
+
+	CExpGenProgram program;
+	program.Compile(byteCode);
+
+	std::vector<TestSpawnable> insts(SPAWN_COUNT);
+	std::vector<char*> instPtrs(SPAWN_COUNT);
+
+	for (int i = 0; i < SPAWN_COUNT; i++) {
+		instPtrs[i] = (char*) &insts[i];
+	}
+
+	TestRNG rng;
+
+	const auto t0 = std::chrono::high_resolution_clock::now();
+
+	for (int n = 0; n < NUM_SPAWNS; n++) {
+		for (int i = 0; i < SPAWN_COUNT; i++) {
+			ExecuteByteCode(byteCode.data(), TEST_DAMAGE, instPtrs[i], i, TEST_DIR, rng);
+		}
+	}
+
+	const auto t1 = std::chrono::high_resolution_clock::now();
+
+	for (int n = 0; n < NUM_SPAWNS; n++) {
+		for (int i = 0; i < SPAWN_COUNT; i += CExpGenProgram::MAX_BATCH_SIZE) {
+			program.Execute(&instPtrs[i], std::min(SPAWN_COUNT - i, CExpGenProgram::MAX_BATCH_SIZE), i, TEST_DAMAGE, TEST_DIR, rng);
+		}
+	}
+
+	const auto t2 = std::chrono::high_resolution_clock::now();
+
+	const float refTime = std::chrono::duration<float, std::milli>(t1 - t0).count();
+	const float prgTime = std::chrono::duration<float, std::milli>(t2 - t1).count();
+	const float numInsts = NUM_SPAWNS * SPAWN_COUNT;
+
+	LOG("[ExpGenProgramThroughput] %d x %d spawns: byte-code %.2fms (%.1fM/s), program %.2fms (%.1fM/s, %.2fx; %u ops for %u code bytes)",
+		NUM_SPAWNS, SPAWN_COUNT,
+		refTime, numInsts / (refTime * 1000.0f),
+		prgTime, numInsts / (prgTime * 1000.0f),
+		refTime / std::max(prgTime, 0.001f),
+		unsigned(program.GetOps().size()), unsigned(byteCode.size()));
+
+	CHECK(insts[0].particleLife == 20);
+}
+#endif
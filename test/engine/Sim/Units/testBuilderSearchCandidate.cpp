@@ -0,0 +1,227 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Units/CommandAI/BuilderSearchCandidate.h"
+
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// what the searches in CBuilderCAI know about an object once the cheap filters passed
+struct TestObject {
+	float dist;
+	bool moving;  // units; for features: not metal
+	bool enemy;   // FindRepairTargetAndRepair only
+	bool valid;   // outcome of the expensive checks (LOS, build-range, ...)
+};
+
+static constexpr int NUM_TRIALS = 50000;
+
+
+static unsigned int rngState = 0;
+
+static int NextInt(int n)
+{
+	rngState = rngState * 1664525u + 1013904223u;
+	return ((rngState >> 8) % n);
+}
+
+static std::vector<TestObject> GenObjects(bool withEnemies)
+{
+	std::vector<TestObject> objects(NextInt(24));
+
+	for (TestObject& o: objects) {
+		// few distinct distances, ties have to resolve like before
+		o.dist = NextInt(12) * 16.0f;
+		o.moving = (NextInt(3) == 0);
+		o.enemy = withEnemies && (NextInt(4) == 0);
+		o.valid = (NextInt(3) != 0);
+	}
+
+	return objects;
+}
+
+
+// FindReclaimTarget's unit loop before the best-first search
+static int LinearReclaimUnit(const std::vector<TestObject>& objects, float& bestDist, bool& stationary)
+{
+	int best = -1;
+
+	for (int i = 0, n = objects.size(); i < n; i++) {
+		const TestObject& o = objects[i];
+
+		if (o.moving && stationary)
+			continue;
+
+		if (o.dist < bestDist || (!stationary && !o.moving)) {
+			if (!o.valid)
+				continue;
+
+			if (!stationary && !o.moving)
+				stationary = true;
+
+			bestDist = o.dist;
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+// FindReclaimTarget's (recSpecial) feature loop before the best-first search
+static int LinearReclaimFeature(const std::vector<TestObject>& objects, float bestDist, bool recSpecial)
+{
+	int best = -1;
+	bool metal = false;
+
+	for (int i = 0, n = objects.size(); i < n; i++) {
+		const TestObject& o = objects[i];
+		const bool isMetal = !o.moving;
+
+		if (recSpecial && metal && !isMetal)
+			continue;
+
+		if (o.dist < bestDist || (recSpecial && !metal && isMetal)) {
+			if (!o.valid)
+				continue;
+
+			metal |= (recSpecial && !metal && isMetal);
+
+			bestDist = o.dist;
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+// FindRepairTargetAndRepair's loop before the best-first search
+static int LinearRepair(const std::vector<TestObject>& objects)
+{
+	int best = -1;
+	float bestDist = 1.0e30f;
+
+	bool haveEnemy = false;
+	bool stationary = false;
+
+	for (int i = 0, n = objects.size(); i < n; i++) {
+		const TestObject& o = objects[i];
+
+		if (!o.enemy) {
+			if (haveEnemy)
+				continue;
+			if (o.moving && stationary)
+				continue;
+
+			if (o.dist < bestDist || (!stationary && !o.moving)) {
+				if (!o.valid)
+					continue;
+
+				stationary |= (!stationary && !o.moving);
+
+				bestDist = o.dist;
+				best = i;
+			}
+		} else {
+			if ((o.dist < bestDist) || !haveEnemy) {
+				if (!o.valid)
+					continue;
+
+				best = i;
+				bestDist = o.dist;
+				haveEnemy = true;
+			}
+		}
+	}
+
+	return best;
+}
+
+
+template<typename ClassFunc>
+static const SearchCandidate<const TestObject>* BestFirst(
+	const std::vector<TestObject>& objects,
+	std::vector< SearchCandidate<const TestObject> >& candidates,
+	float maxDist,
+	const ClassFunc& classOf
+) {
+	candidates.clear();
+
+	for (const TestObject& o: objects) {
+		candidates.push_back({&o, o.dist, classOf(o), int(candidates.size())});
+	}
+
+	return (FindBestCandidate(candidates, maxDist, [](const TestObject* o) { return o->valid; }));
+}
+
+static int IndexOf(const std::vector<TestObject>& objects, const SearchCandidate<const TestObject>* c)
+{
+	if (c == nullptr)
+		return -1;
+
+	return (c->obj - objects.data());
+}
+
+
+TEST_CASE("SearchCandidateOrder")
+{
+	using Candidate = SearchCandidate<const TestObject>;
+
+	const TestObject o = {0.0f, false, false, true};
+
+	// class first, then distance, then order of discovery
+	CHECK(Candidate{&o, 9.0f, 1, 0} < Candidate{&o, 1.0f, 0, 1});
+	CHECK(Candidate{&o, 9.0f, 0, 0} < Candidate{&o, 1.0f, 0, 1});
+	CHECK(Candidate{&o, 1.0f, 0, 1} < Candidate{&o, 1.0f, 0, 0});
+	CHECK(!(Candidate{&o, 1.0f, 0, 0} < Candidate{&o, 1.0f, 0, 0}));
+}
+
+TEST_CASE("ReclaimSearchMatchesLinearScan")
+{
+	std::vector<SearchCandidate<const TestObject>> candidates;
+
+	rngState = 1;
+
+	for (int trial = 0; trial < NUM_TRIALS; trial++) {
+		const std::vector<TestObject> units = GenObjects(false);
+		const std::vector<TestObject> features = GenObjects(false);
+
+		const float bestStartDist = NextInt(16) * 16.0f;
+		const bool recSpecial = (NextInt(2) == 0);
+
+		float linearDist = bestStartDist;
+		bool linearStationary = false;
+
+		const int linearUnit = LinearReclaimUnit(units, linearDist, linearStationary);
+		const auto* bestUnit = BestFirst(units, candidates, bestStartDist, [](const TestObject& o) { return int(o.moving); });
+
+		REQUIRE(IndexOf(units, bestUnit) == linearUnit);
+
+		// features are only searched while no stationary unit was found
+		if (linearUnit != -1 && linearStationary)
+			continue;
+
+		const float featureDist = (bestUnit != nullptr)? bestUnit->dist: bestStartDist;
+		const int linearFeature = LinearReclaimFeature(features, linearDist, recSpecial);
+		const auto* bestFeature = BestFirst(features, candidates, featureDist, [&](const TestObject& o) { return int(!(recSpecial && !o.moving)); });
+
+		REQUIRE(IndexOf(features, bestFeature) == linearFeature);
+	}
+}
+
+TEST_CASE("RepairSearchMatchesLinearScan")
+{
+	std::vector<SearchCandidate<const TestObject>> candidates;
+
+	rngState = 2;
+
+	for (int trial = 0; trial < NUM_TRIALS; trial++) {
+		const std::vector<TestObject> units = GenObjects(true);
+
+		const int linearUnit = LinearRepair(units);
+		const auto* bestUnit = BestFirst(units, candidates, 1.0e30f, [](const TestObject& o) { return (o.enemy? 0: 1 + int(o.moving)); });
+
+		REQUIRE(IndexOf(units, bestUnit) == linearUnit);
+	}
+}
@@ -0,0 +1,285 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Units/CommandAI/BuilderTargetIndex.h"
+#include "System/UnorderedSet.hpp"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+static constexpr int CMD_NONE = 0;
+static constexpr int CMD_RECLAIM = 1;
+
+// front of a builder's command queue, plus what IsFeatureBeingReclaimed checks
+struct TestBuilder {
+	int cmdID = CMD_NONE;
+	int cmdTarget = -1;
+	int allyTeam = 0;
+};
+
+static std::vector<TestBuilder> builders;
+
+
+static bool FrontMatches(int builderID, int targetID)
+{
+	const TestBuilder& b = builders[builderID];
+	return (b.cmdID == CMD_RECLAIM && b.cmdTarget == targetID);
+}
+
+
+// the scheme CBuilderCAI used before: one flat set of all reclaiming builders
+struct LinearReclaimers {
+	void Add(int builderID, int) { reclaimers.insert(builderID); }
+	void Remove(int builderID) { reclaimers.erase(builderID); }
+
+	bool IsBeingReclaimed(int targetID, int allyTeam) {
+		bool retval = false;
+		removees.clear();
+
+		for (const int builderID: reclaimers) {
+			const TestBuilder& b = builders[builderID];
+
+			if (b.cmdID != CMD_RECLAIM) {
+				removees.push_back(builderID);
+				continue;
+			}
+			if (b.cmdTarget != targetID)
+				continue;
+
+			if (b.allyTeam == allyTeam) {
+				retval = true;
+				break;
+			}
+		}
+
+		for (const int builderID: removees) {
+			reclaimers.erase(builderID);
+		}
+
+		return retval;
+	}
+
+	spring::unordered_set<int> reclaimers;
+	std::vector<int> removees;
+};
+
+// the scheme CBuilderCAI::IsTargetOfBuilders uses now, minus the engine types
+struct IndexedReclaimers {
+	void Add(int builderID, int targetID) { index.Add(builderID, targetID); }
+	void Remove(int builderID) { index.Remove(builderID); }
+
+	bool IsBeingReclaimed(int targetID, int allyTeam) {
+		const auto IsWorking = [&](int builderID) { return (FrontMatches(builderID, targetID)); };
+		const auto IsFriend = [&](int builderID) { return (builders[builderID].allyTeam == allyTeam); };
+
+		return (index.HasMatchingBuilder(targetID, removees, IsWorking, IsFriend));
+	}
+
+	CBuilderTargetIndex index;
+	std::vector<int> removees;
+};
+
+
+static unsigned int rngState = 0;
+
+static int NextInt(int n)
+{
+	rngState = rngState * 1664525u + 1013904223u;
+	return ((rngState >> 8) % n);
+}
+
+
+/**
+ * Area-reclaim of a wreck field: every frame each builder either keeps its
+ * target, moves on to a new wreck or drops its command (without unregistering,
+ * like a finished command), then checks a number of nearby wrecks for being
+ * reclaimed already the way FindReclaimTarget does.
+ */
+template<typename Reclaimers>
+static std::vector<int> RunWreckField(Reclaimers& reclaimers, int numBuilders, int numWrecks, int numFrames, int numQueries)
+{
+	std::vector<int> results;
+	results.reserve(numFrames);
+
+	builders.clear();
+	builders.resize(numBuilders);
+
+	rngState = 1;
+
+	for (int i = 0; i < numBuilders; i++) {
+		builders[i].allyTeam = i & 1;
+	}
+
+	for (int frame = 0; frame < numFrames; frame++) {
+		int numReclaimed = 0;
+
+		for (int i = 0; i < numBuilders; i++) {
+			TestBuilder& b = builders[i];
+
+			switch (NextInt(8)) {
+				case 0: {
+					b.cmdID = CMD_NONE;
+					b.cmdTarget = -1;
+				} break;
+				case 1:
+				case 2: {
+					b.cmdID = CMD_RECLAIM;
+					b.cmdTarget = NextInt(numWrecks);
+					reclaimers.Add(i, b.cmdTarget);
+				} break;
+				default: {
+					if (b.cmdID == CMD_RECLAIM)
+						reclaimers.Add(i, b.cmdTarget);
+				} break;
+			}
+
+			for (int q = 0; q < numQueries; q++) {
+				numReclaimed += reclaimers.IsBeingReclaimed(NextInt(numWrecks), b.allyTeam);
+			}
+		}
+
+		// a builder dying takes its registration with it
+		if ((frame % 16) == 0)
+			reclaimers.Remove(NextInt(numBuilders));
+
+		results.push_back(numReclaimed);
+	}
+
+	return results;
+}
+
+
+TEST_CASE("BuilderTargetIndex")
+{
+	CBuilderTargetIndex index;
+
+	index.Add(1, 100);
+	index.Add(2, 100);
+	index.Add(3, 200);
+
+	CHECK(index.GetNumBuilders() == 3);
+	CHECK(index.GetNumTargets() == 2);
+	REQUIRE(index.GetBuilders(100) != nullptr);
+	CHECK(index.GetBuilders(100)->size() == 2);
+	CHECK(index.GetBuilders(300) == nullptr);
+
+	// re-targeting moves the builder
+	index.Add(1, 200);
+	CHECK(index.GetNumBuilders() == 3);
+	REQUIRE(index.GetBuilders(100) != nullptr);
+	CHECK(index.GetBuilders(100)->size() == 1);
+	CHECK(index.GetBuilders(200)->size() == 2);
+	CHECK((*index.GetBuilders(200))[0] == 3);
+	CHECK((*index.GetBuilders(200))[1] == 1);
+
+	// registering the same target twice is a no-op
+	index.Add(1, 200);
+	CHECK(index.GetBuilders(200)->size() == 2);
+
+	index.Remove(2);
+	index.Remove(2);
+	CHECK(index.GetBuilders(100) == nullptr);
+	CHECK(index.GetNumTargets() == 1);
+
+	index.Clear();
+	CHECK(index.GetNumBuilders() == 0);
+	CHECK(index.GetNumTargets() == 0);
+}
+
+
+TEST_CASE("BuilderTargetIndexQuery")
+{
+	CBuilderTargetIndex index;
+	std::vector<int> removees;
+
+	builders.clear();
+	builders.resize(4);
+
+	for (int i = 0; i < 4; i++) {
+		builders[i] = {CMD_RECLAIM, 100, i & 1};
+		index.Add(i, 100);
+	}
+
+	const auto Query = [&](int targetID, int allyTeam) {
+		const auto IsWorking = [&](int builderID) { return (FrontMatches(builderID, targetID)); };
+		const auto IsFriend = [&](int builderID) { return (builders[builderID].allyTeam == allyTeam); };
+
+		return (index.HasMatchingBuilder(targetID, removees, IsWorking, IsFriend));
+	};
+
+	CHECK(Query(100, 0));
+	CHECK(Query(100, 1));
+	CHECK(!Query(200, 0));
+
+	// builder 0 finished its command, the next query drops it
+	builders[0].cmdID = CMD_NONE;
+
+	CHECK(Query(100, 0));
+	CHECK(index.GetBuilders(100)->size() == 3);
+	CHECK(removees == std::vector<int>{0});
+
+	// the search stops at the first friendly builder, stale ones behind it stay
+	builders[2].cmdID = CMD_NONE;
+	builders[3].cmdID = CMD_NONE;
+
+	CHECK(Query(100, 1));
+	CHECK(index.GetBuilders(100)->size() == 3);
+
+	CHECK(!Query(100, 0));
+	CHECK(index.GetBuilders(100)->size() == 1);
+	CHECK((*index.GetBuilders(100))[0] == 1);
+}
+
+
+TEST_CASE("MassReclaim")
+{
+	constexpr int numBuilders = 200;
+	constexpr int numWrecks = 4000;
+	constexpr int numFrames = 300;
+	constexpr int numQueries = 16;
+
+	LinearReclaimers linear;
+	IndexedReclaimers indexed;
+
+	const std::vector<int> linearResults = RunWreckField(linear, numBuilders, numWrecks, numFrames, numQueries);
+	const std::vector<int> indexedResults = RunWreckField(indexed, numBuilders, numWrecks, numFrames, numQueries);
+
+	CHECK(linearResults == indexedResults);
+
+	// stale entries must not accumulate
+	CHECK(indexed.index.GetNumBuilders() <= numBuilders);
+}
+
+
+#ifdef UNIT_BENCHMARK
+TEST_CASE("MassReclaimThroughput")
+{
+	constexpr int numBuilders = 200;
+	constexpr int numWrecks = 4000;
+	constexpr int numFrames = 300;
+	constexpr int numQueries = 16;
+
+	LinearReclaimers linear;
+	IndexedReclaimers indexed;
+
+	const auto t0 = std::chrono::high_resolution_clock::now();
+	const std::vector<int> linearResults = RunWreckField(linear, numBuilders, numWrecks, numFrames, numQueries);
+	const auto t1 = std::chrono::high_resolution_clock::now();
+	const std::vector<int> indexedResults = RunWreckField(indexed, numBuilders, numWrecks, numFrames, numQueries);
+	const auto t2 = std::chrono::high_resolution_clock::now();
+
+	CHECK(linearResults == indexedResults);
+
+	const auto linearTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+	const auto indexedTime = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+	LOG("[MassReclaimThroughput] %d builders, %d wrecks, %d queries: linear=%ldus indexed=%ldus (%.2fx)",
+		numBuilders, numWrecks, numFrames * numBuilders * numQueries,
+		long(linearTime), long(indexedTime), linearTime / std::max(1.0, double(indexedTime)));
+}
+#endif
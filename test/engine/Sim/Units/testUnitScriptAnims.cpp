@@ -0,0 +1,194 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Units/Scripts/UnitScriptAnims.h"
+#include "System/SpringMath.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// split evenly over the tick rates, per animation type
+static constexpr size_t NUM_INPUTS = 1000 * 1000;
+
+// 1000 / deltaTime for the usual sim and unsynced update intervals
+static constexpr int TICK_RATES[] = {1000, 62, 33, 30, 15, 1};
+static constexpr size_t NUM_TICK_RATES = sizeof(TICK_RATES) / sizeof(TICK_RATES[0]);
+
+
+// CUnitScript::MoveToward, TurnToward and DoSpin as they were before the
+// animations were moved into CUnitScriptEngine's tables
+static bool MoveToward(float& cur, float dest, float speed)
+{
+	const float delta = dest - cur;
+
+	if (math::fabsf(delta) <= speed) {
+		cur = dest;
+		return true;
+	}
+
+	cur += (speed * Sign(delta));
+	return false;
+}
+
+static bool TurnToward(float& cur, float dest, float speed)
+{
+	float delta = dest - cur;
+
+	// clamp: -pi .. 0 .. +pi (fmod(x,TWOPI) would do the same but is slower due to streflop)
+	if (delta > math::PI) {
+		delta -= math::TWOPI;
+	} else if (delta <= -math::PI) {
+		delta += math::TWOPI;
+	}
+
+	if (math::fabsf(delta) <= speed) {
+		cur = dest;
+		return true;
+	}
+
+	cur = ClampRad(cur + speed * Sign(delta));
+	return false;
+}
+
+static bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor)
+{
+	const float delta = dest - speed;
+
+	// Check if we are not at the final speed and
+	// make sure we do not go past desired speed
+	if (math::fabsf(delta) <= accel) {
+		if ((speed = dest) == 0.0f)
+			return true;
+	} else {
+		// accelerations are defined in speed/frame (at GAME_SPEED fps)
+		speed += (accel * (GAME_SPEED * 1.0f / divisor) * Sign(delta));
+	}
+
+	cur = ClampRad(cur + (speed / divisor));
+	return false;
+}
+
+
+struct AnimInputs {
+	std::vector<float> values;
+	std::vector<float> speeds;
+	std::vector<float> dests;
+	std::vector<float> accels;
+	std::vector<std::uint8_t> done;
+};
+
+static bool BitEqual(float a, float b) { return (std::memcmp(&a, &b, sizeof(float)) == 0); }
+
+
+static std::mt19937 rng;
+
+static float RandFloat(float lo, float hi) { return (std::uniform_real_distribution<float>(lo, hi)(rng)); }
+static int RandInt(int n) { return (std::uniform_int_distribution<int>(0, n - 1)(rng)); }
+
+// mostly arbitrary values, with a good share of the edge cases (already at
+// the destination, just next to it, half a circle away, zero speeds)
+static float RandDest(float cur, float range)
+{
+	switch (RandInt(8)) {
+		case 0: { return cur; } break;
+		case 1: { return std::nextafter(cur, cur + 1.0f); } break;
+		case 2: { return cur + math::PI; } break;
+		case 3: { return cur - math::PI; } break;
+		default: {} break;
+	}
+
+	return (RandFloat(-range, range));
+}
+
+static AnimInputs GenInputs(size_t numAnims, bool spin)
+{
+	AnimInputs in;
+
+	in.values.resize(numAnims);
+	in.speeds.resize(numAnims);
+	in.dests.resize(numAnims);
+	in.accels.resize(numAnims);
+	in.done.resize(numAnims);
+
+	for (size_t i = 0; i < numAnims; i++) {
+		in.values[i] = RandFloat(-math::TWOPI, math::TWOPI * 2.0f);
+
+		if (spin) {
+			in.speeds[i] = RandFloat(-10.0f, 10.0f);
+			in.dests[i] = (RandInt(4) == 0)? 0.0f: RandDest(in.speeds[i], 10.0f);
+			in.accels[i] = (RandInt(8) == 0)? 0.0f: RandFloat(0.0f, 2.0f);
+		} else {
+			in.speeds[i] = (RandInt(8) == 0)? 0.0f: RandFloat(0.0f, 20.0f);
+			in.dests[i] = RandDest(in.values[i], math::TWOPI * 2.0f);
+		}
+	}
+
+	return in;
+}
+
+
+TEST_CASE("TurnAnimsMatchTurnToward")
+{
+	rng.seed(1);
+
+	for (const int tickRate: TICK_RATES) {
+		AnimInputs in = GenInputs(NUM_INPUTS / NUM_TICK_RATES, false);
+		std::vector<float> oldValues = in.values;
+
+		UnitScriptAnims::AdvanceTurns(in.values.data(), in.done.data(), in.speeds.data(), in.dests.data(), in.values.size(), tickRate);
+
+		for (size_t i = 0; i < in.values.size(); i++) {
+			const bool oldDone = TurnToward(oldValues[i], in.dests[i], in.speeds[i] / tickRate);
+			// what CUnitScriptEngine::TickAnims stores
+			const float newValue = in.done[i]? in.values[i]: ClampRad(in.values[i]);
+
+			REQUIRE(bool(in.done[i]) == oldDone);
+			REQUIRE(BitEqual(newValue, oldValues[i]));
+		}
+	}
+}
+
+TEST_CASE("SpinAnimsMatchDoSpin")
+{
+	rng.seed(2);
+
+	for (const int tickRate: TICK_RATES) {
+		AnimInputs in = GenInputs(NUM_INPUTS / NUM_TICK_RATES, true);
+		std::vector<float> oldValues = in.values;
+		std::vector<float> oldSpeeds = in.speeds;
+
+		UnitScriptAnims::AdvanceSpins(in.values.data(), in.done.data(), in.speeds.data(), in.dests.data(), in.accels.data(), in.values.size(), tickRate);
+
+		for (size_t i = 0; i < in.values.size(); i++) {
+			const bool oldDone = DoSpin(oldValues[i], in.dests[i], oldSpeeds[i], in.accels[i], tickRate);
+			const float newValue = in.done[i]? in.values[i]: ClampRad(in.values[i]);
+
+			REQUIRE(bool(in.done[i]) == oldDone);
+			REQUIRE(BitEqual(newValue, oldValues[i]));
+			REQUIRE(BitEqual(in.speeds[i], oldSpeeds[i]));
+		}
+	}
+}
+
+TEST_CASE("MoveAnimsMatchMoveToward")
+{
+	rng.seed(3);
+
+	for (const int tickRate: TICK_RATES) {
+		AnimInputs in = GenInputs(NUM_INPUTS / NUM_TICK_RATES, false);
+		std::vector<float> oldValues = in.values;
+
+		UnitScriptAnims::AdvanceMoves(in.values.data(), in.done.data(), in.speeds.data(), in.dests.data(), in.values.size(), tickRate);
+
+		for (size_t i = 0; i < in.values.size(); i++) {
+			const bool oldDone = MoveToward(oldValues[i], in.dests[i], in.speeds[i] / tickRate);
+
+			REQUIRE(bool(in.done[i]) == oldDone);
+			REQUIRE(BitEqual(in.values[i], oldValues[i]));
+		}
+	}
+}
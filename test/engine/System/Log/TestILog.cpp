@@ -9,7 +9,11 @@
 #include "lib/catch.hpp"
 
 #include <cstdarg>
+#include <cstring>
+#include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 
 
@@ -233,3 +237,70 @@ TEST_CASE("IsEnabled")
 	TLOG_SL(   "other-one-time-section", L_DEBUG, "Testing LOG_IS_ENABLED_S");
 }
 
+
+
+TEST_CASE("AsyncFileSink")
+{
+	constexpr int numThreads = 4;
+	constexpr int numRecords = 500;
+
+	// the stream-sink is not thread-safe
+	log_sink_stream_setLogStream(NULL);
+
+	const unsigned int numDropsPre = log_file_getNumDroppedRecords();
+
+	log_file_startWriterThread();
+
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < numThreads; t++) {
+		threads.emplace_back([t]() {
+			for (int n = 0; n < numRecords; n++) {
+				// warnings may never be dropped, infos only when the queue is full
+				if ((n & 1) == 0) {
+					LOG_L(L_WARNING, "(AsyncFileSink) thread=%d record=%d", t, n);
+				} else {
+					LOG("(AsyncFileSink) thread=%d record=%d", t, n);
+				}
+			}
+		});
+	}
+
+	for (std::thread& t: threads) {
+		t.join();
+	}
+
+	log_file_stopWriterThread();
+	log_sink_stream_setLogStream(&ls.logStream);
+
+	std::vector<int> nextRecords(numThreads, 0);
+	std::ifstream logFile(ls.logFile);
+	std::string line;
+
+	int numWarnings = 0;
+	int numInfos = 0;
+
+	while (std::getline(logFile, line)) {
+		const size_t pos = line.find("(AsyncFileSink) ");
+
+		if (pos == std::string::npos)
+			continue;
+
+		int t = -1;
+		int n = -1;
+
+		REQUIRE(sscanf(line.c_str() + pos, "(AsyncFileSink) thread=%d record=%d", &t, &n) == 2);
+		REQUIRE(t >= 0);
+		REQUIRE(t < numThreads);
+
+		// records of each thread stay in order
+		CHECK(n >= nextRecords[t]);
+		nextRecords[t] = n + 1;
+
+		numWarnings += ((n & 1) == 0);
+		numInfos += ((n & 1) == 1);
+	}
+
+	CHECK(numWarnings == (numThreads * numRecords / 2));
+	CHECK(numInfos + int(log_file_getNumDroppedRecords() - numDropsPre) == (numThreads * numRecords / 2));
+}
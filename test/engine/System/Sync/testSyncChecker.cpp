@@ -0,0 +1,147 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SYNCCHECK
+	#error "This test requires SYNCCHECK to be defined on the compiler command line."
+#endif
+#include "System/Sync/SyncedPrimitive.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+struct TestObject {
+	SyncedSint health;
+	SyncedFloat speed;
+	SyncedUint flags;
+};
+
+// one object's share of a sim phase, <salt> changes what gets synced
+static void UpdateObject(TestObject& o, unsigned id, unsigned salt)
+{
+	for (unsigned i = 0; i < (id % 7) + 1; i++) {
+		o.health = int(id * 31 + i + salt);
+		o.speed = (id + i) * 0.25f;
+		o.flags = (id ^ i) & 0xff;
+	}
+}
+
+static unsigned RunPhase(const std::vector<unsigned>& order, int numThreads, unsigned salt)
+{
+	std::vector<TestObject> objects(order.size());
+	std::atomic<unsigned> next = {0};
+
+	CSyncChecker::NewFrame();
+	CSyncChecker::BeginParallelPhase();
+
+	const auto worker = [&]() {
+		for (unsigned n; (n = next.fetch_add(1)) < order.size(); ) {
+			CSyncChecker::ScopedLane lane(order[n]);
+			UpdateObject(objects[order[n]], order[n], salt * (order[n] == 17));
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < numThreads; i++) {
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (std::thread& t: threads) {
+		t.join();
+	}
+
+	CSyncChecker::EndParallelPhase();
+	return CSyncChecker::GetChecksum();
+}
+
+
+TEST_CASE("SyncCheckerLanes")
+{
+	ENTER_SYNCED_CODE();
+
+	std::vector<unsigned> order(1000);
+
+	for (unsigned n = 0; n < order.size(); n++) {
+		order[n] = n;
+	}
+
+	const unsigned serial = RunPhase(order, 1, 0);
+
+	// same work in any order and on any number of threads gives the same checksum
+	std::reverse(order.begin(), order.end());
+	CHECK(RunPhase(order, 1, 0) == serial);
+
+	std::mt19937 rng(1);
+
+	for (int numThreads: {2, 4, 8}) {
+		for (int run = 0; run < 5; run++) {
+			std::shuffle(order.begin(), order.end(), rng);
+			CHECK(RunPhase(order, numThreads, 0) == serial);
+		}
+	}
+
+	// while a differing write by one object is still caught
+	CHECK(RunPhase(order, 4, 1) != serial);
+
+	LEAVE_SYNCED_CODE();
+}
+
+
+TEST_CASE("SyncCheckerPhases")
+{
+	ENTER_SYNCED_CODE();
+
+	SyncedSint v;
+
+	CSyncChecker::NewFrame();
+	v = 1;
+	v = 2;
+	const unsigned serial = CSyncChecker::GetChecksum();
+
+	// lanes nothing was synced into leave the checksum as it was
+	CSyncChecker::NewFrame();
+	v = 1;
+	CSyncChecker::BeginParallelPhase();
+	{
+		CSyncChecker::ScopedLane lane(3);
+	}
+	CSyncChecker::EndParallelPhase();
+	v = 2;
+	CHECK(CSyncChecker::GetChecksum() == serial);
+
+	// writes outside of lanes keep their order-dependence
+	CSyncChecker::NewFrame();
+	v = 2;
+	v = 1;
+	CHECK(CSyncChecker::GetChecksum() != serial);
+
+	// lanes sharing a key are merged in checksum-order
+	unsigned checksums[2];
+
+	for (int i = 0; i < 2; i++) {
+		CSyncChecker::NewFrame();
+		CSyncChecker::BeginParallelPhase();
+		{
+			CSyncChecker::ScopedLane lane(5);
+			v = 10 + i;
+		}
+		{
+			CSyncChecker::ScopedLane lane(5);
+			v = 11 - i;
+		}
+		CSyncChecker::EndParallelPhase();
+		checksums[i] = CSyncChecker::GetChecksum();
+	}
+
+	CHECK(checksums[0] == checksums[1]);
+
+	LEAVE_SYNCED_CODE();
+}
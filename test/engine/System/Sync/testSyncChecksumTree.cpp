@@ -0,0 +1,253 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Sync/SyncChecksumTree.h"
+#include "System/Sync/SyncTreeBisector.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+struct Desync {
+	int frameNum;
+	unsigned phaseID;
+	int objectID;
+	int writeIdx;
+};
+
+// a few sim phases over <numObjects> objects, every object doing a handful
+// of synced writes; the client with <desync> writes one differing value
+static void SimFrame(CSyncChecksumTree& tree, int frameNum, int numObjects, const Desync* desync)
+{
+	tree.NewFrame(frameNum);
+
+	// writes outside of any phase
+	tree.Sync(frameNum);
+
+	for (unsigned phaseID: {SYNC_PHASE_UNIT_MOVETYPES, SYNC_PHASE_UNIT_UPDATES, SYNC_PHASE_PROJECTILE_UPDATES}) {
+		const unsigned prevPhaseID = tree.SetPhase(phaseID);
+
+		for (int objectID = 0; objectID < numObjects; objectID++) {
+			// objects that do not write anything leave no trace
+			if (((objectID + frameNum) % 5) == 0)
+				continue;
+
+			const int prevObjectID = tree.SetObject(objectID);
+
+			for (int n = 0; n < (objectID % 4) + 1; n++) {
+				unsigned data = objectID * 7919 + frameNum * 31 + n;
+
+				if (desync != nullptr && desync->frameNum == frameNum && desync->phaseID == phaseID && desync->objectID == objectID && desync->writeIdx == n)
+					data ^= 1;
+
+				tree.Sync(data);
+			}
+
+			tree.SetObject(prevObjectID);
+		}
+
+		tree.SetPhase(prevPhaseID);
+	}
+}
+
+// runs the server's side of the search to its end, every client answering
+// each request from its own tree like NetCommands does
+static CSyncTreeBisector::Result Bisect(const std::vector< std::unique_ptr<CSyncChecksumTree> >& trees, int errorFrameNum, int& numRequests)
+{
+	CSyncTreeBisector bisector;
+	std::vector<int> playerNums;
+
+	for (size_t i = 0; i < trees.size(); i++) {
+		playerNums.push_back(i);
+	}
+
+	bisector.Start(errorFrameNum, playerNums);
+
+	for (numRequests = 0; bisector.IsActive(); numRequests++) {
+		const CSyncTreeBisector::Request request = bisector.GetRequest();
+
+		for (size_t i = 0; i < trees.size(); i++) {
+			std::vector<std::uint32_t> data;
+			CSyncTreeBisector::GetResponse(*trees[i], request, data);
+
+			// only the last response completes the set
+			CHECK(bisector.AddResponse(i, request.level, std::move(data)) == (i == (trees.size() - 1)));
+		}
+	}
+
+	CHECK(bisector.GetRequest().frameNum == errorFrameNum);
+	return bisector.GetResult();
+}
+
+
+TEST_CASE("SyncChecksumTreeBisect")
+{
+	constexpr int numClients = 3;
+	constexpr int numObjects = 2000;
+	// more than are kept, the oldest ones are dropped
+	constexpr int numFrames = CSyncChecksumTree::NUM_FRAMES + 40;
+
+	const Desync desync = {numFrames - 20, SYNC_PHASE_UNIT_UPDATES, 1217, 1};
+
+	std::vector< std::unique_ptr<CSyncChecksumTree> > trees;
+
+	for (int i = 0; i < numClients; i++) {
+		trees.emplace_back(new CSyncChecksumTree());
+
+		for (int frameNum = 0; frameNum < numFrames; frameNum++) {
+			SimFrame(*trees.back(), frameNum, numObjects, (i == 1)? &desync: nullptr);
+		}
+
+		std::vector<std::uint32_t> frameChecksums;
+		trees.back()->GetFrameChecksums(frameChecksums);
+		CHECK(frameChecksums.size() == CSyncChecksumTree::NUM_FRAMES * 2);
+	}
+
+	int numRequests = 0;
+	const CSyncTreeBisector::Result result = Bisect(trees, numFrames - 1, numRequests);
+
+	CHECK(result.frameNum == desync.frameNum);
+	CHECK(result.phaseID == int(desync.phaseID));
+	CHECK(result.objectID == desync.objectID);
+	CHECK(result.writeIdx == desync.writeIdx);
+
+	// frames, phases, two rounds of chunks over the ~1600 leaves, one leaf
+	CHECK(numRequests <= 5);
+
+	// the differing write is in the desync-frame values of the object
+	std::vector<std::uint32_t> writes[numClients];
+	CSyncChecksumTree::Leaf leaf;
+
+	for (int i = 0; i < numClients; i++) {
+		const CSyncChecksumTree::Frame* frame = trees[i]->GetFrame(desync.frameNum);
+		REQUIRE(frame != nullptr);
+
+		const auto pred = [&](const CSyncChecksumTree::Phase& p) { return (p.phaseID == desync.phaseID); };
+		const unsigned phaseIdx = std::find_if(frame->phases.begin(), frame->phases.end(), pred) - frame->phases.begin();
+		unsigned leafIdx = 0;
+
+		while (trees[i]->GetLeaf(desync.frameNum, phaseIdx, leafIdx, leaf) && leaf.objectID != desync.objectID) {
+			leafIdx++;
+		}
+
+		REQUIRE(leaf.objectID == desync.objectID);
+		CHECK(trees[i]->GetLeafWrites(desync.frameNum, phaseIdx, leafIdx, writes[i]));
+		CHECK(writes[i].size() == leaf.numWrites);
+	}
+
+	CHECK(writes[0] == writes[2]);
+	CHECK(writes[0][0] == writes[1][0]);
+	CHECK(writes[0][1] == (writes[1][1] ^ 1));
+}
+
+TEST_CASE("SyncChecksumTreeBisectLateJoiner")
+{
+	constexpr int numClients = 3;
+	constexpr int numObjects = 100;
+	constexpr int numFrames = CSyncChecksumTree::NUM_FRAMES;
+
+	const Desync desync = {numFrames - 30, SYNC_PHASE_PROJECTILE_UPDATES, 42, 0};
+
+	std::vector< std::unique_ptr<CSyncChecksumTree> > trees;
+
+	for (int i = 0; i < numClients; i++) {
+		trees.emplace_back(new CSyncChecksumTree());
+
+		// the last client connected late and has fewer frames, an earlier
+		// difference between the others is not the desync all of them see
+		for (int frameNum = ((i == 2)? (numFrames - 50): 0); frameNum < numFrames; frameNum++) {
+			const Desync early = {10, SYNC_PHASE_UNIT_MOVETYPES, 7, 0};
+			const Desync* d = (i == 1)? &desync: ((i == 0)? &early: nullptr);
+
+			SimFrame(*trees.back(), frameNum, numObjects, d);
+		}
+	}
+
+	int numRequests = 0;
+	const CSyncTreeBisector::Result result = Bisect(trees, numFrames - 1, numRequests);
+
+	CHECK(result.frameNum == desync.frameNum);
+	CHECK(result.phaseID == int(desync.phaseID));
+	CHECK(result.objectID == desync.objectID);
+	CHECK(result.writeIdx == desync.writeIdx);
+}
+
+TEST_CASE("SyncTreeBisectorRemovePlayer")
+{
+	CSyncChecksumTree tree;
+	CSyncTreeBisector bisector;
+
+	SimFrame(tree, 0, 10, nullptr);
+
+	const CSyncTreeBisector::Request request = bisector.Start(0, {3, 5});
+	std::vector<std::uint32_t> data;
+
+	CSyncTreeBisector::GetResponse(tree, request, data);
+
+	CHECK_FALSE(bisector.AddResponse(3, request.level, std::move(data)));
+	// responses to other levels or from unknown players are ignored
+	CHECK_FALSE(bisector.AddResponse(5, CSyncTreeBisector::SD_TREE_LEAF, {}));
+	CHECK_FALSE(bisector.AddResponse(4, request.level, {}));
+
+	// the one that left is not waited for, all frames are equal
+	CHECK(bisector.RemovePlayer(5));
+	CHECK_FALSE(bisector.IsActive());
+	CHECK(bisector.GetResult().frameNum == -1);
+}
+
+
+TEST_CASE("SyncChecksumTreeMismatch")
+{
+	CSyncChecksumTree a;
+	CSyncChecksumTree b;
+
+	for (CSyncChecksumTree* tree: {&a, &b}) {
+		tree->NewFrame(0);
+		tree->SetPhase(SYNC_PHASE_FEATURE_UPDATES);
+
+		for (int objectID = 0; objectID < 10; objectID++) {
+			tree->SetObject(objectID);
+			tree->Sync(objectID);
+		}
+
+		tree->SetObject(-1);
+		tree->SetPhase(SYNC_PHASE_OTHER);
+	}
+
+	// one client updated an extra object
+	b.SetPhase(SYNC_PHASE_FEATURE_UPDATES);
+	b.SetObject(10);
+	b.Sync(10);
+
+	std::vector<std::uint32_t> ra;
+	std::vector<std::uint32_t> rb;
+
+	a.GetPhaseChecksums(0, ra);
+	b.GetPhaseChecksums(0, rb);
+
+	// the first phase differs in size and checksum, the extra phase is missing from <a>
+	CHECK(ra.size() == 3);
+	CHECK(rb.size() == 6);
+	CHECK(CSyncChecksumTree::FindFirstMismatch({&ra, &ra}, 3) == -1);
+	CHECK(CSyncChecksumTree::FindFirstMismatch({&ra, &rb}, 3) == 1);
+
+	// leaves past the end of the shorter phase still differ
+	a.GetLeafChecksums(0, 1, 0, 1, CSyncChecksumTree::NUM_CHUNKS, ra);
+	b.GetLeafChecksums(0, 1, 0, 1, CSyncChecksumTree::NUM_CHUNKS, rb);
+
+	CHECK(ra.size() == 1);
+	CHECK(rb.size() == 1);
+	CHECK(ra[0] != rb[0]);
+
+	// frozen trees keep their frames
+	a.SetFrozen(true);
+	a.NewFrame(1);
+	a.Sync(1);
+	a.GetFrameChecksums(ra);
+
+	CHECK(a.GetFrame(1) == nullptr);
+	CHECK(ra.size() == 2);
+}
@@ -0,0 +1,235 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/MemPoolTypes.h"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// roughly projectile-sized; pools hand out fixed pages
+struct PoolObject {
+	PoolObject(int v): value(v) { std::fill(std::begin(payload), std::end(payload), v); }
+
+	int value;
+	int payload[127];
+};
+
+static constexpr size_t NUM_OBJECTS = 1 << 14;
+
+typedef DynMemPool<sizeof(PoolObject)> TestDynMemPool;
+typedef StaticMemPool<NUM_OBJECTS, sizeof(PoolObject)> TestStaticMemPool;
+typedef FixedDynMemPool<sizeof(PoolObject), NUM_OBJECTS / 1024, 1024> TestFixedDynMemPool;
+
+
+template<typename Pool> static void TestPool(Pool& pool)
+{
+	std::vector<PoolObject*> objects;
+
+	for (int i = 0; i < 100; i++) {
+		objects.push_back(pool.template alloc<PoolObject>(i));
+
+		CHECK(pool.mapped(objects.back()));
+		CHECK(pool.alloced(objects.back()));
+	}
+
+	for (int i = 0; i < 100; i++) {
+		CHECK(objects[i]->value == i);
+		CHECK(objects[i]->payload[126] == i);
+	}
+
+	// FixedDynMemPool hands out indices a chunk at a time
+	const size_t freedSize = pool.freed_size();
+
+	// free every other object, their pages must come back zeroed
+	for (int i = 0; i < 100; i += 2) {
+		pool.free(objects[i]);
+
+		CHECK(objects[i] == nullptr);
+	}
+
+	CHECK(pool.freed_size() == (freedSize + 50 * Pool::PAGE_SIZE()));
+
+	for (int i = 0; i < 100; i += 2) {
+		void* m = pool.allocMem(sizeof(PoolObject));
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(m);
+
+		CHECK(std::all_of(bytes, bytes + sizeof(PoolObject), [](unsigned char b) { return (b == 0); }));
+
+		objects[i] = new (m) PoolObject(-i);
+	}
+
+	CHECK(pool.freed_size() == freedSize);
+
+	for (int i = 0; i < 100; i++) {
+		CHECK(objects[i]->value == ((i & 1)? i: -i));
+		pool.free(objects[i]);
+	}
+
+	CHECK(pool.freed_size() == (freedSize + 100 * Pool::PAGE_SIZE()));
+}
+
+
+TEST_CASE("DynMemPool")
+{
+	TestDynMemPool pool;
+	TestPool(pool);
+
+	// addresses of live objects must stay stable as the pool grows
+	std::vector<PoolObject*> objects;
+
+	for (size_t i = 0; i < NUM_OBJECTS; i++) {
+		objects.push_back(pool.alloc<PoolObject>(int(i)));
+	}
+	for (size_t i = 0; i < NUM_OBJECTS; i++) {
+		CHECK(objects[i]->value == int(i));
+		pool.free(objects[i]);
+	}
+}
+
+TEST_CASE("StaticMemPool")
+{
+	std::unique_ptr<TestStaticMemPool> pool(new TestStaticMemPool());
+	TestPool(*pool);
+
+	PoolObject outside(0);
+	CHECK(!pool->mapped(&outside));
+}
+
+TEST_CASE("FixedDynMemPool")
+{
+	TestFixedDynMemPool pool;
+	TestPool(pool);
+}
+
+
+// alloc/free churn in the order projectiles typically die, i.e. mostly
+// but not strictly FIFO; live objects must never be clobbered
+template<typename Pool> static void ChurnPool(Pool& pool)
+{
+	constexpr size_t numLive = NUM_OBJECTS / 2;
+	constexpr size_t numRounds = 16;
+
+	std::mt19937 rng(123);
+	std::vector<PoolObject*> live;
+
+	live.reserve(NUM_OBJECTS);
+
+	for (size_t n = 0; n < numLive; n++) {
+		live.push_back(pool.template alloc<PoolObject>(int(n)));
+	}
+
+	bool intact = true;
+
+	for (size_t r = 0; r < numRounds; r++) {
+		for (size_t n = 0; n < (numLive / 4); n++) {
+			const size_t i = rng() % (live.size() / 8);
+
+			pool.free(live[i]);
+			live[i] = live.back();
+			live.pop_back();
+		}
+
+		while (live.size() < numLive) {
+			live.push_back(pool.template alloc<PoolObject>(int(live.size())));
+		}
+
+		for (const PoolObject* p: live) {
+			intact &= (p->payload[0] == p->value && p->payload[126] == p->value);
+		}
+	}
+
+	CHECK(intact);
+
+	for (PoolObject* p: live) {
+		pool.free(p);
+	}
+
+	CHECK(pool.freed_size() == pool.alloc_size());
+}
+
+TEST_CASE("MemPoolChurn")
+{
+	TestDynMemPool dynPool;
+	TestFixedDynMemPool fixedDynPool;
+	std::unique_ptr<TestStaticMemPool> staticPool(new TestStaticMemPool());
+
+	ChurnPool(dynPool);
+	ChurnPool(fixedDynPool);
+	ChurnPool(*staticPool);
+}
+
+
+#ifdef UNIT_BENCHMARK
+// the pools themselves are what is measured, not the ctor
+struct BenchObject {
+	BenchObject(int v): value(v) {}
+
+	int value;
+	char padding[sizeof(PoolObject) - sizeof(int)];
+};
+
+// same churn as ChurnPool, timed
+template<typename AllocFunc, typename FreeFunc>
+static double ChurnBenchmark(AllocFunc allocFunc, FreeFunc freeFunc)
+{
+	constexpr size_t numLive = NUM_OBJECTS / 2;
+	constexpr size_t numRounds = 64;
+
+	std::mt19937 rng(123);
+	std::vector<BenchObject*> live;
+
+	live.reserve(NUM_OBJECTS);
+
+	const auto t0 = std::chrono::steady_clock::now();
+
+	for (size_t n = 0; n < numLive; n++) {
+		live.push_back(allocFunc(int(n)));
+	}
+
+	for (size_t r = 0; r < numRounds; r++) {
+		for (size_t n = 0; n < (numLive / 4); n++) {
+			const size_t i = rng() % (live.size() / 8);
+
+			freeFunc(live[i]);
+			live[i] = live.back();
+			live.pop_back();
+		}
+
+		while (live.size() < numLive) {
+			live.push_back(allocFunc(int(r)));
+		}
+	}
+
+	for (BenchObject* p: live) {
+		freeFunc(p);
+	}
+
+	const auto t1 = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+TEST_CASE("MemPoolThroughput")
+{
+	TestDynMemPool dynPool;
+	TestFixedDynMemPool fixedDynPool;
+	std::unique_ptr<TestStaticMemPool> staticPool(new TestStaticMemPool());
+
+	const double dynTime = ChurnBenchmark([&](int v) { return dynPool.alloc<BenchObject>(v); }, [&](BenchObject* p) { dynPool.free(p); });
+	const double fixedDynTime = ChurnBenchmark([&](int v) { return fixedDynPool.alloc<BenchObject>(v); }, [&](BenchObject* p) { fixedDynPool.free(p); });
+	const double staticTime = ChurnBenchmark([&](int v) { return staticPool->alloc<BenchObject>(v); }, [&](BenchObject* p) { staticPool->free(p); });
+	const double heapTime = ChurnBenchmark([&](int v) { return new BenchObject(v); }, [&](BenchObject* p) { delete p; });
+
+	CHECK(dynPool.freed_size() == dynPool.alloc_size());
+	CHECK(fixedDynPool.freed_size() == fixedDynPool.alloc_size());
+	CHECK(staticPool->freed_size() == staticPool->alloc_size());
+
+	LOG("[MemPoolThroughput] DynMemPool=%.3fms FixedDynMemPool=%.3fms StaticMemPool=%.3fms new/delete=%.3fms", dynTime, fixedDynTime, staticTime, heapTime);
+}
+#endif
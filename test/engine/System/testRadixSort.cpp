@@ -0,0 +1,99 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/RadixSort.h"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+struct SortItem {
+	std::uint32_t key;
+	std::uint32_t idx;
+};
+
+static std::vector<SortItem> MakeItems(size_t numItems, std::uint32_t keyMask)
+{
+	std::mt19937 rng(numItems);
+	std::vector<SortItem> items(numItems);
+
+	for (size_t i = 0; i < numItems; i++) {
+		items[i] = {std::uint32_t(rng() & keyMask), std::uint32_t(i)};
+	}
+
+	return items;
+}
+
+static bool IsSortedStable(const std::vector<SortItem>& items)
+{
+	for (size_t i = 1; i < items.size(); i++) {
+		if (items[i - 1].key > items[i].key)
+			return false;
+		if (items[i - 1].key == items[i].key && items[i - 1].idx > items[i].idx)
+			return false;
+	}
+
+	return true;
+}
+
+
+TEST_CASE("RadixSort")
+{
+	std::vector<SortItem> scratch;
+
+	for (size_t numItems: {0, 1, 2, 100, 5000, 1 << 17}) {
+		for (std::uint32_t keyMask: {0x0u, 0xFFu, 0xFFFFu, 0xFF00FFu, 0xFFFFFFFFu}) {
+			std::vector<SortItem> items = MakeItems(numItems, keyMask);
+			std::vector<SortItem> expected = items;
+
+			std::stable_sort(expected.begin(), expected.end(), [](const SortItem& a, const SortItem& b) { return (a.key < b.key); });
+			spring::RadixSort(items, scratch, [](const SortItem& i) { return i.key; });
+
+			CHECK(items.size() == numItems);
+			CHECK(IsSortedStable(items));
+			CHECK(std::equal(items.begin(), items.end(), expected.begin(), [](const SortItem& a, const SortItem& b) { return (a.idx == b.idx); }));
+		}
+	}
+}
+
+#ifdef UNIT_BENCHMARK
+TEST_CASE("RadixSortThroughput")
+{
+	// 16-bit keys, same as the particle depth-sort
+	constexpr size_t numItems = 1 << 17;
+	constexpr int numRuns = 20;
+
+	const std::vector<SortItem> items = MakeItems(numItems, 0xFFFF);
+
+	std::vector<SortItem> radixItems;
+	std::vector<SortItem> sortItems;
+	std::vector<SortItem> scratch;
+
+	double radixTime = 0.0;
+	double sortTime = 0.0;
+
+	for (int n = 0; n < numRuns; n++) {
+		radixItems = items;
+		sortItems = items;
+
+		const auto t0 = std::chrono::steady_clock::now();
+		spring::RadixSort(radixItems, scratch, [](const SortItem& i) { return i.key; });
+		const auto t1 = std::chrono::steady_clock::now();
+		std::sort(sortItems.begin(), sortItems.end(), [](const SortItem& a, const SortItem& b) { return (a.key < b.key || (a.key == b.key && a.idx < b.idx)); });
+		const auto t2 = std::chrono::steady_clock::now();
+
+		radixTime += std::chrono::duration<double, std::milli>(t1 - t0).count();
+		sortTime += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+		CHECK(IsSortedStable(radixItems));
+	}
+
+	LOG("[RadixSortThroughput] %u items: RadixSort=%.3fms std::sort=%.3fms (mean of %d runs)",
+		unsigned(numItems), radixTime / numRuns, sortTime / numRuns, numRuns);
+}
+#endif
@@ -28,6 +28,7 @@ no console output (you still could use this.exe > z.tzt though).
 	DEFINE_bool  (dump,         false, "Only dump networc traffic saved in demo");
 	DEFINE_bool  (stats,        false, "Print all game, player and team stats");
 	DEFINE_bool  (header,       false, "Print demoheader content");
+	DEFINE_bool  (frames,       false, "Print the number of sim frames recorded in the demo (see test/benchmark/replay.sh)");
 	DEFINE_bool  (playerstats,  false, "Print playerstats");
 	DEFINE_bool  (teamstats,    false, "Print teamstats");
 	DEFINE_int32 (team,         -1,    "Select team");
@@ -35,6 +36,7 @@ no console output (you still could use this.exe > z.tzt though).
 
 
 void TrafficDump(CDemoReader& reader, bool trafficStats);
+int CountFrames(CDemoReader& reader);
 void WriteTeamstatHistory(CDemoReader& reader, unsigned team, const std::string& file);
 
 int main (int argc, char* argv[])
@@ -59,6 +61,11 @@ int main (int argc, char* argv[])
 		TrafficDump(reader, true);
 		return 0;
 	}
+	if (FLAGS_frames)
+	{
+		std::cout << CountFrames(reader) << std::endl;
+		return 0;
+	}
 	if (!FLAGS_teamsstatcsv.empty())
 	{
 		if (FLAGS_team < 0)
@@ -453,6 +460,21 @@ void TrafficDump(CDemoReader& reader, bool trafficStats)
 	}
 }
 
+int CountFrames(CDemoReader& reader)
+{
+	int frames = 0;
+	while (!reader.ReachedEnd())
+	{
+		netcode::RawPacket* packet = reader.GetData(3.402823466e+38f);
+		if (packet == NULL)
+			continue;
+		if (packet->data[0] == NETMSG_NEWFRAME || packet->data[0] == NETMSG_KEYFRAME)
+			++frames;
+		delete packet;
+	}
+	return frames;
+}
+
 template<typename T>
 void PrintSep(std::ofstream& file, T value)
 {